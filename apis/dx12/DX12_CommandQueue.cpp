@@ -5,6 +5,7 @@
 
 #include <rose-common/math/Common.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace Atrium::DirectX12
@@ -14,6 +15,7 @@ namespace Atrium::DirectX12
 		, myNextFenceValue((std::uint64_t(aQueueType) << 56) + 1)
 		, myLastCompletedFenceValue(std::uint64_t(aQueueType) << 56)
 		, myFenceEventHandle(INVALID_HANDLE_VALUE)
+		, myNextTimelineValue(1)
 	{
 		PROFILE_SCOPE();
 
@@ -69,6 +71,11 @@ namespace Atrium::DirectX12
 			myFence->SetName(queueName);
 		myFence->Signal(myLastCompletedFenceValue);
 
+		Debug::Assert(
+			aDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(myTimelineFence.ReleaseAndGetAddressOf())),
+			"Create command queue timeline fence."
+		);
+
 		myFenceEventHandle = CreateEventEx(NULL, nullptr, false, EVENT_ALL_ACCESS);
 		Debug::Assert(myFenceEventHandle != INVALID_HANDLE_VALUE, "Event handle is valid.");
 	}
@@ -111,14 +118,46 @@ namespace Atrium::DirectX12
 	}
 
 	void CommandQueue::WaitForFenceCPUBlocking(std::uint64_t aFenceValue)
+	{
+		WaitForFenceCPUBlocking(aFenceValue, std::chrono::milliseconds::max());
+	}
+
+	bool CommandQueue::WaitForFenceCPUBlocking(std::uint64_t aFenceValue, std::chrono::milliseconds aTimeout)
 	{
 		if (IsFenceComplete(aFenceValue))
-			return;
+			return true;
+
+		const bool isComplete = WaitForFenceCPUBlocking(*myFence.Get(), aFenceValue, aTimeout);
+		PollCurrentFenceValue();
+		return isComplete;
+	}
+
+	bool CommandQueue::WaitForFenceCPUBlocking(ID3D12Fence& aFence, std::uint64_t aFenceValue, std::chrono::milliseconds aTimeout)
+	{
+		const bool isInfinite = aTimeout == std::chrono::milliseconds::max();
+		const auto deadline = isInfinite ? std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + aTimeout;
 
 		std::lock_guard lock(myEventMutex);
-		myFence->SetEventOnCompletion(aFenceValue, myFenceEventHandle);
-		WaitForSingleObjectEx(myFenceEventHandle, INFINITE, false);
-		myLastCompletedFenceValue = aFenceValue;
+
+		// A wait that timed out earlier leaves its completion event registered, which can wake this one early.
+		// Re-check the fence after every wake-up instead of trusting the event.
+		while (aFence.GetCompletedValue() < aFenceValue)
+		{
+			DWORD waitMilliseconds = INFINITE;
+			if (!isInfinite)
+			{
+				const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+				if (remaining.count() <= 0)
+					return false;
+
+				waitMilliseconds = static_cast<DWORD>(std::min<std::chrono::milliseconds::rep>(remaining.count(), INFINITE - 1));
+			}
+
+			aFence.SetEventOnCompletion(aFenceValue, myFenceEventHandle);
+			WaitForSingleObjectEx(myFenceEventHandle, waitMilliseconds, false);
+		}
+
+		return true;
 	}
 
 	std::uint64_t CommandQueue::PollCurrentFenceValue()
@@ -159,6 +198,36 @@ namespace Atrium::DirectX12
 		return InsertSignal();
 	}
 
+	std::uint64_t CommandQueue::ReserveTimelineValue()
+	{
+		std::lock_guard lock(myFenceMutex);
+		return myNextTimelineValue++;
+	}
+
+	void CommandQueue::InsertTimelineSignal(std::uint64_t aTimelineValue)
+	{
+		std::lock_guard lock(myFenceMutex);
+		myCommandQueue->Signal(myTimelineFence.Get(), aTimelineValue);
+	}
+
+	bool CommandQueue::IsTimelineValueComplete(std::uint64_t aTimelineValue)
+	{
+		return myTimelineFence->GetCompletedValue() >= aTimelineValue;
+	}
+
+	void CommandQueue::InsertWaitForTimelineValue(CommandQueue& anOtherQueue, std::uint64_t aTimelineValue)
+	{
+		myCommandQueue->Wait(anOtherQueue.myTimelineFence.Get(), aTimelineValue);
+	}
+
+	bool CommandQueue::WaitForTimelineValueCPUBlocking(std::uint64_t aTimelineValue, std::chrono::milliseconds aTimeout)
+	{
+		if (IsTimelineValueComplete(aTimelineValue))
+			return true;
+
+		return WaitForFenceCPUBlocking(*myTimelineFence.Get(), aTimelineValue, aTimeout);
+	}
+
 	CommandQueueManager::CommandQueueManager(ComPtr<ID3D12Device> aDevice)
 		: myGraphicsQueue(aDevice, D3D12_COMMAND_LIST_TYPE_DIRECT)
 		, myAsyncComputeQueue(aDevice, D3D12_COMMAND_LIST_TYPE_COMPUTE)
@@ -7,6 +7,7 @@
 
 #include <d3d12.h>
 
+#include <chrono>
 #include <mutex>
 #include <span>
 
@@ -27,6 +28,7 @@ namespace Atrium::DirectX12
 		void InsertWaitForQueue(CommandQueue& anOtherQueue);
 
 		void WaitForFenceCPUBlocking(std::uint64_t aFenceValue);
+		bool WaitForFenceCPUBlocking(std::uint64_t aFenceValue, std::chrono::milliseconds aTimeout);
 		void WaitForIdle() { WaitForFenceCPUBlocking(myNextFenceValue - 1); }
 
 		ComPtr<ID3D12CommandQueue> GetCommandQueue() { return myCommandQueue; }
@@ -44,6 +46,22 @@ namespace Atrium::DirectX12
 		std::uint64_t ExecuteCommandList(ComPtr<ID3D12CommandList> aCommandList);
 		std::uint64_t ExecuteCommandLists(std::span<ComPtr<ID3D12CommandList>> someCommandLists);
 
+		/**
+		 * @brief Reserve a value on the queue's timeline fence, which is only signaled through InsertTimelineSignal().
+		 *        Being separate from the submission fence, a value can be handed out before the signal is inserted.
+		 *
+		 * @return The reserved value. Signals have to be inserted in the order their values were reserved.
+		 */
+		std::uint64_t ReserveTimelineValue();
+		void InsertTimelineSignal(std::uint64_t aTimelineValue);
+
+		bool IsTimelineValueComplete(std::uint64_t aTimelineValue);
+		void InsertWaitForTimelineValue(CommandQueue& anOtherQueue, std::uint64_t aTimelineValue);
+		bool WaitForTimelineValueCPUBlocking(std::uint64_t aTimelineValue, std::chrono::milliseconds aTimeout);
+
+	private:
+		bool WaitForFenceCPUBlocking(ID3D12Fence& aFence, std::uint64_t aFenceValue, std::chrono::milliseconds aTimeout);
+
 	private:
 		ComPtr<ID3D12CommandQueue> myCommandQueue;
 		D3D12_COMMAND_LIST_TYPE myQueueType;
@@ -59,6 +77,9 @@ namespace Atrium::DirectX12
 		std::uint64_t myNextFenceValue;
 		std::uint64_t myLastCompletedFenceValue;
 		HANDLE myFenceEventHandle;
+
+		ComPtr<ID3D12Fence> myTimelineFence;
+		std::uint64_t myNextTimelineValue;
 	};
 
 	class CommandQueueManager
@@ -1,6 +1,8 @@
 #include "DX12_DescriptorHeap.hpp"
 #include "DX12_Diagnostics.hpp"
 
+#include <algorithm>
+
 namespace Atrium::DirectX12
 {
 	D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeapHandle::GetCPUHandle() const
@@ -146,38 +148,164 @@ namespace Atrium::DirectX12
 		myActiveHandleCount--;
 	}
 
-	RenderPassDescriptorHeap::RenderPassDescriptorHeap(ComPtr<ID3D12Device> aDevice, D3D12_DESCRIPTOR_HEAP_TYPE aHeapType, std::uint32_t aNumDescriptors)
-		: DescriptorHeap(aDevice, aHeapType, aNumDescriptors, true)
-		, myCurrentDescriptorIndex(0)
+	D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeapBlock::GetCPUHandle(unsigned int anIndex) const
 	{
-		myDescriptorHeap->SetName(L"Render pass descriptor heap");
+		if (!IsValid())
+			return D3D12_CPU_DESCRIPTOR_HANDLE{ 0 };
+
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = myCPUHandle;
+		handle.ptr += static_cast<SIZE_T>(myDescriptorSize) * anIndex;
+		return handle;
 	}
 
-	void RenderPassDescriptorHeap::Reset()
+	D3D12_GPU_DESCRIPTOR_HANDLE DescriptorHeapBlock::GetGPUHandle(unsigned int anIndex) const
 	{
-		myCurrentDescriptorIndex = 0;
+		if (!IsValid())
+			return D3D12_GPU_DESCRIPTOR_HANDLE{ 0 };
+
+		D3D12_GPU_DESCRIPTOR_HANDLE handle = myGPUHandle;
+		handle.ptr += static_cast<UINT64>(myDescriptorSize) * anIndex;
+		return handle;
 	}
 
-	DescriptorHeapHandle RenderPassDescriptorHeap::GetHeapHandleBlock(std::uint32_t aCount)
+	FrameDescriptorRing::FrameDescriptorRing(ComPtr<ID3D12Device> aDevice, D3D12_DESCRIPTOR_HEAP_TYPE aHeapType, std::uint32_t aPersistentDescriptors, std::uint32_t aDescriptorsPerFrame, std::uint32_t aFramesInFlight)
+		: DescriptorHeap(aDevice, aHeapType, (aPersistentDescriptors + aDescriptorsPerFrame) * aFramesInFlight, true)
+		, myDevice(aDevice)
+		, mySegments(new FrameSegment[aFramesInFlight])
+		, myPersistentAllocator(aPersistentDescriptors)
+		, myFrameNumber(0)
+		, myPersistentDescriptors(aPersistentDescriptors)
+		, myDescriptorsPerFrame(aDescriptorsPerFrame)
+		, myFramesInFlight(aFramesInFlight)
+		, myLastFrameUsage(0)
+		, myHighWaterMark(0)
 	{
-		std::uint32_t newHandleID = 0;
-		std::uint32_t blockEnd = myCurrentDescriptorIndex + aCount;
+		myDescriptorHeap->SetName(L"Frame descriptor ring");
+	}
+
+	DescriptorHeapHandle FrameDescriptorRing::AllocatePersistent()
+	{
+		return AllocatePersistentBlock(1);
+	}
+
+	DescriptorHeapHandle FrameDescriptorRing::AllocatePersistentBlock(std::uint32_t aCount)
+	{
+		std::uint32_t heapIndex = 0;
 
-		if (blockEnd < myMaxDescriptors)
 		{
-			newHandleID = myCurrentDescriptorIndex;
-			myCurrentDescriptorIndex = blockEnd;
+			std::scoped_lock lock(myPersistentMutex);
+
+			const std::optional<TlsfAllocator::Allocation> allocation = myPersistentAllocator.Allocate(aCount);
+			if (!allocation)
+			{
+				Debug::LogError("Ran out of persistent descriptors, need to increase the persistent region size. Requested %u descriptors, with %u of %u in use.", aCount, myPersistentAllocator.GetUsedSize(), myPersistentDescriptors);
+				return { };
+			}
+
+			heapIndex = allocation->Offset;
+			myPersistentAllocations.emplace(heapIndex, allocation.value());
 		}
-		else
+
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = myDescriptorHeapGPUStart;
+		gpuHandle.ptr += static_cast<UINT64>(heapIndex) * myDescriptorSize;
+
+		return CreateHeapHandle(GetPersistentCPUHandle(heapIndex, 0), gpuHandle, heapIndex);
+	}
+
+	void FrameDescriptorRing::CopyPersistent(const DescriptorHeapHandle& aDestination, D3D12_CPU_DESCRIPTOR_HANDLE aSource, std::uint32_t aCount)
+	{
+		for (std::uint32_t frameInFlight = 0; frameInFlight < myFramesInFlight; ++frameInFlight)
+			CopyPersistent(aDestination, aSource, aCount, static_cast<std::uint_least8_t>(frameInFlight));
+	}
+
+	void FrameDescriptorRing::CopyPersistent(const DescriptorHeapHandle& aDestination, D3D12_CPU_DESCRIPTOR_HANDLE aSource, std::uint32_t aCount, std::uint_least8_t aFrameInFlight)
+	{
+		Debug::Assert(aDestination.IsValid() && aDestination.GetHeapIndex() + aCount <= myPersistentDescriptors, "Copies into a persistent allocation.");
+		Debug::Assert(aFrameInFlight < myFramesInFlight, "Frame in flight must be within the range specified upon creation.");
+
+		myDevice->CopyDescriptorsSimple(aCount, GetPersistentCPUHandle(aDestination.GetHeapIndex(), aFrameInFlight), aSource, myHeapType);
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE FrameDescriptorRing::GetPersistentGPUStart(std::uint_least8_t aFrameInFlight) const
+	{
+		return GetPersistentGPUHandle(0, aFrameInFlight);
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE FrameDescriptorRing::GetPersistentCPUHandle(std::uint32_t aHeapIndex, std::uint_least8_t aFrameInFlight) const
+	{
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = myDescriptorHeapCPUStart;
+		handle.ptr += (static_cast<SIZE_T>(aFrameInFlight) * myPersistentDescriptors + aHeapIndex) * myDescriptorSize;
+		return handle;
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE FrameDescriptorRing::GetPersistentGPUHandle(std::uint32_t aHeapIndex, std::uint_least8_t aFrameInFlight) const
+	{
+		D3D12_GPU_DESCRIPTOR_HANDLE handle = myDescriptorHeapGPUStart;
+		handle.ptr += (static_cast<UINT64>(aFrameInFlight) * myPersistentDescriptors + aHeapIndex) * myDescriptorSize;
+		return handle;
+	}
+
+	void FrameDescriptorRing::FreeHeapHandle(std::uint32_t anIndex)
+	{
+		Debug::Assert(anIndex < myPersistentDescriptors, "Only persistent descriptors are freed individually.");
+
+		// Frames already recorded may still read the descriptors, so they're only reused once those have finished.
+		std::scoped_lock lock(myPersistentMutex);
+		myPendingFrees.push_back(PendingFree { anIndex, myFrameNumber });
+	}
+
+	void FrameDescriptorRing::BeginFrame(std::uint_least8_t aFrameInFlight)
+	{
+		Debug::Assert(aFrameInFlight < myFramesInFlight, "Frame in flight must be within the range specified upon creation.");
+
+		// The segment's previous contents were used by the frame that has just been waited on,
+		// so its usage is the final count for that frame.
+		myLastFrameUsage = mySegments[aFrameInFlight].Used.exchange(0, std::memory_order_relaxed);
+		myHighWaterMark = std::max(myHighWaterMark, myLastFrameUsage);
+
+		std::scoped_lock lock(myPersistentMutex);
+		myFrameNumber++;
+
+		// Frees are queued in frame order, and a free made during a frame can be read by it and the frames before it.
+		// Each frame in flight starts after the one using its slot before has finished, so those frames are done once as many frames have started.
+		std::size_t releasedFrees = 0;
+		for (; releasedFrees < myPendingFrees.size() && myPendingFrees[releasedFrees].FrameNumber + myFramesInFlight <= myFrameNumber; ++releasedFrees)
 		{
-			Debug::LogFatal("Ran out of render pass descriptor heap handles, need to increase heap size.");
+			const auto allocation = myPersistentAllocations.find(myPendingFrees[releasedFrees].HeapIndex);
+			myPersistentAllocator.Free(allocation->second);
+			myPersistentAllocations.erase(allocation);
 		}
 
-		D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = myDescriptorHeapCPUStart;
-		cpuHandle.ptr += newHandleID * myDescriptorSize;
-		D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle = myDescriptorHeapGPUStart;
-		gpuHandle.ptr += newHandleID * myDescriptorSize;
+		myPendingFrees.erase(myPendingFrees.begin(), myPendingFrees.begin() + releasedFrees);
+	}
+
+	DescriptorHeapBlock FrameDescriptorRing::AllocateBlock(std::uint_least8_t aFrameInFlight, std::uint32_t aCount)
+	{
+		Debug::Assert(aFrameInFlight < myFramesInFlight, "Frame in flight must be within the range specified upon creation.");
+
+		DescriptorHeapBlock block;
+		if (aCount == 0)
+			return block;
+
+		const std::uint32_t segmentOffset = mySegments[aFrameInFlight].Used.fetch_add(aCount, std::memory_order_relaxed);
+		if (segmentOffset + aCount > myDescriptorsPerFrame)
+		{
+			// The failed request stays counted, so later ones this frame fail as well and only the first is reported.
+			if (segmentOffset <= myDescriptorsPerFrame)
+				Debug::LogError("Frame descriptor ring is out of space for this frame. Requested %u descriptors, with %u of %u already in use.", aCount, segmentOffset, myDescriptorsPerFrame);
+
+			return block;
+		}
+
+		const std::uint32_t heapIndex = (myPersistentDescriptors * myFramesInFlight) + (aFrameInFlight * myDescriptorsPerFrame) + segmentOffset;
 
-		return CreateHeapHandle(cpuHandle, gpuHandle, newHandleID);
+		block.myCPUHandle = myDescriptorHeapCPUStart;
+		block.myCPUHandle.ptr += static_cast<SIZE_T>(heapIndex) * myDescriptorSize;
+		block.myGPUHandle = myDescriptorHeapGPUStart;
+		block.myGPUHandle.ptr += static_cast<UINT64>(heapIndex) * myDescriptorSize;
+		block.myDescriptorSize = myDescriptorSize;
+		block.myHeapIndex = heapIndex;
+		block.myCount = aCount;
+		return block;
 	}
-}
+}
\ No newline at end of file
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "Atrium_TlsfAllocator.hpp"
+
 #include "DX12_ComPtr.hpp"
 
 #include <d3d12.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace Atrium::DirectX12
@@ -82,15 +87,131 @@ namespace Atrium::DirectX12
 		std::uint32_t myActiveHandleCount;
 	};
 
-	class RenderPassDescriptorHeap : public DescriptorHeap
+	/**
+	 * @brief A contiguous range of descriptors handed out by a FrameDescriptorRing.
+	 *        Plain value type, valid until the frame it was allocated for is reused.
+	 */
+	class DescriptorHeapBlock
 	{
+		friend class FrameDescriptorRing;
 	public:
-		RenderPassDescriptorHeap(ComPtr<ID3D12Device> aDevice, D3D12_DESCRIPTOR_HEAP_TYPE aHeapType, std::uint32_t aNumDescriptors);
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle(unsigned int anIndex = 0) const;
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle(unsigned int anIndex = 0) const;
+		std::uint32_t GetHeapIndex() const { return myHeapIndex; }
+		std::uint32_t GetCount() const { return myCount; }
 
-		void Reset();
-		DescriptorHeapHandle GetHeapHandleBlock(std::uint32_t aCount);
+		bool IsValid() const { return myCPUHandle.ptr != 0; }
 
 	private:
-		std::uint32_t myCurrentDescriptorIndex;
+		D3D12_CPU_DESCRIPTOR_HANDLE myCPUHandle = { 0 };
+		D3D12_GPU_DESCRIPTOR_HANDLE myGPUHandle = { 0 };
+		std::uint32_t myDescriptorSize = 0;
+		std::uint32_t myHeapIndex = 0;
+		std::uint32_t myCount = 0;
+	};
+
+	/**
+	 * @brief Shader-visible heap split into one segment per frame in flight.
+	 *        Blocks are carved out of the current segment with an atomic bump,
+	 *        so any number of recording threads can allocate concurrently.
+	 *
+	 *        The front of the heap is reserved for persistent descriptors, which keep their index
+	 *        until freed and back the bindless resource tables.
+	 *        The persistent region has a copy per frame in flight, so a resource with a copy per frame,
+	 *        such as a constant buffer, can have each frame's descriptor under the same index.
+	 *        Freed persistent descriptors are only reused once every frame that could still read them has finished.
+	 */
+	class FrameDescriptorRing : public DescriptorHeap
+	{
+	public:
+		FrameDescriptorRing(ComPtr<ID3D12Device> aDevice, D3D12_DESCRIPTOR_HEAP_TYPE aHeapType, std::uint32_t aPersistentDescriptors, std::uint32_t aDescriptorsPerFrame, std::uint32_t aFramesInFlight);
+
+		/**
+		 * @brief Allocate a descriptor in the persistent region. Thread-safe.
+		 *        Its heap index is stable and is freed when the last handle copy is released.
+		 *        The handle refers to the first frame's copy of the region, write every copy with CopyPersistent().
+		 */
+		DescriptorHeapHandle AllocatePersistent();
+
+		/**
+		 * @brief Allocate contiguous descriptors in the persistent region, for descriptor tables that outlive a frame. Thread-safe.
+		 *        The block is freed when the last handle copy is released.
+		 * @return A handle to the first descriptor, or an invalid handle if the region has no contiguous space left.
+		 */
+		DescriptorHeapHandle AllocatePersistentBlock(std::uint32_t aCount);
+
+		/**
+		 * @brief Copy descriptors into every frame's copy of a persistent allocation.
+		 *        Only safe while no frame in flight can read the allocation yet, such as right after allocating it.
+		 */
+		void CopyPersistent(const DescriptorHeapHandle& aDestination, D3D12_CPU_DESCRIPTOR_HANDLE aSource, std::uint32_t aCount = 1);
+
+		/**
+		 * @brief Copy descriptors into one frame's copy of a persistent allocation.
+		 *        Only safe while the GPU is done with the frame's previous use, such as during the frame itself.
+		 */
+		void CopyPersistent(const DescriptorHeapHandle& aDestination, D3D12_CPU_DESCRIPTOR_HANDLE aSource, std::uint32_t aCount, std::uint_least8_t aFrameInFlight);
+
+		/**
+		 * @brief Make a frame segment available for reuse, along with persistent descriptors freed early enough that no frame in flight can read them.
+		 *        The GPU must be done with the segment's previous frame.
+		 */
+		void BeginFrame(std::uint_least8_t aFrameInFlight);
+
+		/**
+		 * @brief Allocate a block of descriptors for the given frame. Thread-safe.
+		 * @return The block, or an invalid block if the frame segment is exhausted. Once a request fails, the rest of the frame's requests fail too.
+		 */
+		DescriptorHeapBlock AllocateBlock(std::uint_least8_t aFrameInFlight, std::uint32_t aCount);
+
+		std::uint32_t GetPersistentDescriptors() const { return myPersistentDescriptors; }
+		D3D12_GPU_DESCRIPTOR_HANDLE GetPersistentGPUStart(std::uint_least8_t aFrameInFlight) const;
+		D3D12_CPU_DESCRIPTOR_HANDLE GetPersistentCPUHandle(std::uint32_t aHeapIndex, std::uint_least8_t aFrameInFlight) const;
+		D3D12_GPU_DESCRIPTOR_HANDLE GetPersistentGPUHandle(std::uint32_t aHeapIndex, std::uint_least8_t aFrameInFlight) const;
+
+		std::uint32_t GetDescriptorsPerFrame() const { return myDescriptorsPerFrame; }
+
+		/**
+		 * @brief Get the amount of descriptors requested by the most recently finished frame.
+		 *        May exceed the per-frame capacity if allocations failed.
+		 */
+		std::uint32_t GetLastFrameUsage() const { return myLastFrameUsage; }
+
+		/**
+		 * @brief Get the highest amount of descriptors requested in a single frame since creation.
+		 *        May exceed the per-frame capacity if allocations failed.
+		 */
+		std::uint32_t GetHighWaterMark() const { return myHighWaterMark; }
+
+	protected:
+		void FreeHeapHandle(std::uint32_t anIndex) override;
+
+	private:
+		struct alignas(64) FrameSegment
+		{
+			std::atomic<std::uint32_t> Used = 0;
+		};
+
+		struct PendingFree
+		{
+			std::uint32_t HeapIndex;
+			std::uint64_t FrameNumber;
+		};
+
+		ComPtr<ID3D12Device> myDevice;
+
+		std::unique_ptr<FrameSegment[]> mySegments;
+
+		std::mutex myPersistentMutex;
+		TlsfAllocator myPersistentAllocator;
+		std::unordered_map<std::uint32_t, TlsfAllocator::Allocation> myPersistentAllocations;
+		std::vector<PendingFree> myPendingFrees;
+		std::uint64_t myFrameNumber;
+		std::uint32_t myPersistentDescriptors;
+
+		std::uint32_t myDescriptorsPerFrame;
+		std::uint32_t myFramesInFlight;
+		std::uint32_t myLastFrameUsage;
+		std::uint32_t myHighWaterMark;
 	};
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ namespace Atrium::DirectX12
 		StagingDescriptorHeap& GetRTVHeap() { return myRTVHeap; }
 		StagingDescriptorHeap& GetDSVHeap() { return myDSVHeap; }
 
-		RenderPassDescriptorHeap& GetFrameHeap(std::uint_least8_t aFrameInFlight);
+		FrameDescriptorRing& GetFrameRing() { return myFrameRing; }
 
 	private:
 		StagingDescriptorHeap mySRVHeap;
@@ -29,6 +29,6 @@ namespace Atrium::DirectX12
 		StagingDescriptorHeap myRTVHeap;
 		StagingDescriptorHeap myDSVHeap;
 
-		std::vector<std::unique_ptr<RenderPassDescriptorHeap>> myFrameHeaps;
+		FrameDescriptorRing myFrameRing;
 	};
 }
\ No newline at end of file
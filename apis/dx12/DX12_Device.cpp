@@ -29,6 +29,7 @@ namespace Atrium::DirectX12
 		SetupAllocator();
 		SetupInfoQueue();
 		SetupHeapManager();
+		SetupCommandSignatures();
 	}
 
 	Device::~Device()
@@ -286,4 +287,36 @@ namespace Atrium::DirectX12
 		myDescriptorHeapManager.reset(new DescriptorHeapManager(myDevice, DX12_FRAMES_IN_FLIGHT));
 		return myDescriptorHeapManager.get() != nullptr;
 	}
+
+	bool Device::SetupCommandSignatures()
+	{
+		PROFILE_SCOPE();
+
+		// Argument records have no root parameter changes, so the signatures don't need a root signature.
+		D3D12_INDIRECT_ARGUMENT_DESC drawIndexedArgument = { };
+		drawIndexedArgument.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW_INDEXED;
+
+		D3D12_COMMAND_SIGNATURE_DESC drawIndexedDesc = { };
+		drawIndexedDesc.ByteStride = sizeof(D3D12_DRAW_INDEXED_ARGUMENTS);
+		drawIndexedDesc.NumArgumentDescs = 1;
+		drawIndexedDesc.pArgumentDescs = &drawIndexedArgument;
+
+		if (!Debug::Verify(
+			myDevice->CreateCommandSignature(&drawIndexedDesc, nullptr, IID_PPV_ARGS(myDrawIndexedSignature.ReleaseAndGetAddressOf())),
+			"Create draw indexed command signature"))
+			return false;
+
+		D3D12_INDIRECT_ARGUMENT_DESC dispatchArgument = { };
+		dispatchArgument.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+
+		D3D12_COMMAND_SIGNATURE_DESC dispatchDesc = { };
+		dispatchDesc.ByteStride = sizeof(D3D12_DISPATCH_ARGUMENTS);
+		dispatchDesc.NumArgumentDescs = 1;
+		dispatchDesc.pArgumentDescs = &dispatchArgument;
+
+		return Debug::Verify(
+			myDevice->CreateCommandSignature(&dispatchDesc, nullptr, IID_PPV_ARGS(myDispatchSignature.ReleaseAndGetAddressOf())),
+			"Create dispatch command signature"
+		);
+	}
 }
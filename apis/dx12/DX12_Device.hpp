@@ -41,6 +41,9 @@ namespace Atrium::DirectX12
 		ComPtr<IDXGIFactory4> GetFactory() { return myDXGIFactory; }
 		DescriptorHeapManager& GetDescriptorHeapManager() { return *myDescriptorHeapManager; }
 
+		ID3D12CommandSignature* GetDispatchSignature() const { return myDispatchSignature.Get(); }
+		ID3D12CommandSignature* GetDrawIndexedSignature() const { return myDrawIndexedSignature.Get(); }
+
 	private:
 	#ifndef NDEBUG
 		void SetupDebug(UINT& someDXGIFlagsOut);
@@ -52,6 +55,7 @@ namespace Atrium::DirectX12
 		bool SetupInfoQueue();
 		bool FindMaximumFeatureLevel();
 		bool SetupHeapManager();
+		bool SetupCommandSignatures();
 
 	private:
 		ComPtr<IDXGIFactory4> myDXGIFactory;
@@ -61,6 +65,9 @@ namespace Atrium::DirectX12
 		ComPtr<ID3D12InfoQueue> myInfoQueue;
 		std::unique_ptr<DescriptorHeapManager> myDescriptorHeapManager;
 
+		ComPtr<ID3D12CommandSignature> myDispatchSignature;
+		ComPtr<ID3D12CommandSignature> myDrawIndexedSignature;
+
 		DeviceParameters myParameters;
 		D3D_FEATURE_LEVEL myFeatureLevel;
 	};
@@ -245,6 +245,53 @@ namespace Atrium::DirectX12
 		}
 	}
 
+	D3D12_RESOURCE_STATES ToD3DResourceState(const ResourceState& aState)
+	{
+		switch (aState)
+		{
+			case ResourceState::RenderTarget:
+				return D3D12_RESOURCE_STATE_RENDER_TARGET;
+			case ResourceState::DepthWrite:
+				return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+			case ResourceState::DepthRead:
+				return D3D12_RESOURCE_STATE_DEPTH_READ;
+			case ResourceState::ShaderResource:
+				return D3D12_RESOURCE_STATE_ALL_SHADER_RESOURCE;
+			case ResourceState::UnorderedAccess:
+				return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+			case ResourceState::CopySource:
+				return D3D12_RESOURCE_STATE_COPY_SOURCE;
+			case ResourceState::CopyDestination:
+				return D3D12_RESOURCE_STATE_COPY_DEST;
+			case ResourceState::IndirectArgument:
+				return D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+			case ResourceState::Present:
+				return D3D12_RESOURCE_STATE_PRESENT;
+			case ResourceState::Common:
+			default:
+				return D3D12_RESOURCE_STATE_COMMON;
+		}
+	}
+
+	D3D12_PRIMITIVE_TOPOLOGY ToD3DPrimitiveTopology(const PrimitiveTopology& aTopology)
+	{
+		switch (aTopology)
+		{
+			case PrimitiveTopology::PointList:
+				return D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
+			case PrimitiveTopology::LineList:
+				return D3D_PRIMITIVE_TOPOLOGY_LINELIST;
+			case PrimitiveTopology::LineStrip:
+				return D3D_PRIMITIVE_TOPOLOGY_LINESTRIP;
+			case PrimitiveTopology::TriangleList:
+				return D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+			case PrimitiveTopology::TriangleStrip:
+				return D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+			default:
+				return D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		}
+	}
+
 	TextureFormat ToTextureFormat(const DXGI_FORMAT& aFormat)
 	{
 		switch (aFormat)
@@ -13,6 +13,8 @@ namespace Atrium::DirectX12
 	D3D12_RESOURCE_DIMENSION ToD3DTextureDimension(const TextureDimension& aDimension);
 	D3D12_RTV_DIMENSION ToRTVTextureDimension(const TextureDimension& aDimension);
 	D3D12_DSV_DIMENSION ToDSVTextureDimension(const TextureDimension& aDimension);
+	D3D12_RESOURCE_STATES ToD3DResourceState(const ResourceState& aState);
+	D3D12_PRIMITIVE_TOPOLOGY ToD3DPrimitiveTopology(const PrimitiveTopology& aTopology);
 
 	TextureFormat ToTextureFormat(const DXGI_FORMAT& aFormat);
 }
\ No newline at end of file
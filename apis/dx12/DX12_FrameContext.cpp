@@ -3,26 +3,35 @@
 #include "DX12_Texture.hpp"
 #include "DX12_Device.hpp"
 #include "DX12_Diagnostics.hpp"
+#include "DX12_Enums.hpp"
 #include "DX12_FrameContext.hpp"
 #include "DX12_Manager.hpp"
 #include "DX12_MemoryAlignment.hpp"
 #include "DX12_RenderTexture.hpp"
 
+#include <algorithm>
+
 namespace Atrium::DirectX12
 {
+	static_assert(sizeof(Atrium::FrameGraphicsContext::DrawIndexedArguments) == sizeof(D3D12_DRAW_INDEXED_ARGUMENTS), "Indirect draw records must match the D3D12 layout.");
+	static_assert(sizeof(Atrium::FrameGraphicsContext::DispatchArguments) == sizeof(D3D12_DISPATCH_ARGUMENTS), "Indirect dispatch records must match the D3D12 layout.");
+	static_assert(ResourceStateTracker<GPUResource, D3D12_RESOURCE_STATES>::AllSubresources == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, "Whole-resource transitions must match the D3D12 value.");
+
 	FrameContext::FrameContext(Device& aDevice, CommandQueue& aCommandQueue)
 		: myDevice(aDevice)
 		, myCommandType(aCommandQueue.GetQueueType())
-		, myCurrentFrameHeap(nullptr)
-		, myResourceBarrierQueue()
+		, myFrameRing(aDevice.GetDescriptorHeapManager().GetFrameRing())
+		, myFrameInFlight(0)
+		, myStateTracker(D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
+		, myHasGraphicsQueueBarriers(false)
 	#ifdef TRACY_ENABLE
 		, myProfilingContext(aCommandQueue.GetProfilingContext())
 	#endif
 	{
 		PROFILE_SCOPE();
-		myFrameCommandAllocators.resize(DX12_FRAMES_IN_FLIGHT);
+		myFrameCommandAllocators.resize(DirectX12API::GetFramesInFlightAmount());
 
-		for (unsigned int i = 0; i < DX12_FRAMES_IN_FLIGHT; ++i)
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
 		{
 			Debug::Assert(
 				aDevice.GetDevice()->CreateCommandAllocator(
@@ -50,52 +59,215 @@ namespace Atrium::DirectX12
 		);
 
 		myCommandList->SetName(L"Frame context command list");
+
+		// Initial transitions are only known at submission, so they go in a separate list submitted ahead of the context's.
+		myFrameInitialBarrierAllocators.resize(DirectX12API::GetFramesInFlightAmount());
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+		{
+			Debug::Assert(
+				aDevice.GetDevice()->CreateCommandAllocator(
+					myCommandType,
+					IID_PPV_ARGS(myFrameInitialBarrierAllocators[i].ReleaseAndGetAddressOf())
+				),
+				"Create initial barrier command allocator."
+			);
+
+			myFrameInitialBarrierAllocators[i]->SetName(L"Frame context initial barrier allocator");
+		}
+
+		Debug::Assert(
+			device4->CreateCommandList1(
+				0,
+				myCommandType,
+				D3D12_COMMAND_LIST_FLAG_NONE,
+				IID_PPV_ARGS(myInitialBarrierCommandList.ReleaseAndGetAddressOf())
+			),
+			"Create closed initial barrier command list."
+		);
+
+		myInitialBarrierCommandList->SetName(L"Frame context initial barrier command list");
+
+		if (myCommandType != D3D12_COMMAND_LIST_TYPE_COMPUTE)
+			return;
+
+		myFrameGraphicsQueueBarrierAllocators.resize(DirectX12API::GetFramesInFlightAmount());
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+		{
+			Debug::Assert(
+				aDevice.GetDevice()->CreateCommandAllocator(
+					D3D12_COMMAND_LIST_TYPE_DIRECT,
+					IID_PPV_ARGS(myFrameGraphicsQueueBarrierAllocators[i].ReleaseAndGetAddressOf())
+				),
+				"Create graphics queue barrier command allocator."
+			);
+
+			myFrameGraphicsQueueBarrierAllocators[i]->SetName(L"Frame context graphics queue barrier allocator");
+		}
+
+		Debug::Assert(
+			device4->CreateCommandList1(
+				0,
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				D3D12_COMMAND_LIST_FLAG_NONE,
+				IID_PPV_ARGS(myGraphicsQueueBarrierCommandList.ReleaseAndGetAddressOf())
+			),
+			"Create closed graphics queue barrier command list."
+		);
+
+		myGraphicsQueueBarrierCommandList->SetName(L"Frame context graphics queue barrier command list");
 	}
 
 	void FrameContext::Reset(const std::uint_least8_t& aFrameInFlight)
 	{
 		myFrameCommandAllocators[aFrameInFlight]->Reset();
+		myFrameInitialBarrierAllocators[aFrameInFlight]->Reset();
+		if (myCommandType == D3D12_COMMAND_LIST_TYPE_COMPUTE)
+			myFrameGraphicsQueueBarrierAllocators[aFrameInFlight]->Reset();
+		myHasGraphicsQueueBarriers = false;
 		myCommandList->Reset(myFrameCommandAllocators[aFrameInFlight].Get(), nullptr);
 
-		DescriptorHeapManager& heapManager = myDevice.GetDescriptorHeapManager();
-		myCurrentFrameHeap = &heapManager.GetFrameHeap(aFrameInFlight);
-		myCurrentFrameHeap->Reset();
+		// The frame ring itself is shared between contexts, and is recycled by the API at frame start.
+		myFrameInFlight = aFrameInFlight;
+
+		Debug::Assert(myBegunSplitBarriers.empty(), "All split barriers were ended last frame.");
+		myBegunSplitBarriers.clear();
+
+		myStateTracker.Reset();
+		myQueuedBarriers.clear();
 
 		if (myCommandType != D3D12_COMMAND_LIST_TYPE_COPY)
 			BindDescriptorHeaps();
 	}
 
-	void FrameContext::AddBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState)
+	void FrameContext::AddBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState, std::uint32_t aSubresource)
 	{
-		if (myQueuedBarriers >= ourMaxQueuedBarriers)
-			FlushBarriers();
+		myTransitions.clear();
+		myStateTracker.Require(aResource, aResource.GetSubresourceCount(), aSubresource, aNewState, myTransitions);
 
 		if (myCommandType == D3D12_COMMAND_LIST_TYPE_COMPUTE)
 		{
-			constexpr D3D12_RESOURCE_STATES VALID_COMPUTE_CONTEXT_STATES = (D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
-				D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_COPY_SOURCE);
+			Debug::Assert((aNewState & ComputeQueueStates) == aNewState, "Target state is valid for compute contexts.");
+			for (const StateTracker::Transition& transition : myTransitions)
+				Debug::Assert((transition.Before & ComputeQueueStates) == transition.Before, "Current state is valid for compute contexts.");
+		}
+
+		QueueTransitions(D3D12_RESOURCE_BARRIER_FLAG_NONE);
+	}
 
-			const D3D12_RESOURCE_STATES oldState = aResource.GetUsageState();
-			Debug::Assert((oldState & VALID_COMPUTE_CONTEXT_STATES) == oldState, "Current state is valid for compute contexts.");
-			Debug::Assert((aNewState & VALID_COMPUTE_CONTEXT_STATES) == aNewState, "Target state is valid for compute contexts.");
+	void FrameContext::BeginSplitBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState, std::uint32_t aSubresource)
+	{
+		myTransitions.clear();
+		myStateTracker.Require(aResource, aResource.GetSubresourceCount(), aSubresource, aNewState, myTransitions);
+
+		const std::size_t firstBarrier = myQueuedBarriers.size();
+		QueueTransitions(D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+
+		std::vector<D3D12_RESOURCE_BARRIER>& begunBarriers = myBegunSplitBarriers[aResource.GetResource().Get()];
+		for (std::size_t i = firstBarrier; i < myQueuedBarriers.size(); ++i)
+		{
+			// UAV barriers can't be split, they only order accesses.
+			if (myQueuedBarriers[i].Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+				begunBarriers.push_back(myQueuedBarriers[i]);
 		}
 
-		std::optional<D3D12_RESOURCE_BARRIER> barrier = aResource.UpdateUsageState(aNewState);
-		if (barrier.has_value())
+		if (begunBarriers.empty())
+			myBegunSplitBarriers.erase(aResource.GetResource().Get());
+	}
+
+	void FrameContext::EndSplitBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState)
+	{
+		// Without a begun barrier the resource was already in the state when the split began,
+		// or it's the resource's first use in the context and the transition is deferred to submission.
+		// Either way the tracked state is already the new one.
+		const auto begunBarriers = myBegunSplitBarriers.find(aResource.GetResource().Get());
+		if (begunBarriers == myBegunSplitBarriers.end())
+			return;
+
+		for (D3D12_RESOURCE_BARRIER barrier : begunBarriers->second)
 		{
-			myResourceBarrierQueue.at(myQueuedBarriers) = barrier.value();
-			myQueuedBarriers++;
+			Debug::Assert(barrier.Transition.StateAfter == aNewState, "Split barrier ends with the state it began with.");
+
+			barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+			myQueuedBarriers.push_back(barrier);
 		}
+
+		myBegunSplitBarriers.erase(begunBarriers);
 	}
 
 	void FrameContext::FlushBarriers()
 	{
-		if (myQueuedBarriers == 0)
+		if (myQueuedBarriers.empty())
 			return;
 
 		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Flush resource barriers");
-		myCommandList->ResourceBarrier(static_cast<UINT>(myQueuedBarriers), myResourceBarrierQueue.data());
-		myQueuedBarriers = 0;
+		myCommandList->ResourceBarrier(static_cast<UINT>(myQueuedBarriers.size()), myQueuedBarriers.data());
+		myQueuedBarriers.clear();
+	}
+
+	bool FrameContext::RecordInitialBarriers()
+	{
+		myTransitions.clear();
+		myStateTracker.Resolve([](GPUResource& aResource) { return aResource.GetSubresourceStates(); }, myTransitions);
+
+		myHasGraphicsQueueBarriers = false;
+		if (myCommandType == D3D12_COMMAND_LIST_TYPE_COMPUTE)
+		{
+			// A resource last used by graphics work, such as a render target, is transitioned by the graphics queue.
+			const auto graphicsQueueTransitions = std::stable_partition(myTransitions.begin(), myTransitions.end(), [](const StateTracker::Transition& aTransition) {
+				return ((aTransition.Before | aTransition.After) & ~ComputeQueueStates) == 0;
+			});
+
+			if (graphicsQueueTransitions != myTransitions.end())
+			{
+				std::vector<StateTracker::Transition> computeQueueTransitions(myTransitions.begin(), graphicsQueueTransitions);
+				myTransitions.erase(myTransitions.begin(), graphicsQueueTransitions);
+
+				myGraphicsQueueBarrierCommandList->Reset(myFrameGraphicsQueueBarrierAllocators[myFrameInFlight].Get(), nullptr);
+
+				const std::size_t firstBarrier = myQueuedBarriers.size();
+				QueueTransitions(D3D12_RESOURCE_BARRIER_FLAG_NONE);
+				myGraphicsQueueBarrierCommandList->ResourceBarrier(static_cast<UINT>(myQueuedBarriers.size() - firstBarrier), myQueuedBarriers.data() + firstBarrier);
+				myQueuedBarriers.resize(firstBarrier);
+
+				myTransitions = std::move(computeQueueTransitions);
+				myHasGraphicsQueueBarriers = true;
+			}
+		}
+
+		if (myTransitions.empty())
+			return false;
+
+		myInitialBarrierCommandList->Reset(myFrameInitialBarrierAllocators[myFrameInFlight].Get(), nullptr);
+
+		const std::size_t firstBarrier = myQueuedBarriers.size();
+		QueueTransitions(D3D12_RESOURCE_BARRIER_FLAG_NONE);
+		myInitialBarrierCommandList->ResourceBarrier(static_cast<UINT>(myQueuedBarriers.size() - firstBarrier), myQueuedBarriers.data() + firstBarrier);
+		myQueuedBarriers.resize(firstBarrier);
+
+		return true;
+	}
+
+	void FrameContext::QueueTransitions(D3D12_RESOURCE_BARRIER_FLAGS someFlags)
+	{
+		for (const StateTracker::Transition& transition : myTransitions)
+		{
+			D3D12_RESOURCE_BARRIER& barrier = myQueuedBarriers.emplace_back();
+
+			if (transition.Before == transition.After)
+			{
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+				barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+				barrier.UAV.pResource = transition.Resource->GetResource().Get();
+				continue;
+			}
+
+			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			barrier.Flags = someFlags;
+			barrier.Transition.pResource = transition.Resource->GetResource().Get();
+			barrier.Transition.Subresource = transition.Subresource;
+			barrier.Transition.StateBefore = transition.Before;
+			barrier.Transition.StateAfter = transition.After;
+		}
 	}
 
 	void FrameContext::CopyResource(const GPUResource& aSource, GPUResource& aDestination)
@@ -136,13 +308,33 @@ namespace Atrium::DirectX12
 		}
 	}
 
+	void FrameContext::CopyTextureRegion(GPUResource& aSource, std::size_t aSourceOffset, std::span<const TextureRegionLayout> someRegions, GPUResource& aDestination)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Copy texture regions");
+		for (const TextureRegionLayout& region : someRegions)
+		{
+			D3D12_TEXTURE_COPY_LOCATION destinationLocation = {};
+			destinationLocation.pResource = aDestination.GetResource().Get();
+			destinationLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+			destinationLocation.SubresourceIndex = region.Subresource;
+
+			D3D12_TEXTURE_COPY_LOCATION sourceLocation = {};
+			sourceLocation.pResource = aSource.GetResource().Get();
+			sourceLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+			sourceLocation.PlacedFootprint = region.Layout;
+			sourceLocation.PlacedFootprint.Offset += aSourceOffset;
+
+			myCommandList->CopyTextureRegion(&destinationLocation, region.X, region.Y, region.Z, &sourceLocation, nullptr);
+		}
+	}
+
 	void FrameContext::BindDescriptorHeaps()
 	{
 		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Bind descriptor heaps");
 
 		ID3D12DescriptorHeap* heapsToBind[] =
 		{
-			myCurrentFrameHeap->GetHeap().Get()
+			myFrameRing.GetHeap().Get()
 			//, heapManager.GetFrameSamplerHeap().GetHeap().Get()
 		};
 
@@ -152,22 +344,64 @@ namespace Atrium::DirectX12
 	UploadContext::UploadContext(Device& aDevice, CommandQueue& aCommandQueue)
 		: FrameContext(aDevice, aCommandQueue)
 	{
-		for (unsigned int i = 0; i < DX12_FRAMES_IN_FLIGHT; ++i)
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
 			myFrameCommandAllocators[i]->SetName(L"Upload context command allocator");
 
 		myCommandList->SetName(L"Upload context command list");
 
-		Debug::Assert(aCommandQueue.GetQueueType() == D3D12_COMMAND_LIST_TYPE_COPY, "Using copy queue.");
+		Debug::Assert(aCommandQueue.GetQueueType() == D3D12_COMMAND_LIST_TYPE_DIRECT, "Using graphics queue.");
 
-		myBufferUploadHeap.reset(new BackendGraphicsBuffer(aDevice, GraphicsBuffer::Target::None, 1, 10 * 1024 * 1024));
-		myTextureUploadHeap.reset(new BackendGraphicsBuffer(aDevice, GraphicsBuffer::Target::None, 1, 40 * 1024 * 1024));
-		myBufferUploadHeap->Map();
-		myTextureUploadHeap->Map();
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+		{
+			myBufferUploadHeaps.emplace_back(new BackendGraphicsBuffer(aDevice, GraphicsBuffer::Target::None, 1, static_cast<std::uint32_t>(BufferUploadHeapSize)))->Map();
+			myTextureUploadHeaps.emplace_back(new BackendGraphicsBuffer(aDevice, GraphicsBuffer::Target::None, 1, static_cast<std::uint32_t>(TextureUploadHeapSize)))->Map();
+		}
 	}
 
 	UploadContext::~UploadContext()
 	{
-		myBufferUploadHeap->Unmap();
+		for (std::unique_ptr<BackendGraphicsBuffer>& heap : myBufferUploadHeaps)
+			heap->Unmap();
+		for (std::unique_ptr<BackendGraphicsBuffer>& heap : myTextureUploadHeaps)
+			heap->Unmap();
+	}
+
+	void UploadContext::AddBufferUpload(const std::shared_ptr<GPUResource>& aResource, const void* aDataPtr, std::size_t aDataSize, std::size_t aDestinationOffset)
+	{
+		Debug::Assert(aDataSize <= BufferUploadHeapSize, "A single upload has to fit in the upload heap.");
+
+		// Only the latest upload to the resource can take the write, as merging into an earlier one would reorder it before the writes queued since.
+		const auto previousUpload = std::find_if(myBufferUploads.rbegin(), myBufferUploads.rend(), [&](const BufferUpload& anUpload) { return anUpload.Resource == aResource; });
+		if (previousUpload != myBufferUploads.rend())
+		{
+			const std::size_t previousEnd = previousUpload->DestinationOffset + previousUpload->BufferSize;
+			const std::size_t mergedStart = (std::min)(previousUpload->DestinationOffset, aDestinationOffset);
+			const std::size_t mergedEnd = (std::max)(previousEnd, aDestinationOffset + aDataSize);
+
+			const bool isAdjacent = aDestinationOffset <= previousEnd && previousUpload->DestinationOffset <= aDestinationOffset + aDataSize;
+			if (isAdjacent && (mergedEnd - mergedStart) <= BufferUploadHeapSize)
+			{
+				if (mergedStart != previousUpload->DestinationOffset || mergedEnd != previousEnd)
+				{
+					std::unique_ptr<std::uint8_t[]> mergedData(new std::uint8_t[mergedEnd - mergedStart]);
+					std::memcpy(mergedData.get() + (previousUpload->DestinationOffset - mergedStart), previousUpload->BufferData.get(), previousUpload->BufferSize);
+
+					previousUpload->BufferData = std::move(mergedData);
+					previousUpload->BufferSize = mergedEnd - mergedStart;
+					previousUpload->DestinationOffset = mergedStart;
+				}
+
+				std::memcpy(previousUpload->BufferData.get() + (aDestinationOffset - mergedStart), aDataPtr, aDataSize);
+				return;
+			}
+		}
+
+		BufferUpload& upload = myBufferUploads.emplace_back();
+		upload.Resource = aResource;
+		upload.BufferData.reset(new std::uint8_t[aDataSize]);
+		upload.BufferSize = aDataSize;
+		upload.DestinationOffset = aDestinationOffset;
+		std::memcpy(upload.BufferData.get(), aDataPtr, aDataSize);
 	}
 
 	UploadContext::TextureUpload& UploadContext::AddTextureUpload()
@@ -175,52 +409,83 @@ namespace Atrium::DirectX12
 		return myTextureUploads.emplace_back();
 	}
 
-	void UploadContext::ProcessUploads()
+	bool UploadContext::ProcessUploads()
 	{
-		const uint32_t numBufferUploads = static_cast<uint32_t>(myBufferUploads.size());
-		const uint32_t numTextureUploads = static_cast<uint32_t>(myTextureUploads.size());
-		uint32_t numBuffersProcessed = 0;
-		uint32_t numTexturesProcessed = 0;
-		size_t bufferUploadHeapOffset = 0;
-		size_t textureUploadHeapOffset = 0;
+		BackendGraphicsBuffer& bufferUploadHeap = *myBufferUploadHeaps[myFrameInFlight];
+		BackendGraphicsBuffer& textureUploadHeap = *myTextureUploadHeaps[myFrameInFlight];
 
-		for (numBuffersProcessed; numBuffersProcessed < numBufferUploads; numBuffersProcessed++)
+		// Find the uploads that fit in this frame's heaps first, so all their transitions can be flushed together.
+		std::vector<std::size_t> bufferUploadHeapOffsets;
+		std::vector<std::size_t> textureUploadHeapOffsets;
 		{
-			BufferUpload& currentUpload = myBufferUploads[numBuffersProcessed];
+			std::size_t bufferUploadHeapOffset = 0;
+			for (const BufferUpload& currentUpload : myBufferUploads)
+			{
+				if ((bufferUploadHeapOffset + currentUpload.BufferSize) > bufferUploadHeap.GetStride())
+					break;
+
+				bufferUploadHeapOffsets.push_back(bufferUploadHeapOffset);
+				bufferUploadHeapOffset += currentUpload.BufferSize;
+			}
+
+			std::size_t textureUploadHeapOffset = 0;
+			for (const TextureUpload& currentUpload : myTextureUploads)
+			{
+				if ((textureUploadHeapOffset + currentUpload.BufferSize) > textureUploadHeap.GetStride())
+					break;
+
+				textureUploadHeapOffsets.push_back(textureUploadHeapOffset);
+				textureUploadHeapOffset += currentUpload.BufferSize;
+				textureUploadHeapOffset = Align<std::size_t>(textureUploadHeapOffset, 512);
+			}
+		}
 
-			if ((bufferUploadHeapOffset + currentUpload.BufferSize) > myBufferUploadHeap->GetStride())
-				break;
+		const std::size_t numBuffersProcessed = bufferUploadHeapOffsets.size();
+		const std::size_t numTexturesProcessed = textureUploadHeapOffsets.size();
+		if (numBuffersProcessed == 0 && numTexturesProcessed == 0)
+			return false;
 
-			myBufferUploadHeap->SetData(currentUpload.BufferData.get(), static_cast<std::uint32_t>(currentUpload.BufferSize), static_cast<std::uint32_t>(bufferUploadHeapOffset));
+		// The barriers into the copy state wait for earlier frames' reads on this queue to finish.
+		for (std::size_t i = 0; i < numBuffersProcessed; ++i)
+			AddBarrier(*myBufferUploads[i].Resource, D3D12_RESOURCE_STATE_COPY_DEST);
+		for (std::size_t i = 0; i < numTexturesProcessed; ++i)
+			AddBarrier(*myTextureUploads[i].Resource, D3D12_RESOURCE_STATE_COPY_DEST);
+		FlushBarriers();
+
+		for (std::size_t i = 0; i < numBuffersProcessed; ++i)
+		{
+			BufferUpload& currentUpload = myBufferUploads[i];
+
+			bufferUploadHeap.SetData(currentUpload.BufferData.get(), static_cast<std::uint32_t>(currentUpload.BufferSize), bufferUploadHeapOffsets[i]);
 			TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Buffer upload");
-			CopyBufferRegion(*currentUpload.Resource, 0, *myBufferUploadHeap->GetResource(), bufferUploadHeapOffset, currentUpload.BufferSize);
+			CopyBufferRegion(*bufferUploadHeap.GetResource(), bufferUploadHeapOffsets[i], *currentUpload.Resource, currentUpload.DestinationOffset, currentUpload.BufferSize);
 
-			bufferUploadHeapOffset += currentUpload.BufferSize;
+			AddBarrier(*currentUpload.Resource, D3D12_RESOURCE_STATE_GENERIC_READ);
 			myBufferUploadsInProgress.push_back(currentUpload.Resource);
 		}
 
-		for (numTexturesProcessed; numTexturesProcessed < numTextureUploads; numTexturesProcessed++)
+		for (std::size_t i = 0; i < numTexturesProcessed; ++i)
 		{
-			TextureUpload& currentUpload = myTextureUploads[numTexturesProcessed];
+			TextureUpload& currentUpload = myTextureUploads[i];
 
-			if ((textureUploadHeapOffset + currentUpload.BufferSize) > myTextureUploadHeap->GetStride())
-				break;
-
-			myTextureUploadHeap->SetData(currentUpload.BufferData.get(), static_cast<std::uint32_t>(currentUpload.BufferSize), static_cast<std::uint32_t>(textureUploadHeapOffset));
+			textureUploadHeap.SetData(currentUpload.BufferData.get(), static_cast<std::uint32_t>(currentUpload.BufferSize), textureUploadHeapOffsets[i]);
 			TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Texture upload");
-			CopyTextureRegion(*myTextureUploadHeap->GetResource(), textureUploadHeapOffset, currentUpload.SubresourceLayouts, currentUpload.SubresourceCount, *currentUpload.Resource);
-
-			textureUploadHeapOffset += currentUpload.BufferSize;
-			textureUploadHeapOffset = Align<std::size_t>(textureUploadHeapOffset, 512);
+			if (currentUpload.Regions.empty())
+				CopyTextureRegion(*textureUploadHeap.GetResource(), textureUploadHeapOffsets[i], currentUpload.SubresourceLayouts, currentUpload.SubresourceCount, *currentUpload.Resource);
+			else
+				CopyTextureRegion(*textureUploadHeap.GetResource(), textureUploadHeapOffsets[i], currentUpload.Regions, *currentUpload.Resource);
 
+			// Textures are sampled through descriptors without being transitioned, so they're left readable by any shader stage.
+			AddBarrier(*currentUpload.Resource, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
 			myTextureUploadsInProgress.push_back(currentUpload.Resource);
 		}
 
-		if (numBuffersProcessed > 0)
-			myBufferUploads.erase(myBufferUploads.begin(), myBufferUploads.begin() + numBuffersProcessed);
+		FlushBarriers();
+
+		myBufferUploads.erase(myBufferUploads.begin(), myBufferUploads.begin() + numBuffersProcessed);
+		myTextureUploads.erase(myTextureUploads.begin(), myTextureUploads.begin() + numTexturesProcessed);
 
-		if (numTexturesProcessed > 0)
-			myTextureUploads.erase(myTextureUploads.begin(), myTextureUploads.begin() + numTexturesProcessed);
+		return true;
 	}
 
 	void UploadContext::ResolveUploads()
@@ -229,19 +494,43 @@ namespace Atrium::DirectX12
 		myTextureUploadsInProgress.clear();
 	}
 
-	FrameGraphicsContext::FrameGraphicsContext(Device& aDevice, CommandQueue& aCommandQueue)
+	PipelineFrameContext::PipelineFrameContext(Device& aDevice, CommandQueue& aCommandQueue)
 		: DirectX12::FrameContext(aDevice, aCommandQueue)
 		, myCurrentPipelineState(nullptr)
 	{
-		if (aCommandQueue.GetQueueType() != D3D12_COMMAND_LIST_TYPE_DIRECT)
-			throw std::domain_error("Graphics frame context requires a command queue with type Direct.");
+	}
 
-		for (unsigned int i = 0; i < DX12_FRAMES_IN_FLIGHT; ++i)
-			myFrameCommandAllocators[i]->SetName(L"Frame graphics command allocator");
-		myCommandList->SetName(L"Frame graphics command list");
+	void PipelineFrameContext::Reset(const std::uint_least8_t& aFrameInFlight)
+	{
+		DirectX12::FrameContext::Reset(aFrameInFlight);
+
+		myBufferHeapHandles.clear();
+		myTextureHeapHandles.clear();
+
+		myPendingBufferResources.clear();
+		myPendingTextureResources.clear();
+		myUnorderedAccessBuffers.clear();
 	}
 
-	void FrameGraphicsContext::BeginProfileZone(ProfileContextZone& aZoneScope
+	void PipelineFrameContext::AddDependency(const PipelineFrameContext& aContext)
+	{
+		// Checked once here, as contexts in a cycle can't be ordered when they're submitted every frame.
+		if (!Debug::Verify(!aContext.DependsOn(*this), "Context dependencies don't form a cycle."))
+			return;
+
+		if (std::find(myDependencies.begin(), myDependencies.end(), &aContext) == myDependencies.end())
+			myDependencies.push_back(&aContext);
+	}
+
+	bool PipelineFrameContext::DependsOn(const PipelineFrameContext& aContext) const
+	{
+		if (&aContext == this)
+			return true;
+
+		return std::any_of(myDependencies.begin(), myDependencies.end(), [&](const PipelineFrameContext* aDependency) { return aDependency->DependsOn(aContext); });
+	}
+
+	void PipelineFrameContext::RecordProfileZone(Atrium::FrameGraphicsContext::ProfileContextZone& aZoneScope
 	#ifdef TRACY_ENABLE
 		, const tracy::SourceLocationData& aLocation
 	#endif
@@ -250,7 +539,7 @@ namespace Atrium::DirectX12
 		std::memset(aZoneScope.Data, 0, sizeof(aZoneScope.Data));
 
 	#ifdef TRACY_ENABLE
-		static_assert(sizeof(ProfileContextZone::Data) >= sizeof(tracy::D3D12ZoneScope));
+		static_assert(sizeof(Atrium::FrameGraphicsContext::ProfileContextZone::Data) >= sizeof(tracy::D3D12ZoneScope));
 
 		std::construct_at(
 			reinterpret_cast<tracy::D3D12ZoneScope*>(&aZoneScope.Data[0]),
@@ -260,228 +549,103 @@ namespace Atrium::DirectX12
 			true
 		);
 
-		aZoneScope.Destructor = [](ProfileContextZone& aZone) {
+		aZoneScope.Destructor = [](Atrium::FrameGraphicsContext::ProfileContextZone& aZone) {
 			tracy::D3D12ZoneScope* scope = reinterpret_cast<tracy::D3D12ZoneScope*>(&aZone.Data[0]);
 			scope->~D3D12ZoneScope();
 			};
 	#endif
 	}
 
-	void FrameGraphicsContext::Reset(const std::uint_least8_t& aFrameInFlight)
+	void PipelineFrameContext::RecordDispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ)
 	{
-		DirectX12::FrameContext::Reset(aFrameInFlight);
-
-		myBufferHeapHandles.clear();
-		myTextureHeapHandles.clear();
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch");
+		if (!FlushPipelineResources())
+			return;
 
-		myPendingBufferResources.clear();
-		myPendingTextureResources.clear();
+		myCommandList->Dispatch(aGroupCountX, aGroupCountY, aGroupCountZ);
 	}
 
-	void FrameGraphicsContext::ClearColor(const std::shared_ptr<Atrium::RenderTexture>& aTarget, ColorARGB<float> aClearColor)
+	void PipelineFrameContext::RecordDispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset)
 	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Clear color");
-		Debug::Assert(!!aTarget, "ClearColor() requires a target.");
-
-		RenderTarget& target = static_cast<RenderTarget&>(*aTarget);
-		AddBarrier(*target.GetGPUResource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-		FlushBarriers();
-
-		D3D12_CPU_DESCRIPTOR_HANDLE handle = target.GetColorView().GetCPUHandle();
+		Debug::Assert(!!anArgumentBuffer, "Assumes a valid argument buffer.");
 
-		if (!Debug::Verify(handle.ptr != NULL, "Invalid target."))
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch indirect");
+		if (!FlushPipelineResources())
 			return;
 
-		float color[4] = {
-			aClearColor.R,
-			aClearColor.G,
-			aClearColor.B,
-			aClearColor.A
-		};
-		myCommandList->ClearRenderTargetView(
-			handle,
-			color,
-			0,
-			nullptr
+		TransitionIndirectArguments(*anArgumentBuffer, aCountBuffer.get());
+
+		myCommandList->ExecuteIndirect(
+			myDevice.GetDispatchSignature(),
+			aMaxDispatchCount,
+			static_cast<ID3D12Resource*>(anArgumentBuffer->GetNativeBufferPtr()),
+			anArgumentOffset,
+			aCountBuffer ? static_cast<ID3D12Resource*>(aCountBuffer->GetNativeBufferPtr()) : nullptr,
+			aCountOffset
 		);
 	}
 
-	void FrameGraphicsContext::ClearDepth(const std::shared_ptr<Atrium::RenderTexture>& aTarget, float aDepth, std::uint8_t aStencil)
+	void PipelineFrameContext::BindPipelineState(PipelineState& aPipelineState)
 	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Clear depth");
-		Debug::Assert(!!aTarget, "ClearDepth() requires a target.");
+		myCurrentPipelineState = &aPipelineState;
+		myCommandList->SetPipelineState(myCurrentPipelineState->GetPipelineStateObject().Get());
 
-		RenderTarget& target = static_cast<RenderTarget&>(*aTarget);
-		AddBarrier(*target.GetDepthGPUResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
-		FlushBarriers();
+		ID3D12RootSignature* rootSignature = myCurrentPipelineState->GetRootSignature()->GetRootSignatureObject().Get();
+		if (myCurrentPipelineState->IsCompute())
+			myCommandList->SetComputeRootSignature(rootSignature);
+		else
+			myCommandList->SetGraphicsRootSignature(rootSignature);
 
-		D3D12_CPU_DESCRIPTOR_HANDLE handle = target.GetDepthStencilView().GetCPUHandle();
+		// Bindless tables always cover the frame's whole copy of the persistent region, so they only need binding once per root signature.
+		for (unsigned int rootParameterIndex : myCurrentPipelineState->GetRootSignature()->GetBindlessTables())
+			SetRootDescriptorTable(rootParameterIndex, myFrameRing.GetPersistentGPUStart(myFrameInFlight));
+	}
 
-		if (!Debug::Verify(handle.ptr != NULL, "Invalid target."))
-			return;
+	void PipelineFrameContext::BindPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline constants");
 
-		myCommandList->ClearDepthStencilView(
-			handle,
-			D3D12_CLEAR_FLAG_DEPTH,
-			aDepth,
-			aStencil, 0, nullptr
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(
+			anUpdateFrequency,
+			RootParameterMapping::RegisterType::ConstantBuffer,
+			aRegisterIndex
 		);
-	}
 
-	void FrameGraphicsContext::DisableScissorRect()
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Disable scissor rect");
-		myCommandList->RSSetScissorRects(0, nullptr);
-	}
+		if (!parameterInfo.has_value())
+		{
+			Debug::LogError("Root parameter missing for register c%i, space%i", aRegisterIndex, static_cast<unsigned int>(anUpdateFrequency));
+			return;
+		}
 
-	void FrameGraphicsContext::Dispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch");
-		FlushPipelineResources();
-		myCommandList->Dispatch(aGroupCountX, aGroupCountY, aGroupCountZ);
+		const UINT valueCount = Atrium::TruncateTo<UINT>(someValues.size());
+		if (myCurrentPipelineState->IsCompute())
+			myCommandList->SetComputeRoot32BitConstants(parameterInfo.value().RootParameterIndex, valueCount, someValues.data(), 0);
+		else
+			myCommandList->SetGraphicsRoot32BitConstants(parameterInfo.value().RootParameterIndex, valueCount, someValues.data(), 0);
 	}
 
-	void FrameGraphicsContext::Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX)
+	void PipelineFrameContext::QueuePipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
 	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 1D");
-		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), 1, 1);
-	}
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(
+			anUpdateFrequency,
+			RootParameterMapping::RegisterType::ConstantBuffer,
+			aRegisterIndex
+		);
 
-	void FrameGraphicsContext::Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 2D");
-		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), 1);
-	}
+		if (!parameterInfo.has_value())
+		{
+			Debug::LogError("Root parameter missing for register c%i, space%i", aRegisterIndex, static_cast<unsigned int>(anUpdateFrequency));
+			return;
+		}
 
-	void FrameGraphicsContext::Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 3D");
-		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), GetGroupCount(aThreadCountZ, aGroupSizeZ));
-	}
+		if (!myPendingBufferResources.contains(parameterInfo.value().RootParameterIndex))
+			myPendingBufferResources[parameterInfo.value().RootParameterIndex].resize(parameterInfo.value().Count);
 
-	void FrameGraphicsContext::Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw");
-		DrawInstanced(aVertexCount, 1, aVertexStartOffset, 0);
+		std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>& parameterBuffers = myPendingBufferResources.at(parameterInfo.value().RootParameterIndex);
+		parameterBuffers[parameterInfo.value().RegisterOffset] = aBuffer;
 	}
 
-	void FrameGraphicsContext::DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed");
-		DrawIndexedInstanced(anIndexCount, 1, aStartIndexLocation, aBaseVertexLocation, 0);
-	}
-
-	void FrameGraphicsContext::DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw instanced");
-		FlushPipelineResources();
-		myCommandList->DrawInstanced(aVertexCountPerInstance, anInstanceCount, aStartVertexLocation, aStartInstanceLocation);
-	}
-
-	void FrameGraphicsContext::DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed instanced");
-		FlushPipelineResources();
-		myCommandList->DrawIndexedInstanced(anIndexCountPerInstance, anInstanceCount, aStartIndexLocation, aBaseVertexLocation, aStartInstanceLocation);
-	}
-
-	void FrameGraphicsContext::SetBlendFactor(ColorARGB<float> aBlendFactor)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set blend factor");
-		float color[4] = { aBlendFactor.R, aBlendFactor.G, aBlendFactor.B, aBlendFactor.A };
-		myCommandList->OMSetBlendFactor(color);
-	}
-
-	void FrameGraphicsContext::SetScissorRect(const Rectangle<int>& aRectangle)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set scissor rect");
-
-		D3D12_RECT rect;
-		rect.left = aRectangle.Center().X - (aRectangle.Width / 2);
-		rect.right = aRectangle.Center().X + (aRectangle.Width / 2);
-		rect.top = aRectangle.Center().Y - (aRectangle.Height / 2);
-		rect.bottom = aRectangle.Center().Y + (aRectangle.Height / 2);
-
-		myCommandList->RSSetScissorRects(1, &rect);
-	}
-
-	void FrameGraphicsContext::SetPrimitiveTopology(PrimitiveTopology aTopology)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set primitive topology");
-
-		D3D12_PRIMITIVE_TOPOLOGY topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
-
-		switch (aTopology)
-		{
-			case PrimitiveTopology::PointList:
-				topology = D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
-				break;
-			case PrimitiveTopology::LineList:
-				topology = D3D_PRIMITIVE_TOPOLOGY_LINELIST;
-				break;
-			case PrimitiveTopology::LineStrip:
-				topology = D3D_PRIMITIVE_TOPOLOGY_LINESTRIP;
-				break;
-			case PrimitiveTopology::TriangleList:
-				topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-				break;
-			case PrimitiveTopology::TriangleStrip:
-				topology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
-				break;
-		}
-
-		myCommandList->IASetPrimitiveTopology(topology);
-	}
-
-	void FrameGraphicsContext::SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline state");
-		Debug::Assert(!!aPipelineState, "SetPipelineState() requires pipeline state to be non-null.");
-
-		myCurrentPipelineState = static_cast<DirectX12::PipelineState*>(aPipelineState.get());
-		myCommandList->SetPipelineState(myCurrentPipelineState->GetPipelineStateObject().Get());
-		myCommandList->SetGraphicsRootSignature(myCurrentPipelineState->GetRootSignature()->GetRootSignatureObject().Get());
-	}
-
-	void FrameGraphicsContext::SetVertexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& aVertexBuffer, unsigned int aSlot)
-	{
-		Debug::Assert(!!aVertexBuffer, "Assumes a valid buffer.");
-
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set vertex buffer");
-
-		if (std::optional<D3D12_VERTEX_BUFFER_VIEW> bufferView = static_cast<const GraphicsBuffer*>(aVertexBuffer.get())->GetVertexView())
-		{
-			myCommandList->IASetVertexBuffers(aSlot, 1, &bufferView.value());
-		}
-		else
-		{
-			Debug::LogError("Tried to set graphics-buffer as a vertex-buffer, but it wasn't valid for that purpose.");
-			return;
-		}
-	}
-
-	void FrameGraphicsContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
-	{
-		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(
-			anUpdateFrequency,
-			RootParameterMapping::RegisterType::ConstantBuffer,
-			aRegisterIndex
-		);
-
-		if (!parameterInfo.has_value())
-		{
-			Debug::LogError("Root parameter missing for register c%i, space%i", aRegisterIndex, static_cast<unsigned int>(anUpdateFrequency));
-			return;
-		}
-
-		if (!myPendingBufferResources.contains(parameterInfo.value().RootParameterIndex))
-			myPendingBufferResources[parameterInfo.value().RootParameterIndex].resize(parameterInfo.value().Count);
-
-		std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>& parameterBuffers = myPendingBufferResources.at(parameterInfo.value().RootParameterIndex);
-		parameterBuffers[parameterInfo.value().RegisterOffset] = aBuffer;
-	}
-
-	void FrameGraphicsContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture)
+	void PipelineFrameContext::QueuePipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture)
 	{
 		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(
 			anUpdateFrequency,
@@ -502,80 +666,59 @@ namespace Atrium::DirectX12
 		parameterBuffers[parameterInfo.value().RegisterOffset] = aTexture;
 	}
 
-	void FrameGraphicsContext::SetStencilRef(std::uint32_t aStencilRef)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set stencil ref");
-		myCommandList->OMSetStencilRef(aStencilRef);
-	}
-
-	void FrameGraphicsContext::SetRenderTargets(const std::vector<std::shared_ptr<Atrium::RenderTexture>>& someTargets, const std::shared_ptr<Atrium::RenderTexture>& aDepthTarget)
+	void PipelineFrameContext::BindPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
 	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set render targets");
-		std::array<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> colorHandles;
-		colorHandles.fill(D3D12_CPU_DESCRIPTOR_HANDLE{ 0 });
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline unordered access");
 
-		for (std::size_t i = 0; i < someTargets.size(); ++i)
-		{
-			RenderTarget* dxRenderTarget = static_cast<RenderTarget*>(someTargets.at(i).get());
-			AddBarrier(*dxRenderTarget->GetGPUResource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
-			colorHandles.at(i) = dxRenderTarget->GetColorView().GetCPUHandle();
-		}
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(
+			anUpdateFrequency,
+			RootParameterMapping::RegisterType::Unordered,
+			aRegisterIndex
+		);
 
-		RenderTarget* dxDepthTarget = static_cast<RenderTarget*>(aDepthTarget.get());
-		D3D12_CPU_DESCRIPTOR_HANDLE depthStencilHandle;
-		if (dxDepthTarget)
+		if (!parameterInfo.has_value())
 		{
-			AddBarrier(*dxDepthTarget->GetDepthGPUResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
-			depthStencilHandle = dxDepthTarget->GetDepthStencilView().GetCPUHandle();
+			Debug::LogError("Root parameter missing for register u%i, space%i", aRegisterIndex, static_cast<unsigned int>(anUpdateFrequency));
+			return;
 		}
 
-		FlushBarriers();
+		GraphicsBuffer* graphicsBuffer = static_cast<GraphicsBuffer*>(aBuffer.get());
+		Debug::Assert(graphicsBuffer, "Assumes non-null buffers.");
 
-		myCommandList->OMSetRenderTargets(
-			static_cast<UINT>(someTargets.size()),
-			colorHandles.data(),
-			false,
-			dxDepthTarget ? &depthStencilHandle : nullptr);
-	}
+		GPUResource* resource = graphicsBuffer->GetTransitionableResource();
+		if (!Debug::Verify(
+			resource && (graphicsBuffer->GetTarget() & Atrium::GraphicsBuffer::Target::UnorderedAccess) != Atrium::GraphicsBuffer::Target::None,
+			"Buffers bound for unordered access are created with the UnorderedAccess target."))
+			return;
 
-	void FrameGraphicsContext::SetViewportAndScissorRect(const Vector2<int>& aScreenSize)
-	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set viewport and scissor rect");
-		D3D12_VIEWPORT viewport;
-		viewport.Width = static_cast<float>(aScreenSize.X);
-		viewport.Height = static_cast<float>(aScreenSize.Y);
-		viewport.MinDepth = 0.0f;
-		viewport.MaxDepth = 1.0f;
-		viewport.TopLeftX = 0;
-		viewport.TopLeftY = 0;
+		// Root descriptors are set right away, so the buffer has to be writable before the next dispatch rather than when resources are flushed.
+		AddBarrier(*resource, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+		FlushBarriers();
 
-		D3D12_RECT scissor;
-		scissor.top = 0;
-		scissor.left = 0;
-		scissor.bottom = aScreenSize.Y;
-		scissor.right = aScreenSize.X;
+		if (myCurrentPipelineState->IsCompute())
+			myCommandList->SetComputeRootUnorderedAccessView(parameterInfo.value().RootParameterIndex, resource->GetGPUAddress());
+		else
+			myCommandList->SetGraphicsRootUnorderedAccessView(parameterInfo.value().RootParameterIndex, resource->GetGPUAddress());
 
-		myCommandList->RSSetViewports(1, &viewport);
-		myCommandList->RSSetScissorRects(1, &scissor);
+		myUnorderedAccessBuffers.push_back(aBuffer);
 	}
 
-	void FrameGraphicsContext::SetViewport(const Rectangle<float>& aRectangle)
+	void PipelineFrameContext::TransitionIndirectArguments(Atrium::GraphicsBuffer& anArgumentBuffer, Atrium::GraphicsBuffer* aCountBuffer)
 	{
-		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set viewport");
-		const Vector2<float> topLeft = aRectangle.TopLeft();
+		// PerFrame buffers stay in the generic read state of their upload heaps, which arguments can already be read in.
+		for (Atrium::GraphicsBuffer* buffer : { &anArgumentBuffer, aCountBuffer })
+		{
+			if (!buffer)
+				continue;
 
-		D3D12_VIEWPORT viewport;
-		viewport.TopLeftX = topLeft.X;
-		viewport.TopLeftY = topLeft.Y;
-		viewport.Width = aRectangle.Width;
-		viewport.Height = aRectangle.Height;
-		viewport.MinDepth = 0.1f;
-		viewport.MaxDepth = 1.0f;
+			if (GPUResource* resource = static_cast<GraphicsBuffer*>(buffer)->GetTransitionableResource())
+				AddBarrier(*resource, D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT);
+		}
 
-		myCommandList->RSSetViewports(1, &viewport);
+		FlushBarriers();
 	}
 
-	void FrameGraphicsContext::FlushPipelineConstantBuffers()
+	bool PipelineFrameContext::FlushPipelineConstantBuffers()
 	{
 		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline buffer resources");
 
@@ -601,11 +744,13 @@ namespace Atrium::DirectX12
 
 			if (existingHeapHandle != myBufferHeapHandles.cend())
 			{
-				myCommandList->SetGraphicsRootDescriptorTable(rootParameterBuffers.first, existingHeapHandle->second.GetGPUHandle());
+				SetRootDescriptorTable(rootParameterBuffers.first, existingHeapHandle->second.GetGPUHandle());
 				continue;
 			}
 
-			DescriptorHeapHandle heapHandle = myCurrentFrameHeap->GetHeapHandleBlock(Atrium::TruncateTo<uint32_t>(rootParameterBuffers.second.size()));
+			const DescriptorHeapBlock heapHandle = myFrameRing.AllocateBlock(myFrameInFlight, Atrium::TruncateTo<uint32_t>(rootParameterBuffers.second.size()));
+			if (!heapHandle.IsValid())
+				return false;
 
 			for (std::size_t i = 0; i < rootParameterBuffers.second.size(); ++i)
 			{
@@ -619,16 +764,18 @@ namespace Atrium::DirectX12
 					1,
 					heapHandle.GetCPUHandle(Atrium::TruncateTo<unsigned int>(i)),
 					descriptorHandle.GetCPUHandle(),
-					myCurrentFrameHeap->GetHeapType()
+					myFrameRing.GetHeapType()
 				);
 			}
 
 			myBufferHeapHandles[rootParameterBuffers.second] = heapHandle;
-			myCommandList->SetGraphicsRootDescriptorTable(rootParameterBuffers.first, heapHandle.GetGPUHandle());
+			SetRootDescriptorTable(rootParameterBuffers.first, heapHandle.GetGPUHandle());
 		}
+
+		return true;
 	}
 
-	void FrameGraphicsContext::FlushPipelineTextures()
+	bool PipelineFrameContext::FlushPipelineTextures()
 	{
 		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline texture resources");
 
@@ -654,11 +801,13 @@ namespace Atrium::DirectX12
 
 			if (existingHeapHandle != myTextureHeapHandles.cend())
 			{
-				myCommandList->SetGraphicsRootDescriptorTable(rootParameterTextures.first, existingHeapHandle->second.GetGPUHandle());
+				SetRootDescriptorTable(rootParameterTextures.first, existingHeapHandle->second.GetGPUHandle());
 				continue;
 			}
 
-			DescriptorHeapHandle heapHandle = myCurrentFrameHeap->GetHeapHandleBlock(Atrium::TruncateTo<uint32_t>(rootParameterTextures.second.size()));
+			const DescriptorHeapBlock heapHandle = myFrameRing.AllocateBlock(myFrameInFlight, Atrium::TruncateTo<uint32_t>(rootParameterTextures.second.size()));
+			if (!heapHandle.IsValid())
+				return false;
 
 			for (std::size_t i = 0; i < rootParameterTextures.second.size(); ++i)
 			{
@@ -668,7 +817,7 @@ namespace Atrium::DirectX12
 						1,
 						heapHandle.GetCPUHandle(Atrium::TruncateTo<unsigned int>(i)),
 						static_cast<Texture*>(texture)->GetImage().GetSRVHandle().GetCPUHandle(),
-						myCurrentFrameHeap->GetHeapType()
+						myFrameRing.GetHeapType()
 					);
 				}
 				else
@@ -691,13 +840,872 @@ namespace Atrium::DirectX12
 			}
 
 			myTextureHeapHandles[rootParameterTextures.second] = heapHandle;
-			myCommandList->SetGraphicsRootDescriptorTable(rootParameterTextures.first, heapHandle.GetGPUHandle());
+			SetRootDescriptorTable(rootParameterTextures.first, heapHandle.GetGPUHandle());
 		}
+
+		return true;
+	}
+
+	bool PipelineFrameContext::FlushPipelineResources()
+	{
+		return FlushPipelineConstantBuffers() && FlushPipelineTextures();
+	}
+
+	void PipelineFrameContext::SetRootDescriptorTable(UINT aRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE aHandle)
+	{
+		if (myCurrentPipelineState->IsCompute())
+			myCommandList->SetComputeRootDescriptorTable(aRootParameterIndex, aHandle);
+		else
+			myCommandList->SetGraphicsRootDescriptorTable(aRootParameterIndex, aHandle);
+	}
+
+	FrameGraphicsContext::FrameGraphicsContext(Device& aDevice, CommandQueue& aCommandQueue)
+		: PipelineFrameContext(aDevice, aCommandQueue)
+	{
+		if (aCommandQueue.GetQueueType() != D3D12_COMMAND_LIST_TYPE_DIRECT)
+			throw std::domain_error("Graphics frame context requires a command queue with type Direct.");
+
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+			myFrameCommandAllocators[i]->SetName(L"Frame graphics command allocator");
+		myCommandList->SetName(L"Frame graphics command list");
+
+		myFrameExecutedBundles.resize(DirectX12API::GetFramesInFlightAmount());
+	}
+
+	void FrameGraphicsContext::Reset(const std::uint_least8_t& aFrameInFlight)
+	{
+		PipelineFrameContext::Reset(aFrameInFlight);
+
+		myFrameExecutedBundles[aFrameInFlight].clear();
+	}
+
+	void FrameGraphicsContext::BeginProfileZone(ProfileContextZone& aZoneScope
+	#ifdef TRACY_ENABLE
+		, const tracy::SourceLocationData& aLocation
+	#endif
+	)
+	{
+		RecordProfileZone(aZoneScope
+		#ifdef TRACY_ENABLE
+			, aLocation
+		#endif
+		);
+	}
+
+	void FrameGraphicsContext::AddDependency(const std::shared_ptr<Atrium::FrameComputeContext>& aContext)
+	{
+		Debug::Assert(!!aContext, "AddDependency() requires a context.");
+		PipelineFrameContext::AddDependency(static_cast<const DirectX12::FrameComputeContext&>(*aContext));
+	}
+
+	void FrameGraphicsContext::ClearColor(const std::shared_ptr<Atrium::RenderTexture>& aTarget, ColorARGB<float> aClearColor)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Clear color");
+		Debug::Assert(!!aTarget, "ClearColor() requires a target.");
+
+		RenderTarget& target = static_cast<RenderTarget&>(*aTarget);
+		AddBarrier(*target.GetGPUResource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+		FlushBarriers();
+
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = target.GetColorView().GetCPUHandle();
+
+		if (!Debug::Verify(handle.ptr != NULL, "Invalid target."))
+			return;
+
+		float color[4] = {
+			aClearColor.R,
+			aClearColor.G,
+			aClearColor.B,
+			aClearColor.A
+		};
+		myCommandList->ClearRenderTargetView(
+			handle,
+			color,
+			0,
+			nullptr
+		);
+	}
+
+	void FrameGraphicsContext::ClearDepth(const std::shared_ptr<Atrium::RenderTexture>& aTarget, float aDepth, std::uint8_t aStencil)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Clear depth");
+		Debug::Assert(!!aTarget, "ClearDepth() requires a target.");
+
+		RenderTarget& target = static_cast<RenderTarget&>(*aTarget);
+		AddBarrier(*target.GetDepthGPUResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		FlushBarriers();
+
+		D3D12_CPU_DESCRIPTOR_HANDLE handle = target.GetDepthStencilView().GetCPUHandle();
+
+		if (!Debug::Verify(handle.ptr != NULL, "Invalid target."))
+			return;
+
+		myCommandList->ClearDepthStencilView(
+			handle,
+			D3D12_CLEAR_FLAG_DEPTH,
+			aDepth,
+			aStencil, 0, nullptr
+		);
+	}
+
+	void FrameGraphicsContext::DisableScissorRect()
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Disable scissor rect");
+		myCommandList->RSSetScissorRects(0, nullptr);
 	}
 
-	void FrameGraphicsContext::FlushPipelineResources()
+	void FrameGraphicsContext::Dispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ)
 	{
-		FlushPipelineConstantBuffers();
-		FlushPipelineTextures();
+		RecordDispatch(aGroupCountX, aGroupCountY, aGroupCountZ);
+	}
+
+	void FrameGraphicsContext::Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 1D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), 1, 1);
+	}
+
+	void FrameGraphicsContext::Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 2D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), 1);
+	}
+
+	void FrameGraphicsContext::Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 3D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), GetGroupCount(aThreadCountZ, aGroupSizeZ));
+	}
+
+	void FrameGraphicsContext::DispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset)
+	{
+		RecordDispatchIndirect(anArgumentBuffer, aMaxDispatchCount, anArgumentOffset, aCountBuffer, aCountOffset);
+	}
+
+	void FrameGraphicsContext::ExecuteBundle(const std::shared_ptr<Atrium::CommandBundle>& aBundle)
+	{
+		Debug::Assert(aBundle && aBundle->IsClosed(), "Only closed bundles can be executed.");
+
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Execute bundle");
+
+		CommandBundle& bundle = static_cast<CommandBundle&>(*aBundle);
+		myCommandList->ExecuteBundle(bundle.GetCommandList(myFrameInFlight));
+
+		// Destroying the bundle frees its descriptor tables, so it's kept until the frame is done with it.
+		myFrameExecutedBundles[myFrameInFlight].push_back(aBundle);
+
+		// The bundle's pipeline state and root arguments stay bound after it.
+		if (bundle.GetPipelineState())
+			myCurrentPipelineState = bundle.GetPipelineState();
+	}
+
+	void FrameGraphicsContext::Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw");
+		DrawInstanced(aVertexCount, 1, aVertexStartOffset, 0);
+	}
+
+	void FrameGraphicsContext::DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed");
+		DrawIndexedInstanced(anIndexCount, 1, aStartIndexLocation, aBaseVertexLocation, 0);
+	}
+
+	void FrameGraphicsContext::DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw instanced");
+		if (!FlushPipelineResources())
+			return;
+
+		myCommandList->DrawInstanced(aVertexCountPerInstance, anInstanceCount, aStartVertexLocation, aStartInstanceLocation);
+	}
+
+	void FrameGraphicsContext::DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed instanced");
+		if (!FlushPipelineResources())
+			return;
+
+		myCommandList->DrawIndexedInstanced(anIndexCountPerInstance, anInstanceCount, aStartIndexLocation, aBaseVertexLocation, aStartInstanceLocation);
+	}
+
+	void FrameGraphicsContext::DrawIndexedInstancedBatch(std::span<const DrawIndexedArguments> someDraws)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed instanced batch");
+		if (!FlushPipelineResources())
+			return;
+
+		for (const DrawIndexedArguments& draw : someDraws)
+		{
+			myCommandList->DrawIndexedInstanced(
+				draw.IndexCountPerInstance,
+				draw.InstanceCount,
+				draw.StartIndexLocation,
+				draw.BaseVertexLocation,
+				draw.StartInstanceLocation
+			);
+		}
+	}
+
+	void FrameGraphicsContext::DrawIndexedInstancedIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDrawCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset)
+	{
+		Debug::Assert(!!anArgumentBuffer, "Assumes a valid argument buffer.");
+
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Draw indexed instanced indirect");
+		if (!FlushPipelineResources())
+			return;
+
+		TransitionIndirectArguments(*anArgumentBuffer, aCountBuffer.get());
+
+		myCommandList->ExecuteIndirect(
+			myDevice.GetDrawIndexedSignature(),
+			aMaxDrawCount,
+			static_cast<ID3D12Resource*>(anArgumentBuffer->GetNativeBufferPtr()),
+			anArgumentOffset,
+			aCountBuffer ? static_cast<ID3D12Resource*>(aCountBuffer->GetNativeBufferPtr()) : nullptr,
+			aCountOffset
+		);
+	}
+
+	void FrameGraphicsContext::SetBlendFactor(ColorARGB<float> aBlendFactor)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set blend factor");
+		float color[4] = { aBlendFactor.R, aBlendFactor.G, aBlendFactor.B, aBlendFactor.A };
+		myCommandList->OMSetBlendFactor(color);
+	}
+
+	void FrameGraphicsContext::SetScissorRect(const Rectangle<int>& aRectangle)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set scissor rect");
+
+		D3D12_RECT rect;
+		rect.left = aRectangle.Center().X - (aRectangle.Width / 2);
+		rect.right = aRectangle.Center().X + (aRectangle.Width / 2);
+		rect.top = aRectangle.Center().Y - (aRectangle.Height / 2);
+		rect.bottom = aRectangle.Center().Y + (aRectangle.Height / 2);
+
+		myCommandList->RSSetScissorRects(1, &rect);
+	}
+
+	void FrameGraphicsContext::SetPrimitiveTopology(PrimitiveTopology aTopology)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set primitive topology");
+		myCommandList->IASetPrimitiveTopology(ToD3DPrimitiveTopology(aTopology));
+	}
+
+	void FrameGraphicsContext::SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline state");
+		Debug::Assert(!!aPipelineState, "SetPipelineState() requires pipeline state to be non-null.");
+
+		BindPipelineState(static_cast<DirectX12::PipelineState&>(*aPipelineState));
+	}
+
+	void FrameGraphicsContext::SetVertexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& aVertexBuffer, unsigned int aSlot)
+	{
+		Debug::Assert(!!aVertexBuffer, "Assumes a valid buffer.");
+
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set vertex buffer");
+
+		if (std::optional<D3D12_VERTEX_BUFFER_VIEW> bufferView = static_cast<const GraphicsBuffer*>(aVertexBuffer.get())->GetVertexView())
+		{
+			myCommandList->IASetVertexBuffers(aSlot, 1, &bufferView.value());
+		}
+		else
+		{
+			Debug::LogError("Tried to set graphics-buffer as a vertex-buffer, but it wasn't valid for that purpose.");
+			return;
+		}
+	}
+
+	void FrameGraphicsContext::SetIndexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& anIndexBuffer)
+	{
+		Debug::Assert(!!anIndexBuffer, "Assumes a valid buffer.");
+
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set index buffer");
+
+		if (std::optional<D3D12_INDEX_BUFFER_VIEW> bufferView = static_cast<const GraphicsBuffer*>(anIndexBuffer.get())->GetIndexView())
+		{
+			myCommandList->IASetIndexBuffer(&bufferView.value());
+		}
+		else
+		{
+			Debug::LogError("Tried to set graphics-buffer as an index-buffer, but it wasn't valid for that purpose.");
+			return;
+		}
+	}
+
+	void FrameGraphicsContext::SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues)
+	{
+		BindPipelineConstants(anUpdateFrequency, aRegisterIndex, someValues);
+	}
+
+	void FrameGraphicsContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
+	{
+		QueuePipelineResource(anUpdateFrequency, aRegisterIndex, aBuffer);
+	}
+
+	void FrameGraphicsContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture)
+	{
+		QueuePipelineResource(anUpdateFrequency, aRegisterIndex, aTexture);
+	}
+
+	void FrameGraphicsContext::SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
+	{
+		BindPipelineUnorderedAccess(anUpdateFrequency, aRegisterIndex, aBuffer);
+	}
+
+	void FrameGraphicsContext::SetStencilRef(std::uint32_t aStencilRef)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set stencil ref");
+		myCommandList->OMSetStencilRef(aStencilRef);
+	}
+
+	void FrameGraphicsContext::SetRenderTargets(const std::vector<std::shared_ptr<Atrium::RenderTexture>>& someTargets, const std::shared_ptr<Atrium::RenderTexture>& aDepthTarget)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set render targets");
+		std::array<D3D12_CPU_DESCRIPTOR_HANDLE, D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT> colorHandles;
+		colorHandles.fill(D3D12_CPU_DESCRIPTOR_HANDLE{ 0 });
+
+		for (std::size_t i = 0; i < someTargets.size(); ++i)
+		{
+			RenderTarget* dxRenderTarget = static_cast<RenderTarget*>(someTargets.at(i).get());
+			AddBarrier(*dxRenderTarget->GetGPUResource(), D3D12_RESOURCE_STATE_RENDER_TARGET);
+			colorHandles.at(i) = dxRenderTarget->GetColorView().GetCPUHandle();
+		}
+
+		RenderTarget* dxDepthTarget = static_cast<RenderTarget*>(aDepthTarget.get());
+		D3D12_CPU_DESCRIPTOR_HANDLE depthStencilHandle;
+		if (dxDepthTarget)
+		{
+			AddBarrier(*dxDepthTarget->GetDepthGPUResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+			depthStencilHandle = dxDepthTarget->GetDepthStencilView().GetCPUHandle();
+		}
+
+		FlushBarriers();
+
+		myCommandList->OMSetRenderTargets(
+			static_cast<UINT>(someTargets.size()),
+			colorHandles.data(),
+			false,
+			dxDepthTarget ? &depthStencilHandle : nullptr);
+	}
+
+	void FrameGraphicsContext::SetViewportAndScissorRect(const Vector2<int>& aScreenSize)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set viewport and scissor rect");
+		D3D12_VIEWPORT viewport;
+		viewport.Width = static_cast<float>(aScreenSize.X);
+		viewport.Height = static_cast<float>(aScreenSize.Y);
+		viewport.MinDepth = 0.0f;
+		viewport.MaxDepth = 1.0f;
+		viewport.TopLeftX = 0;
+		viewport.TopLeftY = 0;
+
+		D3D12_RECT scissor;
+		scissor.top = 0;
+		scissor.left = 0;
+		scissor.bottom = aScreenSize.Y;
+		scissor.right = aScreenSize.X;
+
+		myCommandList->RSSetViewports(1, &viewport);
+		myCommandList->RSSetScissorRects(1, &scissor);
+	}
+
+	void FrameGraphicsContext::SetViewport(const Rectangle<float>& aRectangle)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set viewport");
+		const Vector2<float> topLeft = aRectangle.TopLeft();
+
+		D3D12_VIEWPORT viewport;
+		viewport.TopLeftX = topLeft.X;
+		viewport.TopLeftY = topLeft.Y;
+		viewport.Width = aRectangle.Width;
+		viewport.Height = aRectangle.Height;
+		viewport.MinDepth = 0.1f;
+		viewport.MaxDepth = 1.0f;
+
+		myCommandList->RSSetViewports(1, &viewport);
+	}
+
+	void FrameGraphicsContext::TransitionResources(std::span<const ResourceTransition> someTransitions, TransitionTiming aTiming)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Transition resources");
+
+		for (const ResourceTransition& transition : someTransitions)
+		{
+			GPUResource* resource = nullptr;
+			if (transition.Texture)
+			{
+				if (RenderTarget* renderTarget = dynamic_cast<RenderTarget*>(transition.Texture.get()))
+				{
+					const bool isDepthState = transition.State == ResourceState::DepthWrite || transition.State == ResourceState::DepthRead;
+					resource = (isDepthState ? renderTarget->GetDepthGPUResource() : renderTarget->GetGPUResource()).get();
+				}
+				else
+				{
+					resource = static_cast<Texture*>(transition.Texture.get())->GetImage().GetResource().get();
+				}
+			}
+			else if (transition.Buffer)
+			{
+				// Null for PerFrame buffers, which live in upload heaps that must stay in the generic read state.
+				resource = static_cast<GraphicsBuffer*>(transition.Buffer.get())->GetTransitionableResource();
+			}
+
+			if (!resource)
+				continue;
+
+			const D3D12_RESOURCE_STATES newState = ToD3DResourceState(transition.State);
+			switch (aTiming)
+			{
+				case TransitionTiming::Begin:
+					BeginSplitBarrier(*resource, newState);
+					break;
+				case TransitionTiming::End:
+					EndSplitBarrier(*resource, newState);
+					break;
+				case TransitionTiming::Immediate:
+				default:
+					AddBarrier(*resource, newState);
+					break;
+			}
+		}
+
+		FlushBarriers();
+	}
+
+
+	FrameComputeContext::FrameComputeContext(Device& aDevice, CommandQueue& aCommandQueue)
+		: PipelineFrameContext(aDevice, aCommandQueue)
+	{
+		if (aCommandQueue.GetQueueType() != D3D12_COMMAND_LIST_TYPE_COMPUTE)
+			throw std::domain_error("Compute frame context requires a command queue with type Compute.");
+
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+			myFrameCommandAllocators[i]->SetName(L"Frame compute command allocator");
+		myCommandList->SetName(L"Frame compute command list");
+	}
+
+	void FrameComputeContext::BeginProfileZone(Atrium::FrameGraphicsContext::ProfileContextZone& aZoneScope
+	#ifdef TRACY_ENABLE
+		, const tracy::SourceLocationData& aLocation
+	#endif
+	)
+	{
+		RecordProfileZone(aZoneScope
+		#ifdef TRACY_ENABLE
+			, aLocation
+		#endif
+		);
+	}
+
+	void FrameComputeContext::AddDependency(const std::shared_ptr<Atrium::FrameGraphicsContext>& aContext)
+	{
+		Debug::Assert(!!aContext, "AddDependency() requires a context.");
+		PipelineFrameContext::AddDependency(static_cast<const DirectX12::FrameGraphicsContext&>(*aContext));
+	}
+
+	void FrameComputeContext::Dispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ)
+	{
+		RecordDispatch(aGroupCountX, aGroupCountY, aGroupCountZ);
+	}
+
+	void FrameComputeContext::Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 1D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), 1, 1);
+	}
+
+	void FrameComputeContext::Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 2D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), 1);
+	}
+
+	void FrameComputeContext::Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Dispatch 3D");
+		Dispatch(GetGroupCount(aThreadCountX, aGroupSizeX), GetGroupCount(aThreadCountY, aGroupSizeY), GetGroupCount(aThreadCountZ, aGroupSizeZ));
+	}
+
+	void FrameComputeContext::DispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset)
+	{
+		RecordDispatchIndirect(anArgumentBuffer, aMaxDispatchCount, anArgumentOffset, aCountBuffer, aCountOffset);
+	}
+
+	void FrameComputeContext::SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState)
+	{
+		TracyD3D12Zone(myProfilingContext, myCommandList.Get(), "Set pipeline state");
+		Debug::Assert(!!aPipelineState, "SetPipelineState() requires pipeline state to be non-null.");
+
+		DirectX12::PipelineState& pipelineState = static_cast<DirectX12::PipelineState&>(*aPipelineState);
+		if (!Debug::Verify(pipelineState.IsCompute(), "Compute contexts only accept compute pipeline states."))
+			return;
+
+		BindPipelineState(pipelineState);
+	}
+
+	void FrameComputeContext::SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues)
+	{
+		BindPipelineConstants(anUpdateFrequency, aRegisterIndex, someValues);
+	}
+
+	void FrameComputeContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
+	{
+		QueuePipelineResource(anUpdateFrequency, aRegisterIndex, aBuffer);
+	}
+
+	void FrameComputeContext::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture)
+	{
+		QueuePipelineResource(anUpdateFrequency, aRegisterIndex, aTexture);
+	}
+
+	void FrameComputeContext::SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
+	{
+		BindPipelineUnorderedAccess(anUpdateFrequency, aRegisterIndex, aBuffer);
+	}
+
+	CommandBundle::CommandBundle(Device& aDevice)
+		: myDevice(aDevice)
+		, myFrameRing(aDevice.GetDescriptorHeapManager().GetFrameRing())
+		, myCurrentPipelineState(nullptr)
+		, myIsClosed(false)
+	{
+		PROFILE_SCOPE();
+
+		// Has to match the heaps bound by the executing context.
+		ID3D12DescriptorHeap* heapsToBind[] =
+		{
+			myFrameRing.GetHeap().Get()
+		};
+
+		myCommandAllocators.resize(DirectX12API::GetFramesInFlightAmount());
+		myCommandLists.resize(DirectX12API::GetFramesInFlightAmount());
+		for (unsigned int i = 0; i < DirectX12API::GetFramesInFlightAmount(); ++i)
+		{
+			Debug::Assert(
+				aDevice.GetDevice()->CreateCommandAllocator(
+					D3D12_COMMAND_LIST_TYPE_BUNDLE,
+					IID_PPV_ARGS(myCommandAllocators[i].ReleaseAndGetAddressOf())
+				),
+				"Create bundle command allocator."
+			);
+
+			myCommandAllocators[i]->SetName(L"Command bundle allocator");
+
+			// Bundles are only recorded once, so the lists are created open.
+			Debug::Assert(
+				aDevice.GetDevice()->CreateCommandList(
+					0,
+					D3D12_COMMAND_LIST_TYPE_BUNDLE,
+					myCommandAllocators[i].Get(),
+					nullptr,
+					IID_PPV_ARGS(myCommandLists[i].ReleaseAndGetAddressOf())
+				),
+				"Create bundle command list."
+			);
+
+			myCommandLists[i]->SetName(L"Command bundle");
+			myCommandLists[i]->SetDescriptorHeaps(1, heapsToBind);
+		}
+	}
+
+	CommandBundle::~CommandBundle()
+	{
+		// Frames in flight may still be replaying the bundle, so the tables' descriptors are only reused once those are done.
+		myBufferTables.clear();
+		myTextureTables.clear();
+	}
+
+	void CommandBundle::Close()
+	{
+		if (!CanRecord())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			Debug::Verify(commandList->Close(), "Close bundle command list.");
+		myIsClosed = true;
+
+		myPendingBufferResources.clear();
+		myPendingTextureResources.clear();
+	}
+
+	void CommandBundle::Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset)
+	{
+		DrawInstanced(aVertexCount, 1, aVertexStartOffset, 0);
+	}
+
+	void CommandBundle::DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation)
+	{
+		DrawIndexedInstanced(anIndexCount, 1, aStartIndexLocation, aBaseVertexLocation, 0);
+	}
+
+	void CommandBundle::DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation)
+	{
+		if (!CanRecord())
+			return;
+
+		if (!FlushPipelineResources())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->DrawInstanced(aVertexCountPerInstance, anInstanceCount, aStartVertexLocation, aStartInstanceLocation);
+	}
+
+	void CommandBundle::DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation)
+	{
+		if (!CanRecord())
+			return;
+
+		if (!FlushPipelineResources())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->DrawIndexedInstanced(anIndexCountPerInstance, anInstanceCount, aStartIndexLocation, aBaseVertexLocation, aStartInstanceLocation);
+	}
+
+	void CommandBundle::DrawIndexedInstancedBatch(std::span<const Atrium::FrameGraphicsContext::DrawIndexedArguments> someDraws)
+	{
+		if (!CanRecord())
+			return;
+
+		if (!FlushPipelineResources())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+		{
+			for (const Atrium::FrameGraphicsContext::DrawIndexedArguments& draw : someDraws)
+			{
+				commandList->DrawIndexedInstanced(
+					draw.IndexCountPerInstance,
+					draw.InstanceCount,
+					draw.StartIndexLocation,
+					draw.BaseVertexLocation,
+					draw.StartInstanceLocation
+				);
+			}
+		}
+	}
+
+	void CommandBundle::SetBlendFactor(ColorARGB<float> aBlendFactor)
+	{
+		if (!CanRecord())
+			return;
+
+		float color[4] = { aBlendFactor.R, aBlendFactor.G, aBlendFactor.B, aBlendFactor.A };
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->OMSetBlendFactor(color);
+	}
+
+	void CommandBundle::SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState)
+	{
+		Debug::Assert(!!aPipelineState, "SetPipelineState() requires pipeline state to be non-null.");
+		if (!CanRecord())
+			return;
+
+		myCurrentPipelineState = static_cast<DirectX12::PipelineState*>(aPipelineState.get());
+		Debug::Assert(!myCurrentPipelineState->IsCompute(), "Bundles only record graphics pipeline states.");
+		myReferencedObjects.push_back(aPipelineState);
+
+		// Each frame's list binds that frame's copy of the persistent region.
+		for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+		{
+			ID3D12GraphicsCommandList* commandList = myCommandLists[frameInFlight].Get();
+			commandList->SetPipelineState(myCurrentPipelineState->GetPipelineStateObject().Get());
+			commandList->SetGraphicsRootSignature(myCurrentPipelineState->GetRootSignature()->GetRootSignatureObject().Get());
+
+			for (unsigned int rootParameterIndex : myCurrentPipelineState->GetRootSignature()->GetBindlessTables())
+				commandList->SetGraphicsRootDescriptorTable(rootParameterIndex, myFrameRing.GetPersistentGPUStart(frameInFlight));
+		}
+	}
+
+	void CommandBundle::SetVertexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& aVertexBuffer, unsigned int aSlot)
+	{
+		Debug::Assert(!!aVertexBuffer, "Assumes a valid buffer.");
+		if (!CanRecord())
+			return;
+
+		if (std::optional<D3D12_VERTEX_BUFFER_VIEW> bufferView = static_cast<const GraphicsBuffer*>(aVertexBuffer.get())->GetVertexView())
+		{
+			myReferencedObjects.push_back(aVertexBuffer);
+			for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+				commandList->IASetVertexBuffers(aSlot, 1, &bufferView.value());
+		}
+		else
+		{
+			Debug::LogError("Tried to set graphics-buffer as a vertex-buffer, but it wasn't valid for that purpose.");
+		}
+	}
+
+	void CommandBundle::SetIndexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& anIndexBuffer)
+	{
+		Debug::Assert(!!anIndexBuffer, "Assumes a valid buffer.");
+		if (!CanRecord())
+			return;
+
+		if (std::optional<D3D12_INDEX_BUFFER_VIEW> bufferView = static_cast<const GraphicsBuffer*>(anIndexBuffer.get())->GetIndexView())
+		{
+			myReferencedObjects.push_back(anIndexBuffer);
+			for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+				commandList->IASetIndexBuffer(&bufferView.value());
+		}
+		else
+		{
+			Debug::LogError("Tried to set graphics-buffer as an index-buffer, but it wasn't valid for that purpose.");
+		}
+	}
+
+	void CommandBundle::SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues)
+	{
+		if (!CanRecord())
+			return;
+
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = GetParameterInfo(anUpdateFrequency, RootParameterMapping::RegisterType::ConstantBuffer, aRegisterIndex);
+		if (!parameterInfo.has_value())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->SetGraphicsRoot32BitConstants(parameterInfo.value().RootParameterIndex, Atrium::TruncateTo<UINT>(someValues.size()), someValues.data(), 0);
+	}
+
+	void CommandBundle::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer)
+	{
+		if (!CanRecord())
+			return;
+
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = GetParameterInfo(anUpdateFrequency, RootParameterMapping::RegisterType::ConstantBuffer, aRegisterIndex);
+		if (!parameterInfo.has_value())
+			return;
+
+		std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>& parameterBuffers = myPendingBufferResources[parameterInfo.value().RootParameterIndex];
+		parameterBuffers.resize(parameterInfo.value().Count);
+		parameterBuffers[parameterInfo.value().RegisterOffset] = aBuffer;
+	}
+
+	void CommandBundle::SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture)
+	{
+		if (!CanRecord())
+			return;
+
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = GetParameterInfo(anUpdateFrequency, RootParameterMapping::RegisterType::Texture, aRegisterIndex);
+		if (!parameterInfo.has_value())
+			return;
+
+		std::vector<std::shared_ptr<Atrium::Texture>>& parameterTextures = myPendingTextureResources[parameterInfo.value().RootParameterIndex];
+		parameterTextures.resize(parameterInfo.value().Count);
+		parameterTextures[parameterInfo.value().RegisterOffset] = aTexture;
+	}
+
+	void CommandBundle::SetPrimitiveTopology(PrimitiveTopology aTopology)
+	{
+		if (!CanRecord())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->IASetPrimitiveTopology(ToD3DPrimitiveTopology(aTopology));
+	}
+
+	void CommandBundle::SetStencilRef(std::uint32_t aStencilRef)
+	{
+		if (!CanRecord())
+			return;
+
+		for (ComPtr<ID3D12GraphicsCommandList>& commandList : myCommandLists)
+			commandList->OMSetStencilRef(aStencilRef);
+	}
+
+	std::optional<RootParameterMapping::ParameterInfo> CommandBundle::GetParameterInfo(ResourceUpdateFrequency anUpdateFrequency, RootParameterMapping::RegisterType aRegisterType, std::uint32_t aRegisterIndex) const
+	{
+		if (!myCurrentPipelineState)
+		{
+			Debug::LogError("A pipeline state has to be set before its resources.");
+			return { };
+		}
+
+		const std::optional<RootParameterMapping::ParameterInfo> parameterInfo = myCurrentPipelineState->GetRootSignature()->GetParameterInfo(anUpdateFrequency, aRegisterType, aRegisterIndex);
+		if (!parameterInfo.has_value())
+		{
+			const char registerName = aRegisterType == RootParameterMapping::RegisterType::Texture ? 't' : 'c';
+			Debug::LogError("Root parameter missing for register %c%i, space%i", registerName, aRegisterIndex, static_cast<unsigned int>(anUpdateFrequency));
+		}
+
+		return parameterInfo;
+	}
+
+	bool CommandBundle::CanRecord() const
+	{
+		return Debug::Verify(!myIsClosed, "Bundle is still open for recording.");
+	}
+
+	bool CommandBundle::FlushPipelineResources()
+	{
+		// Each frame's copy of a table holds the views that frame reads, such as the frame's copy of a constant buffer.
+		for (const auto& [rootParameterIndex, buffers] : myPendingBufferResources)
+		{
+			auto table = myBufferTables.find(buffers);
+			if (table == myBufferTables.end())
+			{
+				DescriptorHeapHandle handle = myFrameRing.AllocatePersistentBlock(Atrium::TruncateTo<std::uint32_t>(buffers.size()));
+				if (!handle.IsValid())
+					return false;
+
+				for (std::uint32_t i = 0; i < buffers.size(); ++i)
+				{
+					GraphicsBuffer* graphicsBuffer = static_cast<GraphicsBuffer*>(buffers.at(i).get());
+					Debug::Assert(graphicsBuffer, "Assumes non-null buffers.");
+
+					for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+						myDevice.GetDevice()->CopyDescriptorsSimple(1, myFrameRing.GetPersistentCPUHandle(handle.GetHeapIndex() + i, frameInFlight), graphicsBuffer->GetConstantViewHandle(frameInFlight).GetCPUHandle(), myFrameRing.GetHeapType());
+
+					myReferencedObjects.push_back(buffers.at(i));
+				}
+
+				table = myBufferTables.emplace(buffers, std::move(handle)).first;
+			}
+
+			for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+				myCommandLists[frameInFlight]->SetGraphicsRootDescriptorTable(rootParameterIndex, myFrameRing.GetPersistentGPUHandle(table->second.GetHeapIndex(), frameInFlight));
+		}
+
+		for (const auto& [rootParameterIndex, textures] : myPendingTextureResources)
+		{
+			auto table = myTextureTables.find(textures);
+			if (table == myTextureTables.end())
+			{
+				DescriptorHeapHandle handle = myFrameRing.AllocatePersistentBlock(Atrium::TruncateTo<std::uint32_t>(textures.size()));
+				if (!handle.IsValid())
+					return false;
+
+				for (std::uint32_t i = 0; i < textures.size(); ++i)
+				{
+					// Texture views are created once with the texture, so every frame gets the same one.
+					if (Atrium::Texture* texture = textures.at(i).get())
+					{
+						for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+							myDevice.GetDevice()->CopyDescriptorsSimple(1, myFrameRing.GetPersistentCPUHandle(handle.GetHeapIndex() + i, frameInFlight), static_cast<Texture*>(texture)->GetImage().GetSRVHandle().GetCPUHandle(), myFrameRing.GetHeapType());
+						myReferencedObjects.push_back(textures.at(i));
+					}
+					else
+					{
+						D3D12_SHADER_RESOURCE_VIEW_DESC nullDesc = { };
+						nullDesc.Format = DXGI_FORMAT_R8_UINT;
+						nullDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+						nullDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+						nullDesc.Texture2D.MipLevels = 1;
+
+						for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+							myDevice.GetDevice()->CreateShaderResourceView(nullptr, &nullDesc, myFrameRing.GetPersistentCPUHandle(handle.GetHeapIndex() + i, frameInFlight));
+					}
+				}
+
+				table = myTextureTables.emplace(textures, std::move(handle)).first;
+			}
+
+			for (std::uint_least8_t frameInFlight = 0; frameInFlight < myCommandLists.size(); ++frameInFlight)
+				myCommandLists[frameInFlight]->SetGraphicsRootDescriptorTable(rootParameterIndex, myFrameRing.GetPersistentGPUHandle(table->second.GetHeapIndex(), frameInFlight));
+		}
+
+		return true;
 	}
 }
@@ -4,6 +4,7 @@
 
 #include "Atrium_FrameContext.hpp"
 #include "Atrium_RenderTexture.hpp"
+#include "Atrium_ResourceStateTracker.hpp"
 
 #include "DX12_CommandQueue.hpp"
 #include "DX12_ComPtr.hpp"
@@ -17,6 +18,10 @@
 
 #include <array>
 #include <cstddef>
+#include <map>
+#include <optional>
+#include <span>
+#include <vector>
 
 // https://alextardif.com/D3D11To12P3.html
 // https://alextardif.com/DX12Tutorial.html
@@ -27,12 +32,29 @@ namespace Atrium::DirectX12
 
 	class FrameContext
 	{
-		static constexpr std::size_t ourMaxQueuedBarriers = 16u;
+		using StateTracker = ResourceStateTracker<GPUResource, D3D12_RESOURCE_STATES>;
 
 	public:
 		static constexpr std::size_t MaxTextureSubresourceCount = 32;
+
+		// States compute queues can transition resources from and to.
+		static constexpr D3D12_RESOURCE_STATES ComputeQueueStates = D3D12_RESOURCE_STATE_UNORDERED_ACCESS | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
+			D3D12_RESOURCE_STATE_COPY_DEST | D3D12_RESOURCE_STATE_COPY_SOURCE | D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT;
+
 		using SubresourceLayouts = std::array<D3D12_PLACED_SUBRESOURCE_FOOTPRINT, MaxTextureSubresourceCount>;
 
+		/**
+		 * @brief A box of pixels to copy into a subresource, from its own footprint in the source buffer.
+		 */
+		struct TextureRegionLayout
+		{
+			std::uint32_t Subresource = 0;
+			std::uint32_t X = 0;
+			std::uint32_t Y = 0;
+			std::uint32_t Z = 0;
+			D3D12_PLACED_SUBRESOURCE_FOOTPRINT Layout = { };
+		};
+
 	public:
 		FrameContext(Device& aDevice, CommandQueue& aCommandQueue);
 		virtual ~FrameContext() = default;
@@ -41,11 +63,35 @@ namespace Atrium::DirectX12
 		ID3D12GraphicsCommandList* GetCommandList() { return myCommandList.Get(); }
 
 		virtual void Reset(const std::uint_least8_t& aFrameInFlight);
-		void AddBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState);
+		void AddBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState, std::uint32_t aSubresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+		void BeginSplitBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState, std::uint32_t aSubresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+		void EndSplitBarrier(GPUResource& aResource, D3D12_RESOURCE_STATES aNewState);
 		void FlushBarriers();
+
+		/**
+		 * @brief Record the transitions from the resources' shared states to the states this context first uses them in,
+		 *        and update the shared states with the states the context leaves them in.
+		 *        Call in submission order, right before submitting the context.
+		 *
+		 *        Compute contexts can't transition from or to states only the graphics queue uses, such as a pixel shader resource or render target.
+		 *        Those transitions go to GetGraphicsQueueBarrierCommandList() instead, if HasGraphicsQueueBarriers().
+		 *
+		 * @return Whether any transitions were recorded, in which case GetInitialBarrierCommandList() has to be submitted before the context.
+		 */
+		bool RecordInitialBarriers();
+		ID3D12GraphicsCommandList* GetInitialBarrierCommandList() { return myInitialBarrierCommandList.Get(); }
+
+		/**
+		 * @brief Check whether RecordInitialBarriers() recorded transitions for the graphics queue,
+		 *        which then has to run GetGraphicsQueueBarrierCommandList() before the context is submitted.
+		 */
+		bool HasGraphicsQueueBarriers() const { return myHasGraphicsQueueBarriers; }
+		ID3D12GraphicsCommandList* GetGraphicsQueueBarrierCommandList() { return myGraphicsQueueBarrierCommandList.Get(); }
+
 		void CopyResource(const GPUResource& aSource, GPUResource& aDestination);
 		void CopyBufferRegion(const GPUResource& aSource, std::size_t aSourceOffset, GPUResource& aDestination, std::size_t aDestinationOffset, std::size_t aByteCountToCopy);
 		void CopyTextureRegion(GPUResource& aSource, std::size_t aSourceOffset, SubresourceLayouts& someSubResourceLayouts, std::uint32_t aSubresourceCount, GPUResource& aDestination);
+		void CopyTextureRegion(GPUResource& aSource, std::size_t aSourceOffset, std::span<const TextureRegionLayout> someRegions, GPUResource& aDestination);
 
 	protected:
 		void BindDescriptorHeaps();
@@ -59,20 +105,46 @@ namespace Atrium::DirectX12
 		ComPtr<ID3D12GraphicsCommandList6> myCommandList;
 		std::vector<ComPtr<ID3D12CommandAllocator>> myFrameCommandAllocators;
 
-		RenderPassDescriptorHeap* myCurrentFrameHeap;
+		FrameDescriptorRing& myFrameRing;
+		std::uint_least8_t myFrameInFlight;
+
+	private:
+		void QueueTransitions(D3D12_RESOURCE_BARRIER_FLAGS someFlags);
+
+		StateTracker myStateTracker;
+		std::vector<StateTracker::Transition> myTransitions;
+		std::vector<D3D12_RESOURCE_BARRIER> myQueuedBarriers;
+
+		std::map<ID3D12Resource*, std::vector<D3D12_RESOURCE_BARRIER>> myBegunSplitBarriers;
+
+		ComPtr<ID3D12GraphicsCommandList> myInitialBarrierCommandList;
+		std::vector<ComPtr<ID3D12CommandAllocator>> myFrameInitialBarrierAllocators;
 
-		std::array<D3D12_RESOURCE_BARRIER, ourMaxQueuedBarriers> myResourceBarrierQueue;
-		std::size_t myQueuedBarriers = 0;
+		// Only created for compute contexts.
+		ComPtr<ID3D12GraphicsCommandList> myGraphicsQueueBarrierCommandList;
+		std::vector<ComPtr<ID3D12CommandAllocator>> myFrameGraphicsQueueBarrierAllocators;
+		bool myHasGraphicsQueueBarriers;
 	};
 
+	/**
+	 * @brief Copies CPU data into GPU resources, submitted on the graphics queue ahead of the frame's contexts.
+	 *        Being on the same queue as the draws orders each copy after earlier frames are done reading the resource,
+	 *        and lets resources be transitioned to the copy destination state and back.
+	 */
 	class UploadContext final : public FrameContext
 	{
+	public:
+		// Size of each frame's upload heaps. A single upload has to fit in one.
+		static constexpr std::size_t BufferUploadHeapSize = 10 * 1024 * 1024;
+		static constexpr std::size_t TextureUploadHeapSize = 40 * 1024 * 1024;
+
 	public:
 		struct BufferUpload
 		{
 			std::shared_ptr<GPUResource> Resource;
-			std::unique_ptr<std::uint8_t> BufferData;
+			std::unique_ptr<std::uint8_t[]> BufferData;
 			std::size_t BufferSize = 0;
+			std::size_t DestinationOffset = 0;
 		};
 
 		struct TextureUpload
@@ -83,24 +155,42 @@ namespace Atrium::DirectX12
 			}
 
 			std::shared_ptr<GPUResource> Resource;
-			std::unique_ptr<std::uint8_t> BufferData;
+			std::unique_ptr<std::uint8_t[]> BufferData;
 			std::uint64_t BufferSize = 0;
 			std::uint32_t SubresourceCount = 0;
 			SubresourceLayouts SubresourceLayouts;
+
+			// When set, only these regions are copied instead of the first SubresourceCount whole subresources.
+			std::vector<TextureRegionLayout> Regions;
 		};
 
 	public:
 		UploadContext(Device& aDevice, CommandQueue& aCommandQueue);
 		~UploadContext();
 
-		//void AddUpload(Buffer);
+		/**
+		 * @brief Queue a copy of CPU data into a buffer. A write overlapping or touching the latest one queued for the same buffer is merged into it.
+		 *
+		 * @param aResource The buffer to write.
+		 * @param aDataPtr The data to copy, which is copied into the queue right away.
+		 * @param aDataSize Size of the data in bytes, at most BufferUploadHeapSize.
+		 * @param aDestinationOffset Byte offset in the buffer to write at.
+		 */
+		void AddBufferUpload(const std::shared_ptr<GPUResource>& aResource, const void* aDataPtr, std::size_t aDataSize, std::size_t aDestinationOffset);
 		TextureUpload& AddTextureUpload();
-		void ProcessUploads();
+
+		/**
+		 * @brief Record the copies of the queued uploads that fit in this frame's upload heaps. The rest wait for the next frame.
+		 *
+		 * @return Whether any copies were recorded.
+		 */
+		bool ProcessUploads();
 		void ResolveUploads();
 
 	private:
-		std::unique_ptr<BackendGraphicsBuffer> myBufferUploadHeap;
-		std::unique_ptr<BackendGraphicsBuffer> myTextureUploadHeap;
+		// Each frame in flight has its own heaps, as the GPU may still be copying out of the previous frames'.
+		std::vector<std::unique_ptr<BackendGraphicsBuffer>> myBufferUploadHeaps;
+		std::vector<std::unique_ptr<BackendGraphicsBuffer>> myTextureUploadHeaps;
 
 		std::vector<std::shared_ptr<GPUResource>> myBufferUploadsInProgress;
 		std::vector<std::shared_ptr<GPUResource>> myTextureUploadsInProgress;
@@ -109,18 +199,94 @@ namespace Atrium::DirectX12
 		std::vector<TextureUpload> myTextureUploads;
 	};
 
-	class FrameGraphicsContext final : public FrameContext, public Atrium::FrameGraphicsContext
+	/**
+	 * @brief Frame context able to bind pipeline states and shader resources.
+	 *        Shared by the graphics and compute contexts.
+	 */
+	class PipelineFrameContext : public FrameContext
+	{
+	public:
+		PipelineFrameContext(Device& aDevice, CommandQueue& aCommandQueue);
+
+		void Reset(const std::uint_least8_t& aFrameInFlight) override;
+
+		/**
+		 * @brief Make the context's submission wait for another context's submission, every frame.
+		 *        Contexts are submitted in creation order, except that the other context is moved ahead of this one if needed.
+		 */
+		void AddDependency(const PipelineFrameContext& aContext);
+		const std::vector<const PipelineFrameContext*>& GetDependencies() const { return myDependencies; }
+
+		/**
+		 * @brief Check whether the context is another context, or waits for it through its dependencies.
+		 */
+		bool DependsOn(const PipelineFrameContext& aContext) const;
+
+	protected:
+		static inline std::uint32_t GetGroupCount(std::uint32_t threadCount, std::uint32_t groupSize) { return (threadCount + groupSize - 1) / groupSize; }
+
+		void RecordProfileZone(Atrium::FrameGraphicsContext::ProfileContextZone& aZoneScope
+		#ifdef TRACY_ENABLE
+			, const tracy::SourceLocationData& aLocation
+		#endif
+		);
+
+		void RecordDispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ);
+		void RecordDispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset);
+
+		void BindPipelineState(PipelineState& aPipelineState);
+		void BindPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues);
+		void QueuePipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer);
+		void QueuePipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture);
+		void BindPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer);
+
+		/**
+		 * @brief Transition the buffers of an indirect draw or dispatch for reading the arguments, after a shader may have written them.
+		 */
+		void TransitionIndirectArguments(Atrium::GraphicsBuffer& anArgumentBuffer, Atrium::GraphicsBuffer* aCountBuffer);
+
+		/**
+		 * @brief Bind descriptor tables for the queued resources.
+		 *
+		 * @return Whether all tables were bound. When the frame's descriptors ran out the draw or dispatch has to be skipped,
+		 *         since the tables of an earlier one would still be bound.
+		 */
+		bool FlushPipelineResources();
+
+		PipelineState* myCurrentPipelineState;
+
+	private:
+		bool FlushPipelineConstantBuffers();
+		bool FlushPipelineTextures();
+		void SetRootDescriptorTable(UINT aRootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE aHandle);
+
+		std::vector<const PipelineFrameContext*> myDependencies;
+
+		std::map<std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>, DescriptorHeapBlock> myBufferHeapHandles;
+		std::map<std::vector<std::shared_ptr<Atrium::Texture>>, DescriptorHeapBlock> myTextureHeapHandles;
+
+		std::map<std::uint32_t, std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>> myPendingBufferResources;
+		std::map<std::uint32_t, std::vector<std::shared_ptr<Atrium::Texture>>> myPendingTextureResources;
+
+		// Bound through root descriptors, which don't keep the buffers alive until the frame is done.
+		std::vector<std::shared_ptr<Atrium::GraphicsBuffer>> myUnorderedAccessBuffers;
+	};
+
+	class FrameComputeContext;
+	class FrameGraphicsContext final : public PipelineFrameContext, public Atrium::FrameGraphicsContext
 	{
 	public:
 		FrameGraphicsContext(Device& aDevice, CommandQueue& aCommandQueue);
 
+		void Reset(const std::uint_least8_t& aFrameInFlight) override;
+
 		void BeginProfileZone(ProfileContextZone& aZoneScope
 		#ifdef TRACY_ENABLE
 			, const tracy::SourceLocationData& aLocation
 		#endif
 		) override;
 
-		void Reset(const std::uint_least8_t& aFrameInFlight) override;
+		void AddDependency(const std::shared_ptr<Atrium::FrameComputeContext>& aContext) override;
 
 		void ClearColor(const std::shared_ptr<Atrium::RenderTexture>& aTarget, ColorARGB<float> aClearColor) override;
 		void ClearDepth(const std::shared_ptr<Atrium::RenderTexture>& aTarget, float aDepth, std::uint8_t aStencil) override;
@@ -131,36 +297,124 @@ namespace Atrium::DirectX12
 		void Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX) override;
 		void Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY) override;
 		void Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ) override;
+		void DispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset) override;
+
+		void ExecuteBundle(const std::shared_ptr<Atrium::CommandBundle>& aBundle) override;
 
 		void Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset) override;
 		void DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation) override;
 		void DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation) override;
 		void DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation) override;
+		void DrawIndexedInstancedBatch(std::span<const DrawIndexedArguments> someDraws) override;
+		void DrawIndexedInstancedIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDrawCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset) override;
 
 		void SetBlendFactor(ColorARGB<float> aBlendFactor) override;
 		void SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState) override;
 		void SetVertexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& aVertexBuffer, unsigned int aSlot) override;
+		void SetIndexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& anIndexBuffer) override;
+		void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) override;
 		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer) override;
 		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture) override;
+		void SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer) override;
 		void SetPrimitiveTopology(PrimitiveTopology aTopology) override;
 		void SetScissorRect(const Rectangle<int>& aRectangle) override;
 		void SetStencilRef(std::uint32_t aStencilRef) override;
 		void SetRenderTargets(const std::vector<std::shared_ptr<Atrium::RenderTexture>>& someTargets, const std::shared_ptr<Atrium::RenderTexture>& aDepthTarget) override;
 		void SetViewportAndScissorRect(const Vector2<int>& aScreenSize) override;
 		void SetViewport(const Rectangle<float>& aRectangle) override;
+		void TransitionResources(std::span<const ResourceTransition> someTransitions, TransitionTiming aTiming) override;
 
 	private:
-		inline std::uint32_t GetGroupCount(std::uint32_t threadCount, std::uint32_t groupSize) { return (threadCount + groupSize - 1) / groupSize; }
-		void FlushPipelineConstantBuffers();
-		void FlushPipelineTextures();
-		void FlushPipelineResources();
+		std::vector<std::vector<std::shared_ptr<Atrium::CommandBundle>>> myFrameExecutedBundles;
+	};
 
-		PipelineState* myCurrentPipelineState;
+	class FrameComputeContext final : public PipelineFrameContext, public Atrium::FrameComputeContext
+	{
+	public:
+		FrameComputeContext(Device& aDevice, CommandQueue& aCommandQueue);
+
+		void BeginProfileZone(Atrium::FrameGraphicsContext::ProfileContextZone& aZoneScope
+		#ifdef TRACY_ENABLE
+			, const tracy::SourceLocationData& aLocation
+		#endif
+		) override;
+
+		void AddDependency(const std::shared_ptr<Atrium::FrameGraphicsContext>& aContext) override;
+
+		void Dispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ) override;
+		void Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX) override;
+		void Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY) override;
+		void Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ) override;
+		void DispatchIndirect(const std::shared_ptr<Atrium::GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset, const std::shared_ptr<Atrium::GraphicsBuffer>& aCountBuffer, std::uint32_t aCountOffset) override;
+
+		void SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState) override;
+		void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) override;
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer) override;
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture) override;
+		void SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer) override;
+	};
+
+	/**
+	 * @brief Records to a D3D12 bundle, replayed by graphics contexts with ExecuteBundle().
+	 *        Commands are recorded once per frame in flight, so each frame's copy binds that frame's copy of the persistent region
+	 *        and of per-frame constant buffers. Descriptor tables are built in the persistent region of the frame descriptor ring,
+	 *        as the bundle outlives any frame, and are released when the bundle is destroyed.
+	 *        Bundles can't contain profiling zones or barriers, so nothing here is profiled or transitioned.
+	 */
+	class CommandBundle final : public Atrium::CommandBundle
+	{
+	public:
+		CommandBundle(Device& aDevice);
+		~CommandBundle() override;
+
+		ID3D12GraphicsCommandList* GetCommandList(std::uint_least8_t aFrameInFlight) { return myCommandLists[aFrameInFlight].Get(); }
+
+		/**
+		 * @brief Pipeline state the bundle leaves bound after it has executed, if it sets any.
+		 */
+		PipelineState* GetPipelineState() const { return myCurrentPipelineState; }
 
-		std::map<std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>, DescriptorHeapHandle> myBufferHeapHandles;
-		std::map<std::vector<std::shared_ptr<Atrium::Texture>>, DescriptorHeapHandle> myTextureHeapHandles;
+		void Close() override;
+		bool IsClosed() const override { return myIsClosed; }
+
+		void Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset) override;
+		void DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation) override;
+		void DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation) override;
+		void DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation) override;
+		void DrawIndexedInstancedBatch(std::span<const Atrium::FrameGraphicsContext::DrawIndexedArguments> someDraws) override;
+
+		void SetBlendFactor(ColorARGB<float> aBlendFactor) override;
+		void SetPipelineState(const std::shared_ptr<Atrium::PipelineState>& aPipelineState) override;
+		void SetVertexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& aVertexBuffer, unsigned int aSlot) override;
+		void SetIndexBuffer(const std::shared_ptr<const Atrium::GraphicsBuffer>& anIndexBuffer) override;
+		void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) override;
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::GraphicsBuffer>& aBuffer) override;
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Atrium::Texture>& aTexture) override;
+		void SetPrimitiveTopology(PrimitiveTopology aTopology) override;
+		void SetStencilRef(std::uint32_t aStencilRef) override;
+
+	private:
+		std::optional<RootParameterMapping::ParameterInfo> GetParameterInfo(ResourceUpdateFrequency anUpdateFrequency, RootParameterMapping::RegisterType aRegisterType, std::uint32_t aRegisterIndex) const;
+		bool CanRecord() const;
+		bool FlushPipelineResources();
+
+		Device& myDevice;
+		FrameDescriptorRing& myFrameRing;
+
+		std::vector<ComPtr<ID3D12CommandAllocator>> myCommandAllocators;
+		std::vector<ComPtr<ID3D12GraphicsCommandList>> myCommandLists;
+
+		PipelineState* myCurrentPipelineState;
 
 		std::map<std::uint32_t, std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>> myPendingBufferResources;
 		std::map<std::uint32_t, std::vector<std::shared_ptr<Atrium::Texture>>> myPendingTextureResources;
+
+		std::map<std::vector<std::shared_ptr<Atrium::GraphicsBuffer>>, DescriptorHeapHandle> myBufferTables;
+		std::map<std::vector<std::shared_ptr<Atrium::Texture>>, DescriptorHeapHandle> myTextureTables;
+
+		// Everything the recorded commands refer to, kept alive for as long as the bundle can be replayed.
+		std::vector<std::shared_ptr<const void>> myReferencedObjects;
+
+		bool myIsClosed;
 	};
-}
\ No newline at end of file
+}
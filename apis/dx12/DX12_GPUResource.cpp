@@ -6,22 +6,25 @@
 
 #include "D3D12MemAlloc.h"
 
+#include <algorithm>
+
 namespace Atrium::DirectX12
 {
 	GPUResource::GPUResource(const ComPtr<ID3D12Resource>& aResource, D3D12_RESOURCE_STATES aUsageState)
 		: myResource(aResource)
-		, myUsageState(aUsageState)
 	{
 		Debug::Assert(aResource != nullptr, "Requires a valid resource.");
+
+		ResetSubresourceStates(aUsageState);
 	}
 
 	GPUResource::GPUResource(const ComPtr<D3D12MA::Allocation>& anAllocation, D3D12_RESOURCE_STATES aUsageState)
 		: myAllocation(anAllocation)
-		, myUsageState(aUsageState)
 	{
 		Debug::Assert(anAllocation != nullptr, "Requires a valid allocation.");
 
 		myResource = anAllocation->GetResource();
+		ResetSubresourceStates(aUsageState);
 	}
 
 	GPUResource::~GPUResource()
@@ -39,37 +42,6 @@ namespace Atrium::DirectX12
 		return GetResource()->GetGPUVirtualAddress();
 	}
 
-	std::optional<D3D12_RESOURCE_BARRIER> GPUResource::UpdateUsageState(D3D12_RESOURCE_STATES aNewState)
-	{
-		if (myUsageState != aNewState)
-		{
-			D3D12_RESOURCE_BARRIER barrier;
-
-			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
-			barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-			barrier.Transition.pResource = GetResource().Get();
-			barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-			barrier.Transition.StateBefore = myUsageState;
-			barrier.Transition.StateAfter = aNewState;
-
-			myUsageState = aNewState;
-
-			return barrier;
-		}
-		else if (aNewState == D3D12_RESOURCE_STATE_UNORDERED_ACCESS)
-		{
-			D3D12_RESOURCE_BARRIER barrier;
-
-			barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-			barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-			barrier.UAV.pResource = GetResource().Get();
-
-			return barrier;
-		}
-
-		return { };
-	}
-
 	void GPUResource::SetName(const std::wstring_view& aName)
 	{
 		if (myAllocation)
@@ -84,6 +56,28 @@ namespace Atrium::DirectX12
 			myAllocation->SetResource(aResource.Get());
 
 		myResource = aResource;
-		myUsageState = aCurrentUsageState;
+		ResetSubresourceStates(aCurrentUsageState);
+	}
+
+	void GPUResource::ResetSubresourceStates(D3D12_RESOURCE_STATES aUsageState)
+	{
+		if (!myResource)
+		{
+			mySubresourceStates.assign(1, aUsageState);
+			return;
+		}
+
+		// Planes of depth-stencil formats aren't counted, so subresources here are mip levels of array slices.
+		// Whole-resource transitions still cover every plane.
+		const D3D12_RESOURCE_DESC description = myResource->GetDesc();
+
+		std::uint32_t subresourceCount = 1;
+		if (description.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+		{
+			const std::uint32_t arraySize = description.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1 : description.DepthOrArraySize;
+			subresourceCount = std::max<std::uint32_t>(description.MipLevels, 1) * arraySize;
+		}
+
+		mySubresourceStates.assign(subresourceCount, aUsageState);
 	}
 }
@@ -6,8 +6,9 @@
 
 #include <d3d12.h>
 
-#include <optional>
+#include <span>
 #include <string_view>
+#include <vector>
 
 namespace D3D12MA { class Allocation; }
 
@@ -25,18 +26,27 @@ namespace Atrium::DirectX12
 
 		D3D12_GPU_VIRTUAL_ADDRESS GetGPUAddress() const;
 
-		inline D3D12_RESOURCE_STATES GetUsageState() const { return myUsageState; }
+		/**
+		 * @brief State of the first subresource, as of the last submitted command list.
+		 */
+		inline D3D12_RESOURCE_STATES GetUsageState() const { return mySubresourceStates.front(); }
 
-		[[nodiscard]]
-		std::optional<D3D12_RESOURCE_BARRIER> UpdateUsageState(D3D12_RESOURCE_STATES aNewState);
+		/**
+		 * @brief States of each subresource as of the last submitted command list.
+		 *        Only updated when contexts are submitted, contexts track their own states while recording.
+		 */
+		std::span<D3D12_RESOURCE_STATES> GetSubresourceStates() { return mySubresourceStates; }
+		std::uint32_t GetSubresourceCount() const { return static_cast<std::uint32_t>(mySubresourceStates.size()); }
 
 		void SetName(const std::wstring_view& aName);
 
 		void SetResource(const ComPtr<ID3D12Resource>& aResource, D3D12_RESOURCE_STATES aCurrentUsageState);
 
 	private:
+		void ResetSubresourceStates(D3D12_RESOURCE_STATES aUsageState);
+
 		ComPtr<D3D12MA::Allocation> myAllocation;
 		ComPtr<ID3D12Resource> myResource;
-		D3D12_RESOURCE_STATES myUsageState;
+		std::vector<D3D12_RESOURCE_STATES> mySubresourceStates;
 	};
 }
@@ -6,9 +6,12 @@
 #include "DX12_Manager.hpp"
 #include "DX12_MemoryAlignment.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Atrium::DirectX12
 {
-	BackendGraphicsBuffer::BackendGraphicsBuffer(Device& aDevice, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride)
+	BackendGraphicsBuffer::BackendGraphicsBuffer(Device& aDevice, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, D3D12_HEAP_TYPE aHeapType)
 		: myCount(aCount)
 		, myStride(aStride)
 		, myMappedBuffer(nullptr)
@@ -17,24 +20,30 @@ namespace Atrium::DirectX12
 			= GraphicsBuffer::Target::Constant
 			| GraphicsBuffer::Target::Index
 			| GraphicsBuffer::Target::Vertex
+			| GraphicsBuffer::Target::IndirectArguments
+			| GraphicsBuffer::Target::UnorderedAccess
 			;
 
 		Debug::Assert(
 			(aTarget & ~SupportedTargets) == GraphicsBuffer::Target::None,
-			"Supported targets: Constant, Index, Vertex"
+			"Supported targets: Constant, Index, Vertex, IndirectArguments, UnorderedAccess"
 		);
 
+		const bool isUnorderedAccess = (aTarget & GraphicsBuffer::Target::UnorderedAccess) != GraphicsBuffer::Target::None;
+		Debug::Assert(!isUnorderedAccess || aHeapType == D3D12_HEAP_TYPE_DEFAULT, "Only device-local buffers can be written by shaders.");
+
 		const std::uint32_t alignedSize =
 			(aTarget & GraphicsBuffer::Target::Constant) != GraphicsBuffer::Target::None
 			? Align<std::uint32_t>(aCount * aStride, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT)
 			: aCount * aStride;
 
-		D3D12_RESOURCE_STATES usageState = D3D12_RESOURCE_STATE_GENERIC_READ;
+		// Upload heap buffers have to stay readable, device-local ones are transitioned by the upload context when written.
+		D3D12_RESOURCE_STATES usageState = aHeapType == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON;
 
-		if ((aTarget & GraphicsBuffer::Target::Index) != GraphicsBuffer::Target::None)
+		if (aHeapType == D3D12_HEAP_TYPE_UPLOAD && (aTarget & GraphicsBuffer::Target::Index) != GraphicsBuffer::Target::None)
 			usageState |= D3D12_RESOURCE_STATE_INDEX_BUFFER;
 
-		CreateResource(aDevice, usageState, alignedSize);
+		CreateResource(aDevice, usageState, alignedSize, aHeapType, isUnorderedAccess ? D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS : D3D12_RESOURCE_FLAG_NONE);
 
 		if ((aTarget & GraphicsBuffer::Target::Vertex) != GraphicsBuffer::Target::None)
 			CreateVertexView(aCount, aStride);
@@ -72,13 +81,8 @@ namespace Atrium::DirectX12
 			myStride * myCount,
 			aDestinationOffset + aDataSize);
 
+		// Views keep covering the whole buffer, as a write can update only part of it.
 		std::memcpy((char*)myMappedBuffer + aDestinationOffset, aDataPtr, aDataSize);
-
-		if (myIndexView)
-			myIndexView.value().SizeInBytes = aDataSize;
-
-		if (myVertexView)
-			myVertexView.value().SizeInBytes = aDataSize;
 	}
 
 	void BackendGraphicsBuffer::Unmap()
@@ -102,16 +106,16 @@ namespace Atrium::DirectX12
 
 	void BackendGraphicsBuffer::CreateIndexView(std::uint32_t aCount, std::uint32_t aStride)
 	{
-		Debug::Assert(sizeof(std::uint32_t) == aStride, "Assumes indices to be uint32.");
+		Debug::Assert(aStride == sizeof(std::uint16_t) || aStride == sizeof(std::uint32_t), "Indices are either uint16 or uint32.");
 
 		D3D12_INDEX_BUFFER_VIEW indexView;
-		indexView.SizeInBytes = aCount * sizeof(std::uint32_t);
-		indexView.Format = DXGI_FORMAT_R32_UINT;
+		indexView.SizeInBytes = aCount * aStride;
+		indexView.Format = aStride == sizeof(std::uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
 		indexView.BufferLocation = myResource->GetGPUAddress();
 		myIndexView = indexView;
 	}
 
-	void BackendGraphicsBuffer::CreateResource(Device& aDevice, D3D12_RESOURCE_STATES aUsageState, std::uint32_t anAlignedSize)
+	void BackendGraphicsBuffer::CreateResource(Device& aDevice, D3D12_RESOURCE_STATES aUsageState, std::uint32_t anAlignedSize, D3D12_HEAP_TYPE aHeapType, D3D12_RESOURCE_FLAGS someFlags)
 	{
 		D3D12_RESOURCE_DESC bufferDesc;
 		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
@@ -124,9 +128,9 @@ namespace Atrium::DirectX12
 		bufferDesc.SampleDesc.Count = 1;
 		bufferDesc.SampleDesc.Quality = 0;
 		bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		bufferDesc.Flags = someFlags;
 
-		myResource = aDevice.CreateResource(&bufferDesc, aUsageState, NULL, D3D12_HEAP_TYPE_UPLOAD);
+		myResource = aDevice.CreateResource(&bufferDesc, aUsageState, NULL, aHeapType);
 	}
 
 	void BackendGraphicsBuffer::CreateVertexView(std::uint32_t aCount, std::uint32_t aStride)
@@ -138,14 +142,90 @@ namespace Atrium::DirectX12
 		myVertexView = vertexView;
 	}
 
-	GraphicsBuffer::GraphicsBuffer(DirectX12API& anAPI, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride)
+	GraphicsBuffer::GraphicsBuffer(DirectX12API& anAPI, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, GraphicsBuffer::Mode aMode)
 		: myAPI(anAPI)
 		, myLastWrittenBuffer(nullptr)
 		, myTarget(aTarget)
+		, myMode(aMode)
 		, myCount(aCount)
 		, myStride(aStride)
 	{
-		myBuffers.resize(DirectX12API::GetFramesInFlightAmount());
+		const bool isConstant = (myTarget & GraphicsBuffer::Target::Constant) != GraphicsBuffer::Target::None;
+
+		Debug::Assert(
+			(myTarget & GraphicsBuffer::Target::UnorderedAccess) == GraphicsBuffer::Target::None || myMode == GraphicsBuffer::Mode::Dynamic,
+			"UnorderedAccess buffers are written by the GPU, so they use the Dynamic mode's single device-local buffer.");
+
+		if (myMode == GraphicsBuffer::Mode::Dynamic)
+		{
+			// Writes are copied in on the GPU, ordered after earlier frames' reads, so a single buffer serves every frame.
+			myBuffers.emplace_back(new BackendGraphicsBuffer(myAPI.GetDevice(), myTarget, myCount, myStride, D3D12_HEAP_TYPE_DEFAULT));
+			myLastWrittenBuffer = myBuffers.front().get();
+		}
+		else
+		{
+			myBuffers.resize(DirectX12API::GetFramesInFlightAmount());
+
+			// Constant buffers get every copy up front, so their bindless descriptor can be written for every frame before any frame reads it.
+			if (isConstant)
+			{
+				for (std::shared_ptr<BackendGraphicsBuffer>& buffer : myBuffers)
+					buffer.reset(new BackendGraphicsBuffer(myAPI.GetDevice(), myTarget, myCount, myStride));
+			}
+		}
+
+		// Direct bindings, bundles and the bindless descriptor all read the frame's own copy of a constant buffer.
+		// Writes are replayed into the other copies as their frames start, so a buffer written once reads the same in every frame.
+		if (isConstant)
+		{
+			Debug::Assert(myBuffers.size() <= 32, "Every frame in flight has a bit in a pending write's mask.");
+
+			FrameDescriptorRing& frameRing = myAPI.GetDevice().GetDescriptorHeapManager().GetFrameRing();
+			myBindlessHandle = frameRing.AllocatePersistent();
+			if (myBindlessHandle.IsValid())
+			{
+				for (std::uint_least8_t frameInFlight = 0; frameInFlight < DirectX12API::GetFramesInFlightAmount(); ++frameInFlight)
+					frameRing.CopyPersistent(myBindlessHandle, GetConstantViewHandle(frameInFlight).GetCPUHandle(), 1, frameInFlight);
+			}
+		}
+	}
+
+	GraphicsBuffer::~GraphicsBuffer()
+	{
+		myAPI.RemoveBufferWithPendingWrites(*this);
+	}
+
+	bool GraphicsBuffer::ApplyPendingWrites(std::uint_least8_t aFrameInFlight)
+	{
+		std::scoped_lock lock(myPendingWritesMutex);
+
+		BackendGraphicsBuffer& frameBuffer = *myBuffers[aFrameInFlight];
+		if (!frameBuffer.IsMapped())
+			frameBuffer.Map();
+
+		const std::uint32_t frameBit = 1u << aFrameInFlight;
+
+		// Writes are applied in the order they were made, so later writes to the same range win.
+		for (PendingWrite& write : myPendingWrites)
+		{
+			if ((write.MissingBuffers & frameBit) == 0)
+				continue;
+
+			frameBuffer.SetData(write.Data.data(), static_cast<std::uint32_t>(write.Data.size()), write.Offset);
+			write.MissingBuffers &= ~frameBit;
+		}
+
+		std::erase_if(myPendingWrites, [](const PendingWrite& aWrite) { return aWrite.MissingBuffers == 0; });
+
+		return !myPendingWrites.empty();
+	}
+
+	std::optional<std::uint32_t> GraphicsBuffer::GetBindlessIndex() const
+	{
+		if (!myBindlessHandle.IsValid())
+			return { };
+
+		return myBindlessHandle.GetHeapIndex();
 	}
 
 	void* GraphicsBuffer::GetNativeBufferPtr()
@@ -158,10 +238,48 @@ namespace Atrium::DirectX12
 
 	void GraphicsBuffer::SetData(const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset)
 	{
+		if (myMode == GraphicsBuffer::Mode::Dynamic)
+		{
+			Debug::Assert(
+				(aDataSize + aDestinationOffset) <= (myStride * myCount),
+				"Expects aDestinationOffset + aDataSize to not be greater than the buffer size %i, but was %i.",
+				myStride * myCount,
+				aDestinationOffset + aDataSize);
+
+			// Large writes are split, as each upload has to fit in the upload heap.
+			const std::uint8_t* data = static_cast<const std::uint8_t*>(aDataPtr);
+			for (std::size_t uploaded = 0; uploaded < aDataSize; uploaded += UploadContext::BufferUploadHeapSize)
+			{
+				const std::size_t uploadSize = (std::min)(aDataSize - uploaded, UploadContext::BufferUploadHeapSize);
+				myAPI.GetUploadContext().AddBufferUpload(myBuffers.front()->GetResource(), data + uploaded, uploadSize, aDestinationOffset + uploaded);
+			}
+
+			return;
+		}
+
+		// PerFrame buffers live in upload heaps, which can stay mapped for their whole lifetime.
+		// Mapping only once keeps buffers rewritten every frame, such as sprite and instance data, cheap to update.
 		BackendGraphicsBuffer& frameBuffer = GetBufferForWrite();
-		frameBuffer.Map();
+		if (!frameBuffer.IsMapped())
+			frameBuffer.Map();
+
 		frameBuffer.SetData(aDataPtr, aDataSize, aDestinationOffset);
-		frameBuffer.Unmap();
+
+		// Registered after the write is logged, without holding the log's lock, as frame starts take the locks in the other order.
+		if ((myTarget & GraphicsBuffer::Target::Constant) != GraphicsBuffer::Target::None && AddPendingWrite(myAPI.GetFrameInFlight(), aDataPtr, aDataSize, aDestinationOffset))
+			myAPI.AddBufferWithPendingWrites(*this);
+	}
+
+	std::span<std::byte> GraphicsBuffer::GetWritableData()
+	{
+		Debug::Assert(myMode == GraphicsBuffer::Mode::PerFrame, "Dynamic buffers are written with SetData(), which stages the written ranges.");
+		Debug::Assert((myTarget & GraphicsBuffer::Target::Constant) == GraphicsBuffer::Target::None, "Constant buffers are written with SetData(), which keeps every frame's copy up to date.");
+
+		BackendGraphicsBuffer& frameBuffer = GetBufferForWrite();
+		if (!frameBuffer.IsMapped())
+			frameBuffer.Map();
+
+		return frameBuffer.GetMappedData();
 	}
 
 	void GraphicsBuffer::SetName(const wchar_t* aName)
@@ -178,6 +296,9 @@ namespace Atrium::DirectX12
 		if (!myLastWrittenBuffer)
 			throw std::runtime_error("Buffer was never written to; There is no buffer to read.");
 
+		if ((myTarget & GraphicsBuffer::Target::Constant) != GraphicsBuffer::Target::None && myMode == GraphicsBuffer::Mode::PerFrame)
+			return *myBuffers[myAPI.GetFrameInFlight()];
+
 		return *myLastWrittenBuffer;
 	}
 
@@ -194,4 +315,27 @@ namespace Atrium::DirectX12
 
 		return *myLastWrittenBuffer;
 	}
+
+	bool GraphicsBuffer::AddPendingWrite(std::uint_least8_t aFrameInFlight, const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset)
+	{
+		const std::uint32_t allBuffers = static_cast<std::uint32_t>((1ull << myBuffers.size()) - 1);
+		const std::uint32_t missingBuffers = allBuffers & ~(1u << aFrameInFlight);
+		if (missingBuffers == 0 || aDataSize == 0)
+			return false;
+
+		std::scoped_lock lock(myPendingWritesMutex);
+
+		// The current copy was brought up to date when its frame started, so every earlier write is missing from at most the same copies.
+		// Those entirely covered by this one are superseded.
+		std::erase_if(myPendingWrites, [aDestinationOffset, end = aDestinationOffset + aDataSize](const PendingWrite& aWrite) {
+			return aWrite.Offset >= aDestinationOffset && aWrite.Offset + aWrite.Data.size() <= end;
+		});
+
+		const std::byte* data = static_cast<const std::byte*>(aDataPtr);
+		myPendingWrites.push_back(PendingWrite { aDestinationOffset, std::vector<std::byte>(data, data + aDataSize), missingBuffers });
+
+		PROFILE_PLOT("Constant buffer pending writes", static_cast<std::int64_t>(myPendingWrites.size()));
+
+		return true;
+	}
 }
@@ -10,6 +10,7 @@
 
 #include <d3d12.h>
 
+#include <mutex>
 #include <vector>
 
 namespace Atrium::DirectX12
@@ -20,7 +21,7 @@ namespace Atrium::DirectX12
 	class BackendGraphicsBuffer
 	{
 	public:
-		BackendGraphicsBuffer(Device& aDevice, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride);
+		BackendGraphicsBuffer(Device& aDevice, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, D3D12_HEAP_TYPE aHeapType = D3D12_HEAP_TYPE_UPLOAD);
 
 		~BackendGraphicsBuffer();
 
@@ -33,6 +34,9 @@ namespace Atrium::DirectX12
 
 		std::shared_ptr<GPUResource> GetResource() { return myResource; }
 
+		bool IsMapped() const { return myMappedBuffer != nullptr; }
+		std::span<std::byte> GetMappedData() const { return { static_cast<std::byte*>(myMappedBuffer), IsMapped() ? myCount * myStride : 0u }; }
+
 		void Map();
 		void SetData(const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset);
 		void Unmap();
@@ -40,7 +44,7 @@ namespace Atrium::DirectX12
 	protected:
 		void CreateConstantView(Device& aDevice, std::uint32_t anAlignedSize);
 		void CreateIndexView(std::uint32_t aCount, std::uint32_t aStride);
-		void CreateResource(Device& aDevice, D3D12_RESOURCE_STATES aUsageState, std::uint32_t anAlignedSize);
+		void CreateResource(Device& aDevice, D3D12_RESOURCE_STATES aUsageState, std::uint32_t anAlignedSize, D3D12_HEAP_TYPE aHeapType, D3D12_RESOURCE_FLAGS someFlags);
 		void CreateVertexView(std::uint32_t aCount, std::uint32_t aStride);
 
 	private:
@@ -58,32 +62,77 @@ namespace Atrium::DirectX12
 	class GraphicsBuffer : public Atrium::GraphicsBuffer
 	{
 	public:
-		GraphicsBuffer(DirectX12API& anAPI, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride);
+		GraphicsBuffer(DirectX12API& anAPI, GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, GraphicsBuffer::Mode aMode);
+		~GraphicsBuffer();
+
+		/**
+		 * @brief Make the writes a frame's copy is missing, once the GPU is done reading it.
+		 *
+		 * @param aFrameInFlight The frame whose copy to update.
+		 * @return Whether some copy is still missing writes.
+		 */
+		bool ApplyPendingWrites(std::uint_least8_t aFrameInFlight);
 
 		const DescriptorHeapHandle GetConstantViewHandle() const { return GetBufferForRead().GetConstantViewHandle(); }
+
+		/**
+		 * @brief Get the view of the copy a frame in flight reads. Only constant buffers have every copy from creation.
+		 *        Constant buffers keep every copy up to date, so this is the copy any read in that frame gets.
+		 */
+		const DescriptorHeapHandle GetConstantViewHandle(std::uint_least8_t aFrameInFlight) const { return myBuffers[aFrameInFlight % myBuffers.size()]->GetConstantViewHandle(); }
 		std::optional<D3D12_INDEX_BUFFER_VIEW> GetIndexView() const { return GetBufferForRead().GetIndexView(); }
 		std::optional<D3D12_VERTEX_BUFFER_VIEW> GetVertexView() const { return GetBufferForRead().GetVertexView(); }
 
+		/**
+		 * @brief Get the resource of a Dynamic buffer, which lives in device-local memory and is transitioned between states as it's used.
+		 *
+		 * @return The resource, or null for PerFrame buffers, whose upload heap copies stay in the generic read state.
+		 */
+		GPUResource* GetTransitionableResource() const { return myMode == GraphicsBuffer::Mode::Dynamic ? myBuffers.front()->GetResource().get() : nullptr; }
+		GraphicsBuffer::Target GetTarget() const { return myTarget; }
+
 		// Implementing Atrium::GraphicsBuffer
 	public:
 		std::uint32_t GetCount() const override { return myCount; }
 		std::uint32_t GetStride() const override { return myStride; }
 
+		std::optional<std::uint32_t> GetBindlessIndex() const override;
 		void* GetNativeBufferPtr() override;
 
 		void SetData(const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset) override;
+		std::span<std::byte> GetWritableData() override;
 		void SetName(const wchar_t* aName) override;
 
 	private:
+		// A write to a PerFrame constant buffer, kept until every frame's copy has it.
+		struct PendingWrite
+		{
+			std::size_t Offset;
+			std::vector<std::byte> Data;
+
+			// Bit per frame in flight, set for the copies the write hasn't been made to yet.
+			std::uint32_t MissingBuffers;
+		};
+
 		BackendGraphicsBuffer& GetBufferForRead() const;
 		BackendGraphicsBuffer& GetBufferForWrite();
 
+		bool AddPendingWrite(std::uint_least8_t aFrameInFlight, const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset);
+
 		DirectX12API& myAPI;
 
+		// A copy per frame in flight for PerFrame buffers, a single device-local buffer for Dynamic ones.
 		std::vector<std::shared_ptr<BackendGraphicsBuffer>> myBuffers;
 		BackendGraphicsBuffer* myLastWrittenBuffer;
 
+		// Shared by every copy, each frame's copy of the persistent region holds the view of that frame's copy.
+		DescriptorHeapHandle myBindlessHandle;
+
+		std::mutex myPendingWritesMutex;
+		std::vector<PendingWrite> myPendingWrites;
+
 		GraphicsBuffer::Target myTarget;
+		GraphicsBuffer::Mode myMode;
 		std::uint32_t myCount;
 		std::uint32_t myStride;
 	};
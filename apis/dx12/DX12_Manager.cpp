@@ -15,6 +15,8 @@
 #endif
 
 #include <algorithm>
+#include <map>
+#include <utility>
 
 namespace Atrium::DirectX12
 {
@@ -29,7 +31,8 @@ namespace Atrium::DirectX12
 	}
 
 	DirectX12API::DirectX12API()
-		: myFrameIndex(static_cast<std::uint64_t>(-1))
+		: myIsRecordingFrame(false)
+		, myFrameIndex(static_cast<std::uint64_t>(-1))
 		, myFrameInFlight(0)
 	{
 		PROFILE_SCOPE();
@@ -38,7 +41,6 @@ namespace Atrium::DirectX12
 		for (auto& frameEndFence : myFrameEndFences)
 		{
 			frameEndFence.ComputeQueue = 0;
-			frameEndFence.CopyQueue = 0;
 			frameEndFence.GraphicsQueue = 0;
 		}
 
@@ -49,7 +51,7 @@ namespace Atrium::DirectX12
 		myCommandQueueManager.reset(new CommandQueueManager(myDevice->GetDevice()));
 
 		myPresentPrepareContext.reset(new FrameGraphicsContext(*myDevice, myCommandQueueManager->GetGraphicsQueue()));
-		myUploadContext.reset(new UploadContext(*myDevice, myCommandQueueManager->GetCopyQueue()));
+		myUploadContext.reset(new UploadContext(*myDevice, myCommandQueueManager->GetGraphicsQueue()));
 
 		myResourceManager.reset(new DirectX12::ResourceManager(*this));
 	}
@@ -64,7 +66,7 @@ namespace Atrium::DirectX12
 
 		myUploadContext.reset();
 		myPresentPrepareContext.reset();
-		myFrameGraphicsContexts.clear();
+		myFrameContexts.clear();
 
 		myCommandQueueManager.reset();
 
@@ -75,9 +77,55 @@ namespace Atrium::DirectX12
 
 	std::shared_ptr<Atrium::FrameGraphicsContext> DirectX12API::CreateFrameGraphicsContext()
 	{
-		return myFrameGraphicsContexts.emplace_back(
-			new FrameGraphicsContext(*myDevice, myCommandQueueManager->GetGraphicsQueue())
-		);
+		std::shared_ptr<FrameGraphicsContext> context(new FrameGraphicsContext(*myDevice, myCommandQueueManager->GetGraphicsQueue()));
+		myFrameContexts.emplace_back(context);
+		return context;
+	}
+
+	std::shared_ptr<Atrium::FrameComputeContext> DirectX12API::CreateFrameComputeContext()
+	{
+		std::shared_ptr<FrameComputeContext> context(new FrameComputeContext(*myDevice, myCommandQueueManager->GetComputeQueue()));
+		myFrameContexts.emplace_back(context);
+		return context;
+	}
+
+	std::shared_ptr<Atrium::CommandBundle> DirectX12API::CreateCommandBundle()
+	{
+		return std::make_shared<CommandBundle>(*myDevice);
+	}
+
+	Atrium::GraphicsAPI::TimelinePoint DirectX12API::InsertSignal(QueueType aQueue)
+	{
+		CommandQueue& queue = GetQueue(aQueue);
+
+		// Points are on the queues' timeline fences, so their values are known before the signals are inserted.
+		// Reserved under the lock, so the pending signals stay in the order of their values.
+		std::scoped_lock lock(myPendingSignalsMutex);
+		const TimelinePoint point { aQueue, queue.ReserveTimelineValue() };
+
+		// Signals made while a frame is recorded wait for MarkFrameEnd() to submit its contexts.
+		if (myIsRecordingFrame)
+			myPendingSignals.push_back(point);
+		else
+			queue.InsertTimelineSignal(point.Value);
+
+		return point;
+	}
+
+	void DirectX12API::InsertWait(QueueType aQueue, const TimelinePoint& aPoint)
+	{
+		GetQueue(aQueue).InsertWaitForTimelineValue(GetQueue(aPoint.Queue), aPoint.Value);
+	}
+
+	bool DirectX12API::IsComplete(const TimelinePoint& aPoint) const
+	{
+		return GetQueue(aPoint.Queue).IsTimelineValueComplete(aPoint.Value);
+	}
+
+	bool DirectX12API::WaitForCompletion(const TimelinePoint& aPoint, std::chrono::milliseconds aTimeout) const
+	{
+		PROFILE_SCOPE();
+		return GetQueue(aPoint.Queue).WaitForTimelineValueCPUBlocking(aPoint.Value, aTimeout);
 	}
 
 	std::uint_least64_t DirectX12API::GetCurrentFrameIndex() const
@@ -96,19 +144,34 @@ namespace Atrium::DirectX12
 			PROFILE_SCOPE_NAME("Waiting for previous frame");
 
 			myCommandQueueManager->GetComputeQueue().WaitForFenceCPUBlocking(myFrameEndFences[myFrameInFlight].ComputeQueue);
-			myCommandQueueManager->GetCopyQueue().WaitForFenceCPUBlocking(myFrameEndFences[myFrameInFlight].CopyQueue);
 			myCommandQueueManager->GetGraphicsQueue().WaitForFenceCPUBlocking(myFrameEndFences[myFrameInFlight].GraphicsQueue);
 		}
 
-		myDevice->GetDescriptorHeapManager().GetFrameHeap(myFrameInFlight).Reset();
+		{
+			FrameDescriptorRing& frameRing = myDevice->GetDescriptorHeapManager().GetFrameRing();
+			frameRing.BeginFrame(myFrameInFlight);
+			PROFILE_PLOT("Frame descriptors used", static_cast<std::int64_t>(frameRing.GetLastFrameUsage()));
+			PROFILE_PLOT("Frame descriptors high-water mark", static_cast<std::int64_t>(frameRing.GetHighWaterMark()));
+		}
+
+		{
+			PROFILE_SCOPE_NAME("Apply pending buffer writes");
+
+			// The GPU is done with this frame's copies, so they can be brought up to date before anything records reads of them.
+			std::scoped_lock lock(myBuffersWithPendingWritesMutex);
+			std::erase_if(myBuffersWithPendingWrites, [&](GraphicsBuffer* aBuffer) { return !aBuffer->ApplyPendingWrites(myFrameInFlight); });
+		}
 
 		myUploadContext->ResolveUploads();
 		myUploadContext->Reset(myFrameInFlight);
-		for (auto& contextIterator : myFrameGraphicsContexts)
+		for (auto& contextIterator : myFrameContexts)
 			contextIterator->Reset(myFrameInFlight);
 		myPresentPrepareContext->Reset(myFrameInFlight);
 
 		HandleSwapChainResize();
+
+		std::scoped_lock lock(myPendingSignalsMutex);
+		myIsRecordingFrame = true;
 	}
 
 	void DirectX12API::MarkFrameEnd()
@@ -117,20 +180,39 @@ namespace Atrium::DirectX12
 
 		{
 			PROFILE_SCOPE_NAME("Process uploads");
-			myUploadContext->ProcessUploads();
-			myFrameEndFences[myFrameInFlight].CopyQueue = myCommandQueueManager->GetCopyQueue().ExecuteCommandList(myUploadContext->GetCommandList());
+			const bool hasUploads = myUploadContext->ProcessUploads();
+
+			std::vector<ComPtr<ID3D12CommandList>> commandLists;
+			if (myUploadContext->RecordInitialBarriers())
+				commandLists.emplace_back(myUploadContext->GetInitialBarrierCommandList());
+			commandLists.emplace_back(myUploadContext->GetCommandList());
+
+			CommandQueue& graphicsQueue = myCommandQueueManager->GetGraphicsQueue();
+			CommandQueue& computeQueue = myCommandQueueManager->GetComputeQueue();
+
+			// Dynamic buffers have a single copy, so the copies wait for earlier frames' compute contexts to be done reading them.
+			if (hasUploads)
+				graphicsQueue.InsertWaitForQueue(computeQueue);
+
+			const std::uint64_t uploadFence = graphicsQueue.ExecuteCommandLists(commandLists);
+			myFrameEndFences[myFrameInFlight].GraphicsQueue = uploadFence;
+
+			// Graphics contexts are ordered after the uploads by the queue, compute contexts have to wait for them.
+			if (hasUploads)
+				computeQueue.InsertWaitForQueueFence(graphicsQueue, uploadFence);
 		}
 
 		// Submit the frame's work.
-		{
-			PROFILE_SCOPE_NAME("Submit graphic commands");
+		SubmitFrameContexts();
 
-			std::vector<ComPtr<ID3D12CommandList>> commandLists;
-			commandLists.reserve(myFrameGraphicsContexts.size());
-			for (const auto& context : myFrameGraphicsContexts)
-				commandLists.emplace_back(context->GetCommandList());
+		{
+			// Timeline values were reserved in the order the signals were made, which they're inserted in too.
+			std::scoped_lock lock(myPendingSignalsMutex);
+			for (const TimelinePoint& signal : myPendingSignals)
+				GetQueue(signal.Queue).InsertTimelineSignal(signal.Value);
 
-			myFrameEndFences[myFrameInFlight].GraphicsQueue = myCommandQueueManager->GetGraphicsQueue().ExecuteCommandLists(commandLists);
+			myPendingSignals.clear();
+			myIsRecordingFrame = false;
 		}
 
 		// Record used swapchains and make them ready to present.
@@ -148,7 +230,12 @@ namespace Atrium::DirectX12
 
 			myPresentPrepareContext->FlushBarriers();
 
-			myFrameEndFences[myFrameInFlight].GraphicsQueue = myCommandQueueManager->GetGraphicsQueue().ExecuteCommandList(myPresentPrepareContext->GetCommandList());
+			std::vector<ComPtr<ID3D12CommandList>> commandLists;
+			if (myPresentPrepareContext->RecordInitialBarriers())
+				commandLists.emplace_back(myPresentPrepareContext->GetInitialBarrierCommandList());
+			commandLists.emplace_back(myPresentPrepareContext->GetCommandList());
+
+			myFrameEndFences[myFrameInFlight].GraphicsQueue = myCommandQueueManager->GetGraphicsQueue().ExecuteCommandLists(commandLists);
 		}
 
 		{
@@ -167,11 +254,139 @@ namespace Atrium::DirectX12
 		TracyD3D12NewFrame(myCommandQueueManager->GetGraphicsQueue().GetProfilingContext());
 	}
 
+	void DirectX12API::AddBufferWithPendingWrites(GraphicsBuffer& aBuffer)
+	{
+		std::scoped_lock lock(myBuffersWithPendingWritesMutex);
+		if (std::find(myBuffersWithPendingWrites.begin(), myBuffersWithPendingWrites.end(), &aBuffer) == myBuffersWithPendingWrites.end())
+			myBuffersWithPendingWrites.push_back(&aBuffer);
+	}
+
+	void DirectX12API::RemoveBufferWithPendingWrites(GraphicsBuffer& aBuffer)
+	{
+		std::scoped_lock lock(myBuffersWithPendingWritesMutex);
+		std::erase(myBuffersWithPendingWrites, &aBuffer);
+	}
+
 	void DirectX12API::WaitForIdle() const
 	{
 		myCommandQueueManager->WaitForAllIdle();
 	}
 
+	void DirectX12API::SubmitFrameContexts()
+	{
+		PROFILE_SCOPE_NAME("Submit frame commands");
+
+		// Contexts are submitted in creation order, except that dependencies are moved ahead of the contexts depending on them.
+		// Resources' shared states are resolved in that order too, which then matches the order the GPU runs the contexts in.
+		std::vector<PipelineFrameContext*> submissionOrder;
+		{
+			std::map<const PipelineFrameContext*, PipelineFrameContext*> contexts;
+			for (const auto& context : myFrameContexts)
+				contexts.emplace(context.get(), context.get());
+
+			std::map<const PipelineFrameContext*, bool> isVisited;
+			const auto visit = [&](const auto& aVisit, PipelineFrameContext* aContext) -> void {
+				if (std::exchange(isVisited[aContext], true))
+					return;
+
+				for (const PipelineFrameContext* dependency : aContext->GetDependencies())
+				{
+					if (const auto dependencyContext = contexts.find(dependency); dependencyContext != contexts.end())
+						aVisit(aVisit, dependencyContext->second);
+				}
+
+				submissionOrder.push_back(aContext);
+			};
+
+			for (const auto& context : myFrameContexts)
+				visit(visit, context.get());
+		}
+
+		// Consecutive contexts on the same queue are batched into one submission,
+		// which is split wherever a context has to wait for another queue.
+		std::map<const PipelineFrameContext*, std::uint64_t> submittedFences;
+		std::vector<const PipelineFrameContext*> batchContexts;
+		std::vector<ComPtr<ID3D12CommandList>> batchCommandLists;
+		CommandQueue* batchQueue = nullptr;
+
+		const auto flushBatch = [&]() {
+			if (batchCommandLists.empty())
+				return;
+
+			const std::uint64_t fence = batchQueue->ExecuteCommandLists(batchCommandLists);
+			for (const PipelineFrameContext* context : batchContexts)
+				submittedFences[context] = fence;
+
+			if (batchQueue == &myCommandQueueManager->GetComputeQueue())
+				myFrameEndFences[myFrameInFlight].ComputeQueue = fence;
+			else
+				myFrameEndFences[myFrameInFlight].GraphicsQueue = fence;
+
+			batchContexts.clear();
+			batchCommandLists.clear();
+		};
+
+		for (PipelineFrameContext* context : submissionOrder)
+		{
+			// Resources' shared states are resolved right before each context.
+			const bool hasInitialBarriers = context->RecordInitialBarriers();
+
+			CommandQueue* queue = myCommandQueueManager->GetQueue(context->GetCommandType());
+			if (queue != batchQueue || !context->GetDependencies().empty() || context->HasGraphicsQueueBarriers())
+			{
+				flushBatch();
+				batchQueue = queue;
+			}
+
+			// Transitions the compute queue can't make run on the graphics queue, after the graphics work submitted so far.
+			if (context->HasGraphicsQueueBarriers())
+			{
+				CommandQueue& graphicsQueue = myCommandQueueManager->GetGraphicsQueue();
+
+				std::vector<ComPtr<ID3D12CommandList>> barrierCommandLists { context->GetGraphicsQueueBarrierCommandList() };
+				const std::uint64_t barrierFence = graphicsQueue.ExecuteCommandLists(barrierCommandLists);
+				myFrameEndFences[myFrameInFlight].GraphicsQueue = barrierFence;
+
+				queue->InsertWaitForQueueFence(graphicsQueue, barrierFence);
+			}
+
+			for (const PipelineFrameContext* dependency : context->GetDependencies())
+			{
+				if (dependency->GetCommandType() == context->GetCommandType())
+					continue; // Same queue, already ordered by submission.
+
+				// Dependencies are submitted first, as AddDependency() refuses cycles.
+				const auto fenceIterator = submittedFences.find(dependency);
+				if (fenceIterator == submittedFences.end())
+					continue;
+
+				queue->InsertWaitForQueueFence(*myCommandQueueManager->GetQueue(dependency->GetCommandType()), fenceIterator->second);
+			}
+
+			if (hasInitialBarriers)
+				batchCommandLists.emplace_back(context->GetInitialBarrierCommandList());
+
+			batchContexts.push_back(context);
+			batchCommandLists.emplace_back(context->GetCommandList());
+		}
+
+		flushBatch();
+	}
+
+	CommandQueue& DirectX12API::GetQueue(QueueType aQueue) const
+	{
+		switch (aQueue)
+		{
+			case QueueType::Compute:
+				return myCommandQueueManager->GetComputeQueue();
+			case QueueType::Copy:
+				return myCommandQueueManager->GetCopyQueue();
+			case QueueType::Graphics:
+			default:
+				return myCommandQueueManager->GetGraphicsQueue();
+		}
+	}
+
 	void DirectX12API::HandleSwapChainResize()
 	{
 		const std::vector<std::shared_ptr<SwapChain>> swapchains = myResourceManager->GetSwapChains();
@@ -12,10 +12,13 @@
 #include <d3d12.h>
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace Atrium::DirectX12
 {
 	class Device;
+	class GraphicsBuffer;
 	class RootSignature;
 
 	class DirectX12API final : public Atrium::GraphicsAPI
@@ -35,14 +38,29 @@ namespace Atrium::DirectX12
 
 		UploadContext& GetUploadContext() { return *myUploadContext; }
 
+		/**
+		 * @brief Track a buffer with writes some frames' copies are missing, which are made to each copy when its frame starts.
+		 */
+		void AddBufferWithPendingWrites(GraphicsBuffer& aBuffer);
+		void RemoveBufferWithPendingWrites(GraphicsBuffer& aBuffer);
+
 		// Implementing Atrium::GraphicsAPI
 	public:
 		std::shared_ptr<Atrium::FrameGraphicsContext> CreateFrameGraphicsContext() override;
+		std::shared_ptr<Atrium::FrameComputeContext> CreateFrameComputeContext() override;
+		std::shared_ptr<Atrium::CommandBundle> CreateCommandBundle() override;
+
+		TimelinePoint InsertSignal(QueueType aQueue) override;
+		void InsertWait(QueueType aQueue, const TimelinePoint& aPoint) override;
+		bool IsComplete(const TimelinePoint& aPoint) const override;
+		bool WaitForCompletion(const TimelinePoint& aPoint, std::chrono::milliseconds aTimeout = std::chrono::milliseconds::max()) const override;
 
 		std::uint_least64_t GetCurrentFrameIndex() const override;
+		std::size_t GetFramesInFlightCount() const override { return GetFramesInFlightAmount(); }
 
 		GraphicsAPI::ResourceManager& GetResourceManager() override { return *myResourceManager; }
 
+		bool SupportsBindlessResources() const override { return true; }
 		bool SupportsMultipleWindows() const override { return true; }
 
 		void MarkFrameStart() override;
@@ -51,7 +69,9 @@ namespace Atrium::DirectX12
 		void WaitForIdle() const override;
 
 	private:
+		CommandQueue& GetQueue(QueueType aQueue) const;
 		void HandleSwapChainResize();
+		void SubmitFrameContexts();
 		void ReportUnreleasedObjects();
 
 	private:
@@ -60,18 +80,26 @@ namespace Atrium::DirectX12
 		std::unique_ptr<CommandQueueManager> myCommandQueueManager;
 
 		std::unique_ptr<FrameGraphicsContext> myPresentPrepareContext;
-		std::vector<std::shared_ptr<FrameGraphicsContext>> myFrameGraphicsContexts;
+		std::vector<std::shared_ptr<PipelineFrameContext>> myFrameContexts;
 		std::unique_ptr<UploadContext> myUploadContext;
 
+		// Buffers can be written from any thread.
+		std::mutex myBuffersWithPendingWritesMutex;
+		std::vector<GraphicsBuffer*> myBuffersWithPendingWrites;
+
 		struct FrameEndFences
 		{
 			std::uint64_t ComputeQueue;
-			std::uint64_t CopyQueue;
 			std::uint64_t GraphicsQueue;
 		};
 
 		std::vector<FrameEndFences> myFrameEndFences;
 
+		// Signals made while a frame is recorded, inserted once its contexts are submitted.
+		std::mutex myPendingSignalsMutex;
+		std::vector<TimelinePoint> myPendingSignals;
+		bool myIsRecordingFrame;
+
 		std::uint_least64_t myFrameIndex;
 		std::uint_least8_t myFrameInFlight;
 
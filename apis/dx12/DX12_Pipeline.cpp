@@ -33,6 +33,11 @@ namespace Atrium::DirectX12
 		return table;
 	}
 
+	void RootParameterMapping::AddBindlessTable()
+	{
+		myBindlessTables.push_back(GetNextParameterIndex());
+	}
+
 	std::optional<RootParameterMapping::ParameterInfo> RootParameterMapping::GetParameterInfo(ResourceUpdateFrequency anUpdateFrequency, RegisterType aRegisterType, unsigned int aRegisterIndex) const
 	{
 		for (const auto& param : mySingleParameters)
@@ -75,7 +80,7 @@ namespace Atrium::DirectX12
 
 	unsigned int RootParameterMapping::GetNextParameterIndex() const
 	{
-		return static_cast<unsigned int>(mySingleParameters.size() + myTableParameters.size());
+		return static_cast<unsigned int>(mySingleParameters.size() + myTableParameters.size() + myBindlessTables.size());
 	}
 
 	RootSignatureCreator::Sampler::Sampler(D3D12_STATIC_SAMPLER_DESC& aDescriptor)
@@ -172,6 +177,12 @@ namespace Atrium::DirectX12
 			unsigned int descriptorRangeCount = 0;
 			for (const std::unique_ptr<Parameter>& param : myParameters)
 			{
+				if (param->myType == Parameter::Type::Bindless)
+				{
+					descriptorRangeCount += 2;
+					continue;
+				}
+
 				if (param->myType != Parameter::Type::Table)
 					continue;
 
@@ -186,7 +197,15 @@ namespace Atrium::DirectX12
 
 		std::vector<D3D12_ROOT_PARAMETER1> parameters;
 		{
-			parameters.reserve(myParameters.size());
+			// Bindless parameters expand into two root parameters, which are taken by reference below.
+			std::size_t parameterCount = myParameters.size();
+			for (const std::unique_ptr<Parameter>& param : myParameters)
+			{
+				if (param->myType == Parameter::Type::Bindless)
+					parameterCount++;
+			}
+
+			parameters.reserve(parameterCount);
 
 			for (const std::unique_ptr<Parameter>& param : myParameters)
 			{
@@ -217,6 +236,17 @@ namespace Atrium::DirectX12
 							return nullptr; // Table details were wrong, abort.
 						break;
 					}
+					case Parameter::Type::Bindless:
+					{
+						rootParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+						PopulateBindlessTable(parameterMapping, descriptorRanges, rootParameter, *param, D3D12_DESCRIPTOR_RANGE_TYPE_SRV);
+
+						D3D12_ROOT_PARAMETER1& constantBufferParameter = parameters.emplace_back();
+						constantBufferParameter.ShaderVisibility = param->myVisibility;
+						constantBufferParameter.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+						PopulateBindlessTable(parameterMapping, descriptorRanges, constantBufferParameter, *param, D3D12_DESCRIPTOR_RANGE_TYPE_CBV);
+						break;
+					}
 					case Parameter::Type::CBV:
 					case Parameter::Type::SRV:
 					case Parameter::Type::UAV:
@@ -317,6 +347,11 @@ namespace Atrium::DirectX12
 	{
 	}
 
+	void RootSignatureCreator::AddBindlessTables(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency)
+	{
+		AddParameter(Parameter::Type::Bindless, aRegister, anUpdateFrequency);
+	}
+
 	void RootSignatureCreator::AddCBV(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency)
 	{
 		AddParameter(Parameter::Type::CBV, aRegister, anUpdateFrequency);
@@ -432,6 +467,24 @@ namespace Atrium::DirectX12
 		return true;
 	}
 
+	void RootSignatureCreator::PopulateBindlessTable(RootParameterMapping& aParameterMapping, std::vector<D3D12_DESCRIPTOR_RANGE1>& someRanges, D3D12_ROOT_PARAMETER1& aResult, const Parameter& aParameter, D3D12_DESCRIPTOR_RANGE_TYPE aRangeType)
+	{
+		aParameterMapping.AddBindlessTable();
+
+		// The table is bound at the start of the persistent region, so descriptor N is the resource with bindless index N.
+		// Persistent descriptors may be rewritten while a table is bound, such as when a texture is re-applied.
+		D3D12_DESCRIPTOR_RANGE1& descriptorRange = someRanges.emplace_back();
+		descriptorRange.RangeType = aRangeType;
+		descriptorRange.BaseShaderRegister = aParameter.myShaderRegister;
+		descriptorRange.RegisterSpace = static_cast<unsigned int>(aParameter.myUpdateFrequency);
+		descriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE;
+		descriptorRange.NumDescriptors = UINT_MAX;
+		descriptorRange.OffsetInDescriptorsFromTableStart = 0;
+
+		aResult.DescriptorTable.NumDescriptorRanges = 1;
+		aResult.DescriptorTable.pDescriptorRanges = &descriptorRange;
+	}
+
 	std::shared_ptr<PipelineState> PipelineState::CreateFrom(ID3D12Device& aDevice, const PipelineStateDescription& aPipelineStateDescription)
 	{
 		if (!aPipelineStateDescription.IsValid())
@@ -562,6 +615,38 @@ namespace Atrium::DirectX12
 		}
 	}
 
+	std::shared_ptr<PipelineState> PipelineState::CreateFrom(ID3D12Device& aDevice, const ComputePipelineStateDescription& aPipelineStateDescription)
+	{
+		if (!aPipelineStateDescription.IsValid())
+		{
+			Debug::LogError("Compute pipeline state description requires a root signature and compute shader to be valid.");
+			return nullptr;
+		}
+
+		std::shared_ptr<PipelineState> createdPipelineState(new PipelineState());
+		createdPipelineState->myRootSignature = std::static_pointer_cast<RootSignature>(aPipelineStateDescription.RootSignature);
+		createdPipelineState->myComputeShader = std::static_pointer_cast<DirectX12::Shader>(aPipelineStateDescription.ComputeShader);
+
+		D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+		psoDesc.pRootSignature = createdPipelineState->myRootSignature->GetRootSignatureObject().Get();
+		psoDesc.CS = createdPipelineState->myComputeShader->GetByteCode();
+		psoDesc.NodeMask = 0;
+		psoDesc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+		if (!Debug::Verify(
+			aDevice.CreateComputePipelineState(
+				&psoDesc,
+				IID_PPV_ARGS(
+					createdPipelineState->myPipelineState.ReleaseAndGetAddressOf()
+				)
+			), "Create compute pipeline state"))
+		{
+			return nullptr;
+		}
+
+		return createdPipelineState;
+	}
+
 	D3D12_BLEND PipelineState::ToDXBlend(PipelineStateDescription::BlendFactor aFactor)
 	{
 		switch (aFactor)
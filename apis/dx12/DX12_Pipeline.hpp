@@ -71,6 +71,13 @@ namespace Atrium::DirectX12
 
 		Table& AddTable();
 
+		/**
+		 * @brief Add a descriptor table covering the persistent region of the frame descriptor ring.
+		 */
+		void AddBindlessTable();
+
+		const std::vector<unsigned int>& GetBindlessTables() const { return myBindlessTables; }
+
 		std::optional<ParameterInfo> GetParameterInfo(
 			ResourceUpdateFrequency anUpdateFrequency,
 			RegisterType aRegisterType,
@@ -82,6 +89,7 @@ namespace Atrium::DirectX12
 
 		std::vector<std::pair<Parameter, unsigned int>> mySingleParameters;
 		std::vector<Table> myTableParameters;
+		std::vector<unsigned int> myBindlessTables;
 	};
 
 	class RootSignature : public Atrium::RootSignature
@@ -100,6 +108,8 @@ namespace Atrium::DirectX12
 			return myParameterMapping.GetParameterInfo(anUpdateFrequency, aRegisterType, aRegisterIndex);
 		}
 
+		const std::vector<unsigned int>& GetBindlessTables() const { return myParameterMapping.GetBindlessTables(); }
+
 	private:
 		RootSignature(ComPtr<ID3D12RootSignature> aRootSignature, const RootParameterMapping& aParameterMapping)
 			: myRootSignature(aRootSignature)
@@ -121,7 +131,7 @@ namespace Atrium::DirectX12
 			virtual ~Parameter() = default;
 
 		protected:
-			enum class Type { Table, Constant, CBV, SRV, UAV, Sampler } myType = Type::Constant;
+			enum class Type { Table, Bindless, Constant, CBV, SRV, UAV, Sampler } myType = Type::Constant;
 
 			unsigned int myShaderRegister = 0;
 			ResourceUpdateFrequency myUpdateFrequency = ResourceUpdateFrequency::PerObject;
@@ -183,6 +193,7 @@ namespace Atrium::DirectX12
 	public:
 		RootSignatureCreator(ID3D12Device* aDevice);
 
+		void AddBindlessTables(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) override;
 		void AddCBV(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) override;
 		void AddConstant(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) override;
 		void AddConstants(unsigned int aCount, unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) override;
@@ -200,6 +211,7 @@ namespace Atrium::DirectX12
 
 	private:
 		static bool PopulateTable(RootParameterMapping& aParameterMapping, std::vector<D3D12_DESCRIPTOR_RANGE1>& someRanges, D3D12_ROOT_PARAMETER1& aResult, const DescriptorTable& aTable);
+		static void PopulateBindlessTable(RootParameterMapping& aParameterMapping, std::vector<D3D12_DESCRIPTOR_RANGE1>& someRanges, D3D12_ROOT_PARAMETER1& aResult, const Parameter& aParameter, D3D12_DESCRIPTOR_RANGE_TYPE aRangeType);
 
 		Parameter& AddParameter(Parameter::Type aType, unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency)
 		{
@@ -232,12 +244,16 @@ namespace Atrium::DirectX12
 	{
 	public:
 		static std::shared_ptr<PipelineState> CreateFrom(ID3D12Device& aDevice, const PipelineStateDescription& aPipelineStateDescription);
+		static std::shared_ptr<PipelineState> CreateFrom(ID3D12Device& aDevice, const ComputePipelineStateDescription& aPipelineStateDescription);
 
 		const ComPtr<ID3D12PipelineState>& GetPipelineStateObject() const { return myPipelineState; }
 		const std::shared_ptr<RootSignature>& GetRootSignature() const { return myRootSignature; }
 
 		const std::shared_ptr<DirectX12::Shader>& GetVertexShader() const { return myVertexShader; }
 		const std::shared_ptr<DirectX12::Shader>& GetPixelShader() const { return myPixelShader; }
+		const std::shared_ptr<DirectX12::Shader>& GetComputeShader() const { return myComputeShader; }
+
+		bool IsCompute() const { return myComputeShader != nullptr; }
 
 	private:
 		PipelineState() = default;
@@ -249,5 +265,6 @@ namespace Atrium::DirectX12
 
 		std::shared_ptr<RootSignature> myRootSignature;
 		std::shared_ptr<DirectX12::Shader> myVertexShader, myPixelShader;
+		std::shared_ptr<DirectX12::Shader> myComputeShader;
 	};
 }
\ No newline at end of file
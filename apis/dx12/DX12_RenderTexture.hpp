@@ -23,6 +23,9 @@ namespace Atrium::DirectX12
 		virtual std::shared_ptr<GPUResource> GetDepthGPUResource() = 0;
 
 		virtual bool IsSwapChain() const = 0;
+
+		// Render targets change state while rendering, so they aren't part of the bindless table.
+		std::optional<std::uint32_t> GetBindlessIndex() const override { return { }; }
 	};
 
 	class Device;
@@ -3,6 +3,7 @@
 #include "DX12_Device.hpp"
 #include "DX12_GraphicsBuffer.hpp"
 #include "DX12_Manager.hpp"
+#include "DX12_RenderTexture.hpp"
 #include "DX12_Texture.hpp"
 
 namespace Atrium::DirectX12
@@ -12,6 +13,13 @@ namespace Atrium::DirectX12
 	{
 	}
 
+	std::shared_ptr<Atrium::RenderTexture> ResourceManager::CreateRenderTexture(const RenderTextureDescriptor& aDescriptor)
+	{
+		PROFILE_SCOPE();
+
+		return std::shared_ptr<Atrium::RenderTexture>(new RenderTexture(myManager.GetDevice(), aDescriptor));
+	}
+
 	std::shared_ptr<Atrium::RenderTexture> ResourceManager::CreateRenderTextureForWindow(Window& aWindow)
 	{
 		PROFILE_SCOPE();
@@ -28,11 +36,11 @@ namespace Atrium::DirectX12
 		return createdSwapChain;
 	}
 
-	std::shared_ptr<Atrium::GraphicsBuffer> ResourceManager::CreateGraphicsBuffer(GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride)
+	std::shared_ptr<Atrium::GraphicsBuffer> ResourceManager::CreateGraphicsBuffer(GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, GraphicsBuffer::Mode aMode)
 	{
 		PROFILE_SCOPE();
 
-		return std::shared_ptr<Atrium::GraphicsBuffer>(new GraphicsBuffer(myManager, aTarget, aCount, aStride));
+		return std::shared_ptr<Atrium::GraphicsBuffer>(new GraphicsBuffer(myManager, aTarget, aCount, aStride, aMode));
 	}
 
 	std::shared_ptr<Atrium::PipelineState> ResourceManager::CreatePipelineState(const PipelineStateDescription& aPipelineState)
@@ -42,6 +50,13 @@ namespace Atrium::DirectX12
 			aPipelineState);
 	}
 
+	std::shared_ptr<Atrium::PipelineState> ResourceManager::CreateComputePipelineState(const ComputePipelineStateDescription& aPipelineState)
+	{
+		return DirectX12::PipelineState::CreateFrom(
+			*myManager.GetDevice().GetDevice().Get(),
+			aPipelineState);
+	}
+
 	std::unique_ptr<Atrium::RootSignatureBuilder> ResourceManager::CreateRootSignature()
 	{
 		return std::unique_ptr<Atrium::RootSignatureBuilder>(new RootSignatureCreator(myManager.GetDevice().GetDevice().Get()));
@@ -59,6 +74,9 @@ namespace Atrium::DirectX12
 			case Atrium::Shader::Type::Pixel:
 				return Shader::CreateFromSource(aSource, anEntryPoint, "ps_5_1");
 
+			case Atrium::Shader::Type::Compute:
+				return Shader::CreateFromSource(aSource, anEntryPoint, "cs_5_1");
+
 			default:
 				return nullptr;
 		}
@@ -17,12 +17,16 @@ namespace Atrium::DirectX12
 	public:
 		ResourceManager(DirectX12API& aManager);
 
+		std::shared_ptr<Atrium::RenderTexture> CreateRenderTexture(const RenderTextureDescriptor& aDescriptor) override;
+
 		std::shared_ptr<Atrium::RenderTexture> CreateRenderTextureForWindow(Window& aWindow) override;
 
-		std::shared_ptr<Atrium::GraphicsBuffer> CreateGraphicsBuffer(Atrium::GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride) override;
+		std::shared_ptr<Atrium::GraphicsBuffer> CreateGraphicsBuffer(Atrium::GraphicsBuffer::Target aTarget, std::uint32_t aCount, std::uint32_t aStride, Atrium::GraphicsBuffer::Mode aMode = Atrium::GraphicsBuffer::Mode::PerFrame) override;
 
 		std::shared_ptr<Atrium::PipelineState> CreatePipelineState(const PipelineStateDescription& aPipelineState) override;
 
+		std::shared_ptr<Atrium::PipelineState> CreateComputePipelineState(const ComputePipelineStateDescription& aPipelineState) override;
+
 		std::unique_ptr<Atrium::RootSignatureBuilder> CreateRootSignature() override;
 
 		std::shared_ptr<Atrium::Shader> CreateShader(const std::filesystem::path& aSource, Atrium::Shader::Type aType, const char* anEntryPoint) override;
@@ -7,49 +7,169 @@
 #include "DX12_MemoryAlignment.hpp"
 #include "DX12_Texture.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
 namespace Atrium::DirectX12
 {
 	using namespace DirectX;
 
+	namespace
+	{
+		// Touching boxes count as well, so regions written next to each other are uploaded together.
+		bool Touches(const D3D12_BOX& aBox, const D3D12_BOX& anotherBox)
+		{
+			return aBox.left <= anotherBox.right && anotherBox.left <= aBox.right
+				&& aBox.top <= anotherBox.bottom && anotherBox.top <= aBox.bottom
+				&& aBox.front <= anotherBox.back && anotherBox.front <= aBox.back;
+		}
+
+		D3D12_BOX Merge(const D3D12_BOX& aBox, const D3D12_BOX& anotherBox)
+		{
+			return D3D12_BOX {
+				(std::min)(aBox.left, anotherBox.left),
+				(std::min)(aBox.top, anotherBox.top),
+				(std::min)(aBox.front, anotherBox.front),
+				(std::max)(aBox.right, anotherBox.right),
+				(std::max)(aBox.bottom, anotherBox.bottom),
+				(std::max)(aBox.back, anotherBox.back)
+			};
+		}
+	}
+
 	DDSImage::DDSImage(Device& aDevice, UploadContext& anUploader, const DirectX::TexMetadata& aMetadata)
 		: myDevice(aDevice)
 		, myUploader(anUploader)
 		, myImage(std::make_unique<DirectX::ScratchImage>())
 		, myMetadata(aMetadata)
+		, myIsUploaded(false)
 	{
 		myImage->Initialize(aMetadata);
+
+		// Initializing resolves a mip count of 0 to the full chain.
+		myMetadata = myImage->GetMetadata();
+
+		SetupResource();
 	}
 
 	DDSImage::DDSImage(Device& aDevice, UploadContext& anUploader, std::unique_ptr<DirectX::ScratchImage>&& anImage)
 		: myDevice(aDevice)
 		, myUploader(anUploader)
 		, myMetadata(anImage->GetMetadata())
+		, myIsUploaded(false)
 	{
 		std::swap(myImage, anImage);
+
+		SetupResource();
 	}
 
 	void DDSImage::Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable)
 	{
+		if (!Debug::Verify(myImage != nullptr, "The texture is readable."))
+			return;
+
 		if (anUpdateMipmaps)
-		{
-			GenerateMipMaps(
-				*myImage->GetImage(0, 0, 0),
-				TEX_FILTER_DEFAULT,
-				myMetadata.mipLevels,
-				*myImage,
-				myMetadata.dimension == TEX_DIMENSION_TEXTURE1D
-			);
-		}
+			Apply_GenerateMipmaps();
 
-		Apply_SetupResource();
 		Apply_BeginImageUpload();
+		myDirtyRegions.clear();
+		myIsUploaded = true;
 
 		if (aMakeNoLongerReadable)
 			myImage.reset();
 	}
 
-	// Todo: Keep resource if it's still the right setup.
-	void DDSImage::Apply_SetupResource()
+	bool DDSImage::SetPixels(const void* someData, std::size_t aRowPitch, const TextureRegion& aRegion, unsigned int aMipLevel, unsigned int anArrayIndex)
+	{
+		if (!Debug::Verify(myImage != nullptr, "The texture is readable."))
+			return false;
+
+		const std::size_t bitsPerPixel = BitsPerPixel(myMetadata.format);
+		if (!Debug::Verify(!IsCompressed(myMetadata.format) && bitsPerPixel % 8 == 0, "Pixels can be set in the texture's format."))
+			return false;
+
+		if (!Debug::Verify(aMipLevel < myMetadata.mipLevels && anArrayIndex < myMetadata.arraySize, "Mip level %u and array index %u are in the texture.", aMipLevel, anArrayIndex))
+			return false;
+
+		const bool isVolume = myMetadata.dimension == TEX_DIMENSION_TEXTURE3D;
+		const std::size_t width = (std::max)(myMetadata.width >> aMipLevel, std::size_t(1));
+		const std::size_t height = (std::max)(myMetadata.height >> aMipLevel, std::size_t(1));
+		const std::size_t depth = isVolume ? (std::max)(myMetadata.depth >> aMipLevel, std::size_t(1)) : 1;
+		if (!Debug::Verify(
+			std::size_t(aRegion.X) + aRegion.Width <= width && std::size_t(aRegion.Y) + aRegion.Height <= height && std::size_t(aRegion.Z) + aRegion.Depth <= depth,
+			"The region fits in the mip level, of %zux%zux%zu pixels.", width, height, depth))
+			return false;
+
+		if (aRegion.Width == 0 || aRegion.Height == 0 || aRegion.Depth == 0)
+			return true;
+
+		const std::size_t bytesPerPixel = bitsPerPixel / 8;
+		const std::size_t rowSize = aRegion.Width * bytesPerPixel;
+		const std::uint8_t* source = static_cast<const std::uint8_t*>(someData);
+		for (unsigned int slice = 0; slice < aRegion.Depth; ++slice)
+		{
+			const Image* image = myImage->GetImage(aMipLevel, anArrayIndex, aRegion.Z + slice);
+			std::uint8_t* destination = image->pixels + aRegion.Y * image->rowPitch + aRegion.X * bytesPerPixel;
+			for (unsigned int row = 0; row < aRegion.Height; ++row)
+			{
+				std::memcpy(destination, source, rowSize);
+				destination += image->rowPitch;
+				source += aRowPitch;
+			}
+		}
+
+		AddDirtyRegion(DirtyRegion {
+			aMipLevel,
+			anArrayIndex,
+			D3D12_BOX { aRegion.X, aRegion.Y, aRegion.Z, aRegion.X + aRegion.Width, aRegion.Y + aRegion.Height, aRegion.Z + aRegion.Depth }
+		});
+
+		return true;
+	}
+
+	void DDSImage::ApplyDirtyRegions(bool anUpdateMipmaps)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(myImage != nullptr, "The texture is readable."))
+			return;
+
+		// Until the whole image has been uploaded once, the rest of the resource is undefined.
+		if (!myIsUploaded)
+		{
+			Apply(anUpdateMipmaps, false);
+			return;
+		}
+
+		if (myDirtyRegions.empty())
+			return;
+
+		if (anUpdateMipmaps)
+			UpdateMipmapRegions();
+
+		BeginRegionUpload();
+		myDirtyRegions.clear();
+	}
+
+	void DDSImage::Apply_GenerateMipmaps()
+	{
+		if (myMetadata.mipLevels <= 1)
+			return;
+
+		// Generating a chain clears the image it's generated into, so it can't be generated in place.
+		std::unique_ptr<ScratchImage> mipChain = std::make_unique<ScratchImage>();
+		const HRESULT result = myMetadata.dimension == TEX_DIMENSION_TEXTURE3D
+			? GenerateMipMaps3D(myImage->GetImages(), myImage->GetImageCount(), myMetadata, TEX_FILTER_DEFAULT, myMetadata.mipLevels, *mipChain)
+			: GenerateMipMaps(myImage->GetImages(), myImage->GetImageCount(), myMetadata, TEX_FILTER_DEFAULT, myMetadata.mipLevels, *mipChain);
+
+		if (Debug::Verify(result, "Generate mipmaps."))
+			myImage = std::move(mipChain);
+	}
+
+	// The metadata can't change after creation, so the resource and its views are created once,
+	// and their descriptors are never rewritten while frames in flight may read them.
+	void DDSImage::SetupResource()
 	{
 		D3D12_RESOURCE_DESC textureDesc;
 		textureDesc.Format = myMetadata.format;
@@ -110,6 +230,16 @@ namespace Atrium::DirectX12
 			srvDescPtr,
 			mySRVHandle.GetCPUHandle()
 		);
+
+		// The bindless table is declared as Texture2D[], so only plain 2D textures can live in it.
+		const bool isBindless = myMetadata.dimension == TEX_DIMENSION_TEXTURE2D && !myMetadata.IsCubemap() && myMetadata.arraySize == 1;
+		if (isBindless)
+		{
+			FrameDescriptorRing& frameRing = myDevice.GetDescriptorHeapManager().GetFrameRing();
+			myBindlessHandle = frameRing.AllocatePersistent();
+			if (myBindlessHandle.IsValid())
+				frameRing.CopyPersistent(myBindlessHandle, mySRVHandle.GetCPUHandle());
+		}
 	}
 
 	void DDSImage::Apply_BeginImageUpload()
@@ -163,6 +293,145 @@ namespace Atrium::DirectX12
 		}
 	}
 
+	void DDSImage::AddDirtyRegion(DirtyRegion aRegion)
+	{
+		// A merged region can reach regions the new one didn't, so merging starts over after each merge.
+		for (std::size_t i = 0; i < myDirtyRegions.size();)
+		{
+			const DirtyRegion& region = myDirtyRegions[i];
+			if (region.MipLevel != aRegion.MipLevel || region.ArrayIndex != aRegion.ArrayIndex || !Touches(region.Box, aRegion.Box))
+			{
+				++i;
+				continue;
+			}
+
+			aRegion.Box = Merge(region.Box, aRegion.Box);
+			myDirtyRegions[i] = myDirtyRegions.back();
+			myDirtyRegions.pop_back();
+			i = 0;
+		}
+
+		myDirtyRegions.push_back(aRegion);
+	}
+
+	void DDSImage::UpdateMipmapRegions()
+	{
+		if (myMetadata.mipLevels <= 1)
+			return;
+
+		// Volume mips average neighbouring slices as well, so they're regenerated whole.
+		if (myMetadata.dimension == TEX_DIMENSION_TEXTURE3D)
+		{
+			Apply_GenerateMipmaps();
+			for (std::uint32_t mipLevel = 1; mipLevel < myMetadata.mipLevels; ++mipLevel)
+			{
+				const Image& image = *myImage->GetImage(mipLevel, 0, 0);
+				const UINT depth = static_cast<UINT>((std::max)(myMetadata.depth >> mipLevel, std::size_t(1)));
+				AddDirtyRegion(DirtyRegion { mipLevel, 0, D3D12_BOX { 0, 0, 0, static_cast<UINT>(image.width), static_cast<UINT>(image.height), depth } });
+			}
+			return;
+		}
+
+		const std::size_t bytesPerPixel = BitsPerPixel(myMetadata.format) / 8;
+
+		std::vector<DirtyRegion> topRegions;
+		std::copy_if(myDirtyRegions.begin(), myDirtyRegions.end(), std::back_inserter(topRegions), [](const DirtyRegion& aRegion) { return aRegion.MipLevel == 0; });
+
+		for (const DirtyRegion& topRegion : topRegions)
+		{
+			D3D12_BOX sourceBox = topRegion.Box;
+			for (std::uint32_t mipLevel = 1; mipLevel < myMetadata.mipLevels; ++mipLevel)
+			{
+				const Image& source = *myImage->GetImage(mipLevel - 1, topRegion.ArrayIndex, 0);
+				const Image& destination = *myImage->GetImage(mipLevel, topRegion.ArrayIndex, 0);
+
+				// Each pixel of a level covers two by two pixels of the level above, so the tile is rounded outwards.
+				D3D12_BOX box = { };
+				box.left = sourceBox.left / 2;
+				box.top = sourceBox.top / 2;
+				box.right = (std::min)((sourceBox.right + 1) / 2, static_cast<UINT>(destination.width));
+				box.bottom = (std::min)((sourceBox.bottom + 1) / 2, static_cast<UINT>(destination.height));
+				box.back = 1;
+
+				Image sourceTile = source;
+				sourceTile.width = (std::min)(std::size_t(box.right) * 2, source.width) - box.left * 2;
+				sourceTile.height = (std::min)(std::size_t(box.bottom) * 2, source.height) - box.top * 2;
+				sourceTile.slicePitch = source.rowPitch * sourceTile.height;
+				sourceTile.pixels = source.pixels + box.top * 2 * source.rowPitch + box.left * 2 * bytesPerPixel;
+
+				ScratchImage tile;
+				if (!Debug::Verify(Resize(sourceTile, box.right - box.left, box.bottom - box.top, TEX_FILTER_BOX | TEX_FILTER_FORCE_NON_WIC, tile), "Downsample a mipmap tile."))
+					return;
+
+				const Image& downsampled = *tile.GetImage(0, 0, 0);
+				for (std::size_t row = 0; row < downsampled.height; ++row)
+				{
+					std::memcpy(
+						destination.pixels + (box.top + row) * destination.rowPitch + box.left * bytesPerPixel,
+						downsampled.pixels + row * downsampled.rowPitch,
+						downsampled.width * bytesPerPixel
+					);
+				}
+
+				AddDirtyRegion(DirtyRegion { mipLevel, topRegion.ArrayIndex, box });
+				sourceBox = box;
+			}
+		}
+	}
+
+	void DDSImage::BeginRegionUpload()
+	{
+		UploadContext::TextureUpload& textureUpload = myUploader.AddTextureUpload();
+		textureUpload.Resource = myResource;
+
+		const std::size_t bytesPerPixel = BitsPerPixel(myMetadata.format) / 8;
+
+		// Each region is laid out like a small subresource of its own, with rows and placement aligned the same way.
+		for (const DirtyRegion& region : myDirtyRegions)
+		{
+			FrameContext::TextureRegionLayout& layout = textureUpload.Regions.emplace_back();
+			layout.Subresource = region.MipLevel + region.ArrayIndex * static_cast<std::uint32_t>(myMetadata.mipLevels);
+			layout.X = region.Box.left;
+			layout.Y = region.Box.top;
+			layout.Z = region.Box.front;
+
+			D3D12_SUBRESOURCE_FOOTPRINT& footprint = layout.Layout.Footprint;
+			footprint.Format = myMetadata.format;
+			footprint.Width = region.Box.right - region.Box.left;
+			footprint.Height = region.Box.bottom - region.Box.top;
+			footprint.Depth = region.Box.back - region.Box.front;
+			footprint.RowPitch = Align<UINT>(static_cast<UINT>(footprint.Width * bytesPerPixel), D3D12_TEXTURE_DATA_PITCH_ALIGNMENT);
+
+			layout.Layout.Offset = textureUpload.BufferSize;
+			textureUpload.BufferSize = Align<std::uint64_t>(textureUpload.BufferSize + std::uint64_t(footprint.RowPitch) * footprint.Height * footprint.Depth, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		}
+
+		textureUpload.BufferData.reset(new std::uint8_t[textureUpload.BufferSize]);
+
+		for (std::size_t regionIndex = 0; regionIndex < myDirtyRegions.size(); ++regionIndex)
+		{
+			const DirtyRegion& region = myDirtyRegions[regionIndex];
+			const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& layout = textureUpload.Regions[regionIndex].Layout;
+			const std::size_t rowSize = layout.Footprint.Width * bytesPerPixel;
+			uint8_t* destinationMemory = &textureUpload.BufferData.get()[layout.Offset];
+
+			for (UINT sliceIndex = 0; sliceIndex < layout.Footprint.Depth; ++sliceIndex)
+			{
+				const Image* image = myImage->GetImage(region.MipLevel, region.ArrayIndex, region.Box.front + sliceIndex);
+				const uint8_t* sourceMemory = image->pixels + region.Box.top * image->rowPitch + region.Box.left * bytesPerPixel;
+
+				for (UINT row = 0; row < layout.Footprint.Height; ++row)
+				{
+					memcpy(destinationMemory, sourceMemory, rowSize);
+					destinationMemory += layout.Footprint.RowPitch;
+					sourceMemory += image->rowPitch;
+				}
+			}
+		}
+
+		PROFILE_PLOT("Texture region upload bytes", static_cast<std::int64_t>(textureUpload.BufferSize));
+	}
+
 	Texture::Texture(Device& aDevice, UploadContext& anUploader, const DirectX::TexMetadata& aMetadata)
 		: myImage(aDevice, anUploader, aMetadata)
 	{
@@ -175,11 +444,21 @@ namespace Atrium::DirectX12
 
 	}
 
+	bool Texture::SetPixels(const void* someData, std::size_t aRowPitch, const TextureRegion& aRegion, unsigned int aMipLevel, unsigned int anArrayIndex)
+	{
+		return myImage.SetPixels(someData, aRowPitch, aRegion, aMipLevel, anArrayIndex);
+	}
+
 	void Texture::Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable)
 	{
 		myImage.Apply(anUpdateMipmaps, aMakeNoLongerReadable);
 	}
 
+	void Texture::ApplyDirtyRegions(bool anUpdateMipmaps)
+	{
+		myImage.ApplyDirtyRegions(anUpdateMipmaps);
+	}
+
 	TextureDimension Texture::GetDimensions() const
 	{
 		switch (myImage.GetMetadata().dimension)
@@ -222,6 +501,15 @@ namespace Atrium::DirectX12
 		return static_cast<unsigned int>(myImage.GetMetadata().width);
 	}
 
+	std::optional<std::uint32_t> Texture::GetBindlessIndex() const
+	{
+		const DescriptorHeapHandle& handle = myImage.GetBindlessHandle();
+		if (!handle.IsValid())
+			return { };
+
+		return handle.GetHeapIndex();
+	}
+
 	void* Texture::GetNativeTexturePtr() const
 	{
 		return myImage.GetResource()->GetResource().Get();
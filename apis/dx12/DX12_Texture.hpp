@@ -12,7 +12,9 @@
 #include <d3d12.h>
 #include <DirectXTex.h>
 
+#include <cstddef>
 #include <filesystem>
+#include <vector>
 
 namespace Atrium::DirectX12
 {
@@ -27,15 +29,40 @@ namespace Atrium::DirectX12
 
 		void Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable);
 
+		/**
+		 * @brief Copy pixels into the image and mark their region as dirty.
+		 */
+		bool SetPixels(const void* someData, std::size_t aRowPitch, const TextureRegion& aRegion, unsigned int aMipLevel, unsigned int anArrayIndex);
+
+		/**
+		 * @brief Upload the dirty regions into the resource, or the whole image if it was never uploaded.
+		 *
+		 * @param anUpdateMipmaps Whether to downsample the dirty regions of the top mip level into the tiles under them in the lower ones first.
+		 */
+		void ApplyDirtyRegions(bool anUpdateMipmaps);
+
 		const DirectX::TexMetadata& GetMetadata() const { return myMetadata; }
 		const DirectX::ScratchImage* GetImage() const { return myImage.get(); }
 		std::shared_ptr<GPUResource> GetResource() const { return myResource; }
 		const DescriptorHeapHandle& GetSRVHandle() const { return mySRVHandle; }
+		const DescriptorHeapHandle& GetBindlessHandle() const { return myBindlessHandle; }
 
 	private:
-		void Apply_SetupResource();
+		struct DirtyRegion
+		{
+			std::uint32_t MipLevel;
+			std::uint32_t ArrayIndex;
+			D3D12_BOX Box;
+		};
+
+		void SetupResource();
+		void Apply_GenerateMipmaps();
 		void Apply_BeginImageUpload();
 
+		void AddDirtyRegion(DirtyRegion aRegion);
+		void UpdateMipmapRegions();
+		void BeginRegionUpload();
+
 		Device& myDevice;
 		UploadContext& myUploader;
 
@@ -44,6 +71,12 @@ namespace Atrium::DirectX12
 
 		std::shared_ptr<GPUResource> myResource;
 		DescriptorHeapHandle mySRVHandle;
+		DescriptorHeapHandle myBindlessHandle;
+
+		// Regions written since the last upload, overlapping regions of a subresource are merged.
+		std::vector<DirtyRegion> myDirtyRegions;
+
+		bool myIsUploaded;
 	};
 
 	class Texture : public Atrium::Texture
@@ -52,18 +85,20 @@ namespace Atrium::DirectX12
 		Texture(Device& aDevice, UploadContext& anUploader, const DirectX::TexMetadata& aMetadata);
 		Texture(Device& aDevice, UploadContext& anUploader, std::unique_ptr<DirectX::ScratchImage>&& anImage);
 
-		void Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable);
-
 		DDSImage& GetImage() { return myImage; }
 
 		// Implements Texture
 	public:
+		bool SetPixels(const void* someData, std::size_t aRowPitch, const TextureRegion& aRegion, unsigned int aMipLevel, unsigned int anArrayIndex) override;
+		void Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable) override;
+		void ApplyDirtyRegions(bool anUpdateMipmaps) override;
 		TextureDimension GetDimensions() const override;
 		unsigned int GetDepth() const override;
 		unsigned int GetHeight() const override;
 		bool IsReadable() const override;
 		unsigned int GetMipmapCount() const override;
 		unsigned int GetWidth() const override;
+		std::optional<std::uint32_t> GetBindlessIndex() const override;
 		void* GetNativeTexturePtr() const override;
 
 	private:
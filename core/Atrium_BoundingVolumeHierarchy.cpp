@@ -0,0 +1,820 @@
+// Filter "Graphics"
+
+#include "Atrium_BoundingVolumeHierarchy.hpp"
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_SIMD.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace Atrium
+{
+	namespace
+	{
+		constexpr std::uint32_t BinCount = 16;
+
+		// Leaves hold at most this many primitives, unless their centroids can't be told apart.
+		constexpr std::uint32_t MaxLeafSize = 8;
+
+		// Cost of visiting a node, relative to testing one primitive.
+		constexpr float TraversalCost = 1.f;
+
+		// Deeper nodes become leaves, which bounds the traversal stacks.
+		constexpr std::uint32_t MaxDepth = 60;
+		constexpr std::size_t StackSize = 64;
+
+		// Below this, subtrees are built on the thread that reached them.
+		constexpr std::uint32_t ParallelBuildThreshold = 16384;
+		constexpr unsigned int MaxBuildThreads = 8;
+
+		constexpr float MinTriangleDeterminant = 1e-12f;
+
+		enum class Overlap
+		{
+			Outside,
+			Intersecting,
+			Inside
+		};
+
+		float GetAxis(const Vector3<float>& aVector, std::uint32_t anAxis)
+		{
+			return anAxis == 0 ? aVector.X : (anAxis == 1 ? aVector.Y : aVector.Z);
+		}
+
+		float GetHalfSurfaceArea(const AxisAlignedBox& aBox)
+		{
+			if (aBox.IsEmpty())
+				return 0.f;
+
+			const Vector3<float> size = aBox.Max - aBox.Min;
+			return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+		}
+
+		Vector3<float> GetInverse(const Vector3<float>& aDirection)
+		{
+			return Vector3<float>(1.f / aDirection.X, 1.f / aDirection.Y, 1.f / aDirection.Z);
+		}
+
+		bool IntersectBox(const AxisAlignedBox& aBox, const Vector3<float>& anOrigin, const Vector3<float>& anInverseDirection, float aMaxDistance, float& anEntryOut)
+		{
+			const float x1 = (aBox.Min.X - anOrigin.X) * anInverseDirection.X;
+			const float x2 = (aBox.Max.X - anOrigin.X) * anInverseDirection.X;
+			const float y1 = (aBox.Min.Y - anOrigin.Y) * anInverseDirection.Y;
+			const float y2 = (aBox.Max.Y - anOrigin.Y) * anInverseDirection.Y;
+			const float z1 = (aBox.Min.Z - anOrigin.Z) * anInverseDirection.Z;
+			const float z2 = (aBox.Max.Z - anOrigin.Z) * anInverseDirection.Z;
+
+			// The running values come first, so a NaN from a ray on a slab's plane is ignored.
+			float entry = 0.f;
+			entry = std::max(entry, std::min(x1, x2));
+			entry = std::max(entry, std::min(y1, y2));
+			entry = std::max(entry, std::min(z1, z2));
+
+			float exit = aMaxDistance;
+			exit = std::min(exit, std::max(x1, x2));
+			exit = std::min(exit, std::max(y1, y2));
+			exit = std::min(exit, std::max(z1, z2));
+
+			anEntryOut = entry;
+			return entry <= exit;
+		}
+
+	#if ATRIUM_SIMD_SSE
+		using namespace SIMD;
+
+		/**
+		 * @brief Four rays and four triangles, tested lane against lane with Möller-Trumbore.
+		 *        Either can be the same in every lane, to test one ray against four triangles or four rays against one triangle.
+		 *
+		 * @return A mask of the lanes where the ray hit the triangle closer than the maximum distance.
+		 */
+		__m128 IntersectTriangles(const Lanes3& someOrigins, const Lanes3& someDirections, const Lanes3& someCorners, const Lanes3& someEdgesA, const Lanes3& someEdgesB, __m128 someMaxDistances, __m128& someDistancesOut, __m128& someUsOut, __m128& someVsOut)
+		{
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.f);
+
+			const Lanes3 p = Cross(someDirections, someEdgesB);
+			const __m128 determinant = Dot(someEdgesA, p);
+			const __m128 inverseDeterminant = _mm_div_ps(one, determinant);
+
+			const Lanes3 s = Subtract(someOrigins, someCorners);
+			const __m128 u = _mm_mul_ps(Dot(s, p), inverseDeterminant);
+
+			const Lanes3 q = Cross(s, someEdgesA);
+			const __m128 v = _mm_mul_ps(Dot(someDirections, q), inverseDeterminant);
+			const __m128 distance = _mm_mul_ps(Dot(someEdgesB, q), inverseDeterminant);
+
+			__m128 hit = _mm_cmpgt_ps(Abs(determinant), _mm_set1_ps(MinTriangleDeterminant));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(u, zero));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+			hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+			hit = _mm_and_ps(hit, _mm_cmpge_ps(distance, zero));
+			hit = _mm_and_ps(hit, _mm_cmplt_ps(distance, someMaxDistances));
+
+			someDistancesOut = distance;
+			someUsOut = u;
+			someVsOut = v;
+			return hit;
+		}
+
+		/**
+		 * @brief Four rays tested against one box.
+		 *
+		 * @return A mask of the lanes where the ray enters the box before the maximum distance.
+		 */
+		__m128 IntersectBox(const AxisAlignedBox& aBox, const Lanes3& someOrigins, const Lanes3& someInverseDirections, __m128 someMaxDistances, __m128& someEntriesOut)
+		{
+			const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Min.X), someOrigins[0]), someInverseDirections[0]);
+			const __m128 x2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Max.X), someOrigins[0]), someInverseDirections[0]);
+			const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Min.Y), someOrigins[1]), someInverseDirections[1]);
+			const __m128 y2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Max.Y), someOrigins[1]), someInverseDirections[1]);
+			const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Min.Z), someOrigins[2]), someInverseDirections[2]);
+			const __m128 z2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(aBox.Max.Z), someOrigins[2]), someInverseDirections[2]);
+
+			// As with the scalar test, the running values are the second operands, so NaNs are ignored.
+			__m128 entry = _mm_setzero_ps();
+			entry = _mm_max_ps(_mm_min_ps(x1, x2), entry);
+			entry = _mm_max_ps(_mm_min_ps(y1, y2), entry);
+			entry = _mm_max_ps(_mm_min_ps(z1, z2), entry);
+
+			__m128 exit = someMaxDistances;
+			exit = _mm_min_ps(_mm_max_ps(x1, x2), exit);
+			exit = _mm_min_ps(_mm_max_ps(y1, y2), exit);
+			exit = _mm_min_ps(_mm_max_ps(z1, z2), exit);
+
+			someEntriesOut = entry;
+			return _mm_cmple_ps(entry, exit);
+		}
+	#endif
+	}
+
+	struct BoundingVolumeHierarchy::BuildContext
+	{
+		std::vector<Vector3<float>> Centroids;
+		std::atomic<std::uint32_t> NodeCount = 1;
+
+		// Subtrees above this depth are split over threads.
+		std::uint32_t ParallelDepth = 0;
+	};
+
+	void BoundingVolumeHierarchy::Build(std::span<const AxisAlignedBox> someBounds)
+	{
+		PROFILE_SCOPE();
+
+		myPrimitiveBounds.assign(someBounds.begin(), someBounds.end());
+		myTriangles = TriangleData();
+		BuildTree();
+	}
+
+	void BoundingVolumeHierarchy::Build(const MeshPrimitive& aMesh)
+	{
+		PROFILE_SCOPE();
+
+		myPrimitiveBounds.resize(aMesh.Triangles.size());
+		for (std::size_t i = 0; i < aMesh.Triangles.size(); ++i)
+		{
+			const MeshPrimitive::Triangle& triangle = aMesh.Triangles[i];
+			AxisAlignedBox& bounds = myPrimitiveBounds[i];
+			bounds = AxisAlignedBox();
+			bounds.Add(aMesh.Vertices[triangle.V1].Position);
+			bounds.Add(aMesh.Vertices[triangle.V2].Position);
+			bounds.Add(aMesh.Vertices[triangle.V3].Position);
+		}
+
+		BuildTree();
+		StoreTriangles(aMesh);
+	}
+
+	void BoundingVolumeHierarchy::Refit(std::span<const AxisAlignedBox> someBounds)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someBounds.size() == myPrimitiveBounds.size(), "Refitting with as many objects as the hierarchy was built with."))
+			return;
+
+		std::copy(someBounds.begin(), someBounds.end(), myPrimitiveBounds.begin());
+		RefitNodes();
+	}
+
+	void BoundingVolumeHierarchy::Refit(const MeshPrimitive& aMesh)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(aMesh.Triangles.size() == myPrimitiveBounds.size() && !myTriangles.Corner[0].empty(), "Refitting with the mesh the hierarchy was built with."))
+			return;
+
+		for (std::size_t i = 0; i < aMesh.Triangles.size(); ++i)
+		{
+			const MeshPrimitive::Triangle& triangle = aMesh.Triangles[i];
+			AxisAlignedBox& bounds = myPrimitiveBounds[i];
+			bounds = AxisAlignedBox();
+			bounds.Add(aMesh.Vertices[triangle.V1].Position);
+			bounds.Add(aMesh.Vertices[triangle.V2].Position);
+			bounds.Add(aMesh.Vertices[triangle.V3].Position);
+		}
+
+		StoreTriangles(aMesh);
+		RefitNodes();
+	}
+
+	RayHit BoundingVolumeHierarchy::Raycast(const Ray& aRay) const
+	{
+		RayHit hit;
+		hit.Distance = aRay.MaxDistance;
+
+		const Vector3<float> inverseDirection = GetInverse(aRay.Direction);
+		const bool hasTriangles = !myTriangles.Corner[0].empty();
+
+		float rootEntry;
+		if (myNodes.empty() || !IntersectBox(myNodes[0].Bounds, aRay.Origin, inverseDirection, hit.Distance, rootEntry))
+			return RayHit();
+
+		// Nodes to visit, with the distance the ray enters them, so ones behind a closer hit can be skipped.
+		std::array<std::pair<std::uint32_t, float>, StackSize> stack;
+		std::size_t stackSize = 0;
+		stack[stackSize++] = { 0, rootEntry };
+
+	#if ATRIUM_SIMD_SSE
+		const Lanes3 origins = { _mm_set1_ps(aRay.Origin.X), _mm_set1_ps(aRay.Origin.Y), _mm_set1_ps(aRay.Origin.Z) };
+		const Lanes3 directions = { _mm_set1_ps(aRay.Direction.X), _mm_set1_ps(aRay.Direction.Y), _mm_set1_ps(aRay.Direction.Z) };
+	#endif
+
+		while (stackSize > 0)
+		{
+			const auto [nodeIndex, entry] = stack[--stackSize];
+			if (entry > hit.Distance)
+				continue;
+
+			const Node& node = myNodes[nodeIndex];
+			if (!node.IsLeaf())
+			{
+				const std::uint32_t left = node.FirstPrimitiveOrLeftChild;
+				const std::uint32_t right = left + 1;
+
+				float leftEntry, rightEntry;
+				const bool hitsLeft = IntersectBox(myNodes[left].Bounds, aRay.Origin, inverseDirection, hit.Distance, leftEntry);
+				const bool hitsRight = IntersectBox(myNodes[right].Bounds, aRay.Origin, inverseDirection, hit.Distance, rightEntry);
+
+				// The nearer child is pushed last, to be visited first.
+				if (hitsLeft && hitsRight)
+				{
+					const bool isLeftNearer = leftEntry <= rightEntry;
+					stack[stackSize++] = isLeftNearer ? std::make_pair(right, rightEntry) : std::make_pair(left, leftEntry);
+					stack[stackSize++] = isLeftNearer ? std::make_pair(left, leftEntry) : std::make_pair(right, rightEntry);
+				}
+				else if (hitsLeft)
+				{
+					stack[stackSize++] = { left, leftEntry };
+				}
+				else if (hitsRight)
+				{
+					stack[stackSize++] = { right, rightEntry };
+				}
+
+				continue;
+			}
+
+			const std::uint32_t first = node.FirstPrimitiveOrLeftChild;
+			const std::uint32_t end = first + node.PrimitiveCount;
+
+			if (!hasTriangles)
+			{
+				for (std::uint32_t i = first; i < end; ++i)
+				{
+					float primitiveEntry;
+					const std::uint32_t primitive = myPrimitiveIndices[i];
+					if (IntersectBox(myPrimitiveBounds[primitive], aRay.Origin, inverseDirection, hit.Distance, primitiveEntry) && primitiveEntry < hit.Distance)
+					{
+						hit.Index = primitive;
+						hit.Distance = primitiveEntry;
+					}
+				}
+
+				continue;
+			}
+
+		#if ATRIUM_SIMD_SSE
+			// Four triangles at a time. The arrays are padded, so the last group can read past the leaf and mask the extra lanes.
+			for (std::uint32_t i = first; i < end; i += 4)
+			{
+				const Lanes3 corners = { _mm_loadu_ps(&myTriangles.Corner[0][i]), _mm_loadu_ps(&myTriangles.Corner[1][i]), _mm_loadu_ps(&myTriangles.Corner[2][i]) };
+				const Lanes3 edgesA = { _mm_loadu_ps(&myTriangles.EdgeA[0][i]), _mm_loadu_ps(&myTriangles.EdgeA[1][i]), _mm_loadu_ps(&myTriangles.EdgeA[2][i]) };
+				const Lanes3 edgesB = { _mm_loadu_ps(&myTriangles.EdgeB[0][i]), _mm_loadu_ps(&myTriangles.EdgeB[1][i]), _mm_loadu_ps(&myTriangles.EdgeB[2][i]) };
+
+				__m128 distances, us, vs;
+				const __m128 hits = IntersectTriangles(origins, directions, corners, edgesA, edgesB, _mm_set1_ps(hit.Distance), distances, us, vs);
+
+				int mask = _mm_movemask_ps(hits) & ((1 << std::min(4u, end - i)) - 1);
+				if (mask == 0)
+					continue;
+
+				alignas(16) std::array<float, 4> laneDistances, laneUs, laneVs;
+				_mm_store_ps(laneDistances.data(), distances);
+				_mm_store_ps(laneUs.data(), us);
+				_mm_store_ps(laneVs.data(), vs);
+
+				for (; mask != 0; mask &= mask - 1)
+				{
+					const int lane = std::countr_zero(static_cast<unsigned int>(mask));
+					if (laneDistances[lane] < hit.Distance)
+					{
+						hit.Index = myPrimitiveIndices[i + lane];
+						hit.Distance = laneDistances[lane];
+						hit.U = laneUs[lane];
+						hit.V = laneVs[lane];
+					}
+				}
+			}
+		#else
+			for (std::uint32_t i = first; i < end; ++i)
+			{
+				const Vector3<float> corner(myTriangles.Corner[0][i], myTriangles.Corner[1][i], myTriangles.Corner[2][i]);
+				const Vector3<float> edgeA(myTriangles.EdgeA[0][i], myTriangles.EdgeA[1][i], myTriangles.EdgeA[2][i]);
+				const Vector3<float> edgeB(myTriangles.EdgeB[0][i], myTriangles.EdgeB[1][i], myTriangles.EdgeB[2][i]);
+
+				const Vector3<float> p = Vector3<float>::Cross(aRay.Direction, edgeB);
+				const float determinant = Vector3<float>::Dot(edgeA, p);
+				if (std::abs(determinant) <= MinTriangleDeterminant)
+					continue;
+
+				const float inverseDeterminant = 1.f / determinant;
+				const Vector3<float> s = aRay.Origin - corner;
+				const float u = Vector3<float>::Dot(s, p) * inverseDeterminant;
+				if (u < 0.f || u > 1.f)
+					continue;
+
+				const Vector3<float> q = Vector3<float>::Cross(s, edgeA);
+				const float v = Vector3<float>::Dot(aRay.Direction, q) * inverseDeterminant;
+				if (v < 0.f || u + v > 1.f)
+					continue;
+
+				const float distance = Vector3<float>::Dot(edgeB, q) * inverseDeterminant;
+				if (distance >= 0.f && distance < hit.Distance)
+				{
+					hit.Index = myPrimitiveIndices[i];
+					hit.Distance = distance;
+					hit.U = u;
+					hit.V = v;
+				}
+			}
+		#endif
+		}
+
+		return hit.IsHit() ? hit : RayHit();
+	}
+
+	void BoundingVolumeHierarchy::Raycast(std::span<const Ray, 4> someRays, std::span<RayHit, 4> someHitsOut) const
+	{
+	#if ATRIUM_SIMD_SSE
+		for (RayHit& hit : someHitsOut)
+			hit = RayHit();
+
+		if (myNodes.empty())
+			return;
+
+		const Lanes3 origins = {
+			_mm_setr_ps(someRays[0].Origin.X, someRays[1].Origin.X, someRays[2].Origin.X, someRays[3].Origin.X),
+			_mm_setr_ps(someRays[0].Origin.Y, someRays[1].Origin.Y, someRays[2].Origin.Y, someRays[3].Origin.Y),
+			_mm_setr_ps(someRays[0].Origin.Z, someRays[1].Origin.Z, someRays[2].Origin.Z, someRays[3].Origin.Z)
+		};
+		const Lanes3 directions = {
+			_mm_setr_ps(someRays[0].Direction.X, someRays[1].Direction.X, someRays[2].Direction.X, someRays[3].Direction.X),
+			_mm_setr_ps(someRays[0].Direction.Y, someRays[1].Direction.Y, someRays[2].Direction.Y, someRays[3].Direction.Y),
+			_mm_setr_ps(someRays[0].Direction.Z, someRays[1].Direction.Z, someRays[2].Direction.Z, someRays[3].Direction.Z)
+		};
+		const __m128 one = _mm_set1_ps(1.f);
+		const Lanes3 inverseDirections = { _mm_div_ps(one, directions[0]), _mm_div_ps(one, directions[1]), _mm_div_ps(one, directions[2]) };
+
+		__m128 distances = _mm_setr_ps(someRays[0].MaxDistance, someRays[1].MaxDistance, someRays[2].MaxDistance, someRays[3].MaxDistance);
+		__m128 us = _mm_setzero_ps();
+		__m128 vs = _mm_setzero_ps();
+		std::array<std::uint32_t, 4> indices = { RayHit::InvalidIndex, RayHit::InvalidIndex, RayHit::InvalidIndex, RayHit::InvalidIndex };
+
+		const auto getNearest = [](__m128 aMask, __m128 someEntries) {
+			alignas(16) std::array<float, 4> entries;
+			_mm_store_ps(entries.data(), Select(aMask, someEntries, _mm_set1_ps(std::numeric_limits<float>::max())));
+			return std::min({ entries[0], entries[1], entries[2], entries[3] });
+		};
+		const auto getFarthest = [](__m128 someDistances) {
+			alignas(16) std::array<float, 4> values;
+			_mm_store_ps(values.data(), someDistances);
+			return std::max({ values[0], values[1], values[2], values[3] });
+		};
+		const auto recordHits = [&indices](int aMask, std::uint32_t aPrimitive) {
+			for (; aMask != 0; aMask &= aMask - 1)
+				indices[std::countr_zero(static_cast<unsigned int>(aMask))] = aPrimitive;
+		};
+
+		// Nodes any of the rays may enter, with the nearest distance one of them does.
+		__m128 rootEntries;
+		const __m128 rootHits = IntersectBox(myNodes[0].Bounds, origins, inverseDirections, distances, rootEntries);
+		if (_mm_movemask_ps(rootHits) == 0)
+			return;
+
+		std::array<std::pair<std::uint32_t, float>, StackSize> stack;
+		std::size_t stackSize = 0;
+		stack[stackSize++] = { 0, getNearest(rootHits, rootEntries) };
+
+		const bool hasTriangles = !myTriangles.Corner[0].empty();
+
+		while (stackSize > 0)
+		{
+			const auto [nodeIndex, entry] = stack[--stackSize];
+			if (entry > getFarthest(distances))
+				continue;
+
+			const Node& node = myNodes[nodeIndex];
+			if (!node.IsLeaf())
+			{
+				const std::uint32_t left = node.FirstPrimitiveOrLeftChild;
+				const std::uint32_t right = left + 1;
+
+				__m128 leftEntries, rightEntries;
+				const __m128 leftHits = IntersectBox(myNodes[left].Bounds, origins, inverseDirections, distances, leftEntries);
+				const __m128 rightHits = IntersectBox(myNodes[right].Bounds, origins, inverseDirections, distances, rightEntries);
+				const bool hitsLeft = _mm_movemask_ps(leftHits) != 0;
+				const bool hitsRight = _mm_movemask_ps(rightHits) != 0;
+				const float leftEntry = hitsLeft ? getNearest(leftHits, leftEntries) : 0.f;
+				const float rightEntry = hitsRight ? getNearest(rightHits, rightEntries) : 0.f;
+
+				if (hitsLeft && hitsRight)
+				{
+					const bool isLeftNearer = leftEntry <= rightEntry;
+					stack[stackSize++] = isLeftNearer ? std::make_pair(right, rightEntry) : std::make_pair(left, leftEntry);
+					stack[stackSize++] = isLeftNearer ? std::make_pair(left, leftEntry) : std::make_pair(right, rightEntry);
+				}
+				else if (hitsLeft)
+				{
+					stack[stackSize++] = { left, leftEntry };
+				}
+				else if (hitsRight)
+				{
+					stack[stackSize++] = { right, rightEntry };
+				}
+
+				continue;
+			}
+
+			const std::uint32_t first = node.FirstPrimitiveOrLeftChild;
+			const std::uint32_t end = first + node.PrimitiveCount;
+			for (std::uint32_t i = first; i < end; ++i)
+			{
+				const std::uint32_t primitive = myPrimitiveIndices[i];
+
+				if (!hasTriangles)
+				{
+					__m128 entries;
+					__m128 hits = IntersectBox(myPrimitiveBounds[primitive], origins, inverseDirections, distances, entries);
+					hits = _mm_and_ps(hits, _mm_cmplt_ps(entries, distances));
+
+					distances = Select(hits, entries, distances);
+					recordHits(_mm_movemask_ps(hits), primitive);
+					continue;
+				}
+
+				const Lanes3 corner = { _mm_set1_ps(myTriangles.Corner[0][i]), _mm_set1_ps(myTriangles.Corner[1][i]), _mm_set1_ps(myTriangles.Corner[2][i]) };
+				const Lanes3 edgeA = { _mm_set1_ps(myTriangles.EdgeA[0][i]), _mm_set1_ps(myTriangles.EdgeA[1][i]), _mm_set1_ps(myTriangles.EdgeA[2][i]) };
+				const Lanes3 edgeB = { _mm_set1_ps(myTriangles.EdgeB[0][i]), _mm_set1_ps(myTriangles.EdgeB[1][i]), _mm_set1_ps(myTriangles.EdgeB[2][i]) };
+
+				__m128 hitDistances, hitUs, hitVs;
+				const __m128 hits = IntersectTriangles(origins, directions, corner, edgeA, edgeB, distances, hitDistances, hitUs, hitVs);
+
+				distances = Select(hits, hitDistances, distances);
+				us = Select(hits, hitUs, us);
+				vs = Select(hits, hitVs, vs);
+				recordHits(_mm_movemask_ps(hits), primitive);
+			}
+		}
+
+		alignas(16) std::array<float, 4> laneDistances, laneUs, laneVs;
+		_mm_store_ps(laneDistances.data(), distances);
+		_mm_store_ps(laneUs.data(), us);
+		_mm_store_ps(laneVs.data(), vs);
+
+		for (std::size_t lane = 0; lane < 4; ++lane)
+		{
+			if (indices[lane] == RayHit::InvalidIndex)
+				continue;
+
+			RayHit& hit = someHitsOut[lane];
+			hit.Index = indices[lane];
+			hit.Distance = laneDistances[lane];
+			hit.U = laneUs[lane];
+			hit.V = laneVs[lane];
+		}
+	#else
+		for (std::size_t i = 0; i < someRays.size(); ++i)
+			someHitsOut[i] = Raycast(someRays[i]);
+	#endif
+	}
+
+	void BoundingVolumeHierarchy::Query(const Frustum& aFrustum, std::vector<std::uint32_t>& someIndicesOut) const
+	{
+		QueryOverlapping(someIndicesOut, [&aFrustum](const AxisAlignedBox& aBox) {
+			const Vector3<float> center = aBox.GetCenter();
+			const Vector3<float> extents = aBox.GetExtents();
+
+			Overlap overlap = Overlap::Inside;
+			for (const Plane& plane : aFrustum.Planes)
+			{
+				const float distance = Vector3<float>::Dot(plane.Normal, center) + plane.Distance;
+				const float radius = std::abs(plane.Normal.X) * extents.X + std::abs(plane.Normal.Y) * extents.Y + std::abs(plane.Normal.Z) * extents.Z;
+				if (distance < -radius)
+					return Overlap::Outside;
+
+				if (distance < radius)
+					overlap = Overlap::Intersecting;
+			}
+
+			return overlap;
+			});
+	}
+
+	void BoundingVolumeHierarchy::Query(const BoundingSphere& aSphere, std::vector<std::uint32_t>& someIndicesOut) const
+	{
+		QueryOverlapping(someIndicesOut, [&aSphere](const AxisAlignedBox& aBox) {
+			float nearestSquared = 0.f;
+			float farthestSquared = 0.f;
+			for (std::uint32_t axis = 0; axis < 3; ++axis)
+			{
+				const float center = GetAxis(aSphere.Center, axis);
+				const float min = GetAxis(aBox.Min, axis);
+				const float max = GetAxis(aBox.Max, axis);
+
+				const float nearest = center - std::clamp(center, min, max);
+				const float farthest = std::max(center - min, max - center);
+				nearestSquared += nearest * nearest;
+				farthestSquared += farthest * farthest;
+			}
+
+			const float radiusSquared = aSphere.Radius * aSphere.Radius;
+			if (nearestSquared > radiusSquared)
+				return Overlap::Outside;
+
+			return farthestSquared <= radiusSquared ? Overlap::Inside : Overlap::Intersecting;
+			});
+	}
+
+	void BoundingVolumeHierarchy::Query(const AxisAlignedBox& aBox, std::vector<std::uint32_t>& someIndicesOut) const
+	{
+		QueryOverlapping(someIndicesOut, [&aBox](const AxisAlignedBox& anotherBox) {
+			if (anotherBox.Max.X < aBox.Min.X || anotherBox.Min.X > aBox.Max.X
+				|| anotherBox.Max.Y < aBox.Min.Y || anotherBox.Min.Y > aBox.Max.Y
+				|| anotherBox.Max.Z < aBox.Min.Z || anotherBox.Min.Z > aBox.Max.Z)
+				return Overlap::Outside;
+
+			const bool isInside = anotherBox.Min.X >= aBox.Min.X && anotherBox.Max.X <= aBox.Max.X
+				&& anotherBox.Min.Y >= aBox.Min.Y && anotherBox.Max.Y <= aBox.Max.Y
+				&& anotherBox.Min.Z >= aBox.Min.Z && anotherBox.Max.Z <= aBox.Max.Z;
+			return isInside ? Overlap::Inside : Overlap::Intersecting;
+			});
+	}
+
+	AxisAlignedBox BoundingVolumeHierarchy::GetBounds() const
+	{
+		return myNodes.empty() ? AxisAlignedBox() : myNodes[0].Bounds;
+	}
+
+	void BoundingVolumeHierarchy::BuildTree()
+	{
+		const std::uint32_t primitiveCount = static_cast<std::uint32_t>(myPrimitiveBounds.size());
+
+		myNodes.clear();
+		myPrimitiveIndices.resize(primitiveCount);
+		std::iota(myPrimitiveIndices.begin(), myPrimitiveIndices.end(), 0);
+		if (primitiveCount == 0)
+			return;
+
+		BuildContext context;
+		context.Centroids.reserve(primitiveCount);
+		for (const AxisAlignedBox& bounds : myPrimitiveBounds)
+			context.Centroids.push_back(bounds.GetCenter());
+
+		const unsigned int threadCount = primitiveCount < ParallelBuildThreshold ? 1 : std::min(WorkerPool::Get().GetThreadCount(), MaxBuildThreads);
+		context.ParallelDepth = static_cast<std::uint32_t>(std::bit_width(threadCount) - 1);
+
+		// A binary tree never has more than this many nodes, so they can be claimed from any thread without reallocating.
+		myNodes.resize(primitiveCount * 2 - 1);
+		Subdivide(context, 0, 0, primitiveCount, 0);
+		myNodes.resize(context.NodeCount);
+
+		PROFILE_PLOT("BVH nodes", static_cast<std::int64_t>(myNodes.size()));
+	}
+
+	void BoundingVolumeHierarchy::Subdivide(BuildContext& aContext, std::uint32_t aNode, std::uint32_t aBegin, std::uint32_t anEnd, std::uint32_t aDepth)
+	{
+		Node& node = myNodes[aNode];
+		const std::uint32_t count = anEnd - aBegin;
+
+		AxisAlignedBox bounds;
+		AxisAlignedBox centroidBounds;
+		for (std::uint32_t i = aBegin; i < anEnd; ++i)
+		{
+			bounds.Add(myPrimitiveBounds[myPrimitiveIndices[i]]);
+			centroidBounds.Add(aContext.Centroids[myPrimitiveIndices[i]]);
+		}
+
+		node.Bounds = bounds;
+		node.FirstPrimitiveOrLeftChild = aBegin;
+		node.PrimitiveCount = count;
+		if (count == 1 || aDepth >= MaxDepth)
+			return;
+
+		// Bin the centroids along all three axes in one pass, then find the split between bins with the lowest surface area cost.
+		std::array<float, 3> binLows, binScales;
+		for (std::uint32_t axis = 0; axis < 3; ++axis)
+		{
+			const float extent = GetAxis(centroidBounds.Max, axis) - GetAxis(centroidBounds.Min, axis);
+			binLows[axis] = GetAxis(centroidBounds.Min, axis);
+			binScales[axis] = extent > 0.f ? BinCount / extent : 0.f;
+		}
+
+		std::array<std::array<AxisAlignedBox, BinCount>, 3> binBounds;
+		std::array<std::array<std::uint32_t, BinCount>, 3> binCounts {};
+		for (std::uint32_t i = aBegin; i < anEnd; ++i)
+		{
+			const std::uint32_t primitive = myPrimitiveIndices[i];
+			for (std::uint32_t axis = 0; axis < 3; ++axis)
+			{
+				const std::uint32_t bin = std::min(BinCount - 1, static_cast<std::uint32_t>((GetAxis(aContext.Centroids[primitive], axis) - binLows[axis]) * binScales[axis]));
+				binBounds[axis][bin].Add(myPrimitiveBounds[primitive]);
+				++binCounts[axis][bin];
+			}
+		}
+
+		float bestCost = std::numeric_limits<float>::max();
+		std::uint32_t bestAxis = 0;
+		std::uint32_t bestBin = BinCount;
+		for (std::uint32_t axis = 0; axis < 3; ++axis)
+		{
+			if (binScales[axis] == 0.f)
+				continue;
+
+			// Sweep from the right first, so the left sweep can complete each split's cost.
+			std::array<float, BinCount> rightCosts;
+			AxisAlignedBox rightBounds;
+			std::uint32_t rightCount = 0;
+			for (std::uint32_t bin = BinCount - 1; bin > 0; --bin)
+			{
+				rightBounds.Add(binBounds[axis][bin]);
+				rightCount += binCounts[axis][bin];
+				rightCosts[bin - 1] = GetHalfSurfaceArea(rightBounds) * rightCount;
+			}
+
+			AxisAlignedBox leftBounds;
+			std::uint32_t leftCount = 0;
+			for (std::uint32_t bin = 0; bin < BinCount - 1; ++bin)
+			{
+				leftBounds.Add(binBounds[axis][bin]);
+				leftCount += binCounts[axis][bin];
+				if (leftCount == 0 || leftCount == count)
+					continue;
+
+				const float cost = GetHalfSurfaceArea(leftBounds) * leftCount + rightCosts[bin];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = bin;
+				}
+			}
+		}
+
+		std::uint32_t middle;
+		if (bestBin == BinCount)
+		{
+			// Every centroid is in the same place, so any split is as good as another.
+			if (count <= MaxLeafSize)
+				return;
+
+			middle = aBegin + count / 2;
+		}
+		else
+		{
+			const float area = GetHalfSurfaceArea(bounds);
+			if (count <= MaxLeafSize && count * area <= TraversalCost * area + bestCost)
+				return;
+
+			const float low = binLows[bestAxis];
+			const float scale = binScales[bestAxis];
+			const auto split = std::partition(myPrimitiveIndices.begin() + aBegin, myPrimitiveIndices.begin() + anEnd, [&](std::uint32_t aPrimitive) {
+				return std::min(BinCount - 1, static_cast<std::uint32_t>((GetAxis(aContext.Centroids[aPrimitive], bestAxis) - low) * scale)) <= bestBin;
+				});
+			middle = static_cast<std::uint32_t>(split - myPrimitiveIndices.begin());
+		}
+
+		const std::uint32_t left = aContext.NodeCount.fetch_add(2);
+		node.FirstPrimitiveOrLeftChild = left;
+		node.PrimitiveCount = 0;
+
+		if (aDepth < aContext.ParallelDepth && count >= ParallelBuildThreshold)
+		{
+			WorkerPool::Get().ParallelFor(2, [&](std::size_t aChild) {
+				if (aChild == 0)
+					Subdivide(aContext, left, aBegin, middle, aDepth + 1);
+				else
+					Subdivide(aContext, left + 1, middle, anEnd, aDepth + 1);
+				});
+		}
+		else
+		{
+			Subdivide(aContext, left, aBegin, middle, aDepth + 1);
+			Subdivide(aContext, left + 1, middle, anEnd, aDepth + 1);
+		}
+	}
+
+	void BoundingVolumeHierarchy::RefitNodes()
+	{
+		// Children are always claimed after their parent, so walking backwards updates them first.
+		for (std::size_t i = myNodes.size(); i-- > 0;)
+		{
+			Node& node = myNodes[i];
+			node.Bounds = AxisAlignedBox();
+
+			if (node.IsLeaf())
+			{
+				for (std::uint32_t j = 0; j < node.PrimitiveCount; ++j)
+					node.Bounds.Add(myPrimitiveBounds[myPrimitiveIndices[node.FirstPrimitiveOrLeftChild + j]]);
+			}
+			else
+			{
+				node.Bounds.Add(myNodes[node.FirstPrimitiveOrLeftChild].Bounds);
+				node.Bounds.Add(myNodes[node.FirstPrimitiveOrLeftChild + 1].Bounds);
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::StoreTriangles(const MeshPrimitive& aMesh)
+	{
+		// Padded so groups of four can always be loaded, with zero-sized triangles that nothing hits.
+		const std::size_t paddedCount = myPrimitiveIndices.size() + 3;
+		for (std::size_t axis = 0; axis < 3; ++axis)
+		{
+			myTriangles.Corner[axis].assign(paddedCount, 0.f);
+			myTriangles.EdgeA[axis].assign(paddedCount, 0.f);
+			myTriangles.EdgeB[axis].assign(paddedCount, 0.f);
+		}
+
+		for (std::size_t i = 0; i < myPrimitiveIndices.size(); ++i)
+		{
+			const MeshPrimitive::Triangle& triangle = aMesh.Triangles[myPrimitiveIndices[i]];
+			const Vector3<float>& corner = aMesh.Vertices[triangle.V1].Position;
+			const Vector3<float> edgeA = aMesh.Vertices[triangle.V2].Position - corner;
+			const Vector3<float> edgeB = aMesh.Vertices[triangle.V3].Position - corner;
+
+			for (std::uint32_t axis = 0; axis < 3; ++axis)
+			{
+				myTriangles.Corner[axis][i] = GetAxis(corner, axis);
+				myTriangles.EdgeA[axis][i] = GetAxis(edgeA, axis);
+				myTriangles.EdgeB[axis][i] = GetAxis(edgeB, axis);
+			}
+		}
+	}
+
+	template <typename Overlaps>
+	void BoundingVolumeHierarchy::QueryOverlapping(std::vector<std::uint32_t>& someIndicesOut, const Overlaps& anOverlaps) const
+	{
+		someIndicesOut.clear();
+		if (myNodes.empty())
+			return;
+
+		// Nodes to visit, and whether they're already known to be entirely inside, so their contents need no more tests.
+		std::array<std::pair<std::uint32_t, bool>, StackSize> stack;
+		std::size_t stackSize = 0;
+		stack[stackSize++] = { 0, false };
+
+		while (stackSize > 0)
+		{
+			const auto [nodeIndex, isKnownInside] = stack[--stackSize];
+			const Node& node = myNodes[nodeIndex];
+
+			bool isInside = isKnownInside;
+			if (!isKnownInside)
+			{
+				const Overlap overlap = anOverlaps(node.Bounds);
+				if (overlap == Overlap::Outside)
+					continue;
+
+				isInside = overlap == Overlap::Inside;
+			}
+
+			if (!node.IsLeaf())
+			{
+				stack[stackSize++] = { node.FirstPrimitiveOrLeftChild, isInside };
+				stack[stackSize++] = { node.FirstPrimitiveOrLeftChild + 1, isInside };
+				continue;
+			}
+
+			for (std::uint32_t i = node.FirstPrimitiveOrLeftChild; i < node.FirstPrimitiveOrLeftChild + node.PrimitiveCount; ++i)
+			{
+				const std::uint32_t primitive = myPrimitiveIndices[i];
+				if (isInside || anOverlaps(myPrimitiveBounds[primitive]) != Overlap::Outside)
+					someIndicesOut.push_back(primitive);
+			}
+		}
+	}
+}
@@ -0,0 +1,184 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_BoundingVolumes.hpp"
+#include "Atrium_FrustumCuller.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <rose-common/math/Vector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief A ray starting at an origin, reaching up to a distance along its direction.
+	 *        Distances are in multiples of the direction's length, so it doesn't have to be normalized.
+	 */
+	struct Ray
+	{
+		Vector3<float> Origin;
+		Vector3<float> Direction;
+		float MaxDistance = std::numeric_limits<float>::max();
+	};
+
+	/**
+	 * @brief The nearest primitive a ray hit.
+	 */
+	struct RayHit
+	{
+		static constexpr std::uint32_t InvalidIndex = ~0u;
+
+		// Index of the triangle or object that was hit, or InvalidIndex if the ray missed.
+		std::uint32_t Index = InvalidIndex;
+		float Distance = std::numeric_limits<float>::max();
+
+		// Barycentric coordinates of the hit within a triangle, weighting its second and third vertex.
+		float U = 0.f;
+		float V = 0.f;
+
+		bool IsHit() const { return Index != InvalidIndex; }
+	};
+
+	/**
+	 * @brief A bounding volume hierarchy, for raycasts and range queries over many primitives without testing them all.
+	 *        It can be built over the triangles of a mesh, which rays hit exactly,
+	 *        or over the bounds of objects, which rays hit at the point they enter the bounds.
+	 *
+	 *        The tree is built with a binned surface area heuristic, with large subtrees built in parallel.
+	 *        When primitives move without changing much relative to each other, such as animated objects,
+	 *        it can be refit in place instead of rebuilt, at the cost of less efficient queries over time.
+	 */
+	class BoundingVolumeHierarchy
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Build the hierarchy over the bounds of objects, replacing anything built before.
+		 *
+		 * @param someBounds World-space bounds of each object. Their indices are the ones reported by queries.
+		 */
+		void Build(std::span<const AxisAlignedBox> someBounds);
+
+		/**
+		 * @brief Build the hierarchy over the triangles of a mesh, replacing anything built before.
+		 *
+		 * @param aMesh Mesh to build from. Triangle indices are the ones reported by queries.
+		 */
+		void Build(const MeshPrimitive& aMesh);
+
+		/**
+		 * @brief Update the hierarchy for objects that moved, keeping its structure.
+		 *
+		 * @param someBounds New bounds of each object, as many as it was built with.
+		 */
+		void Refit(std::span<const AxisAlignedBox> someBounds);
+
+		/**
+		 * @brief Update the hierarchy for mesh vertices that moved, keeping its structure.
+		 *
+		 * @param aMesh The mesh it was built with, with the same triangles.
+		 */
+		void Refit(const MeshPrimitive& aMesh);
+
+		/**
+		 * @brief Find the nearest primitive along a ray.
+		 *
+		 * @return The hit, which misses if nothing was within the ray's distance.
+		 */
+		RayHit Raycast(const Ray& aRay) const;
+
+		/**
+		 * @brief Find the nearest primitive along four rays at once, sharing the traversal between them.
+		 *        Faster than separate raycasts when the rays are coherent, such as neighbouring pixels or samples around a cursor.
+		 *
+		 * @param someRays Rays to cast.
+		 * @param someHitsOut The hit of each ray.
+		 */
+		void Raycast(std::span<const Ray, 4> someRays, std::span<RayHit, 4> someHitsOut) const;
+
+		/**
+		 * @brief Find the primitives whose bounds are at least partially inside a frustum.
+		 *
+		 * @param someIndicesOut Replaced with the indices of the primitives found, in no particular order.
+		 */
+		void Query(const Frustum& aFrustum, std::vector<std::uint32_t>& someIndicesOut) const;
+
+		/**
+		 * @brief Find the primitives whose bounds overlap a sphere.
+		 *
+		 * @param someIndicesOut Replaced with the indices of the primitives found, in no particular order.
+		 */
+		void Query(const BoundingSphere& aSphere, std::vector<std::uint32_t>& someIndicesOut) const;
+
+		/**
+		 * @brief Find the primitives whose bounds overlap a box.
+		 *
+		 * @param someIndicesOut Replaced with the indices of the primitives found, in no particular order.
+		 */
+		void Query(const AxisAlignedBox& aBox, std::vector<std::uint32_t>& someIndicesOut) const;
+
+		/**
+		 * @brief Get the bounds of everything in the hierarchy.
+		 */
+		AxisAlignedBox GetBounds() const;
+
+		std::size_t GetPrimitiveCount() const { return myPrimitiveIndices.size(); }
+		std::size_t GetNodeCount() const { return myNodes.size(); }
+
+	#pragma endregion
+
+	private:
+		/**
+		 * @brief A node of the tree. Leaves own a range of primitives, other nodes have two children next to each other.
+		 */
+		struct Node
+		{
+			AxisAlignedBox Bounds;
+			std::uint32_t FirstPrimitiveOrLeftChild = 0;
+			std::uint32_t PrimitiveCount = 0;
+
+			bool IsLeaf() const { return PrimitiveCount > 0; }
+		};
+
+		/**
+		 * @brief Triangle positions in leaf order, as separate arrays so several can be tested at once.
+		 *        Stored as a corner and the two edges from it, as the ray test uses them.
+		 */
+		struct TriangleData
+		{
+			std::array<std::vector<float>, 3> Corner;
+			std::array<std::vector<float>, 3> EdgeA;
+			std::array<std::vector<float>, 3> EdgeB;
+		};
+
+		struct BuildContext;
+
+		void BuildTree();
+		void Subdivide(BuildContext& aContext, std::uint32_t aNode, std::uint32_t aBegin, std::uint32_t anEnd, std::uint32_t aDepth);
+		void RefitNodes();
+		void StoreTriangles(const MeshPrimitive& aMesh);
+
+		template <typename Overlaps>
+		void QueryOverlapping(std::vector<std::uint32_t>& someIndicesOut, const Overlaps& anOverlaps) const;
+
+		std::vector<Node> myNodes;
+		std::vector<std::uint32_t> myPrimitiveIndices;
+
+		// Bounds of each primitive, by its original index.
+		std::vector<AxisAlignedBox> myPrimitiveBounds;
+
+		// Only used when built from a mesh.
+		TriangleData myTriangles;
+	};
+}
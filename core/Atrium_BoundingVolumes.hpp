@@ -0,0 +1,50 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include <rose-common/math/Vector.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace Atrium
+{
+	/**
+	 * @brief A box aligned with the axes of its space, described by its minimum and maximum corners.
+	 *        A default-constructed box is empty, and grows to contain the first point added to it.
+	 */
+	struct AxisAlignedBox
+	{
+		Vector3<float> Min { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+		Vector3<float> Max { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+
+		bool IsEmpty() const { return Min.X > Max.X || Min.Y > Max.Y || Min.Z > Max.Z; }
+
+		Vector3<float> GetCenter() const { return (Min + Max) * 0.5f; }
+		Vector3<float> GetExtents() const { return (Max - Min) * 0.5f; }
+
+		void Add(const Vector3<float>& aPoint)
+		{
+			Min = Vector3<float>(std::min(Min.X, aPoint.X), std::min(Min.Y, aPoint.Y), std::min(Min.Z, aPoint.Z));
+			Max = Vector3<float>(std::max(Max.X, aPoint.X), std::max(Max.Y, aPoint.Y), std::max(Max.Z, aPoint.Z));
+		}
+
+		void Add(const AxisAlignedBox& aBox)
+		{
+			if (aBox.IsEmpty())
+				return;
+
+			Add(aBox.Min);
+			Add(aBox.Max);
+		}
+	};
+
+	/**
+	 * @brief A sphere described by its center and radius.
+	 */
+	struct BoundingSphere
+	{
+		Vector3<float> Center;
+		float Radius = 0.f;
+	};
+}
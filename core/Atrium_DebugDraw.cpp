@@ -0,0 +1,498 @@
+// Filter "Graphics"
+
+#include "Atrium_DebugDraw.hpp"
+
+#if IS_DEBUG_DRAW_ENABLED
+
+#include "Atrium_SIMD.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace Atrium::DebugDraw
+{
+	namespace
+	{
+		constexpr std::uint32_t RetiredBufferLifetime = 4;
+		constexpr std::uint32_t MinBufferVertexCount = 4096;
+
+		// Triangles sharing an edge with normals this close are on the same face, and the edge is left out of wireframes.
+		constexpr float FlatFaceThreshold = 0.999f;
+
+		static_assert(sizeof(Vertex) == 4 * sizeof(float), "A vertex is expanded from one SIMD register.");
+
+		struct ShapeCommand
+		{
+			Vector3<float> Center;
+			Vector3<float> AxisX;
+			Vector3<float> AxisY;
+			Vector3<float> AxisZ;
+			std::uint32_t Color;
+			MeshPrimitiveType Type;
+			bool IsSolid;
+		};
+
+		struct Label
+		{
+			Vector3<float> Position;
+			std::uint32_t Color;
+			std::string Text;
+		};
+
+		struct FrameCommands
+		{
+			std::vector<Vertex> Lines;
+			std::vector<ShapeCommand> Shapes;
+			std::vector<Label> Labels;
+
+			bool IsEmpty() const { return Lines.empty() && Shapes.empty() && Labels.empty(); }
+			void Clear() { Lines.clear(); Shapes.clear(); Labels.clear(); }
+		};
+
+		/**
+		 * Commands are recorded into one of two halves, selected by the shared write index.
+		 * Render() flips the index, then waits for any write still using the old half before reading it.
+		 * Only the recording thread writes to its buffer, so adding primitives never takes a lock.
+		 */
+		struct ThreadBuffer
+		{
+			std::array<FrameCommands, 2> Frames;
+			std::atomic<bool> IsWriting = false;
+			std::atomic<bool> IsOrphaned = false;
+		};
+
+		/**
+		 * Positions of a shape as structure-of-arrays, padded to a multiple of four with copies of the last position.
+		 */
+		struct ShapePositions
+		{
+			std::vector<float> X;
+			std::vector<float> Y;
+			std::vector<float> Z;
+			std::size_t Count = 0;
+
+			void Add(const Vector3<float>& aPosition)
+			{
+				X.push_back(aPosition.X);
+				Y.push_back(aPosition.Y);
+				Z.push_back(aPosition.Z);
+				++Count;
+			}
+
+			void Pad()
+			{
+				while (!X.empty() && X.size() % 4 != 0)
+				{
+					X.push_back(X.back());
+					Y.push_back(Y.back());
+					Z.push_back(Z.back());
+				}
+			}
+		};
+
+		struct ShapeTemplate
+		{
+			// Pairs of positions, one per edge.
+			ShapePositions Edges;
+
+			// Triples of positions, one per triangle.
+			ShapePositions Triangles;
+		};
+
+		struct ThreadBufferRegistry
+		{
+			std::mutex Mutex;
+			std::vector<std::unique_ptr<ThreadBuffer>> Buffers;
+		};
+
+		struct RenderState
+		{
+			Atrium::GraphicsAPI* GraphicsAPI = nullptr;
+			std::shared_ptr<PipelineState> LinePipelineState;
+			std::shared_ptr<PipelineState> TrianglePipelineState;
+
+			std::map<MeshPrimitiveType, ShapeTemplate> ShapeTemplates;
+
+			std::vector<Vertex> LineVertices;
+			std::vector<Vertex> TriangleVertices;
+			std::vector<Label> Labels;
+
+			// Replaced buffers may still be read by frames in flight, so they're kept for a few frames.
+			std::shared_ptr<GraphicsBuffer> LineBuffer;
+			std::shared_ptr<GraphicsBuffer> TriangleBuffer;
+			std::vector<std::pair<std::shared_ptr<GraphicsBuffer>, std::uint32_t>> RetiredBuffers;
+		};
+
+		std::atomic<std::uint32_t> ourWriteIndex = 0;
+		std::unique_ptr<RenderState> ourRenderState;
+
+		ThreadBufferRegistry& GetRegistry()
+		{
+			static ThreadBufferRegistry registry;
+			return registry;
+		}
+
+		// Flags the thread's buffer once the thread exits, so it can be released after its last commands are drawn.
+		struct ThreadBufferHandle
+		{
+			~ThreadBufferHandle()
+			{
+				if (Buffer)
+					Buffer->IsOrphaned = true;
+			}
+
+			ThreadBuffer* Buffer = nullptr;
+		};
+
+		ThreadBuffer& GetThreadBuffer()
+		{
+			thread_local ThreadBufferHandle handle;
+			if (!handle.Buffer)
+			{
+				ThreadBufferRegistry& registry = GetRegistry();
+				std::scoped_lock lock(registry.Mutex);
+				handle.Buffer = registry.Buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+			}
+
+			return *handle.Buffer;
+		}
+
+		template <typename WriteFunction>
+		void Record(WriteFunction&& aWriteFunction)
+		{
+			ThreadBuffer& buffer = GetThreadBuffer();
+
+			// Sequentially consistent, so either Render() sees the write in progress or the write sees the flipped index.
+			buffer.IsWriting.store(true);
+			aWriteFunction(buffer.Frames[ourWriteIndex.load()]);
+			buffer.IsWriting.store(false, std::memory_order_release);
+		}
+
+		std::uint32_t PackColor(const ColorARGB<float>& aColor)
+		{
+			const auto toByte = [](float aChannel) { return static_cast<std::uint32_t>(std::clamp(aChannel, 0.f, 1.f) * 255.f + 0.5f); };
+			return toByte(aColor.R)
+				| (toByte(aColor.G) << 8)
+				| (toByte(aColor.B) << 16)
+				| (toByte(aColor.A) << 24);
+		}
+
+		ShapeTemplate BuildShapeTemplate(MeshPrimitiveType aType)
+		{
+			const MeshPrimitive primitive = MeshPrimitive::Generate(aType);
+
+			ShapeTemplate shapeTemplate;
+
+			// Generated meshes may duplicate positions for flat shading, so edges are matched by position.
+			using PositionKey = std::tuple<float, float, float>;
+			using EdgeKey = std::pair<PositionKey, PositionKey>;
+			struct EdgeInfo
+			{
+				Vector3<float> From;
+				Vector3<float> To;
+				Vector3<float> FirstNormal;
+				bool IsVisible = true;
+			};
+
+			std::map<EdgeKey, EdgeInfo> edges;
+			std::vector<EdgeKey> edgeOrder;
+
+			for (const MeshPrimitive::Triangle& triangle : primitive.Triangles)
+			{
+				const std::array<Vector3<float>, 3> positions = {
+					primitive.Vertices[triangle.V1].Position,
+					primitive.Vertices[triangle.V2].Position,
+					primitive.Vertices[triangle.V3].Position
+				};
+
+				for (const Vector3<float>& position : positions)
+					shapeTemplate.Triangles.Add(position);
+
+				const Vector3<float> normal = Vector3<float>::Cross(positions[1] - positions[0], positions[2] - positions[0]).Normalized();
+
+				for (std::size_t i = 0; i < 3; ++i)
+				{
+					const Vector3<float>& from = positions[i];
+					const Vector3<float>& to = positions[(i + 1) % 3];
+
+					PositionKey fromKey { from.X, from.Y, from.Z };
+					PositionKey toKey { to.X, to.Y, to.Z };
+					if (toKey < fromKey)
+						std::swap(fromKey, toKey);
+
+					const EdgeKey key { fromKey, toKey };
+					const auto [it, isNew] = edges.try_emplace(key, EdgeInfo { from, to, normal });
+					if (isNew)
+						edgeOrder.push_back(key);
+					else if (Vector3<float>::Dot(it->second.FirstNormal, normal) > FlatFaceThreshold)
+						it->second.IsVisible = false;
+				}
+			}
+
+			for (const EdgeKey& key : edgeOrder)
+			{
+				const EdgeInfo& edge = edges.at(key);
+				if (!edge.IsVisible)
+					continue;
+
+				shapeTemplate.Edges.Add(edge.From);
+				shapeTemplate.Edges.Add(edge.To);
+			}
+
+			shapeTemplate.Edges.Pad();
+			shapeTemplate.Triangles.Pad();
+			return shapeTemplate;
+		}
+
+		/**
+		 * Transform four positions at a time with SSE, or one at a time without, and interleave them with the color into vertices.
+		 */
+		void ExpandShape(const ShapePositions& somePositions, const ShapeCommand& aCommand, std::vector<Vertex>& someVerticesOut)
+		{
+			if (somePositions.Count == 0)
+				return;
+
+			const std::size_t firstVertex = someVerticesOut.size();
+		#if ATRIUM_SIMD_SSE
+			someVerticesOut.resize(firstVertex + somePositions.X.size());
+			float* output = reinterpret_cast<float*>(someVerticesOut.data() + firstVertex);
+
+			const __m128 centerX = _mm_set1_ps(aCommand.Center.X), centerY = _mm_set1_ps(aCommand.Center.Y), centerZ = _mm_set1_ps(aCommand.Center.Z);
+			const __m128 axisXX = _mm_set1_ps(aCommand.AxisX.X), axisXY = _mm_set1_ps(aCommand.AxisX.Y), axisXZ = _mm_set1_ps(aCommand.AxisX.Z);
+			const __m128 axisYX = _mm_set1_ps(aCommand.AxisY.X), axisYY = _mm_set1_ps(aCommand.AxisY.Y), axisYZ = _mm_set1_ps(aCommand.AxisY.Z);
+			const __m128 axisZX = _mm_set1_ps(aCommand.AxisZ.X), axisZY = _mm_set1_ps(aCommand.AxisZ.Y), axisZZ = _mm_set1_ps(aCommand.AxisZ.Z);
+			const __m128 color = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(aCommand.Color)));
+
+			for (std::size_t i = 0; i < somePositions.X.size(); i += 4)
+			{
+				const __m128 x = _mm_loadu_ps(somePositions.X.data() + i);
+				const __m128 y = _mm_loadu_ps(somePositions.Y.data() + i);
+				const __m128 z = _mm_loadu_ps(somePositions.Z.data() + i);
+
+				__m128 outX = _mm_add_ps(centerX, _mm_add_ps(_mm_mul_ps(x, axisXX), _mm_add_ps(_mm_mul_ps(y, axisYX), _mm_mul_ps(z, axisZX))));
+				__m128 outY = _mm_add_ps(centerY, _mm_add_ps(_mm_mul_ps(x, axisXY), _mm_add_ps(_mm_mul_ps(y, axisYY), _mm_mul_ps(z, axisZY))));
+				__m128 outZ = _mm_add_ps(centerZ, _mm_add_ps(_mm_mul_ps(x, axisXZ), _mm_add_ps(_mm_mul_ps(y, axisYZ), _mm_mul_ps(z, axisZZ))));
+				__m128 outColor = color;
+
+				_MM_TRANSPOSE4_PS(outX, outY, outZ, outColor);
+
+				_mm_storeu_ps(output + i * 4 + 0, outX);
+				_mm_storeu_ps(output + i * 4 + 4, outY);
+				_mm_storeu_ps(output + i * 4 + 8, outZ);
+				_mm_storeu_ps(output + i * 4 + 12, outColor);
+			}
+
+			// Drop the vertices expanded from the padding.
+			someVerticesOut.resize(firstVertex + somePositions.Count);
+		#else
+			someVerticesOut.resize(firstVertex + somePositions.Count);
+			for (std::size_t i = 0; i < somePositions.Count; ++i)
+			{
+				Vertex& vertex = someVerticesOut[firstVertex + i];
+				vertex.Position = aCommand.Center + aCommand.AxisX * somePositions.X[i] + aCommand.AxisY * somePositions.Y[i] + aCommand.AxisZ * somePositions.Z[i];
+				vertex.Color = aCommand.Color;
+			}
+		#endif
+		}
+
+		void Collect(FrameCommands& someCommands, RenderState& aState)
+		{
+			aState.LineVertices.insert(aState.LineVertices.end(), someCommands.Lines.begin(), someCommands.Lines.end());
+
+			for (const ShapeCommand& shape : someCommands.Shapes)
+			{
+				auto it = aState.ShapeTemplates.find(shape.Type);
+				if (it == aState.ShapeTemplates.end())
+					it = aState.ShapeTemplates.emplace(shape.Type, BuildShapeTemplate(shape.Type)).first;
+
+				if (shape.IsSolid)
+					ExpandShape(it->second.Triangles, shape, aState.TriangleVertices);
+				else
+					ExpandShape(it->second.Edges, shape, aState.LineVertices);
+			}
+
+			for (Label& label : someCommands.Labels)
+				aState.Labels.push_back(std::move(label));
+
+			someCommands.Clear();
+		}
+
+		void Upload(RenderState& aState, const std::vector<Vertex>& someVertices, std::shared_ptr<GraphicsBuffer>& aBuffer, const wchar_t* aName)
+		{
+			const std::uint32_t vertexCount = static_cast<std::uint32_t>(someVertices.size());
+			if (vertexCount == 0)
+				return;
+
+			if (!aBuffer || aBuffer->GetCount() < vertexCount)
+			{
+				if (aBuffer)
+					aState.RetiredBuffers.emplace_back(std::move(aBuffer), RetiredBufferLifetime);
+
+				const std::uint32_t bufferCount = std::max(MinBufferVertexCount, std::bit_ceil(vertexCount));
+				aBuffer = aState.GraphicsAPI->GetResourceManager().CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, bufferCount, sizeof(Vertex));
+				if (aBuffer)
+					aBuffer->SetName(aName);
+			}
+
+			if (aBuffer)
+				aBuffer->SetData(someVertices.data(), vertexCount * static_cast<std::uint32_t>(sizeof(Vertex)));
+		}
+
+		void DrawVertices(FrameGraphicsContext& aContext, const std::shared_ptr<PipelineState>& aPipelineState, PrimitiveTopology aTopology, const std::shared_ptr<GraphicsBuffer>& aBuffer, std::size_t aVertexCount)
+		{
+			if (aVertexCount == 0 || !aBuffer || !aPipelineState)
+				return;
+
+			aContext.SetPipelineState(aPipelineState);
+			aContext.SetPrimitiveTopology(aTopology);
+			aContext.SetVertexBuffer(aBuffer);
+			aContext.Draw(static_cast<std::uint32_t>(aVertexCount), 0);
+		}
+	}
+
+	std::vector<PipelineStateDescription::InputLayoutEntry> GetInputLayout()
+	{
+		using InputLayoutEntry = PipelineStateDescription::InputLayoutEntry;
+		return {
+			InputLayoutEntry("POSITION", GraphicsFormat::R32G32B32_SFloat),
+			InputLayoutEntry("COLOR", GraphicsFormat::R8G8B8A8_UNorm)
+		};
+	}
+
+	void Initialize(GraphicsAPI& aGraphicsAPI, const std::shared_ptr<PipelineState>& aLinePipelineState, const std::shared_ptr<PipelineState>& aTrianglePipelineState)
+	{
+		Debug::Assert(!ourRenderState, "Debug drawing is only initialized once.");
+
+		ourRenderState = std::make_unique<RenderState>();
+		ourRenderState->GraphicsAPI = &aGraphicsAPI;
+		ourRenderState->LinePipelineState = aLinePipelineState;
+		ourRenderState->TrianglePipelineState = aTrianglePipelineState;
+	}
+
+	void Shutdown()
+	{
+		ourRenderState.reset();
+	}
+
+	void Render(FrameGraphicsContext& aContext)
+	{
+		PROFILE_SCOPE();
+
+		if (!ourRenderState)
+			return;
+
+		RenderState& state = *ourRenderState;
+
+		for (auto& retiredBuffer : state.RetiredBuffers)
+			--retiredBuffer.second;
+
+		std::erase_if(state.RetiredBuffers, [](const auto& aRetiredBuffer) { return aRetiredBuffer.second == 0; });
+
+		state.LineVertices.clear();
+		state.TriangleVertices.clear();
+		state.Labels.clear();
+
+		const std::uint32_t readIndex = ourWriteIndex.load();
+		ourWriteIndex.store(readIndex ^ 1);
+
+		{
+			ThreadBufferRegistry& registry = GetRegistry();
+			std::scoped_lock lock(registry.Mutex);
+
+			for (const std::unique_ptr<ThreadBuffer>& buffer : registry.Buffers)
+			{
+				while (buffer->IsWriting.load())
+					std::this_thread::yield();
+
+				Collect(buffer->Frames[readIndex], state);
+			}
+
+			// The other half of an exited thread's buffer can still have commands from before the flip, so those wait for the next frame.
+			std::erase_if(registry.Buffers, [readIndex](const std::unique_ptr<ThreadBuffer>& aBuffer) {
+				return aBuffer->IsOrphaned && aBuffer->Frames[readIndex ^ 1].IsEmpty();
+				});
+		}
+
+		Upload(state, state.LineVertices, state.LineBuffer, L"Debug draw lines");
+		Upload(state, state.TriangleVertices, state.TriangleBuffer, L"Debug draw triangles");
+
+		CONTEXT_ZONE(aContext, "Debug draw");
+		DrawVertices(aContext, state.TrianglePipelineState, PrimitiveTopology::TriangleList, state.TriangleBuffer, state.TriangleVertices.size());
+		DrawVertices(aContext, state.LinePipelineState, PrimitiveTopology::LineList, state.LineBuffer, state.LineVertices.size());
+
+		PROFILE_PLOT("Debug draw vertices", static_cast<std::int64_t>(state.LineVertices.size() + state.TriangleVertices.size()));
+	}
+
+	void ForEachLabel(const std::function<void(const Vector3<float>&, std::uint32_t, std::string_view)>& aVisitor)
+	{
+		if (!ourRenderState)
+			return;
+
+		for (const Label& label : ourRenderState->Labels)
+			aVisitor(label.Position, label.Color, label.Text);
+	}
+
+	void Line(const Vector3<float>& aFrom, const Vector3<float>& aTo, const ColorARGB<float>& aColor)
+	{
+		const std::uint32_t color = PackColor(aColor);
+		Record([&](FrameCommands& someCommands) {
+			someCommands.Lines.push_back(Vertex { aFrom, color });
+			someCommands.Lines.push_back(Vertex { aTo, color });
+			});
+	}
+
+	void Shape(MeshPrimitiveType aType, const Vector3<float>& aCenter, const Vector3<float>& anAxisX, const Vector3<float>& anAxisY, const Vector3<float>& anAxisZ, const ColorARGB<float>& aColor, bool anIsSolid)
+	{
+		const ShapeCommand command { aCenter, anAxisX, anAxisY, anAxisZ, PackColor(aColor), aType, anIsSolid };
+		Record([&](FrameCommands& someCommands) {
+			someCommands.Shapes.push_back(command);
+			});
+	}
+
+	void Box(const Vector3<float>& aCenter, const Vector3<float>& someHalfExtents, const ColorARGB<float>& aColor, bool anIsSolid)
+	{
+		// The generated cube spans -1 to 1 on each axis.
+		Shape(MeshPrimitiveType::Cube, aCenter,
+			Vector3<float>(someHalfExtents.X, 0.f, 0.f),
+			Vector3<float>(0.f, someHalfExtents.Y, 0.f),
+			Vector3<float>(0.f, 0.f, someHalfExtents.Z),
+			aColor, anIsSolid);
+	}
+
+	void Sphere(const Vector3<float>& aCenter, float aRadius, const ColorARGB<float>& aColor, bool anIsSolid)
+	{
+		// The generated icosphere has a radius of 1.
+		Shape(MeshPrimitiveType::Icosphere, aCenter,
+			Vector3<float>(aRadius, 0.f, 0.f),
+			Vector3<float>(0.f, aRadius, 0.f),
+			Vector3<float>(0.f, 0.f, aRadius),
+			aColor, anIsSolid);
+	}
+
+	void Marker(const Vector3<float>& aPosition, float aSize, const ColorARGB<float>& aColor, std::string_view aLabel)
+	{
+		const std::uint32_t color = PackColor(aColor);
+		const float halfSize = aSize * 0.5f;
+
+		Record([&](FrameCommands& someCommands) {
+			someCommands.Lines.push_back(Vertex { aPosition - Vector3<float>(halfSize, 0.f, 0.f), color });
+			someCommands.Lines.push_back(Vertex { aPosition + Vector3<float>(halfSize, 0.f, 0.f), color });
+			someCommands.Lines.push_back(Vertex { aPosition - Vector3<float>(0.f, halfSize, 0.f), color });
+			someCommands.Lines.push_back(Vertex { aPosition + Vector3<float>(0.f, halfSize, 0.f), color });
+			someCommands.Lines.push_back(Vertex { aPosition - Vector3<float>(0.f, 0.f, halfSize), color });
+			someCommands.Lines.push_back(Vertex { aPosition + Vector3<float>(0.f, 0.f, halfSize), color });
+
+			if (!aLabel.empty())
+				someCommands.Labels.push_back(Label { aPosition, color, std::string(aLabel) });
+			});
+	}
+}
+
+#endif
@@ -0,0 +1,117 @@
+// Filter "Graphics"
+
+#pragma once
+
+/**
+ * Debug drawing is only available outside of retail builds, where IS_DEBUG_DRAW_ENABLED is defined.
+ * Draw through the DEBUG_DRAW_* macros, so the calls and their arguments compile out in retail builds.
+ */
+#if IS_DEBUG_DRAW_ENABLED
+
+#include "Atrium_FrameContext.hpp"
+#include "Atrium_GraphicsAPI.hpp"
+#include "Atrium_GraphicsPipeline.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <rose-common/Color.hpp>
+#include <rose-common/math/Vector.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Immediate-mode drawing of lines, shapes and markers, to visualize bounds, paths or physics shapes.
+ *        Primitives can be added from any thread, into buffers owned by each thread, and are drawn by the next Render().
+ *        Lines are drawn with a single line-list draw and solid shapes with a single triangle-list draw.
+ *
+ *        Shapes are the meshes MeshPrimitive::Generate() creates, placed by a center and three axes.
+ *        Their wireframes are the edges of the mesh, leaving out the diagonals of flat faces.
+ */
+namespace Atrium::DebugDraw
+{
+	/**
+	 * @brief Vertex layout of both draws.
+	 */
+	struct Vertex
+	{
+		Vector3<float> Position;
+
+		// Read as R8G8B8A8_UNorm.
+		std::uint32_t Color;
+	};
+
+	/**
+	 * @brief Get the input layout that the debug-draw pipelines need.
+	 */
+	std::vector<PipelineStateDescription::InputLayoutEntry> GetInputLayout();
+
+	/**
+	 * @brief Set up rendering of the primitives.
+	 *
+	 * @param aGraphicsAPI Graphics API to create the vertex buffers with.
+	 * @param aLinePipelineState Pipeline state to draw lines with, with a line topology.
+	 * @param aTrianglePipelineState Pipeline state to draw solid shapes with, with a triangle topology.
+	 */
+	void Initialize(GraphicsAPI& aGraphicsAPI, const std::shared_ptr<PipelineState>& aLinePipelineState, const std::shared_ptr<PipelineState>& aTrianglePipelineState);
+
+	/**
+	 * @brief Release the pipeline states and buffers, before the graphics API is destroyed.
+	 */
+	void Shutdown();
+
+	/**
+	 * @brief Draw all primitives added since the last call, then remove them.
+	 *        Call once per frame. Primitives added by other threads while rendering are drawn the next time.
+	 *
+	 * @param aContext Context to record the draws to. Render targets and the view's constants are expected to be set.
+	 */
+	void Render(FrameGraphicsContext& aContext);
+
+	/**
+	 * @brief Visit the labels of the markers drawn by the last Render(), such as to draw them with a UI overlay.
+	 *
+	 * @param aVisitor Function called with the world position, packed color and text of each label.
+	 */
+	void ForEachLabel(const std::function<void(const Vector3<float>&, std::uint32_t, std::string_view)>& aVisitor);
+
+	void Line(const Vector3<float>& aFrom, const Vector3<float>& aTo, const ColorARGB<float>& aColor);
+
+	/**
+	 * @brief Draw a MeshPrimitive shape.
+	 *
+	 * @param aType Shape to draw.
+	 * @param aCenter Where the origin of the shape is placed.
+	 * @param anAxisX, anAxisY, anAxisZ Axes the shape's X, Y and Z are mapped to, which scale and rotate it.
+	 * @param aColor Color of the shape.
+	 * @param anIsSolid Draw the triangles of the shape rather than its edges.
+	 */
+	void Shape(MeshPrimitiveType aType, const Vector3<float>& aCenter, const Vector3<float>& anAxisX, const Vector3<float>& anAxisY, const Vector3<float>& anAxisZ, const ColorARGB<float>& aColor, bool anIsSolid = false);
+
+	void Box(const Vector3<float>& aCenter, const Vector3<float>& someHalfExtents, const ColorARGB<float>& aColor, bool anIsSolid = false);
+	void Sphere(const Vector3<float>& aCenter, float aRadius, const ColorARGB<float>& aColor, bool anIsSolid = false);
+
+	/**
+	 * @brief Draw a cross along each axis at a position, with an optional text label.
+	 *        Labels aren't rendered by the debug drawing itself, see ForEachLabel().
+	 */
+	void Marker(const Vector3<float>& aPosition, float aSize, const ColorARGB<float>& aColor, std::string_view aLabel = { });
+}
+
+#define DEBUG_DRAW_LINE(...) ::Atrium::DebugDraw::Line(__VA_ARGS__)
+#define DEBUG_DRAW_SHAPE(...) ::Atrium::DebugDraw::Shape(__VA_ARGS__)
+#define DEBUG_DRAW_BOX(...) ::Atrium::DebugDraw::Box(__VA_ARGS__)
+#define DEBUG_DRAW_SPHERE(...) ::Atrium::DebugDraw::Sphere(__VA_ARGS__)
+#define DEBUG_DRAW_MARKER(...) ::Atrium::DebugDraw::Marker(__VA_ARGS__)
+
+#else
+
+#define DEBUG_DRAW_LINE(...)
+#define DEBUG_DRAW_SHAPE(...)
+#define DEBUG_DRAW_BOX(...)
+#define DEBUG_DRAW_SPHERE(...)
+#define DEBUG_DRAW_MARKER(...)
+
+#endif
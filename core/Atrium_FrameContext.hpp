@@ -14,10 +14,14 @@
 #include <functional>
 #include <memory>
 #include <source_location>
+#include <span>
 #include <vector>
 
 namespace Atrium
 {
+	class CommandBundle;
+	class FrameComputeContext;
+
 	/**
 	 * @brief Handles graphics commands and GPU data submission for a specific frame.
 	 */
@@ -32,6 +36,53 @@ namespace Atrium
 
 		struct ProfileContextZone;
 
+		/**
+		 * @brief Arguments for a single indexed, instanced draw.
+		 *        Matches the layout of the records read by DrawIndexedInstancedIndirect().
+		 */
+		struct DrawIndexedArguments
+		{
+			std::uint32_t IndexCountPerInstance = 0;
+			std::uint32_t InstanceCount = 1;
+			std::uint32_t StartIndexLocation = 0;
+			std::int32_t BaseVertexLocation = 0;
+			std::uint32_t StartInstanceLocation = 0;
+		};
+
+		/**
+		 * @brief Arguments for a single compute dispatch.
+		 *        Matches the layout of the records read by DispatchIndirect().
+		 */
+		struct DispatchArguments
+		{
+			std::uint32_t GroupCountX = 1;
+			std::uint32_t GroupCountY = 1;
+			std::uint32_t GroupCountZ = 1;
+		};
+
+		/**
+		 * @brief A requested state change for a texture or a buffer.
+		 *        For render textures, depth states apply to the depth buffer and all other states to the color buffer.
+		 */
+		struct ResourceTransition
+		{
+			std::shared_ptr<Atrium::Texture> Texture;
+			std::shared_ptr<Atrium::GraphicsBuffer> Buffer;
+			ResourceState State = ResourceState::Common;
+		};
+
+		/**
+		 * @brief When a transition takes effect.
+		 *        Split transitions begin after a resource's last use and end before its next,
+		 *        so the GPU can perform them while unrelated work runs in between.
+		 */
+		enum class TransitionTiming
+		{
+			Immediate,
+			Begin,
+			End
+		};
+
 	#pragma endregion
 
 		//--------------------------------------------------
@@ -39,16 +90,25 @@ namespace Atrium
 		//--------------------------------------------------
 	#pragma region Methods
 
-	/**
-	 * @brief Create a new graphics profiling zone.
-	 *        Do not use directly, use "CONTEXT_ZONE" macro instead.
-	 */
+		/**
+		 * @brief Create a new graphics profiling zone.
+		 *        Do not use directly, use "CONTEXT_ZONE" macro instead.
+		 */
 		virtual void BeginProfileZone(ProfileContextZone& aZoneScope
 		#ifdef TRACY_ENABLE
 			, const tracy::SourceLocationData& aLocation
 		#endif
 		) = 0;
 
+		/**
+		 * @brief Make this context's work wait on the GPU for a compute context's work of the same frame.
+		 *        The compute context is submitted before this one, even if it was created after it.
+		 *        The dependency applies to every following frame.
+		 *
+		 * @param aContext Compute context to wait for.
+		 */
+		virtual void AddDependency(const std::shared_ptr<FrameComputeContext>& aContext) = 0;
+
 		/**
 		 * @brief Clear a render texture's color to a specific value.
 		 *        If the chosen target has no color buffer, the call does nothing.
@@ -78,6 +138,27 @@ namespace Atrium
 		virtual void Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY) = 0;
 		virtual void Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ) = 0;
 
+		/**
+		 * @brief Dispatch compute work with group counts read from a buffer of DispatchArguments records.
+		 *        The records can be written by an earlier dispatch, like the arguments of DrawIndexedInstancedIndirect().
+		 *
+		 * @param anArgumentBuffer Buffer created with the IndirectArguments target, holding the argument records.
+		 * @param aMaxDispatchCount Number of records to execute, or the upper limit if a count buffer is used.
+		 * @param anArgumentOffset Offset in bytes to the first record.
+		 * @param aCountBuffer Optional buffer holding a 32-bit record count, clamped to aMaxDispatchCount.
+		 * @param aCountOffset Offset in bytes to the count value.
+		 */
+		virtual void DispatchIndirect(const std::shared_ptr<GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset = 0, const std::shared_ptr<GraphicsBuffer>& aCountBuffer = nullptr, std::uint32_t aCountOffset = 0) = 0;
+
+		/**
+		 * @brief Replay a closed command bundle.
+		 *        The bundle uses the render targets, viewport and scissor rect set on this context.
+		 *        The pipeline state and resources it sets stay set afterwards, so set them again before drawing without the bundle.
+		 *
+		 * @param aBundle Bundle to replay, created with GraphicsAPI::CreateCommandBundle().
+		 */
+		virtual void ExecuteBundle(const std::shared_ptr<CommandBundle>& aBundle) = 0;
+
 		/**
 		 * @brief Draw primitives.
 		 *
@@ -116,6 +197,27 @@ namespace Atrium
 		 */
 		virtual void DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation) = 0;
 
+		/**
+		 * @brief Draw a batch of indexed, instanced primitives sharing the currently bound state and resources.
+		 *        Pipeline resources are only flushed once for the whole batch.
+		 *
+		 * @param someDraws Arguments for each draw.
+		 */
+		virtual void DrawIndexedInstancedBatch(std::span<const DrawIndexedArguments> someDraws) = 0;
+
+		/**
+		 * @brief Draw indexed, instanced primitives with arguments read from a buffer of DrawIndexedArguments records.
+		 *        The records are either written from the CPU with SetData(), or by a compute shader writing an UnorderedAccess buffer,
+		 *        which is transitioned for reading the arguments here.
+		 *
+		 * @param anArgumentBuffer Buffer created with the IndirectArguments target, holding the argument records.
+		 * @param aMaxDrawCount Number of records to draw, or the upper limit if a count buffer is used.
+		 * @param anArgumentOffset Offset in bytes to the first record.
+		 * @param aCountBuffer Optional buffer holding a 32-bit record count, clamped to aMaxDrawCount.
+		 * @param aCountOffset Offset in bytes to the count value.
+		 */
+		virtual void DrawIndexedInstancedIndirect(const std::shared_ptr<GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDrawCount, std::uint32_t anArgumentOffset = 0, const std::shared_ptr<GraphicsBuffer>& aCountBuffer = nullptr, std::uint32_t aCountOffset = 0) = 0;
+
 		/**
 		 * @brief Set the blend factor that modulate values for a pixel-shader, render-target, or both.
 		 *
@@ -140,6 +242,23 @@ namespace Atrium
 		 */
 		virtual void SetVertexBuffer(const std::shared_ptr<const GraphicsBuffer>& aVertexBuffer, unsigned int aSlot = 0) = 0;
 
+		/**
+		 * @brief Set a graphics buffer containing indices as the current index buffer, for indexed draws.
+		 *        The size of the indices is taken from the buffer's stride, which is either 2 or 4 bytes.
+		 *
+		 * @param anIndexBuffer Graphics buffer to use.
+		 */
+		virtual void SetIndexBuffer(const std::shared_ptr<const GraphicsBuffer>& anIndexBuffer) = 0;
+
+		/**
+		 * @brief Set 32-bit root constants declared with AddConstant() or AddConstants(), for example bindless resource indices.
+		 *
+		 * @param anUpdateFrequency Update frequency of the constants, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param someValues Values to set, starting at the first constant of the register.
+		 */
+		virtual void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) = 0;
+
 		/**
 		 * @brief Bind a graphics buffer into a specific slot of the root signature, for use in shaders.
 		 *
@@ -158,6 +277,16 @@ namespace Atrium
 		 */
 		virtual void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Texture>& aTexture) = 0;
 
+		/**
+		 * @brief Bind a graphics buffer for shaders to write, into a UAV root parameter declared with AddUAV().
+		 *        The buffer is transitioned for unordered access here, and back for reading when used for indirect arguments.
+		 *
+		 * @param anUpdateFrequency Update frequency of the chosen resource, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param aBuffer Graphics buffer created with the UnorderedAccess target and the Dynamic mode.
+		 */
+		virtual void SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<GraphicsBuffer>& aBuffer) = 0;
+
 		/**
 		 * @brief Select the type of primitive topology that describes the input data for the Input Assembler stage.
 		 *
@@ -202,6 +331,160 @@ namespace Atrium
 		 */
 		virtual void SetViewport(const Rectangle<float>& aRectangle) = 0;
 
+		/**
+		 * @brief Transition several resources at once, so their barriers are submitted together.
+		 *        Commands that bind or clear resources still transition them as needed, but find them ready when done up front.
+		 *
+		 * @param someTransitions Resources and the states to transition them to.
+		 * @param aTiming Whether to transition right away, or to begin or end a split transition.
+		 *                A begun transition has to be ended with the same resources and states before the resources are used.
+		 */
+		virtual void TransitionResources(std::span<const ResourceTransition> someTransitions, TransitionTiming aTiming = TransitionTiming::Immediate) = 0;
+
+	#pragma endregion
+	};
+
+	/**
+	 * @brief Handles compute commands for a specific frame, submitted separately from graphics work
+	 *        so it can overlap with it on the GPU.
+	 */
+	class FrameComputeContext
+	{
+	public:
+		virtual ~FrameComputeContext() = default;
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Create a new compute profiling zone.
+		 *        Do not use directly, use "CONTEXT_ZONE" macro instead.
+		 */
+		virtual void BeginProfileZone(FrameGraphicsContext::ProfileContextZone& aZoneScope
+		#ifdef TRACY_ENABLE
+			, const tracy::SourceLocationData& aLocation
+		#endif
+		) = 0;
+
+		/**
+		 * @brief Make this context's work wait on the GPU for a graphics context's work of the same frame.
+		 *        The graphics context is submitted before this one, even if it was created after it.
+		 *        The dependency applies to every following frame.
+		 *
+		 * @param aContext Graphics context to wait for.
+		 */
+		virtual void AddDependency(const std::shared_ptr<FrameGraphicsContext>& aContext) = 0;
+
+		virtual void Dispatch(std::uint32_t aGroupCountX, std::uint32_t aGroupCountY, std::uint32_t aGroupCountZ) = 0;
+		virtual void Dispatch1D(std::uint32_t aThreadCountX, std::uint32_t aGroupSizeX) = 0;
+		virtual void Dispatch2D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY) = 0;
+		virtual void Dispatch3D(std::uint32_t aThreadCountX, std::uint32_t aThreadCountY, std::uint32_t aThreadCountZ, std::uint32_t aGroupSizeX, std::uint32_t aGroupSizeY, std::uint32_t aGroupSizeZ) = 0;
+
+		/**
+		 * @brief Dispatch compute work with group counts read from a buffer of DispatchArguments records.
+		 *        The records can be written by an earlier dispatch, like the arguments of DrawIndexedInstancedIndirect().
+		 *
+		 * @param anArgumentBuffer Buffer created with the IndirectArguments target, holding the argument records.
+		 * @param aMaxDispatchCount Number of records to execute, or the upper limit if a count buffer is used.
+		 * @param anArgumentOffset Offset in bytes to the first record.
+		 * @param aCountBuffer Optional buffer holding a 32-bit record count, clamped to aMaxDispatchCount.
+		 * @param aCountOffset Offset in bytes to the count value.
+		 */
+		virtual void DispatchIndirect(const std::shared_ptr<GraphicsBuffer>& anArgumentBuffer, std::uint32_t aMaxDispatchCount, std::uint32_t anArgumentOffset = 0, const std::shared_ptr<GraphicsBuffer>& aCountBuffer = nullptr, std::uint32_t aCountOffset = 0) = 0;
+
+		/**
+		 * @brief Set the active compute Pipeline State Object, including its root signature.
+		 *
+		 * @param aPipelineState Pipeline State Object created with ResourceManager::CreateComputePipelineState().
+		 */
+		virtual void SetPipelineState(const std::shared_ptr<PipelineState>& aPipelineState) = 0;
+
+		/**
+		 * @brief Set 32-bit root constants declared with AddConstant() or AddConstants().
+		 *
+		 * @param anUpdateFrequency Update frequency of the constants, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param someValues Values to set, starting at the first constant of the register.
+		 */
+		virtual void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) = 0;
+
+		/**
+		 * @brief Bind a graphics buffer into a specific slot of the root signature, for use in shaders.
+		 *
+		 * @param anUpdateFrequency Update frequency of the chosen resource, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param aBuffer Graphics buffer to bind.
+		 */
+		virtual void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<GraphicsBuffer>& aBuffer) = 0;
+
+		/**
+		 * @brief Bind a texture buffer into a specific slot of the root signature, for use in shaders.
+		 *
+		 * @param anUpdateFrequency Update frequency of the chosen resource, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param aTexture Texture buffer to bind.
+		 */
+		virtual void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Texture>& aTexture) = 0;
+
+		/**
+		 * @brief Bind a graphics buffer for shaders to write, into a UAV root parameter declared with AddUAV().
+		 *        The buffer is transitioned for unordered access here, and back for reading when used for indirect arguments.
+		 *
+		 * @param anUpdateFrequency Update frequency of the chosen resource, to inform which register to use.
+		 * @param aRegisterIndex Index of the register to use.
+		 * @param aBuffer Graphics buffer created with the UnorderedAccess target and the Dynamic mode.
+		 */
+		virtual void SetPipelineUnorderedAccess(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<GraphicsBuffer>& aBuffer) = 0;
+
+	#pragma endregion
+	};
+
+	/**
+	 * @brief A reusable sequence of draw commands, recorded once and replayed with FrameGraphicsContext::ExecuteBundle() in any later frame.
+	 *        Meant for static geometry, where the pipeline states, resources and draws don't change between frames.
+	 *
+	 *        Bundles can't change render targets, viewports or resource states. The resources they bind are kept alive with the bundle,
+	 *        and their contents can still be updated between replays. Constant buffers and textures are read as they are in the replaying frame,
+	 *        while vertex and index buffers stay bound as they were at record time, so use Dynamic buffers for ones that change.
+	 */
+	class CommandBundle
+	{
+	public:
+		virtual ~CommandBundle() = default;
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Finish recording. The bundle can't be replayed before it is closed, or recorded to after.
+		 */
+		virtual void Close() = 0;
+
+		/**
+		 * @brief Check whether recording has finished.
+		 */
+		virtual bool IsClosed() const = 0;
+
+		virtual void Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset) = 0;
+		virtual void DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation) = 0;
+		virtual void DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation) = 0;
+		virtual void DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation) = 0;
+		virtual void DrawIndexedInstancedBatch(std::span<const FrameGraphicsContext::DrawIndexedArguments> someDraws) = 0;
+
+		virtual void SetBlendFactor(ColorARGB<float> aBlendFactor) = 0;
+		virtual void SetPipelineState(const std::shared_ptr<PipelineState>& aPipelineState) = 0;
+		virtual void SetVertexBuffer(const std::shared_ptr<const GraphicsBuffer>& aVertexBuffer, unsigned int aSlot = 0) = 0;
+		virtual void SetIndexBuffer(const std::shared_ptr<const GraphicsBuffer>& anIndexBuffer) = 0;
+		virtual void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) = 0;
+		virtual void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<GraphicsBuffer>& aBuffer) = 0;
+		virtual void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Texture>& aTexture) = 0;
+		virtual void SetPrimitiveTopology(PrimitiveTopology aTopology) = 0;
+		virtual void SetStencilRef(std::uint32_t aStencilRef) = 0;
+
 	#pragma endregion
 	};
 
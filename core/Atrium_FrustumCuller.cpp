@@ -0,0 +1,255 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_FrustumCuller.hpp"
+#include "Atrium_SIMD.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Below this, handing ranges to workers costs more than culling on one thread.
+		constexpr std::size_t ParallelCullThreshold = 65536;
+		constexpr unsigned int MaxCullThreads = 8;
+
+	#if ATRIUM_SIMD_AVX2
+		constexpr std::size_t SimdWidth = 8;
+	#elif ATRIUM_SIMD_SSE
+		constexpr std::size_t SimdWidth = 4;
+	#else
+		constexpr std::size_t SimdWidth = 1;
+	#endif
+
+		Plane NormalizePlane(float aNormalX, float aNormalY, float aNormalZ, float aDistance)
+		{
+			const float length = std::sqrt(aNormalX * aNormalX + aNormalY * aNormalY + aNormalZ * aNormalZ);
+			const float inverseLength = length > 0.f ? 1.f / length : 0.f;
+			return Plane { Vector3<float>(aNormalX * inverseLength, aNormalY * inverseLength, aNormalZ * inverseLength), aDistance * inverseLength };
+		}
+
+		// Per plane, the normal, its absolute value and the distance, to test boxes by their center and extents.
+		struct PlaneTerms
+		{
+			float NormalX, NormalY, NormalZ;
+			float AbsNormalX, AbsNormalY, AbsNormalZ;
+			float Distance;
+		};
+
+		std::array<PlaneTerms, 6> GetPlaneTerms(const Frustum& aFrustum)
+		{
+			std::array<PlaneTerms, 6> terms;
+			for (std::size_t i = 0; i < terms.size(); ++i)
+			{
+				const Plane& plane = aFrustum.Planes[i];
+				terms[i] = PlaneTerms {
+					plane.Normal.X, plane.Normal.Y, plane.Normal.Z,
+					std::abs(plane.Normal.X), std::abs(plane.Normal.Y), std::abs(plane.Normal.Z),
+					plane.Distance
+				};
+			}
+
+			return terms;
+		}
+	}
+
+	Frustum Frustum::FromViewProjection(const std::array<float, 16>& aViewProjection)
+	{
+		// Gribb-Hartmann extraction, from the columns of the matrix.
+		const auto element = [&aViewProjection](std::size_t aRow, std::size_t aColumn) { return aViewProjection[aRow * 4 + aColumn]; };
+		const auto combine = [&element](std::size_t aColumn, float aSign, std::size_t anotherColumn) {
+			return NormalizePlane(
+				element(0, aColumn) + aSign * element(0, anotherColumn),
+				element(1, aColumn) + aSign * element(1, anotherColumn),
+				element(2, aColumn) + aSign * element(2, anotherColumn),
+				element(3, aColumn) + aSign * element(3, anotherColumn));
+		};
+
+		Frustum frustum;
+		frustum.Planes[0] = combine(3, 1.f, 0);  // Left
+		frustum.Planes[1] = combine(3, -1.f, 0); // Right
+		frustum.Planes[2] = combine(3, 1.f, 1);  // Bottom
+		frustum.Planes[3] = combine(3, -1.f, 1); // Top
+		frustum.Planes[4] = NormalizePlane(element(0, 2), element(1, 2), element(2, 2), element(3, 2)); // Near
+		frustum.Planes[5] = combine(3, -1.f, 2); // Far
+		return frustum;
+	}
+
+	std::uint32_t FrustumCuller::Add(const AxisAlignedBox& aBox)
+	{
+		const std::uint32_t index = static_cast<std::uint32_t>(myCenterX.size());
+		myCenterX.emplace_back();
+		myCenterY.emplace_back();
+		myCenterZ.emplace_back();
+		myExtentX.emplace_back();
+		myExtentY.emplace_back();
+		myExtentZ.emplace_back();
+
+		Set(index, aBox);
+		return index;
+	}
+
+	std::uint32_t FrustumCuller::Add(const BoundingSphere& aSphere)
+	{
+		AxisAlignedBox box;
+		box.Min = aSphere.Center - Vector3<float>(aSphere.Radius, aSphere.Radius, aSphere.Radius);
+		box.Max = aSphere.Center + Vector3<float>(aSphere.Radius, aSphere.Radius, aSphere.Radius);
+		return Add(box);
+	}
+
+	void FrustumCuller::Set(std::uint32_t anIndex, const AxisAlignedBox& aBox)
+	{
+		Debug::Assert(anIndex < myCenterX.size(), "Object %u has been added.", anIndex);
+
+		const Vector3<float> center = aBox.GetCenter();
+		const Vector3<float> extents = aBox.GetExtents();
+		myCenterX[anIndex] = center.X;
+		myCenterY[anIndex] = center.Y;
+		myCenterZ[anIndex] = center.Z;
+		myExtentX[anIndex] = extents.X;
+		myExtentY[anIndex] = extents.Y;
+		myExtentZ[anIndex] = extents.Z;
+	}
+
+	void FrustumCuller::Clear()
+	{
+		myCenterX.clear();
+		myCenterY.clear();
+		myCenterZ.clear();
+		myExtentX.clear();
+		myExtentY.clear();
+		myExtentZ.clear();
+	}
+
+	void FrustumCuller::Cull(const Frustum& aFrustum, std::vector<std::uint32_t>& someVisibleIndicesOut)
+	{
+		PROFILE_SCOPE();
+
+		const std::size_t objectCount = GetCount();
+		someVisibleIndicesOut.resize(objectCount);
+
+		WorkerPool& workerPool = WorkerPool::Get();
+		const unsigned int threadCount = objectCount < ParallelCullThreshold ? 1 : std::min(workerPool.GetThreadCount(), MaxCullThreads);
+		if (threadCount == 1)
+		{
+			someVisibleIndicesOut.resize(CullRange(aFrustum, 0, objectCount, someVisibleIndicesOut.data()));
+			return;
+		}
+
+		// Ranges are whole SIMD batches, so only the last range has a remainder.
+		const std::size_t objectsPerThread = (((objectCount + threadCount - 1) / threadCount) + SimdWidth - 1) / SimdWidth * SimdWidth;
+
+		myThreadResults.resize(threadCount);
+		std::vector<std::size_t> visibleCounts(threadCount, 0);
+
+		workerPool.ParallelFor(threadCount, [&](std::size_t aRange) {
+			const std::size_t rangeBegin = std::min(objectCount, aRange * objectsPerThread);
+			const std::size_t rangeEnd = std::min(objectCount, rangeBegin + objectsPerThread);
+
+			// The first range is written straight to the output, which the others are compacted after.
+			if (aRange == 0)
+			{
+				visibleCounts[0] = CullRange(aFrustum, rangeBegin, rangeEnd, someVisibleIndicesOut.data());
+				return;
+			}
+
+			myThreadResults[aRange].resize(rangeEnd - rangeBegin);
+			visibleCounts[aRange] = CullRange(aFrustum, rangeBegin, rangeEnd, myThreadResults[aRange].data());
+			});
+
+		std::size_t visibleCount = visibleCounts[0];
+		for (unsigned int i = 1; i < threadCount; ++i)
+		{
+			std::copy_n(myThreadResults[i].begin(), visibleCounts[i], someVisibleIndicesOut.begin() + visibleCount);
+			visibleCount += visibleCounts[i];
+		}
+
+		someVisibleIndicesOut.resize(visibleCount);
+	}
+
+	std::size_t FrustumCuller::CullRange(const Frustum& aFrustum, std::size_t aBegin, std::size_t anEnd, std::uint32_t* someVisibleIndicesOut) const
+	{
+		const std::array<PlaneTerms, 6> planes = GetPlaneTerms(aFrustum);
+
+		std::size_t visibleCount = 0;
+		std::size_t i = aBegin;
+
+		// A box is outside when it's entirely behind any plane:
+		// the center's distance to the plane plus the extents projected on its normal is negative.
+	#if ATRIUM_SIMD_AVX2
+		const __m256 zero = _mm256_setzero_ps();
+		for (; i + SimdWidth <= anEnd; i += SimdWidth)
+		{
+			const __m256 centerX = _mm256_loadu_ps(myCenterX.data() + i);
+			const __m256 centerY = _mm256_loadu_ps(myCenterY.data() + i);
+			const __m256 centerZ = _mm256_loadu_ps(myCenterZ.data() + i);
+			const __m256 extentX = _mm256_loadu_ps(myExtentX.data() + i);
+			const __m256 extentY = _mm256_loadu_ps(myExtentY.data() + i);
+			const __m256 extentZ = _mm256_loadu_ps(myExtentZ.data() + i);
+
+			__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (const PlaneTerms& plane : planes)
+			{
+				const __m256 distance = _mm256_add_ps(_mm256_set1_ps(plane.Distance), _mm256_add_ps(
+					_mm256_mul_ps(centerX, _mm256_set1_ps(plane.NormalX)),
+					_mm256_add_ps(_mm256_mul_ps(centerY, _mm256_set1_ps(plane.NormalY)), _mm256_mul_ps(centerZ, _mm256_set1_ps(plane.NormalZ)))));
+				const __m256 radius = _mm256_add_ps(
+					_mm256_mul_ps(extentX, _mm256_set1_ps(plane.AbsNormalX)),
+					_mm256_add_ps(_mm256_mul_ps(extentY, _mm256_set1_ps(plane.AbsNormalY)), _mm256_mul_ps(extentZ, _mm256_set1_ps(plane.AbsNormalZ))));
+
+				inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+			}
+
+			for (unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+				someVisibleIndicesOut[visibleCount++] = static_cast<std::uint32_t>(i + std::countr_zero(mask));
+		}
+	#elif ATRIUM_SIMD_SSE
+		const __m128 zero = _mm_setzero_ps();
+		for (; i + SimdWidth <= anEnd; i += SimdWidth)
+		{
+			const __m128 centerX = _mm_loadu_ps(myCenterX.data() + i);
+			const __m128 centerY = _mm_loadu_ps(myCenterY.data() + i);
+			const __m128 centerZ = _mm_loadu_ps(myCenterZ.data() + i);
+			const __m128 extentX = _mm_loadu_ps(myExtentX.data() + i);
+			const __m128 extentY = _mm_loadu_ps(myExtentY.data() + i);
+			const __m128 extentZ = _mm_loadu_ps(myExtentZ.data() + i);
+
+			__m128 inside = _mm_cmpeq_ps(zero, zero);
+			for (const PlaneTerms& plane : planes)
+			{
+				const __m128 distance = _mm_add_ps(_mm_set1_ps(plane.Distance), _mm_add_ps(
+					_mm_mul_ps(centerX, _mm_set1_ps(plane.NormalX)),
+					_mm_add_ps(_mm_mul_ps(centerY, _mm_set1_ps(plane.NormalY)), _mm_mul_ps(centerZ, _mm_set1_ps(plane.NormalZ)))));
+				const __m128 radius = _mm_add_ps(
+					_mm_mul_ps(extentX, _mm_set1_ps(plane.AbsNormalX)),
+					_mm_add_ps(_mm_mul_ps(extentY, _mm_set1_ps(plane.AbsNormalY)), _mm_mul_ps(extentZ, _mm_set1_ps(plane.AbsNormalZ))));
+
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			for (unsigned int mask = static_cast<unsigned int>(_mm_movemask_ps(inside)); mask != 0; mask &= mask - 1)
+				someVisibleIndicesOut[visibleCount++] = static_cast<std::uint32_t>(i + std::countr_zero(mask));
+		}
+	#endif
+
+		for (; i < anEnd; ++i)
+		{
+			bool isInside = true;
+			for (const PlaneTerms& plane : planes)
+			{
+				const float distance = plane.Distance + myCenterX[i] * plane.NormalX + myCenterY[i] * plane.NormalY + myCenterZ[i] * plane.NormalZ;
+				const float radius = myExtentX[i] * plane.AbsNormalX + myExtentY[i] * plane.AbsNormalY + myExtentZ[i] * plane.AbsNormalZ;
+				isInside = isInside && distance + radius >= 0.f;
+			}
+
+			if (isInside)
+				someVisibleIndicesOut[visibleCount++] = static_cast<std::uint32_t>(i);
+		}
+
+		return visibleCount;
+	}
+}
@@ -0,0 +1,106 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_BoundingVolumes.hpp"
+
+#include <rose-common/math/Vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief A plane, with the points where Dot(Normal, point) + Distance >= 0 in front of it.
+	 */
+	struct Plane
+	{
+		Vector3<float> Normal;
+		float Distance = 0.f;
+	};
+
+	/**
+	 * @brief The six planes bounding a view volume, facing inwards.
+	 */
+	struct Frustum
+	{
+		std::array<Plane, 6> Planes;
+
+		/**
+		 * @brief Extract the planes of a view-projection matrix.
+		 *
+		 * @param aViewProjection Row-major matrix transforming row vectors, (x, y, z, 1) * M, to clip space with a depth range of 0 to 1.
+		 * @return The frustum, with normalized planes.
+		 */
+		static Frustum FromViewProjection(const std::array<float, 16>& aViewProjection);
+	};
+
+	/**
+	 * @brief Tests many axis-aligned boxes against a frustum at once.
+	 *        Boxes are stored as structure-of-arrays centers and extents, and tested several at a time with SIMD:
+	 *        eight with AVX2, four with SSE, or one at a time when neither is available.
+	 *        Large sets are split over several threads.
+	 */
+	class FrustumCuller
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Add an object's bounds.
+		 *
+		 * @return The index of the object, used in the visible indices.
+		 */
+		std::uint32_t Add(const AxisAlignedBox& aBox);
+
+		/**
+		 * @brief Add an object's bounds, tested as the box enclosing the sphere.
+		 *
+		 * @return The index of the object, used in the visible indices.
+		 */
+		std::uint32_t Add(const BoundingSphere& aSphere);
+
+		/**
+		 * @brief Update the bounds of an object that moved.
+		 */
+		void Set(std::uint32_t anIndex, const AxisAlignedBox& aBox);
+
+		/**
+		 * @brief Remove all objects.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Find the objects that are at least partially inside a frustum.
+		 *        Objects outside it may still be reported visible near its corners, as with any plane test.
+		 *
+		 * @param aFrustum Frustum to test against.
+		 * @param someVisibleIndicesOut Replaced with the indices of the visible objects, in ascending order.
+		 */
+		void Cull(const Frustum& aFrustum, std::vector<std::uint32_t>& someVisibleIndicesOut);
+
+		std::size_t GetCount() const { return myCenterX.size(); }
+
+	#pragma endregion
+
+	private:
+		std::size_t CullRange(const Frustum& aFrustum, std::size_t aBegin, std::size_t anEnd, std::uint32_t* someVisibleIndicesOut) const;
+
+		std::vector<float> myCenterX;
+		std::vector<float> myCenterY;
+		std::vector<float> myCenterZ;
+		std::vector<float> myExtentX;
+		std::vector<float> myExtentY;
+		std::vector<float> myExtentZ;
+
+		// Visible indices of each thread's range, before they're compacted into the output.
+		std::vector<std::vector<std::uint32_t>> myThreadResults;
+	};
+}
@@ -0,0 +1,183 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_GeometryPool.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Atrium
+{
+	GeometryPool::Page::Page(std::uint32_t aVertexCount, std::uint32_t anIndexCount)
+		: VertexAllocator(aVertexCount)
+		, IndexAllocator(anIndexCount)
+	{
+	}
+
+	GeometryPool::GeometryPool(GraphicsAPI::ResourceManager& aResourceManager, std::uint32_t aVertexStride, std::uint32_t anIndexStride, const GeometryPoolSettings& someSettings)
+		: myResourceManager(aResourceManager)
+		, mySettings(someSettings)
+		, myVertexStride(aVertexStride)
+		, myIndexStride(anIndexStride)
+	{
+		Debug::Assert(anIndexStride == sizeof(std::uint16_t) || anIndexStride == sizeof(std::uint32_t), "Indices are either uint16 or uint32.");
+	}
+
+	std::optional<GeometryPool::Allocation> GeometryPool::Allocate(std::uint32_t aVertexCount, std::uint32_t anIndexCount)
+	{
+		PROFILE_SCOPE();
+
+		for (std::uint32_t pageIndex = 0; pageIndex <= myPages.size(); ++pageIndex)
+		{
+			if (pageIndex == myPages.size() && !CreatePage(std::max(aVertexCount, mySettings.PageVertexCount), std::max(anIndexCount, mySettings.PageIndexCount)))
+				return { };
+
+			Page& page = myPages[pageIndex];
+			const std::optional<TlsfAllocator::Allocation> vertices = page.VertexAllocator.Allocate(aVertexCount);
+			if (!vertices)
+				continue;
+
+			const std::optional<TlsfAllocator::Allocation> indices = page.IndexAllocator.Allocate(anIndexCount);
+			if (!indices)
+			{
+				page.VertexAllocator.Free(*vertices);
+				continue;
+			}
+
+			return Allocation { pageIndex, *vertices, *indices };
+		}
+
+		return { };
+	}
+
+	void GeometryPool::Free(const Allocation& anAllocation)
+	{
+		if (!Debug::Verify(anAllocation.Page < myPages.size(), "The allocation belongs to the pool."))
+			return;
+
+		myPages[anAllocation.Page].PendingFrees.push_back(anAllocation);
+	}
+
+	std::span<std::byte> GeometryPool::GetVertexData(const Allocation& anAllocation)
+	{
+		Page& page = myPages.at(anAllocation.Page);
+		const std::size_t begin = static_cast<std::size_t>(anAllocation.Vertices.Offset) * myVertexStride;
+		const std::size_t size = static_cast<std::size_t>(anAllocation.Vertices.Size) * myVertexStride;
+		page.VertexDirtyRanges.push_back(DirtyRange { begin, begin + size });
+		return std::span<std::byte>(page.VertexData).subspan(begin, size);
+	}
+
+	std::span<std::byte> GeometryPool::GetIndexData(const Allocation& anAllocation)
+	{
+		Page& page = myPages.at(anAllocation.Page);
+		const std::size_t begin = static_cast<std::size_t>(anAllocation.Indices.Offset) * myIndexStride;
+		const std::size_t size = static_cast<std::size_t>(anAllocation.Indices.Size) * myIndexStride;
+		page.IndexDirtyRanges.push_back(DirtyRange { begin, begin + size });
+		return std::span<std::byte>(page.IndexData).subspan(begin, size);
+	}
+
+	std::span<const std::byte> GeometryPool::GetVertices(const Allocation& anAllocation) const
+	{
+		const Page& page = myPages.at(anAllocation.Page);
+		return std::span<const std::byte>(page.VertexData).subspan(static_cast<std::size_t>(anAllocation.Vertices.Offset) * myVertexStride, static_cast<std::size_t>(anAllocation.Vertices.Size) * myVertexStride);
+	}
+
+	std::span<const std::byte> GeometryPool::GetIndices(const Allocation& anAllocation) const
+	{
+		const Page& page = myPages.at(anAllocation.Page);
+		return std::span<const std::byte>(page.IndexData).subspan(static_cast<std::size_t>(anAllocation.Indices.Offset) * myIndexStride, static_cast<std::size_t>(anAllocation.Indices.Size) * myIndexStride);
+	}
+
+	void GeometryPool::SetVertices(const Allocation& anAllocation, std::span<const std::byte> someVertices)
+	{
+		const std::span<std::byte> destination = GetVertexData(anAllocation);
+		if (!Debug::Verify(someVertices.size() <= destination.size(), "The vertices fit in the %zu bytes allocated for them.", destination.size()))
+			return;
+
+		std::memcpy(destination.data(), someVertices.data(), someVertices.size());
+	}
+
+	void GeometryPool::SetIndices(const Allocation& anAllocation, std::span<const std::byte> someIndices)
+	{
+		const std::span<std::byte> destination = GetIndexData(anAllocation);
+		if (!Debug::Verify(someIndices.size() <= destination.size(), "The indices fit in the %zu bytes allocated for them.", destination.size()))
+			return;
+
+		std::memcpy(destination.data(), someIndices.data(), someIndices.size());
+	}
+
+	void GeometryPool::Upload()
+	{
+		PROFILE_SCOPE();
+
+		for (Page& page : myPages)
+		{
+			UploadRanges(*page.VertexBuffer, page.VertexData, page.VertexDirtyRanges);
+			UploadRanges(*page.IndexBuffer, page.IndexData, page.IndexDirtyRanges);
+
+			// Writes to the room from now on are uploaded with the next frame, after this frame's draws.
+			for (const Allocation& freedAllocation : page.PendingFrees)
+			{
+				page.VertexAllocator.Free(freedAllocation.Vertices);
+				page.IndexAllocator.Free(freedAllocation.Indices);
+			}
+
+			page.PendingFrees.clear();
+		}
+
+		PROFILE_PLOT("Geometry pool pages", static_cast<std::int64_t>(myPages.size()));
+	}
+
+	FrameGraphicsContext::DrawIndexedArguments GeometryPool::GetDrawArguments(const Allocation& anAllocation, std::uint32_t anInstanceCount) const
+	{
+		FrameGraphicsContext::DrawIndexedArguments arguments;
+		arguments.IndexCountPerInstance = anAllocation.Indices.Size;
+		arguments.InstanceCount = anInstanceCount;
+		arguments.StartIndexLocation = anAllocation.Indices.Offset;
+		arguments.BaseVertexLocation = static_cast<std::int32_t>(anAllocation.Vertices.Offset);
+		return arguments;
+	}
+
+	void GeometryPool::UploadRanges(GraphicsBuffer& aBuffer, const std::vector<std::byte>& someData, std::vector<DirtyRange>& someDirtyRanges)
+	{
+		if (someDirtyRanges.empty())
+			return;
+
+		// Overlapping and touching ranges are written together.
+		std::sort(someDirtyRanges.begin(), someDirtyRanges.end(), [](const DirtyRange& aRange, const DirtyRange& anotherRange) { return aRange.Begin < anotherRange.Begin; });
+
+		DirtyRange current = someDirtyRanges.front();
+		for (std::size_t i = 1; i <= someDirtyRanges.size(); ++i)
+		{
+			if (i < someDirtyRanges.size() && someDirtyRanges[i].Begin <= current.End)
+			{
+				current.End = std::max(current.End, someDirtyRanges[i].End);
+				continue;
+			}
+
+			aBuffer.SetData(someData.data() + current.Begin, static_cast<std::uint32_t>(current.End - current.Begin), current.Begin);
+			if (i < someDirtyRanges.size())
+				current = someDirtyRanges[i];
+		}
+
+		someDirtyRanges.clear();
+	}
+
+	bool GeometryPool::CreatePage(std::uint32_t aVertexCount, std::uint32_t anIndexCount)
+	{
+		std::shared_ptr<GraphicsBuffer> vertexBuffer = myResourceManager.CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, aVertexCount, myVertexStride, GraphicsBuffer::Mode::Dynamic);
+		std::shared_ptr<GraphicsBuffer> indexBuffer = myResourceManager.CreateGraphicsBuffer(GraphicsBuffer::Target::Index, anIndexCount, myIndexStride, GraphicsBuffer::Mode::Dynamic);
+		if (!vertexBuffer || !indexBuffer)
+		{
+			Debug::LogError("Failed to create the buffers of a geometry pool page, of %u vertices and %u indices.", aVertexCount, anIndexCount);
+			return false;
+		}
+
+		Page& page = myPages.emplace_back(aVertexCount, anIndexCount);
+		page.VertexData.resize(static_cast<std::size_t>(aVertexCount) * myVertexStride);
+		page.IndexData.resize(static_cast<std::size_t>(anIndexCount) * myIndexStride);
+		page.VertexBuffer = std::move(vertexBuffer);
+		page.IndexBuffer = std::move(indexBuffer);
+		return true;
+	}
+}
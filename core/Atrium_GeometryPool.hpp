@@ -0,0 +1,175 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_FrameContext.hpp"
+#include "Atrium_GraphicsAPI.hpp"
+#include "Atrium_GraphicsBuffer.hpp"
+#include "Atrium_TlsfAllocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Settings for the pages of a GeometryPool.
+	 */
+	struct GeometryPoolSettings
+	{
+		// Size of each page's buffers. Meshes larger than a page get a page of their own.
+		std::uint32_t PageVertexCount = 1 << 20;
+		std::uint32_t PageIndexCount = 3 << 20;
+	};
+
+	/**
+	 * @brief Holds the vertices and indices of many meshes in a few large buffers, instead of a pair of buffers per mesh.
+	 *        All meshes in the pool share a vertex format and index size.
+	 *
+	 *        Each page is a vertex and an index buffer, with ranges sub-allocated by a TlsfAllocator.
+	 *        Meshes are drawn with their allocation's start index and base vertex, so their indices stay relative to their own vertices,
+	 *        and meshes on the same page share their bindings: a RenderQueue binds them once for all of the page's draws.
+	 *
+	 *        Pages keep their data in memory, along with the ranges written since the last Upload(), which writes only those ranges
+	 *        to the page's Dynamic buffers. Those live in GPU memory, and the API copies the written ranges into them ahead of the frame's draws.
+	 *        Upload() is called once per frame, after writing meshes and before drawing them.
+	 */
+	class GeometryPool
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		struct Allocation
+		{
+			std::uint32_t Page = 0;
+			TlsfAllocator::Allocation Vertices;
+			TlsfAllocator::Allocation Indices;
+		};
+
+	#pragma endregion
+
+		/**
+		 * @brief Create an empty pool. Pages are created as they're needed.
+		 *
+		 * @param aVertexStride Size of a vertex, such as a VertexStreamPacker stream's stride.
+		 * @param anIndexStride Size of an index, 2 or 4 bytes.
+		 */
+		GeometryPool(GraphicsAPI::ResourceManager& aResourceManager, std::uint32_t aVertexStride, std::uint32_t anIndexStride, const GeometryPoolSettings& someSettings = GeometryPoolSettings());
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Allocate room for a mesh, on the first page with room for it.
+		 *
+		 * @return The allocation, or nothing if a page couldn't be created for it.
+		 */
+		std::optional<Allocation> Allocate(std::uint32_t aVertexCount, std::uint32_t anIndexCount);
+
+		/**
+		 * @brief Free a mesh's room. The room is only reused after the next Upload(), so the mesh can still be drawn this frame.
+		 */
+		void Free(const Allocation& anAllocation);
+
+		/**
+		 * @brief Get the memory of a mesh's vertices, to write them into, such as with VertexStreamPacker::Pack().
+		 *        The range is uploaded on the next Upload(), so use GetVertices() to only read it.
+		 */
+		std::span<std::byte> GetVertexData(const Allocation& anAllocation);
+
+		/**
+		 * @brief Get the memory of a mesh's indices, to write them into, relative to the mesh's first vertex.
+		 *        The range is uploaded on the next Upload(), so use GetIndices() to only read it.
+		 */
+		std::span<std::byte> GetIndexData(const Allocation& anAllocation);
+
+		/**
+		 * @brief Get a mesh's vertices as last written, without uploading them again.
+		 */
+		std::span<const std::byte> GetVertices(const Allocation& anAllocation) const;
+
+		/**
+		 * @brief Get a mesh's indices as last written, without uploading them again.
+		 */
+		std::span<const std::byte> GetIndices(const Allocation& anAllocation) const;
+
+		/**
+		 * @brief Copy a mesh's vertices into the pool.
+		 *
+		 * @param someVertices Vertices in the pool's format, as many as were allocated.
+		 */
+		void SetVertices(const Allocation& anAllocation, std::span<const std::byte> someVertices);
+
+		/**
+		 * @brief Copy a mesh's indices into the pool, such as PackedIndices::Data.
+		 *
+		 * @param someIndices Indices of the pool's size relative to the mesh's first vertex, as many as were allocated.
+		 */
+		void SetIndices(const Allocation& anAllocation, std::span<const std::byte> someIndices);
+
+		/**
+		 * @brief Write the ranges that changed since the last upload to the pages' buffers, and make room freed since then available.
+		 */
+		void Upload();
+
+		const std::shared_ptr<GraphicsBuffer>& GetVertexBuffer(const Allocation& anAllocation) const { return myPages[anAllocation.Page].VertexBuffer; }
+		const std::shared_ptr<GraphicsBuffer>& GetIndexBuffer(const Allocation& anAllocation) const { return myPages[anAllocation.Page].IndexBuffer; }
+
+		/**
+		 * @brief Get the arguments to draw a mesh with its page's buffers bound.
+		 */
+		FrameGraphicsContext::DrawIndexedArguments GetDrawArguments(const Allocation& anAllocation, std::uint32_t anInstanceCount = 1) const;
+
+		std::size_t GetPageCount() const { return myPages.size(); }
+
+	#pragma endregion
+
+	private:
+		struct DirtyRange
+		{
+			std::size_t Begin;
+			std::size_t End;
+		};
+
+		struct Page
+		{
+			Page(std::uint32_t aVertexCount, std::uint32_t anIndexCount);
+
+			TlsfAllocator VertexAllocator;
+			TlsfAllocator IndexAllocator;
+
+			std::vector<std::byte> VertexData;
+			std::vector<std::byte> IndexData;
+
+			std::shared_ptr<GraphicsBuffer> VertexBuffer;
+			std::shared_ptr<GraphicsBuffer> IndexBuffer;
+
+			std::vector<DirtyRange> VertexDirtyRanges;
+			std::vector<DirtyRange> IndexDirtyRanges;
+
+			// Freed since the last upload. Reusing them sooner would overwrite meshes drawn in the same frame.
+			std::vector<Allocation> PendingFrees;
+		};
+
+		static void UploadRanges(GraphicsBuffer& aBuffer, const std::vector<std::byte>& someData, std::vector<DirtyRange>& someDirtyRanges);
+
+		bool CreatePage(std::uint32_t aVertexCount, std::uint32_t anIndexCount);
+
+		GraphicsAPI::ResourceManager& myResourceManager;
+		GeometryPoolSettings mySettings;
+		std::uint32_t myVertexStride;
+		std::uint32_t myIndexStride;
+
+		std::vector<Page> myPages;
+	};
+}
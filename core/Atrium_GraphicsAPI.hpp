@@ -7,6 +7,8 @@
 #include "Atrium_GraphicsPipeline.hpp"
 #include "Atrium_RenderTexture.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <filesystem>
 
 namespace Atrium
@@ -28,6 +30,29 @@ namespace Atrium
 
 		class ResourceManager;
 
+		/**
+		 * @brief GPU queues that work is submitted to.
+		 *        Graphics contexts and resource uploads are submitted to the graphics queue, compute contexts to the compute queue.
+		 *        Nothing is submitted to the copy queue by the API itself, it's only reachable through the timeline methods.
+		 */
+		enum class QueueType
+		{
+			Graphics,
+			Compute,
+			Copy
+		};
+
+		/**
+		 * @brief A point on a queue's timeline, reached once all work submitted to the queue before it has completed.
+		 *        Values increase monotonically per queue and are only meaningful to the API that created them.
+		 *        A default-constructed point is always complete.
+		 */
+		struct TimelinePoint
+		{
+			QueueType Queue = QueueType::Graphics;
+			std::uint64_t Value = 0;
+		};
+
 	#pragma endregion
 
 		//--------------------------------------------------
@@ -42,12 +67,70 @@ namespace Atrium
 	 */
 		virtual std::shared_ptr<FrameGraphicsContext> CreateFrameGraphicsContext() = 0;
 
+		/**
+		 * @brief Create a new frame compute-context to record compute-commands to.
+		 *        Its commands are submitted to an asynchronous compute queue when the frame ends,
+		 *        so they may overlap with graphics work unless dependencies are added between the contexts.
+		 * @return A pointer to the created context.
+		 */
+		virtual std::shared_ptr<FrameComputeContext> CreateFrameComputeContext() = 0;
+
+		/**
+		 * @brief Create a command bundle to record reusable draw commands to.
+		 *        Unlike frame contexts, bundles aren't submitted on their own, but replayed through FrameGraphicsContext::ExecuteBundle().
+		 * @return A pointer to the created bundle, open for recording.
+		 */
+		virtual std::shared_ptr<CommandBundle> CreateCommandBundle() = 0;
+
+		/**
+		 * @brief Insert a signal after all work submitted to a queue so far, including the frame contexts recorded so far.
+		 *        A signal made during a frame is held back until MarkFrameEnd() has submitted the frame's contexts,
+		 *        so its point can't be reached, or waited for on the CPU, before the frame ends.
+		 *
+		 * @param aQueue Queue to signal on.
+		 * @return The timeline point that is reached when the signal executes.
+		 */
+		virtual TimelinePoint InsertSignal(QueueType aQueue) = 0;
+
+		/**
+		 * @brief Make all work submitted to a queue from now on wait on the GPU until a timeline point is reached.
+		 *        Waits inserted during a frame apply to the frame contexts submitted when it ends,
+		 *        so a queue can't wait for a point signaled on it during the same frame.
+		 *
+		 * @param aQueue Queue that should wait.
+		 * @param aPoint Timeline point to wait for, on any queue.
+		 */
+		virtual void InsertWait(QueueType aQueue, const TimelinePoint& aPoint) = 0;
+
+		/**
+		 * @brief Check on the CPU whether a timeline point has been reached, without blocking.
+		 *
+		 * @param aPoint Timeline point to check.
+		 * @return True if all work up to the point has completed.
+		 */
+		virtual bool IsComplete(const TimelinePoint& aPoint) const = 0;
+
+		/**
+		 * @brief Block the calling thread until a timeline point has been reached, or the timeout expires.
+		 *
+		 * @param aPoint Timeline point to wait for.
+		 * @param aTimeout Longest time to wait. Waits indefinitely by default.
+		 * @return True if the point was reached, false if the wait timed out.
+		 */
+		virtual bool WaitForCompletion(const TimelinePoint& aPoint, std::chrono::milliseconds aTimeout = std::chrono::milliseconds::max()) const = 0;
+
 		/**
 		 * @brief Get the current graphics-frame index.
 		 * @return The index as an unsigned integer at least 64 bit long.
 		 */
 		virtual std::uint_least64_t GetCurrentFrameIndex() const = 0;
 
+		/**
+		 * @brief Get how many frames the CPU can record ahead of the GPU.
+		 *        Resources replaced during a frame can still be read by this many frames.
+		 */
+		virtual std::size_t GetFramesInFlightCount() const = 0;
+
 		/**
 		 * @brief Get the graphics resource manager.
 		 */
@@ -63,6 +146,14 @@ namespace Atrium
 		 */
 		virtual void MarkFrameEnd() = 0;
 
+		/**
+		 * @brief Check whether the API supports bindless resources.
+		 *        If so, textures and constant buffers get indices into tables added with RootSignatureBuilder::AddBindlessTables().
+		 *
+		 * @return True if resources can be accessed through bindless tables.
+		 */
+		virtual bool SupportsBindlessResources() const = 0;
+
 		/**
 		 * @brief Check whether the API supports rendering to multiple windows.
 		 *
@@ -82,6 +173,14 @@ namespace Atrium
 	{
 	public:
 
+		/**
+		 * @brief Create a render texture to draw to off-screen.
+		 *
+		 * @param aDescriptor Size and formats of the color and depth buffers. Buffers with a format of None are not created.
+		 * @return The created render texture.
+		 */
+		virtual std::shared_ptr<RenderTexture> CreateRenderTexture(const RenderTextureDescriptor& aDescriptor) = 0;
+
 		/**
 		 * @brief Create a render texture for a particular window.
 		 *
@@ -96,9 +195,10 @@ namespace Atrium
 		 * @param someTargets Flags specifying which targets the buffer should be set up to support.
 		 * @param aCount Amount of elements the buffer should contain.
 		 * @param aStride Size of an individual element.
+		 * @param aMode How the buffer's data is kept between frames in flight.
 		 * @return The created graphics buffer with a size equal to or greater than (aCount * aStride).
 		 */
-		virtual std::shared_ptr<GraphicsBuffer> CreateGraphicsBuffer(GraphicsBuffer::Target someTargets, std::uint32_t aCount, std::uint32_t aStride) = 0;
+		virtual std::shared_ptr<GraphicsBuffer> CreateGraphicsBuffer(GraphicsBuffer::Target someTargets, std::uint32_t aCount, std::uint32_t aStride, GraphicsBuffer::Mode aMode = GraphicsBuffer::Mode::PerFrame) = 0;
 
 		/**
 		 * @brief Create a new Pipeline State Object according to the provided Pipeline State Description.
@@ -108,6 +208,14 @@ namespace Atrium
 		 */
 		virtual std::shared_ptr<PipelineState> CreatePipelineState(const PipelineStateDescription& aPipelineState) = 0;
 
+		/**
+		 * @brief Create a new compute Pipeline State Object according to the provided description.
+		 *
+		 * @param aPipelineState Description for the pipeline state requested.
+		 * @return The created Pipeline State Object.
+		 */
+		virtual std::shared_ptr<PipelineState> CreateComputePipelineState(const ComputePipelineStateDescription& aPipelineState) = 0;
+
 		/**
 		 * @brief Create a new Root Signature Builder which allows you to create a new Root Signature object.
 		 *
@@ -127,6 +235,7 @@ namespace Atrium
 
 		/**
 		 * @brief Create a CPU-editable texture.
+		 *        Write its pixels with Texture::SetPixels(), then upload them with Texture::Apply(), or only the written regions with Texture::ApplyDirtyRegions().
 		 *
 		 * @param aWidth Width of the texture.
 		 * @param aHeight Height of the texture.
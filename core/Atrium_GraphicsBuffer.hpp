@@ -4,7 +4,10 @@
 
 #include <rose-common/Enum.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <span>
 
 namespace Atrium
@@ -29,7 +32,31 @@ namespace Atrium
 			Index = 1 << 1,
 
 			// GraphicsBuffer to be usable as a Vertex buffer.
-			Vertex = 1 << 2
+			Vertex = 1 << 2,
+
+			// GraphicsBuffer to be usable as argument or count records for indirect draws and dispatches.
+			// Combine with UnorderedAccess for records written by a compute shader, such as a culling pass.
+			IndirectArguments = 1 << 3,
+
+			// GraphicsBuffer to be writable from shaders, bound with SetPipelineUnorderedAccess().
+			// Requires the Dynamic mode, as the buffer has to live in GPU memory.
+			UnorderedAccess = 1 << 4
+		};
+
+		/**
+		 * @brief Specifies how a GraphicsBuffer's data is kept while frames are in flight.
+		 *        Either way, writing doesn't affect frames the GPU is still drawing.
+		 */
+		enum class Mode
+		{
+			// Each frame in flight has its own copy in memory the CPU writes directly.
+			// A frame's copy only holds what was written to it, for data rewritten whole in every frame it's used, such as instance data.
+			PerFrame,
+
+			// A single buffer in GPU memory, for data updated in parts, such as pooled meshes.
+			// Only the ranges written are staged, and they're copied into the buffer at the end of the frame,
+			// after earlier frames are done reading it and before the frame's own commands run.
+			Dynamic
 		};
 
 	public:
@@ -54,6 +81,15 @@ namespace Atrium
 		 */
 		virtual std::uint32_t GetStride() const = 0;
 
+		/**
+		 * @brief Get the buffer's index in the bindless resource table, for shaders using bindless tables.
+		 *        Only constant buffers are accessible this way.
+		 *        The index stays the same for the buffer's whole lifetime, and each frame reads its own copy of the buffer through it.
+		 *
+		 * @return The index, or nothing if the API has no bindless support or the buffer isn't a constant buffer.
+		 */
+		virtual std::optional<std::uint32_t> GetBindlessIndex() const = 0;
+
 		/**
 		 * @brief Get a pointer to the native buffer in use by the Graphics API.
 		 *        The type depends on the underlying API used.
@@ -86,6 +122,15 @@ namespace Atrium
 		 */
 		virtual void SetData(const void* aDataPtr, std::uint32_t aDataSize, std::size_t aDestinationOffset = 0u) = 0;
 
+		/**
+		 * @brief Get the memory SetData() copies into, to write data into it directly instead.
+		 *        Like SetData(), it belongs to the current frame, and may differ between frames.
+		 *        Only PerFrame buffers can be written this way, as Dynamic buffers live in GPU memory.
+		 *
+		 * @return The buffer's memory, GetCount() * GetStride() bytes large.
+		 */
+		virtual std::span<std::byte> GetWritableData() = 0;
+
 		/**
 		 * @brief Set the name of the buffer, to help with debugging.
 		 *
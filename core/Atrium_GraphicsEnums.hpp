@@ -165,6 +165,24 @@ namespace Atrium
 		TriangleStrip
 	};
 
+	/**
+	 * @brief Usage states a GPU resource can be transitioned between.
+	 *        A resource has to be in the state matching how the GPU accesses it next.
+	 */
+	enum class ResourceState
+	{
+		Common,
+		RenderTarget,
+		DepthWrite,
+		DepthRead,
+		ShaderResource,
+		UnorderedAccess,
+		CopySource,
+		CopyDestination,
+		IndirectArgument,
+		Present
+	};
+
 	enum class TextureWrapMode
 	{
 		Repeat,
@@ -25,7 +25,8 @@ namespace Atrium
 			All = ~0,
 
 			Vertex = 1 << 0,
-			Pixel = 1 << 1
+			Pixel = 1 << 1,
+			Compute = 1 << 2
 		};
 	};
 
@@ -84,6 +85,17 @@ namespace Atrium
 		};
 
 	public:
+		/**
+		 * @brief Add unbounded texture and constant buffer arrays which cover every bindless resource.
+		 *        Shaders index them with values from GetBindlessIndex(), usually passed in through root constants.
+		 *        In HLSL they are declared as "Texture2D name[] : register(tN, spaceX)" and "ConstantBuffer<T> name[] : register(bN, spaceX)",
+		 *        where N is the register and X is the update frequency.
+		 *
+		 * @param aRegister First register of both arrays.
+		 * @param anUpdateFrequency Update frequency, selecting the register space.
+		 */
+		virtual void AddBindlessTables(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) = 0;
+
 		virtual void AddCBV(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) = 0;
 		virtual void AddConstant(unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) = 0;
 		virtual void AddConstants(unsigned int aCount, unsigned int aRegister, ResourceUpdateFrequency anUpdateFrequency) = 0;
@@ -204,6 +216,20 @@ namespace Atrium
 		BlendMode BlendMode;
 	};
 
+	/**
+	 * @brief Description of a compute pipeline, to create a PipelineState from.
+	 */
+	class ComputePipelineStateDescription
+	{
+	public:
+		inline bool IsValid() const { return RootSignature && ComputeShader; }
+
+	public:
+		std::shared_ptr<RootSignature> RootSignature;
+
+		std::shared_ptr<Shader> ComputeShader;
+	};
+
 	class PipelineState
 	{
 	public:
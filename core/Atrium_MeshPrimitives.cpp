@@ -1,13 +1,24 @@
 // Filter "Graphics"
 
+#include "Atrium_Diagnostics.hpp"
 #include "Atrium_MeshPrimitives.hpp"
-
+#include "Atrium_TangentFrameGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace Atrium
 {
 	namespace MakeMeshPrimitives
 	{
+		constexpr unsigned int MaxSubdivisionLevel = 8;
+
 		MeshPrimitive::Vertex LerpVertex(const MeshPrimitive::Vertex& aVertex, const MeshPrimitive::Vertex& anOtherVertex, const float anAmount)
 		{
 			MeshPrimitive::Vertex vertex;
@@ -21,352 +32,644 @@ namespace Atrium
 			return vertex;
 		}
 
-		struct GeneratedTriangle
+		/**
+		 * @brief Writes a primitive into memory sized for it up front.
+		 */
+		struct MeshWriter
 		{
-			GeneratedTriangle(Vector3<float> aPosA, Vector3<float> aPosB, Vector3<float> aPosC, Vector2<float> aUVA, Vector2<float> aUVB, Vector2<float> aUVC)
+			std::span<MeshPrimitive::Vertex> Vertices;
+			std::span<MeshPrimitive::Triangle> Triangles;
+			std::uint32_t VertexCount = 0;
+			std::uint32_t TriangleCount = 0;
+
+			MeshPrimitive::Vertex& AddVertex()
+			{
+				MeshPrimitive::Vertex& vertex = Vertices[VertexCount++];
+				vertex = MeshPrimitive::Vertex();
+				return vertex;
+			}
+
+			void AddTriangle(std::uint32_t aVertex, std::uint32_t aSecondVertex, std::uint32_t aThirdVertex)
 			{
-				Position[0] = aPosA;
-				Position[1] = aPosB;
-				Position[2] = aPosC;
-				UV[0] = aUVA;
-				UV[1] = aUVB;
-				UV[2] = aUVC;
+				Triangles[TriangleCount++] = MeshPrimitive::Triangle { aVertex, aSecondVertex, aThirdVertex };
 			}
-			Vector3<float> Position[3];
-			Vector2<float> UV[3];
+
+			std::span<MeshPrimitive::Vertex> GetVertices() const { return Vertices.first(VertexCount); }
+			std::span<const MeshPrimitive::Triangle> GetTriangles() const { return Triangles.first(TriangleCount); }
 		};
 
-		void PopulateQuad(MeshPrimitive& aPrimitive);
+		struct PrimitiveSize
+		{
+			std::uint32_t VertexCount;
+			std::uint32_t TriangleCount;
+		};
 
-		void AddTriangle(const MeshPrimitive::Vertex aTriangle[3], bool mergeVertices, MeshPrimitive& aPrimitive)
+		MeshPrimitiveParameters Sanitize(const MeshPrimitiveParameters& someParameters)
 		{
-			auto findOrAddVertex = [&aPrimitive, mergeVertices](const MeshPrimitive::Vertex& aVertex) -> std::uint32_t {
-				std::size_t vertexIndex = aPrimitive.Vertices.size();
-				if (mergeVertices)
-				{
-					for (std::size_t i = 0; i < aPrimitive.Vertices.size(); ++i)
-					{
-						const MeshPrimitive::Vertex& v = aPrimitive.Vertices[i];
-						if (v.Position == aVertex.Position && v.UV == aVertex.UV && v.Normal == aVertex.Normal)
-							vertexIndex = i;
-					}
-				}
+			MeshPrimitiveParameters parameters = someParameters;
+			parameters.Segments = std::max(3u, parameters.Segments);
+			parameters.Rings = std::max(2u, parameters.Rings);
 
-				if (vertexIndex == aPrimitive.Vertices.size())
-					aPrimitive.Vertices.push_back(aVertex);
+			// An icosphere at this level is 1.3 million triangles, about 50 MB of vertices and indices, and each level above quadruples it.
+			parameters.SubdivisionLevel = std::min(MaxSubdivisionLevel, parameters.SubdivisionLevel);
 
-				return static_cast<std::uint32_t>(vertexIndex);
-				};
+			// Capsules split their rings evenly between the two caps.
+			if (parameters.Type == MeshPrimitiveType::Capsule)
+				parameters.Rings += parameters.Rings % 2;
 
-			MeshPrimitive::Triangle newTriangle;
-			newTriangle.V1 = findOrAddVertex(aTriangle[0]);
-			newTriangle.V2 = findOrAddVertex(aTriangle[1]);
-			newTriangle.V3 = findOrAddVertex(aTriangle[2]);
-			aPrimitive.Triangles.push_back(newTriangle);
+			return parameters;
 		}
 
-		void GenerateNormals_Flat(MeshPrimitive& aPrimitive)
+		PrimitiveSize GetSize(const MeshPrimitiveParameters& someParameters)
 		{
-			for (const MeshPrimitive::Triangle& tri : aPrimitive.Triangles)
+			const std::uint32_t segments = someParameters.Segments;
+			const std::uint32_t rings = someParameters.Rings;
+
+			switch (someParameters.Type)
 			{
-				MeshPrimitive::Vertex& v1 = aPrimitive.Vertices[tri.V1];
-				MeshPrimitive::Vertex& v2 = aPrimitive.Vertices[tri.V2];
-				MeshPrimitive::Vertex& v3 = aPrimitive.Vertices[tri.V3];
+				case MeshPrimitiveType::Capsule:
+					// Both caps end in a row at the equator, with the straight section between them.
+					return { (rings + 2) * (segments + 1), 2 * segments * rings };
+				case MeshPrimitiveType::Cube:
+					return { 36, 12 };
+				case MeshPrimitiveType::Cylinder:
+					// The side, then each cap as a center and a ring of vertices with their own normals.
+					return { 2 * (segments + 1) + 2 * (segments + 2), 4 * segments };
+				case MeshPrimitiveType::Disc:
+					return { segments + 1, segments };
+				case MeshPrimitiveType::Plane:
+				{
+					const std::uint32_t cells = 1u << someParameters.SubdivisionLevel;
+					return { (cells + 1) * (cells + 1), 2 * cells * cells };
+				}
+				case MeshPrimitiveType::Sphere:
+					return { (rings + 1) * (segments + 1), 2 * segments * (rings - 1) };
+				case MeshPrimitiveType::Icosphere:
+				{
+					// Every level adds a vertex per edge, and a closed mesh has one and a half edges per triangle.
+					const std::uint32_t faces = 1u << (2 * someParameters.SubdivisionLevel);
+					return { 10 * faces + 2, 20 * faces };
+				}
+				case MeshPrimitiveType::Quad:
+					return { 4, 2 };
+			}
 
-				const Vector3<float> A = Vector3<float>(v1.Position.X, v1.Position.Y, v1.Position.Z);
-				const Vector3<float> B = Vector3<float>(v2.Position.X, v2.Position.Y, v2.Position.Z);
-				const Vector3<float> C = Vector3<float>(v3.Position.X, v3.Position.Y, v3.Position.Z);
+			return { 0, 0 };
+		}
 
-				v1.Tangent = (B - A).Normalized();
-				v1.Binormal = (C - A).Normalized();
-				v1.Normal = Vector3<float>::Cross(v1.Tangent, v1.Binormal);
+		void GenerateNormals_Flat(std::span<MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles)
+		{
+			for (const MeshPrimitive::Triangle& tri : someTriangles)
+			{
+				MeshPrimitive::Vertex& v1 = someVertices[tri.V1];
+				MeshPrimitive::Vertex& v2 = someVertices[tri.V2];
+				MeshPrimitive::Vertex& v3 = someVertices[tri.V3];
 
-				v3.Tangent = v2.Tangent = v1.Tangent;
-				v3.Binormal = v2.Binormal = v1.Binormal;
+				v1.Normal = Vector3<float>::Cross(v2.Position - v1.Position, v3.Position - v1.Position).Normalized();
 				v3.Normal = v2.Normal = v1.Normal;
 			}
+
+			TangentFrameGenerator generator;
+			generator.SetTopology(someTriangles, someVertices.size());
+			generator.CalculateTangents(someVertices);
 		}
 
-		void GenerateNormals_Smooth(MeshPrimitive& aPrimitive)
+		void GenerateNormals_Smooth(std::span<MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles)
 		{
-			for (MeshPrimitive::Vertex& vert : aPrimitive.Vertices)
-			{
-				vert.Normal = Vector3<float>::Zero();
-				vert.Binormal = Vector3<float>::Zero();
-				vert.Tangent = Vector3<float>::Zero();
-			}
+			TangentFrameGenerator generator;
+			generator.SetTopology(someTriangles, someVertices.size());
+			generator.Calculate(someVertices);
+		}
+
+		void Subdivide(MeshWriter& aWriter, unsigned int aLevelCount)
+		{
+			std::unordered_map<std::uint64_t, std::uint32_t> midpoints;
 
-			for (const MeshPrimitive::Triangle& tri : aPrimitive.Triangles)
+			for (unsigned int level = 0; level < aLevelCount; ++level)
 			{
-				MeshPrimitive::Vertex& v1 = aPrimitive.Vertices[tri.V1];
-				MeshPrimitive::Vertex& v2 = aPrimitive.Vertices[tri.V2];
-				MeshPrimitive::Vertex& v3 = aPrimitive.Vertices[tri.V3];
+				// Each edge is shared by up to two triangles, which reuse the midpoint the first one made.
+				midpoints.clear();
+				midpoints.reserve(aWriter.TriangleCount * 3 / 2);
+
+				const auto getMidpoint = [&aWriter, &midpoints](std::uint32_t aVertex, std::uint32_t anotherVertex) {
+					const std::uint64_t edge = (static_cast<std::uint64_t>(std::min(aVertex, anotherVertex)) << 32) | std::max(aVertex, anotherVertex);
+					const auto [it, isNew] = midpoints.try_emplace(edge, aWriter.VertexCount);
+					if (isNew)
+						aWriter.AddVertex() = LerpVertex(aWriter.Vertices[aVertex], aWriter.Vertices[anotherVertex], 0.5f);
 
-				const Vector3<float> A = Vector3<float>(v1.Position.X, v1.Position.Y, v1.Position.Z);
-				const Vector3<float> B = Vector3<float>(v2.Position.X, v2.Position.Y, v2.Position.Z);
-				const Vector3<float> C = Vector3<float>(v3.Position.X, v3.Position.Y, v3.Position.Z);
+					return it->second;
+				};
+
+				// Split in place, from the last triangle, so each one is read before the four replacing it overwrite it.
+				const std::uint32_t triangleCount = aWriter.TriangleCount;
+				for (std::uint32_t i = triangleCount; i-- > 0;)
+				{
+					const MeshPrimitive::Triangle triangle = aWriter.Triangles[i];
 
-				v1.Tangent = (B - A).Normalized();
-				v1.Binormal = (C - A).Normalized();
+					const std::uint32_t midpoint12 = getMidpoint(triangle.V1, triangle.V2);
+					const std::uint32_t midpoint23 = getMidpoint(triangle.V2, triangle.V3);
+					const std::uint32_t midpoint31 = getMidpoint(triangle.V3, triangle.V1);
 
-				const Vector3<float> vertexNormal = Vector3<float>::Cross(v1.Tangent, v1.Binormal);
-				v1.Normal += vertexNormal;
-				v2.Normal += vertexNormal;
-				v3.Normal += vertexNormal;
+					aWriter.Triangles[i * 4 + 0] = { triangle.V1, midpoint12, midpoint31 };
+					aWriter.Triangles[i * 4 + 1] = { triangle.V2, midpoint23, midpoint12 };
+					aWriter.Triangles[i * 4 + 2] = { triangle.V3, midpoint31, midpoint23 };
+					aWriter.Triangles[i * 4 + 3] = { midpoint12, midpoint23, midpoint31 };
+				}
 
-				v3.Tangent = v2.Tangent = v1.Tangent;
-				v3.Binormal = v2.Binormal = v1.Binormal;
+				aWriter.TriangleCount = triangleCount * 4;
 			}
+		}
 
-			for (MeshPrimitive::Vertex& vert : aPrimitive.Vertices)
+		/**
+		 * @brief Add the quads between rows of vertices around the Y axis, each row having a vertex per segment and one closing it.
+		 *        Quads touching a pole, where a row's vertices meet, are added as single triangles.
+		 */
+		void AddRowTriangles(MeshWriter& aWriter, std::uint32_t aFirstVertex, std::uint32_t aRowCount, std::uint32_t aSegmentCount, bool aHasPoles)
+		{
+			const std::uint32_t rowSize = aSegmentCount + 1;
+			for (std::uint32_t row = 0; row + 1 < aRowCount; ++row)
 			{
-				vert.Normal.Normalize();
-				vert.Binormal.Normalize();
-				vert.Tangent.Normalize();
+				for (std::uint32_t segment = 0; segment < aSegmentCount; ++segment)
+				{
+					const std::uint32_t topLeft = aFirstVertex + row * rowSize + segment;
+					const std::uint32_t bottomLeft = topLeft + rowSize;
+
+					if (!aHasPoles || row != 0)
+						aWriter.AddTriangle(topLeft, topLeft + 1, bottomLeft);
+
+					if (!aHasPoles || row + 2 != aRowCount)
+						aWriter.AddTriangle(topLeft + 1, bottomLeft + 1, bottomLeft);
+				}
 			}
 		}
 
-		void Subdivide(MeshPrimitive& aPrimitive)
+		/**
+		 * @brief Add a row of vertices around the Y axis, on a sphere centered at a height.
+		 *
+		 * @param aPolarAngle Angle of the row from the top pole.
+		 * @param aV Texture coordinate of the row, from 0 at the bottom to 1 at the top.
+		 */
+		void AddSphereRow(MeshWriter& aWriter, std::uint32_t aSegmentCount, float aRadius, float aCenterHeight, float aPolarAngle, float aV)
 		{
-			const std::vector<MeshPrimitive::Triangle> trianglesToSubdivide = aPrimitive.Triangles;
-			aPrimitive.Triangles.clear();
+			// The poles land exactly on the axis, where every segment shares one position.
+			const float polarCosine = std::cos(aPolarAngle);
+			const float polarSine = std::abs(polarCosine) == 1.f ? 0.f : std::sin(aPolarAngle);
 
-			for (const MeshPrimitive::Triangle& triangle : trianglesToSubdivide)
+			for (std::uint32_t segment = 0; segment <= aSegmentCount; ++segment)
 			{
-				const MeshPrimitive::Vertex v1 = aPrimitive.Vertices[triangle.V1];
-				const MeshPrimitive::Vertex v2 = aPrimitive.Vertices[triangle.V2];
-				const MeshPrimitive::Vertex v3 = aPrimitive.Vertices[triangle.V3];
-
-				const MeshPrimitive::Vertex midpoint12 = LerpVertex(v1, v2, 0.5f);
-				const MeshPrimitive::Vertex midpoint23 = LerpVertex(v2, v3, 0.5f);
-				const MeshPrimitive::Vertex midpoint31 = LerpVertex(v3, v1, 0.5f);
-
-				const MeshPrimitive::Vertex tri1[3] = { v1, midpoint12, midpoint31 };
-				const MeshPrimitive::Vertex tri2[3] = { v2, midpoint23, midpoint12 };
-				const MeshPrimitive::Vertex tri3[3] = { v3, midpoint31, midpoint23 };
-				const MeshPrimitive::Vertex tri4[3] = { midpoint12, midpoint23, midpoint31 };
-
-				AddTriangle(tri1, true, aPrimitive);
-				AddTriangle(tri2, true, aPrimitive);
-				AddTriangle(tri3, true, aPrimitive);
-				AddTriangle(tri4, true, aPrimitive);
+				// The last column wraps to the angle of the first, so both sides of the seam share exact positions.
+				const float u = static_cast<float>(segment) / static_cast<float>(aSegmentCount);
+				const float azimuth = Atrium::TwoPi * static_cast<float>(segment % aSegmentCount) / static_cast<float>(aSegmentCount);
+				const float azimuthSine = std::sin(azimuth);
+				const float azimuthCosine = std::cos(azimuth);
+
+				MeshPrimitive::Vertex& v = aWriter.AddVertex();
+				v.Normal = { polarSine * azimuthCosine, polarCosine, polarSine * azimuthSine };
+				v.Position = { v.Normal.X * aRadius, v.Normal.Y * aRadius + aCenterHeight, v.Normal.Z * aRadius };
+				v.Tangent = { -azimuthSine, 0, azimuthCosine };
+				v.Binormal = { -polarCosine * azimuthCosine, polarSine, -polarCosine * azimuthSine };
+				v.UV = { u, aV };
 			}
 		}
 
-		void PopulateCapsule(MeshPrimitive& aPrimitive)
+		void PopulateCapsule(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
-			PopulateQuad(aPrimitive);
+			const std::uint32_t firstVertex = aWriter.VertexCount;
+			const std::uint32_t capRings = someParameters.Rings / 2;
+			const float halfHeight = std::max(0.f, someParameters.Height) * 0.5f;
+			const float rowCount = static_cast<float>(someParameters.Rings + 1);
+
+			for (std::uint32_t ring = 0; ring <= capRings; ++ring)
+				AddSphereRow(aWriter, someParameters.Segments, someParameters.Radius, halfHeight, Atrium::TwoPi * 0.25f * ring / capRings, 1.f - ring / rowCount);
+
+			for (std::uint32_t ring = capRings; ring <= someParameters.Rings; ++ring)
+				AddSphereRow(aWriter, someParameters.Segments, someParameters.Radius, -halfHeight, Atrium::TwoPi * 0.25f * ring / capRings, 1.f - (ring + 1) / rowCount);
+
+			AddRowTriangles(aWriter, firstVertex, someParameters.Rings + 2, someParameters.Segments, true);
 		}
 
-		void PopulateCube(MeshPrimitive& aPrimitive)
+		void PopulateCube(MeshWriter& aWriter, const MeshPrimitiveParameters& /*someParameters*/)
 		{
 			MeshPrimitive::Vertex* v = nullptr;
 
 			// Z-
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, -1 }; v->UV = { 0, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, -1 }; v->UV = { 1, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, -1 }; v->UV = { 0, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, -1 }; v->UV = { 1, 0 }; v->Normal = { 0,  0, -1 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  1,  0 };
 
 			//  Z+
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 0,  0,  1 }; v->Tangent = { -1,  0,  0 }; v->Binormal = { 0,  1,  0 };
 
 			//  X+
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1, -1 }; v->UV = { 0, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1, -1 }; v->UV = { 0, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, -1 }; v->UV = { 0, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 1,  0,  0 }; v->Tangent = { 0,  0,  1 }; v->Binormal = { 0,  1,  0 };
 
 			//  X-
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1, -1 }; v->UV = { 1, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, -1 }; v->UV = { 1, 1 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1, -1 }; v->UV = { 1, 0 }; v->Normal = { -1,  0,  0 }; v->Tangent = { 0,  0, -1 }; v->Binormal = { 0,  1,  0 };
 
 			//  Y+
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1, -1 }; v->UV = { 1, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1,  1 }; v->UV = { 0, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, -1 }; v->UV = { 0, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1,  1 }; v->UV = { 1, 1 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1, -1 }; v->UV = { 1, 0 }; v->Normal = { 0,  1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0,  1 };
 
 			//  Y-
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1, -1 }; v->UV = { 0, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
-
-			GenerateNormals_Flat(aPrimitive);
+			v = &aWriter.AddVertex(); v->Position = { -1, -1, -1 }; v->UV = { 0, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1,  1 }; v->UV = { 0, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, -1 }; v->UV = { 1, 1 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1,  1 }; v->UV = { 1, 0 }; v->Normal = { 0, -1,  0 }; v->Tangent = { 1,  0,  0 }; v->Binormal = { 0,  0, -1 };
+
+			for (std::uint32_t i = 0; i + 2 < aWriter.VertexCount; i += 3)
+				aWriter.AddTriangle(i, i + 1, i + 2);
+
+			GenerateNormals_Flat(aWriter.GetVertices(), aWriter.GetTriangles());
 		}
 
-		void PopulateCylinder(MeshPrimitive& aPrimitive)
+		void PopulateCylinder(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
-			PopulateQuad(aPrimitive);
+			const std::uint32_t segments = someParameters.Segments;
+			const float radius = someParameters.Radius;
+			const float halfHeight = std::max(0.f, someParameters.Height) * 0.5f;
+
+			const std::uint32_t sideVertex = aWriter.VertexCount;
+			for (float height : { halfHeight, -halfHeight })
+			{
+				for (std::uint32_t segment = 0; segment <= segments; ++segment)
+				{
+					const float u = static_cast<float>(segment) / static_cast<float>(segments);
+					const float x = std::cos(Atrium::TwoPi * u);
+					const float z = std::sin(Atrium::TwoPi * u);
+
+					MeshPrimitive::Vertex& v = aWriter.AddVertex();
+					v.Position = { x * radius, height, z * radius };
+					v.Normal = { x, 0, z };
+					v.Tangent = { -z, 0, x };
+					v.Binormal = { 0, 1, 0 };
+					v.UV = { u, height > 0.f ? 1.f : 0.f };
+				}
+			}
+
+			AddRowTriangles(aWriter, sideVertex, 2, segments, false);
+
+			// The caps face up and down, textured as if projected onto them from above.
+			for (float side : { 1.f, -1.f })
+			{
+				const std::uint32_t center = aWriter.VertexCount;
+
+				MeshPrimitive::Vertex& centerVertex = aWriter.AddVertex();
+				centerVertex.Position = { 0, halfHeight * side, 0 };
+				centerVertex.Normal = { 0, side, 0 };
+				centerVertex.Tangent = { 1, 0, 0 };
+				centerVertex.Binormal = { 0, 0, side };
+				centerVertex.UV = { 0.5f, 0.5f };
+
+				for (std::uint32_t segment = 0; segment <= segments; ++segment)
+				{
+					const float angle = Atrium::TwoPi * static_cast<float>(segment) / static_cast<float>(segments);
+					const float x = std::cos(angle);
+					const float z = std::sin(angle);
+
+					MeshPrimitive::Vertex& v = aWriter.AddVertex();
+					v.Position = { x * radius, halfHeight * side, z * radius };
+					v.Normal = centerVertex.Normal;
+					v.Tangent = centerVertex.Tangent;
+					v.Binormal = centerVertex.Binormal;
+					v.UV = { 0.5f + 0.5f * x, 0.5f + 0.5f * z * side };
+				}
+
+				for (std::uint32_t segment = 0; segment < segments; ++segment)
+				{
+					const std::uint32_t rim = center + 1 + segment;
+					if (side > 0.f)
+						aWriter.AddTriangle(center, rim + 1, rim);
+					else
+						aWriter.AddTriangle(center, rim, rim + 1);
+				}
+			}
 		}
 
-		void PopulateDisc(MeshPrimitive& aPrimitive)
+		void PopulateDisc(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
-			const std::size_t first = aPrimitive.Vertices.size();
+			const std::uint32_t first = aWriter.VertexCount;
 
 			{
 				MeshPrimitive::Vertex* v = nullptr;
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 0, 0, 0 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 0, 0, 0 }; v->UV = { 0.5f, 0.5f };
 
-				static constexpr std::size_t numSegments = 24;
-				for (std::size_t i = 0; i < numSegments; i++)
+				const std::uint32_t numSegments = someParameters.Segments;
+				for (std::uint32_t i = 0; i < numSegments; i++)
 				{
 					const float theta = Atrium::TwoPi * static_cast<float>(i) / static_cast<float>(numSegments);
 
 					const float x = cosf(theta);
 					const float y = sinf(theta);
-					v = &aPrimitive.Vertices.emplace_back(); v->Position = { x, 0, -y }; v->UV = { 0, 0 };
+					v = &aWriter.AddVertex(); v->Position = { x * someParameters.Radius, 0, -y * someParameters.Radius }; v->UV = { 0.5f + 0.5f * x, 0.5f + 0.5f * y };
 				}
 			}
 
-			for (std::size_t i = 1; i < aPrimitive.Vertices.size() - 1; ++i)
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ static_cast<std::uint32_t>(first + 0), static_cast<std::uint32_t>(first + i), static_cast<std::uint32_t>(first + i + 1) });
-			aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ static_cast<std::uint32_t>(first + 0), static_cast<std::uint32_t>(first + aPrimitive.Vertices.size() - 1), static_cast<std::uint32_t>(first + 1) });
+			for (std::uint32_t i = first + 1; i < aWriter.VertexCount - 1; ++i)
+				aWriter.AddTriangle(first, i, i + 1);
+			aWriter.AddTriangle(first, aWriter.VertexCount - 1, first + 1);
 
-			GenerateNormals_Flat(aPrimitive);
+			GenerateNormals_Flat(aWriter.GetVertices(), aWriter.GetTriangles());
 		}
 
-		void PopulatePlane(MeshPrimitive& aPrimitive)
+		void PopulatePlane(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
-			MeshPrimitive::Vertex* v = nullptr;
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  0,  1 }; v->UV = { 0, 1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  0,  1 }; v->UV = { 1, 1 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  0, -1 }; v->UV = { 0, 0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  0, -1 }; v->UV = { 1, 0 };
-
-			aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0, 1, 2 });
-			aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 2, 1, 3 });
+			// A grid of cells, split along the same diagonal as the undivided plane's two triangles.
+			const std::uint32_t cells = 1u << someParameters.SubdivisionLevel;
+			const std::uint32_t first = aWriter.VertexCount;
 
-			Subdivide(aPrimitive);
+			for (std::uint32_t row = 0; row <= cells; ++row)
+			{
+				for (std::uint32_t column = 0; column <= cells; ++column)
+				{
+					const float u = static_cast<float>(column) / static_cast<float>(cells);
+					const float v = 1.f - static_cast<float>(row) / static_cast<float>(cells);
+
+					MeshPrimitive::Vertex& vertex = aWriter.AddVertex();
+					vertex.Position = { u * 2.f - 1.f, 0, v * 2.f - 1.f };
+					vertex.Normal = { 0, 1, 0 };
+					vertex.Tangent = { 1, 0, 0 };
+					vertex.Binormal = { 0, 0, 1 };
+					vertex.UV = { u, v };
+				}
+			}
 
-			GenerateNormals_Flat(aPrimitive);
+			for (std::uint32_t row = 0; row < cells; ++row)
+			{
+				for (std::uint32_t column = 0; column < cells; ++column)
+				{
+					const std::uint32_t topLeft = first + row * (cells + 1) + column;
+					const std::uint32_t bottomLeft = topLeft + cells + 1;
+					aWriter.AddTriangle(topLeft, topLeft + 1, bottomLeft);
+					aWriter.AddTriangle(bottomLeft, topLeft + 1, bottomLeft + 1);
+				}
+			}
 		}
 
-		void PopulateSphere(MeshPrimitive& aPrimitive)
+		void PopulateSphere(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
-			PopulateQuad(aPrimitive);
+			const std::uint32_t firstVertex = aWriter.VertexCount;
+			const float rings = static_cast<float>(someParameters.Rings);
+
+			for (std::uint32_t ring = 0; ring <= someParameters.Rings; ++ring)
+				AddSphereRow(aWriter, someParameters.Segments, someParameters.Radius, 0.f, Atrium::TwoPi * 0.5f * ring / rings, 1.f - ring / rings);
+
+			AddRowTriangles(aWriter, firstVertex, someParameters.Rings + 1, someParameters.Segments, true);
 		}
 
-		void PopulateIcosphere(MeshPrimitive& aPrimitive)
+		void PopulateIcosphere(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
 		{
 			constexpr float t = (1.0f + Atrium::Squareroot<float>(5.0f)) / 2.0f;
 
 			{
 				MeshPrimitive::Vertex* v = nullptr;
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  t,  0 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  t,  0 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -t,  0 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -t,  0 }; v->UV = { 0, 0 };
-
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 0, -1,  t }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 0,  1,  t }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 0, -1, -t }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { 0,  1, -t }; v->UV = { 0, 0 };
-
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { t,  0, -1 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { t,  0,  1 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { -t,  0, -1 }; v->UV = { 0, 0 };
-				v = &aPrimitive.Vertices.emplace_back(); v->Position = { -t,  0,  1 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { -1,  t,  0 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 1,  t,  0 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { -1, -t,  0 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 1, -t,  0 }; v->UV = { 0, 0 };
+
+				v = &aWriter.AddVertex(); v->Position = { 0, -1,  t }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 0,  1,  t }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 0, -1, -t }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { 0,  1, -t }; v->UV = { 0, 0 };
+
+				v = &aWriter.AddVertex(); v->Position = { t,  0, -1 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { t,  0,  1 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { -t,  0, -1 }; v->UV = { 0, 0 };
+				v = &aWriter.AddVertex(); v->Position = { -t,  0,  1 }; v->UV = { 0, 0 };
 			}
 
 			{
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0, 11,  5 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0,  5,  1 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0,  1,  7 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0,  7, 10 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0, 10, 11 });
-
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 1,  5,  9 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 5, 11,  4 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 11, 10,  2 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 10,  7,  6 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 7,  1,  8 });
-
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 3,  9,  4 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 3,  4,  2 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 3,  2,  6 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 3,  6,  8 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 3,  8,  9 });
-
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 4,  9,  5 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 2,  4, 11 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 6,  2, 10 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 8,  6,  7 });
-				aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 9,  8,  1 });
+				aWriter.AddTriangle(0, 11, 5);
+				aWriter.AddTriangle(0, 5, 1);
+				aWriter.AddTriangle(0, 1, 7);
+				aWriter.AddTriangle(0, 7, 10);
+				aWriter.AddTriangle(0, 10, 11);
+
+				aWriter.AddTriangle(1, 5, 9);
+				aWriter.AddTriangle(5, 11, 4);
+				aWriter.AddTriangle(11, 10, 2);
+				aWriter.AddTriangle(10, 7, 6);
+				aWriter.AddTriangle(7, 1, 8);
+
+				aWriter.AddTriangle(3, 9, 4);
+				aWriter.AddTriangle(3, 4, 2);
+				aWriter.AddTriangle(3, 2, 6);
+				aWriter.AddTriangle(3, 6, 8);
+				aWriter.AddTriangle(3, 8, 9);
+
+				aWriter.AddTriangle(4, 9, 5);
+				aWriter.AddTriangle(2, 4, 11);
+				aWriter.AddTriangle(6, 2, 10);
+				aWriter.AddTriangle(8, 6, 7);
+				aWriter.AddTriangle(9, 8, 1);
 			}
 
-			Subdivide(aPrimitive);
+			Subdivide(aWriter, someParameters.SubdivisionLevel);
 
-			for (MeshPrimitive::Vertex& v : aPrimitive.Vertices)
-				v.Position.Normalize();
+			for (MeshPrimitive::Vertex& v : aWriter.GetVertices())
+				v.Position = v.Position.Normalized() * someParameters.Radius;
 
-			GenerateNormals_Smooth(aPrimitive);
+			GenerateNormals_Smooth(aWriter.GetVertices(), aWriter.GetTriangles());
 		}
 
-		void PopulateQuad(MeshPrimitive& aPrimitive)
+		void PopulateQuad(MeshWriter& aWriter, const MeshPrimitiveParameters& /*someParameters*/)
 		{
 			MeshPrimitive::Vertex* v = nullptr;
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1,  1, 0 }; v->UV = { 0, 1 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1,  1, 0 }; v->UV = { 1, 1 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { -1, -1, 0 }; v->UV = { 0, 0 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
-			v = &aPrimitive.Vertices.emplace_back(); v->Position = { 1, -1, 0 }; v->UV = { 1, 0 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
+			v = &aWriter.AddVertex(); v->Position = { -1,  1, 0 }; v->UV = { 0, 1 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
+			v = &aWriter.AddVertex(); v->Position = { 1,  1, 0 }; v->UV = { 1, 1 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
+			v = &aWriter.AddVertex(); v->Position = { -1, -1, 0 }; v->UV = { 0, 0 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
+			v = &aWriter.AddVertex(); v->Position = { 1, -1, 0 }; v->UV = { 1, 0 }; v->Normal = { 0, 0, -1 }; v->Tangent = { 1, 0, 0 }; v->Binormal = { 0, 1, 0 };
+
+			aWriter.AddTriangle(0, 1, 2);
+			aWriter.AddTriangle(2, 1, 3);
+		}
 
-			aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 0, 1, 2 });
-			aPrimitive.Triangles.emplace_back(MeshPrimitive::Triangle{ 2, 1, 3 });
+		void Populate(MeshWriter& aWriter, const MeshPrimitiveParameters& someParameters)
+		{
+			switch (someParameters.Type)
+			{
+				case MeshPrimitiveType::Capsule:
+					PopulateCapsule(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Cube:
+					PopulateCube(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Cylinder:
+					PopulateCylinder(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Disc:
+					PopulateDisc(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Plane:
+					PopulatePlane(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Sphere:
+					PopulateSphere(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Icosphere:
+					PopulateIcosphere(aWriter, someParameters);
+					break;
+				case MeshPrimitiveType::Quad:
+					PopulateQuad(aWriter, someParameters);
+					break;
+			}
 		}
+	}
 
+	MeshPrimitive MeshPrimitive::Generate(MeshPrimitiveType aType, unsigned int aSubdivisionLevel)
+	{
+		MeshPrimitiveParameters parameters;
+		parameters.Type = aType;
+		parameters.SubdivisionLevel = aSubdivisionLevel;
+		return Generate(parameters);
 	}
 
-	MeshPrimitive MeshPrimitive::Generate(MeshPrimitiveType aType)
+	MeshPrimitive MeshPrimitive::Generate(const MeshPrimitiveParameters& someParameters)
 	{
 		MeshPrimitive primitive;
+		primitive.Vertices.resize(GetVertexCount(someParameters));
+		primitive.Triangles.resize(GetTriangleCount(someParameters));
 
-		switch (aType)
+		MeshPrimitiveLod lod;
+		Generate(someParameters, primitive.Vertices, primitive.Triangles, std::span(&lod, 1));
+
+		primitive.CalculateBounds();
+		return primitive;
+	}
+
+	void MeshPrimitive::Generate(const MeshPrimitiveParameters& someParameters, std::span<Vertex> someVerticesOut, std::span<Triangle> someTrianglesOut, std::span<MeshPrimitiveLod> someLodsOut)
+	{
+		const unsigned int lodCount = static_cast<unsigned int>(someLodsOut.size());
+		if (!Debug::Verify(someVerticesOut.size() >= GetVertexCount(someParameters, lodCount) && someTrianglesOut.size() >= GetTriangleCount(someParameters, lodCount), "The output has room for every level of detail."))
+			return;
+
+		std::uint32_t firstVertex = 0;
+		std::uint32_t firstTriangle = 0;
+		for (unsigned int i = 0; i < lodCount; ++i)
 		{
-			case MeshPrimitiveType::Capsule:
-				MakeMeshPrimitives::PopulateCapsule(primitive);
-				break;
-			case MeshPrimitiveType::Cube:
-				MakeMeshPrimitives::PopulateCube(primitive);
-				break;
-			case MeshPrimitiveType::Cylinder:
-				MakeMeshPrimitives::PopulateCylinder(primitive);
-				break;
-			case MeshPrimitiveType::Disc:
-				MakeMeshPrimitives::PopulateDisc(primitive);
-				break;
-			case MeshPrimitiveType::Plane:
-				MakeMeshPrimitives::PopulatePlane(primitive);
-				break;
-			case MeshPrimitiveType::Sphere:
-				MakeMeshPrimitives::PopulateSphere(primitive);
-				break;
-			case MeshPrimitiveType::Icosphere:
-				MakeMeshPrimitives::PopulateIcosphere(primitive);
-				break;
-			case MeshPrimitiveType::Quad:
-				MakeMeshPrimitives::PopulateQuad(primitive);
-				break;
+			const MeshPrimitiveParameters parameters = GetLodParameters(someParameters, i);
+			const MakeMeshPrimitives::PrimitiveSize size = MakeMeshPrimitives::GetSize(parameters);
+
+			MakeMeshPrimitives::MeshWriter writer;
+			writer.Vertices = someVerticesOut.subspan(firstVertex, size.VertexCount);
+			writer.Triangles = someTrianglesOut.subspan(firstTriangle, size.TriangleCount);
+			MakeMeshPrimitives::Populate(writer, parameters);
+
+			Debug::Assert(writer.VertexCount == size.VertexCount && writer.TriangleCount == size.TriangleCount, "The primitive is as large as its size was calculated to be.");
+
+			someLodsOut[i] = MeshPrimitiveLod { firstVertex, size.VertexCount, firstTriangle, size.TriangleCount };
+			firstVertex += size.VertexCount;
+			firstTriangle += size.TriangleCount;
 		}
+	}
 
-		return primitive;
+	std::size_t MeshPrimitive::GetVertexCount(const MeshPrimitiveParameters& someParameters, unsigned int aLodCount)
+	{
+		std::size_t count = 0;
+		for (unsigned int i = 0; i < aLodCount; ++i)
+			count += MakeMeshPrimitives::GetSize(GetLodParameters(someParameters, i)).VertexCount;
+
+		return count;
+	}
+
+	std::size_t MeshPrimitive::GetTriangleCount(const MeshPrimitiveParameters& someParameters, unsigned int aLodCount)
+	{
+		std::size_t count = 0;
+		for (unsigned int i = 0; i < aLodCount; ++i)
+			count += MakeMeshPrimitives::GetSize(GetLodParameters(someParameters, i)).TriangleCount;
+
+		return count;
+	}
+
+	MeshPrimitiveParameters MeshPrimitive::GetLodParameters(const MeshPrimitiveParameters& someParameters, unsigned int aLod)
+	{
+		MeshPrimitiveParameters parameters = someParameters;
+		if (aLod > 0)
+		{
+			const unsigned int shift = std::min(aLod, 31u);
+			parameters.Segments >>= shift;
+			parameters.Rings >>= shift;
+			parameters.SubdivisionLevel -= std::min(aLod, parameters.SubdivisionLevel);
+		}
+
+		return MakeMeshPrimitives::Sanitize(parameters);
+	}
+
+	const MeshPrimitive& MeshPrimitive::GetCached(MeshPrimitiveType aType, unsigned int aSubdivisionLevel)
+	{
+		MeshPrimitiveParameters parameters;
+		parameters.Type = aType;
+		parameters.SubdivisionLevel = aSubdivisionLevel;
+		return GetCached(parameters);
+	}
+
+	const MeshPrimitive& MeshPrimitive::GetCached(const MeshPrimitiveParameters& someParameters)
+	{
+		struct CacheEntry
+		{
+			std::once_flag IsGenerated;
+			std::unique_ptr<const MeshPrimitive> Primitive;
+		};
+
+		static std::mutex cacheMutex;
+		static std::map<MeshPrimitiveParameters, CacheEntry> cache;
+
+		// The lock only covers finding the entry, which map insertions never move. Threads asking for the same primitive
+		// wait on its once flag, while threads asking for different ones generate them side by side.
+		CacheEntry* entry = nullptr;
+		{
+			std::scoped_lock lock(cacheMutex);
+			entry = &cache[someParameters];
+		}
+
+		std::call_once(entry->IsGenerated, [&]() { entry->Primitive = std::make_unique<const MeshPrimitive>(Generate(someParameters)); });
+		return *entry->Primitive;
+	}
+
+	void MeshPrimitive::CalculateBounds()
+	{
+		BoundingBox = AxisAlignedBox();
+		for (const Vertex& vertex : Vertices)
+			BoundingBox.Add(vertex.Position);
+
+		BoundingSphere = Atrium::BoundingSphere();
+		if (BoundingBox.IsEmpty())
+			return;
+
+		// Centering the sphere on the box and fitting it to the farthest vertex is tighter than enclosing the box's corners.
+		BoundingSphere.Center = BoundingBox.GetCenter();
+
+		float radiusSquared = 0.f;
+		for (const Vertex& vertex : Vertices)
+		{
+			const Vector3<float> offset = vertex.Position - BoundingSphere.Center;
+			radiusSquared = std::max(radiusSquared, offset.X * offset.X + offset.Y * offset.Y + offset.Z * offset.Z);
+		}
+
+		BoundingSphere.Radius = std::sqrt(radiusSquared);
 	}
 }
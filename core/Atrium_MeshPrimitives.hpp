@@ -2,9 +2,14 @@
 
 #pragma once
 
+#include "Atrium_BoundingVolumes.hpp"
+
 #include <rose-common/math/Vector.hpp>
 
+#include <compare>
+#include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 
 namespace Atrium
@@ -21,6 +26,43 @@ namespace Atrium
 		Quad
 	};
 
+	/**
+	 * @brief Describes the shape and detail of a primitive to generate. Shapes ignore the parameters that don't apply to them.
+	 */
+	struct MeshPrimitiveParameters
+	{
+		MeshPrimitiveType Type = MeshPrimitiveType::Cube;
+
+		// Divisions around the axis of capsules, cylinders, discs and spheres.
+		unsigned int Segments = 24;
+
+		// Divisions from pole to pole of spheres and capsules.
+		unsigned int Rings = 12;
+
+		// How many times the triangles of icospheres are split into four, and the cells along each side of planes are doubled. At most 8.
+		unsigned int SubdivisionLevel = 1;
+
+		// Radius of capsules, cylinders, discs, icospheres and spheres.
+		float Radius = 1.f;
+
+		// Length of the straight section of capsules and cylinders, along the Y axis.
+		float Height = 2.f;
+
+		auto operator<=>(const MeshPrimitiveParameters&) const = default;
+	};
+
+	/**
+	 * @brief The range of one level of detail, within the vertices and triangles a chain of them was generated into.
+	 *        Its triangles index its vertices from FirstVertex, so each level can also be drawn with FirstVertex as its base vertex.
+	 */
+	struct MeshPrimitiveLod
+	{
+		std::uint32_t FirstVertex = 0;
+		std::uint32_t VertexCount = 0;
+		std::uint32_t FirstTriangle = 0;
+		std::uint32_t TriangleCount = 0;
+	};
+
 	/**
 	 * @brief Generates and describes a mesh primitive.
 	 */
@@ -45,6 +87,67 @@ namespace Atrium
 		std::vector<Vertex> Vertices;
 		std::vector<Triangle> Triangles;
 
-		static MeshPrimitive Generate(MeshPrimitiveType aType);
+		// Bounds of the vertex positions, calculated when the primitive is generated.
+		AxisAlignedBox BoundingBox;
+		Atrium::BoundingSphere BoundingSphere;
+
+		/**
+		 * @brief Generate a primitive.
+		 *
+		 * @param aType Shape to generate.
+		 * @param aSubdivisionLevel How many times the triangles of planes and icospheres are split into four, each level quadrupling their count.
+		 */
+		static MeshPrimitive Generate(MeshPrimitiveType aType, unsigned int aSubdivisionLevel = 1);
+
+		/**
+		 * @brief Generate a primitive from its parameters.
+		 */
+		static MeshPrimitive Generate(const MeshPrimitiveParameters& someParameters);
+
+		/**
+		 * @brief Generate a chain of levels of detail into memory owned by the caller, without allocating any of its own
+		 *        except scratch memory for subdividing icospheres.
+		 *        Every level halves the segments and rings of the one before, or subdivides one level less.
+		 *
+		 * @param someParameters Parameters of the most detailed level.
+		 * @param someVerticesOut Vertices of every level, one after the other. Has to hold at least GetVertexCount() vertices.
+		 * @param someTrianglesOut Triangles of every level, one after the other. Has to hold at least GetTriangleCount() triangles.
+		 * @param someLodsOut The range of each level, from most to least detailed. Its size is the number of levels to generate.
+		 */
+		static void Generate(const MeshPrimitiveParameters& someParameters, std::span<Vertex> someVerticesOut, std::span<Triangle> someTrianglesOut, std::span<MeshPrimitiveLod> someLodsOut);
+
+		/**
+		 * @brief Get how many vertices generating a chain of levels of detail writes, to allocate memory for them up front.
+		 */
+		static std::size_t GetVertexCount(const MeshPrimitiveParameters& someParameters, unsigned int aLodCount = 1);
+
+		/**
+		 * @brief Get how many triangles generating a chain of levels of detail writes, to allocate memory for them up front.
+		 */
+		static std::size_t GetTriangleCount(const MeshPrimitiveParameters& someParameters, unsigned int aLodCount = 1);
+
+		/**
+		 * @brief Get the parameters a level of detail is generated with.
+		 *
+		 * @param aLod Level of detail, where 0 is the most detailed.
+		 */
+		static MeshPrimitiveParameters GetLodParameters(const MeshPrimitiveParameters& someParameters, unsigned int aLod);
+
+		/**
+		 * @brief Get a primitive generated once and shared, for callers that don't modify it. Thread-safe.
+		 *        Primitives stay cached until the program exits.
+		 */
+		static const MeshPrimitive& GetCached(MeshPrimitiveType aType, unsigned int aSubdivisionLevel = 1);
+
+		/**
+		 * @brief Get a primitive generated once per set of parameters and shared, for callers that don't modify it. Thread-safe.
+		 *        Primitives stay cached until the program exits.
+		 */
+		static const MeshPrimitive& GetCached(const MeshPrimitiveParameters& someParameters);
+
+		/**
+		 * @brief Calculate the bounding box and sphere from the vertices, after they have been changed.
+		 */
+		void CalculateBounds();
 	};
 }
\ No newline at end of file
@@ -0,0 +1,511 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_MeshSimplifier.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Atrium
+{
+	namespace
+	{
+		constexpr unsigned int MaxThreads = 8;
+
+		constexpr std::uint32_t NoOpposite = ~0u;
+		constexpr std::uint32_t ManyOpposites = ~0u - 1;
+
+		constexpr float MinLengthSquared = 1e-20f;
+
+		// A collapse may turn a surrounding triangle by up to about 75 degrees.
+		constexpr float MinNormalCosine = 0.25f;
+
+		// Levels that remove fewer triangles than this from the one before aren't worth keeping.
+		constexpr float MinLevelReduction = 0.1f;
+
+		std::uint32_t NextCorner(std::uint32_t aCorner)
+		{
+			return aCorner % 3 == 2 ? aCorner - 2 : aCorner + 1;
+		}
+
+		void AddPlane(std::array<double, 10>& aQuadric, const Vector3<float>& aNormal, const Vector3<float>& aPoint)
+		{
+			const double a = aNormal.X;
+			const double b = aNormal.Y;
+			const double c = aNormal.Z;
+			const double d = -Vector3<float>::Dot(aNormal, aPoint);
+
+			aQuadric[0] += a * a;
+			aQuadric[1] += b * b;
+			aQuadric[2] += c * c;
+			aQuadric[3] += a * b;
+			aQuadric[4] += a * c;
+			aQuadric[5] += b * c;
+			aQuadric[6] += a * d;
+			aQuadric[7] += b * d;
+			aQuadric[8] += c * d;
+			aQuadric[9] += d * d;
+		}
+
+		void AddQuadric(std::array<double, 10>& aQuadric, const std::array<double, 10>& anotherQuadric)
+		{
+			for (std::size_t i = 0; i < aQuadric.size(); ++i)
+				aQuadric[i] += anotherQuadric[i];
+		}
+
+		// The sum of squared distances from a point to the quadric's planes.
+		double EvaluateQuadric(const std::array<double, 10>& aQuadric, const Vector3<float>& aPoint)
+		{
+			const double x = aPoint.X;
+			const double y = aPoint.Y;
+			const double z = aPoint.Z;
+
+			const double error = aQuadric[0] * x * x + aQuadric[1] * y * y + aQuadric[2] * z * z
+				+ 2.0 * (aQuadric[3] * x * y + aQuadric[4] * x * z + aQuadric[5] * y * z)
+				+ 2.0 * (aQuadric[6] * x + aQuadric[7] * y + aQuadric[8] * z)
+				+ aQuadric[9];
+
+			// Rounding can take it slightly below zero when the point is on every plane.
+			return std::max(error, 0.0);
+		}
+
+		void BuildChain(MeshSimplifier& aSimplifier, const MeshPrimitive& aMesh, const MeshLodSettings& someSettings, MeshLodChain& aChainOut)
+		{
+			aChainOut.Triangles = aMesh.Triangles;
+			aChainOut.Levels.clear();
+			aChainOut.Levels.push_back({ 0, static_cast<std::uint32_t>(aMesh.Triangles.size()), 0.f });
+
+			if (aMesh.Vertices.empty() || aMesh.Triangles.empty())
+				return;
+
+			Vector3<float> minimum = aMesh.Vertices.front().Position;
+			Vector3<float> maximum = minimum;
+			for (const MeshPrimitive::Vertex& vertex : aMesh.Vertices)
+			{
+				minimum = Vector3<float>(std::min(minimum.X, vertex.Position.X), std::min(minimum.Y, vertex.Position.Y), std::min(minimum.Z, vertex.Position.Z));
+				maximum = Vector3<float>(std::max(maximum.X, vertex.Position.X), std::max(maximum.Y, vertex.Position.Y), std::max(maximum.Z, vertex.Position.Z));
+			}
+
+			const Vector3<float> extents = maximum - minimum;
+			const float maxError = std::sqrt(Vector3<float>::Dot(extents, extents)) * someSettings.MaxRelativeError;
+
+			std::vector<MeshPrimitive::Triangle> current = aMesh.Triangles;
+			std::vector<MeshPrimitive::Triangle> simplified;
+			float error = 0.f;
+
+			for (unsigned int level = 1; level < someSettings.MaxLevelCount; ++level)
+			{
+				const std::size_t targetCount = static_cast<std::size_t>(static_cast<float>(current.size()) * someSettings.TriangleRatio);
+				const float levelError = aSimplifier.Simplify(aMesh.Vertices, current, targetCount, maxError - error, simplified);
+
+				if (static_cast<float>(simplified.size()) > static_cast<float>(current.size()) * (1.f - MinLevelReduction))
+					break;
+
+				// Each level is simplified from the one before, so its distance from the original is at most the sum.
+				error += levelError;
+
+				aChainOut.Levels.push_back({ static_cast<std::uint32_t>(aChainOut.Triangles.size()), static_cast<std::uint32_t>(simplified.size()), error });
+				aChainOut.Triangles.insert(aChainOut.Triangles.end(), simplified.begin(), simplified.end());
+				current.swap(simplified);
+			}
+		}
+	}
+
+	float MeshSimplifier::Simplify(std::span<const MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aTargetTriangleCount, float aMaxError, std::vector<MeshPrimitive::Triangle>& someTrianglesOut)
+	{
+		PROFILE_SCOPE();
+
+		myIndices.resize(someTriangles.size() * 3);
+		for (std::size_t i = 0; i < someTriangles.size(); ++i)
+		{
+			myIndices[i * 3 + 0] = someTriangles[i].V1;
+			myIndices[i * 3 + 1] = someTriangles[i].V2;
+			myIndices[i * 3 + 2] = someTriangles[i].V3;
+		}
+
+		FindCanonicalVertices(someVertices);
+
+		// Every vertex starts with the planes of the triangles around it, so moving it anywhere off them costs the squared distance.
+		myQuadrics.assign(someVertices.size(), Quadric());
+		for (std::size_t corner = 0; corner < myIndices.size(); corner += 3)
+		{
+			const Vector3<float>& position = myPositions[myIndices[corner]];
+			const Vector3<float> normal = Vector3<float>::Cross(myPositions[myIndices[corner + 1]] - position, myPositions[myIndices[corner + 2]] - position);
+			const float lengthSquared = Vector3<float>::Dot(normal, normal);
+			if (lengthSquared <= MinLengthSquared)
+				continue;
+
+			const Vector3<float> unitNormal = normal * (1.f / std::sqrt(lengthSquared));
+			for (std::size_t i = 0; i < 3; ++i)
+				AddPlane(myQuadrics[myCanonical[myIndices[corner + i]]], unitNormal, position);
+		}
+
+		const double maxCost = static_cast<double>(aMaxError) * aMaxError;
+		double reachedCost = 0.0;
+
+		// Each pass collapses edges that don't touch each other, then rebuilds the adjacency for the next.
+		for (bool isFirstPass = true; myIndices.size() / 3 > aTargetTriangleCount; isFirstPass = false)
+		{
+			BuildAdjacency();
+			ClassifyVertices();
+
+			if (isFirstPass)
+				AddEdgeQuadrics();
+
+			FindCollapses();
+
+			myIsTouched.assign(someVertices.size(), 0);
+			myRemap.resize(someVertices.size());
+			std::iota(myRemap.begin(), myRemap.end(), 0u);
+
+			const std::size_t triangleCount = myIndices.size() / 3;
+			std::size_t removedCount = 0;
+			std::size_t collapseCount = 0;
+
+			for (const Collapse& collapse : myCollapses)
+			{
+				if (collapse.Cost > maxCost || triangleCount - std::min(removedCount, triangleCount) <= aTargetTriangleCount)
+					break;
+
+				const std::uint32_t corner = collapse.Corner;
+				const std::uint32_t sourceVertex = myIndices[collapse.IsReversed ? NextCorner(corner) : corner];
+				const std::uint32_t targetVertex = myIndices[collapse.IsReversed ? corner : NextCorner(corner)];
+				const std::uint32_t source = collapse.Source;
+				const std::uint32_t target = myCanonical[targetVertex];
+
+				if (myIsTouched[source] || myIsTouched[target] || CollapseFlipsTriangles(source, target))
+					continue;
+
+				myRemap[sourceVertex] = targetVertex;
+
+				// Seam vertices take their other side along, to the other side of the target.
+				if (myKinds[source] == VertexKind::Seam)
+				{
+					const std::uint32_t opposite = myOpposites[corner];
+					const std::uint32_t oppositeStart = myIndices[opposite];
+					const std::uint32_t oppositeEnd = myIndices[NextCorner(opposite)];
+					if (collapse.IsReversed)
+						myRemap[oppositeStart] = oppositeEnd;
+					else
+						myRemap[oppositeEnd] = oppositeStart;
+				}
+
+				// Neighbouring collapses would change the triangles the flip test just checked, so they wait for the next pass.
+				myIsTouched[source] = 1;
+				myIsTouched[target] = 1;
+				for (std::uint32_t i = myEdgeOffsets[source]; i < myEdgeOffsets[source + 1]; ++i)
+				{
+					const std::uint32_t next = NextCorner(myEdges[i]);
+					myIsTouched[myCanonical[myIndices[next]]] = 1;
+					myIsTouched[myCanonical[myIndices[NextCorner(next)]]] = 1;
+				}
+
+				AddQuadric(myQuadrics[target], myQuadrics[source]);
+
+				removedCount += myKinds[source] == VertexKind::Border ? 1 : 2;
+				reachedCost = std::max(reachedCost, collapse.Cost);
+				++collapseCount;
+			}
+
+			if (collapseCount == 0)
+				break;
+
+			std::size_t writeIndex = 0;
+			for (std::size_t corner = 0; corner < myIndices.size(); corner += 3)
+			{
+				const std::uint32_t a = myRemap[myIndices[corner + 0]];
+				const std::uint32_t b = myRemap[myIndices[corner + 1]];
+				const std::uint32_t c = myRemap[myIndices[corner + 2]];
+				if (myCanonical[a] == myCanonical[b] || myCanonical[b] == myCanonical[c] || myCanonical[c] == myCanonical[a])
+					continue;
+
+				myIndices[writeIndex++] = a;
+				myIndices[writeIndex++] = b;
+				myIndices[writeIndex++] = c;
+			}
+			myIndices.resize(writeIndex);
+		}
+
+		someTrianglesOut.resize(myIndices.size() / 3);
+		for (std::size_t i = 0; i < someTrianglesOut.size(); ++i)
+			someTrianglesOut[i] = { myIndices[i * 3 + 0], myIndices[i * 3 + 1], myIndices[i * 3 + 2] };
+
+		return static_cast<float>(std::sqrt(reachedCost));
+	}
+
+	void MeshSimplifier::FindCanonicalVertices(std::span<const MeshPrimitive::Vertex> someVertices)
+	{
+		const std::uint32_t vertexCount = static_cast<std::uint32_t>(someVertices.size());
+
+		myPositions.resize(vertexCount);
+		for (std::uint32_t i = 0; i < vertexCount; ++i)
+			myPositions[i] = someVertices[i].Position;
+
+		// Sorting by position puts vertices that share one next to each other. Adding zero turns -0 into 0 so the two match.
+		const auto getKey = [this](std::uint32_t aVertex) {
+			const Vector3<float>& position = myPositions[aVertex];
+			return std::array<std::uint32_t, 3> { std::bit_cast<std::uint32_t>(position.X + 0.f), std::bit_cast<std::uint32_t>(position.Y + 0.f), std::bit_cast<std::uint32_t>(position.Z + 0.f) };
+			};
+
+		myRemap.resize(vertexCount);
+		std::iota(myRemap.begin(), myRemap.end(), 0u);
+		std::sort(myRemap.begin(), myRemap.end(), [&getKey](std::uint32_t aVertex, std::uint32_t anotherVertex) {
+			const auto key = getKey(aVertex);
+			const auto otherKey = getKey(anotherVertex);
+			return key != otherKey ? key < otherKey : aVertex < anotherVertex;
+			});
+
+		myCanonical.resize(vertexCount);
+		for (std::uint32_t i = 0; i < vertexCount; ++i)
+		{
+			const std::uint32_t vertex = myRemap[i];
+			myCanonical[vertex] = (i > 0 && getKey(myRemap[i - 1]) == getKey(vertex)) ? myCanonical[myRemap[i - 1]] : vertex;
+		}
+	}
+
+	void MeshSimplifier::BuildAdjacency()
+	{
+		const std::size_t vertexCount = myCanonical.size();
+		const std::uint32_t cornerCount = static_cast<std::uint32_t>(myIndices.size());
+
+		// Count the edges leaving each vertex, then place them from the end of each range back to its start.
+		myEdgeOffsets.assign(vertexCount + 1, 0);
+		for (std::uint32_t corner = 0; corner < cornerCount; ++corner)
+			++myEdgeOffsets[myCanonical[myIndices[corner]]];
+
+		for (std::size_t i = 1; i < vertexCount; ++i)
+			myEdgeOffsets[i] += myEdgeOffsets[i - 1];
+		myEdgeOffsets[vertexCount] = cornerCount;
+
+		myEdges.resize(cornerCount);
+		for (std::uint32_t corner = cornerCount; corner-- > 0;)
+			myEdges[--myEdgeOffsets[myCanonical[myIndices[corner]]]] = corner;
+
+		// The opposite of an edge from A to B is an edge from B to A, by position.
+		myOpposites.resize(cornerCount);
+		for (std::uint32_t corner = 0; corner < cornerCount; ++corner)
+		{
+			const std::uint32_t start = myCanonical[myIndices[corner]];
+			const std::uint32_t end = myCanonical[myIndices[NextCorner(corner)]];
+
+			std::uint32_t opposite = NoOpposite;
+			for (std::uint32_t i = myEdgeOffsets[end]; i < myEdgeOffsets[end + 1]; ++i)
+			{
+				if (myCanonical[myIndices[NextCorner(myEdges[i])]] != start)
+					continue;
+
+				opposite = opposite == NoOpposite ? myEdges[i] : ManyOpposites;
+			}
+
+			myOpposites[corner] = opposite;
+		}
+	}
+
+	void MeshSimplifier::ClassifyVertices()
+	{
+		const std::size_t vertexCount = myCanonical.size();
+		myKinds.assign(vertexCount, VertexKind::Locked);
+
+		for (std::size_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			const std::uint32_t begin = myEdgeOffsets[vertex];
+			const std::uint32_t end = myEdgeOffsets[vertex + 1];
+			if (begin == end)
+				continue;
+
+			// Count the vertices sharing this position that triangles still use, and the border and seam edges leaving it.
+			const std::uint32_t firstWedge = myIndices[myEdges[begin]];
+			std::uint32_t secondWedge = firstWedge;
+			bool isComplex = false;
+			unsigned int borderCount = 0;
+			unsigned int seamCount = 0;
+
+			for (std::uint32_t i = begin; i < end && !isComplex; ++i)
+			{
+				const std::uint32_t corner = myEdges[i];
+				const std::uint32_t wedge = myIndices[corner];
+				if (wedge != firstWedge)
+				{
+					if (secondWedge == firstWedge)
+						secondWedge = wedge;
+					else if (wedge != secondWedge)
+						isComplex = true;
+				}
+
+				const std::uint32_t opposite = myOpposites[corner];
+				if (opposite == ManyOpposites)
+					isComplex = true;
+				else if (opposite == NoOpposite)
+					++borderCount;
+				else if (myIndices[opposite] != myIndices[NextCorner(corner)] || myIndices[NextCorner(opposite)] != wedge)
+					++seamCount;
+			}
+
+			if (isComplex)
+				continue;
+
+			// A simple seam leaves the vertex in two directions, once on each side.
+			if (secondWedge == firstWedge)
+			{
+				if (borderCount == 0)
+					myKinds[vertex] = VertexKind::Manifold;
+				else if (borderCount == 1)
+					myKinds[vertex] = VertexKind::Border;
+			}
+			else if (borderCount == 0 && seamCount == 2)
+			{
+				myKinds[vertex] = VertexKind::Seam;
+			}
+		}
+	}
+
+	void MeshSimplifier::AddEdgeQuadrics()
+	{
+		// Planes through border and seam edges, perpendicular to their triangle, keep them from moving sideways.
+		for (std::uint32_t corner = 0; corner < myIndices.size(); ++corner)
+		{
+			const std::uint32_t opposite = myOpposites[corner];
+			const std::uint32_t next = NextCorner(corner);
+			if (opposite != NoOpposite && (opposite == ManyOpposites || (myIndices[opposite] == myIndices[next] && myIndices[NextCorner(opposite)] == myIndices[corner])))
+				continue;
+
+			const Vector3<float>& start = myPositions[myIndices[corner]];
+			const Vector3<float> edge = myPositions[myIndices[next]] - start;
+			const Vector3<float> normal = Vector3<float>::Cross(edge, myPositions[myIndices[NextCorner(next)]] - start);
+			const Vector3<float> edgeNormal = Vector3<float>::Cross(edge, normal);
+			const float lengthSquared = Vector3<float>::Dot(edgeNormal, edgeNormal);
+			if (lengthSquared <= MinLengthSquared)
+				continue;
+
+			const Vector3<float> unitNormal = edgeNormal * (1.f / std::sqrt(lengthSquared));
+			AddPlane(myQuadrics[myCanonical[myIndices[corner]]], unitNormal, start);
+			AddPlane(myQuadrics[myCanonical[myIndices[next]]], unitNormal, start);
+		}
+	}
+
+	void MeshSimplifier::FindCollapses()
+	{
+		const std::size_t vertexCount = myCanonical.size();
+		myCollapses.assign(vertexCount, Collapse { 0, 0, false, std::numeric_limits<double>::infinity() });
+
+		const auto consider = [this](std::uint32_t aCorner, bool isReversed) {
+			const std::uint32_t startVertex = myIndices[aCorner];
+			const std::uint32_t endVertex = myIndices[NextCorner(aCorner)];
+			const std::uint32_t source = myCanonical[isReversed ? endVertex : startVertex];
+			const std::uint32_t target = myCanonical[isReversed ? startVertex : endVertex];
+			const VertexKind targetKind = myKinds[target];
+			const std::uint32_t opposite = myOpposites[aCorner];
+
+			// Borders and seams only collapse along themselves, onto vertices that are also on them.
+			switch (myKinds[source])
+			{
+				case VertexKind::Manifold:
+					break;
+
+				case VertexKind::Border:
+					if (opposite != NoOpposite || (targetKind != VertexKind::Border && targetKind != VertexKind::Locked))
+						return;
+					break;
+
+				case VertexKind::Seam:
+					if (opposite == NoOpposite || opposite == ManyOpposites || myIndices[opposite] == endVertex || myIndices[NextCorner(opposite)] == startVertex
+						|| (targetKind != VertexKind::Seam && targetKind != VertexKind::Locked))
+						return;
+					break;
+
+				default:
+					return;
+			}
+
+			const double cost = EvaluateQuadric(myQuadrics[source], myPositions[target]);
+			if (cost < myCollapses[source].Cost)
+				myCollapses[source] = { source, aCorner, isReversed, cost };
+			};
+
+		for (std::uint32_t corner = 0; corner < myIndices.size(); ++corner)
+		{
+			consider(corner, false);
+			consider(corner, true);
+		}
+
+		std::erase_if(myCollapses, [](const Collapse& aCollapse) { return aCollapse.Cost == std::numeric_limits<double>::infinity(); });
+		std::sort(myCollapses.begin(), myCollapses.end(), [](const Collapse& aCollapse, const Collapse& anotherCollapse) { return aCollapse.Cost < anotherCollapse.Cost; });
+	}
+
+	bool MeshSimplifier::CollapseFlipsTriangles(std::uint32_t aSource, std::uint32_t aTarget) const
+	{
+		const Vector3<float>& sourcePosition = myPositions[aSource];
+		const Vector3<float>& targetPosition = myPositions[aTarget];
+
+		for (std::uint32_t i = myEdgeOffsets[aSource]; i < myEdgeOffsets[aSource + 1]; ++i)
+		{
+			const std::uint32_t next = NextCorner(myEdges[i]);
+			const std::uint32_t b = myCanonical[myIndices[next]];
+			const std::uint32_t c = myCanonical[myIndices[NextCorner(next)]];
+
+			// Triangles along the collapsed edge disappear instead.
+			if (b == aTarget || c == aTarget)
+				continue;
+
+			const Vector3<float> normal = Vector3<float>::Cross(myPositions[b] - sourcePosition, myPositions[c] - sourcePosition);
+			const Vector3<float> newNormal = Vector3<float>::Cross(myPositions[b] - targetPosition, myPositions[c] - targetPosition);
+			const float lengthSquared = Vector3<float>::Dot(normal, normal);
+			if (lengthSquared <= MinLengthSquared)
+				continue;
+
+			if (Vector3<float>::Dot(normal, newNormal) <= MinNormalCosine * std::sqrt(lengthSquared * Vector3<float>::Dot(newNormal, newNormal)))
+				return true;
+		}
+
+		return false;
+	}
+
+	MeshLodChain MeshLodChain::Build(const MeshPrimitive& aMesh, const MeshLodSettings& someSettings)
+	{
+		MeshSimplifier simplifier;
+		MeshLodChain chain;
+		BuildChain(simplifier, aMesh, someSettings, chain);
+		return chain;
+	}
+
+	void MeshLodChain::Build(std::span<const MeshPrimitive* const> someMeshes, std::span<MeshLodChain> someChainsOut, const MeshLodSettings& someSettings)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someChainsOut.size() >= someMeshes.size(), "There is a chain for every mesh."))
+			return;
+
+		// Meshes vary a lot in size, so threads take the next mesh as they finish one instead of splitting them up front.
+		// Each thread keeps one simplifier for all the meshes it takes, so its scratch buffers are reused.
+		std::atomic<std::size_t> nextMesh = 0;
+		WorkerPool& workerPool = WorkerPool::Get();
+		const unsigned int threadCount = static_cast<unsigned int>(std::min<std::size_t>(std::min(workerPool.GetThreadCount(), MaxThreads), someMeshes.size()));
+		workerPool.ParallelFor(threadCount, [&](std::size_t) {
+			MeshSimplifier simplifier;
+			for (std::size_t i = nextMesh++; i < someMeshes.size(); i = nextMesh++)
+				BuildChain(simplifier, *someMeshes[i], someSettings, someChainsOut[i]);
+			});
+	}
+
+	float MeshLodChain::GetProjectionScale(float aVerticalFieldOfView, float aViewportHeight)
+	{
+		return aViewportHeight / (2.f * std::tan(aVerticalFieldOfView * 0.5f));
+	}
+
+	std::size_t MeshLodChain::SelectLevel(float aDistance, float aProjectionScale, float aMaxScreenError) const
+	{
+		// Errors shrink on screen in proportion to distance, so compare without dividing by it.
+		for (std::size_t level = Levels.size(); level-- > 1;)
+		{
+			if (Levels[level].Error * aProjectionScale <= aMaxScreenError * aDistance)
+				return level;
+		}
+
+		return 0;
+	}
+}
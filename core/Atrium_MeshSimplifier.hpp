@@ -0,0 +1,157 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Reduces the triangle count of meshes by collapsing edges, choosing those that change the surface the least
+	 *        as measured by quadric error metrics.
+	 *
+	 *        Vertices are never moved or created, only removed, so every simplified mesh indexes the vertices of the original.
+	 *        Vertices along borders only collapse along the border, and vertices split along texture or normal seams
+	 *        only collapse along the seam, with both sides at once. Vertices where these meet, or that are split more than once, are kept.
+	 *
+	 *        Keeps its working memory between calls, so one simplifier per thread can process many meshes without reallocating.
+	 */
+	class MeshSimplifier
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Simplify a mesh down to a number of triangles, or until simplifying it further would exceed an error.
+		 *
+		 * @param someVertices Vertices of the mesh.
+		 * @param someTriangles Triangles of the mesh.
+		 * @param aTargetTriangleCount Number of triangles to stop at. The result may have a few less, when the last collapses remove several.
+		 * @param aMaxError Largest distance the surface may move, in the units of the vertex positions.
+		 * @param someTrianglesOut Replaced with the triangles of the simplified mesh, indexing the same vertices.
+		 * @return The approximate distance the surface moved.
+		 */
+		float Simplify(std::span<const MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aTargetTriangleCount, float aMaxError, std::vector<MeshPrimitive::Triangle>& someTrianglesOut);
+
+	#pragma endregion
+
+	private:
+		enum class VertexKind : std::uint8_t
+		{
+			Manifold,
+			Border,
+			Seam,
+			Locked
+		};
+
+		// The terms of a symmetric 4x4 matrix measuring squared distances to a set of planes.
+		using Quadric = std::array<double, 10>;
+
+		// The cheapest edge to collapse a vertex along, as the corner starting the edge and whether it collapses towards that corner.
+		struct Collapse
+		{
+			std::uint32_t Source = 0;
+			std::uint32_t Corner = 0;
+			bool IsReversed = false;
+			double Cost = 0.0;
+		};
+
+		void FindCanonicalVertices(std::span<const MeshPrimitive::Vertex> someVertices);
+		void BuildAdjacency();
+		void ClassifyVertices();
+		void AddEdgeQuadrics();
+		void FindCollapses();
+		bool CollapseFlipsTriangles(std::uint32_t aSource, std::uint32_t aTarget) const;
+
+		// Triangles as three vertex indices each, changed in place as edges collapse.
+		std::vector<std::uint32_t> myIndices;
+		std::vector<Vector3<float>> myPositions;
+
+		// For each vertex, the first vertex with the same position, which stands for all of them.
+		std::vector<std::uint32_t> myCanonical;
+
+		// Half-edges leaving each canonical vertex, as corners of myIndices, and the corner of the opposite half-edge of each corner.
+		std::vector<std::uint32_t> myEdgeOffsets;
+		std::vector<std::uint32_t> myEdges;
+		std::vector<std::uint32_t> myOpposites;
+
+		std::vector<VertexKind> myKinds;
+		std::vector<Quadric> myQuadrics;
+
+		std::vector<Collapse> myCollapses;
+		std::vector<std::uint8_t> myIsTouched;
+		std::vector<std::uint32_t> myRemap;
+	};
+
+	/**
+	 * @brief Settings for generating a chain of simplified levels of detail.
+	 */
+	struct MeshLodSettings
+	{
+		// Most levels to generate, including the original mesh.
+		unsigned int MaxLevelCount = 5;
+
+		// Fraction of the previous level's triangles each level aims for.
+		float TriangleRatio = 0.5f;
+
+		// Largest error of any level, as a fraction of the diagonal of the mesh's bounds.
+		float MaxRelativeError = 0.05f;
+	};
+
+	/**
+	 * @brief A mesh's triangles at decreasing levels of detail, all indexing the mesh's original vertices.
+	 */
+	struct MeshLodChain
+	{
+		struct Level
+		{
+			std::uint32_t FirstTriangle = 0;
+			std::uint32_t TriangleCount = 0;
+
+			// Approximate distance the surface moved from the original, in the units of the vertex positions.
+			float Error = 0.f;
+		};
+
+		std::vector<MeshPrimitive::Triangle> Triangles;
+		std::vector<Level> Levels;
+
+		/**
+		 * @brief Generate the levels of a mesh, each simplified from the one before.
+		 */
+		static MeshLodChain Build(const MeshPrimitive& aMesh, const MeshLodSettings& someSettings = MeshLodSettings());
+
+		/**
+		 * @brief Generate the levels of many meshes at once, split over threads.
+		 *
+		 * @param someChainsOut The chain of each mesh, as many as there are meshes.
+		 */
+		static void Build(std::span<const MeshPrimitive* const> someMeshes, std::span<MeshLodChain> someChainsOut, const MeshLodSettings& someSettings = MeshLodSettings());
+
+		/**
+		 * @brief Get the scale from an error at a distance of one to its size on screen.
+		 *
+		 * @param aVerticalFieldOfView Vertical field of view of the camera, in radians.
+		 * @param aViewportHeight Height of the viewport, in pixels.
+		 */
+		static float GetProjectionScale(float aVerticalFieldOfView, float aViewportHeight);
+
+		/**
+		 * @brief Pick the least detailed level whose error stays below a size on screen.
+		 *
+		 * @param aDistance Distance from the camera to the mesh, divided by the mesh's scale.
+		 * @param aProjectionScale Scale from GetProjectionScale().
+		 * @param aMaxScreenError Largest error to allow on screen, in pixels.
+		 * @return Index of the level to draw.
+		 */
+		std::size_t SelectLevel(float aDistance, float aProjectionScale, float aMaxScreenError = 1.f) const;
+	};
+}
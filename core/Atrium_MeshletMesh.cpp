@@ -0,0 +1,370 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_MeshletMesh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace Atrium
+{
+	namespace
+	{
+		constexpr std::uint32_t NotInMeshlet = ~0u;
+
+		// Local vertex indices are packed a byte each.
+		constexpr std::uint32_t MaxMeshletVertices = 256;
+
+		constexpr float MinLengthSquared = 1e-20f;
+
+		float GetAxis(const Vector3<float>& aVector, std::size_t anAxis)
+		{
+			return anAxis == 0 ? aVector.X : (anAxis == 1 ? aVector.Y : aVector.Z);
+		}
+
+		/**
+		 * @brief Find a sphere around some points, in two passes: starting from the two points furthest apart along an axis,
+		 *        then growing to include any point outside it. At most a few percent larger than the smallest sphere.
+		 */
+		template <typename GetPosition>
+		BoundingSphere GetBoundingSphere(std::size_t aCount, const GetPosition& aGetPosition)
+		{
+			if (aCount == 0)
+				return BoundingSphere();
+
+			std::array<std::size_t, 3> minimum = { 0, 0, 0 };
+			std::array<std::size_t, 3> maximum = { 0, 0, 0 };
+			for (std::size_t i = 1; i < aCount; ++i)
+			{
+				const Vector3<float> position = aGetPosition(i);
+				for (std::size_t axis = 0; axis < 3; ++axis)
+				{
+					if (GetAxis(position, axis) < GetAxis(aGetPosition(minimum[axis]), axis))
+						minimum[axis] = i;
+					if (GetAxis(position, axis) > GetAxis(aGetPosition(maximum[axis]), axis))
+						maximum[axis] = i;
+				}
+			}
+
+			float widestSquared = -1.f;
+			BoundingSphere sphere;
+			for (std::size_t axis = 0; axis < 3; ++axis)
+			{
+				const Vector3<float> low = aGetPosition(minimum[axis]);
+				const Vector3<float> high = aGetPosition(maximum[axis]);
+				const float lengthSquared = Vector3<float>::Dot(high - low, high - low);
+				if (lengthSquared > widestSquared)
+				{
+					widestSquared = lengthSquared;
+					sphere.Center = (low + high) * 0.5f;
+					sphere.Radius = std::sqrt(lengthSquared) * 0.5f;
+				}
+			}
+
+			for (std::size_t i = 0; i < aCount; ++i)
+			{
+				const Vector3<float> offset = aGetPosition(i) - sphere.Center;
+				const float distanceSquared = Vector3<float>::Dot(offset, offset);
+				if (distanceSquared <= sphere.Radius * sphere.Radius)
+					continue;
+
+				// Move the sphere towards the point just enough to reach it, keeping the opposite side where it was.
+				const float distance = std::sqrt(distanceSquared);
+				const float newRadius = (sphere.Radius + distance) * 0.5f;
+				sphere.Center += offset * ((newRadius - sphere.Radius) / distance);
+				sphere.Radius = newRadius;
+			}
+
+			return sphere;
+		}
+
+		bool IsInFrustum(const Frustum& aFrustum, const Vector3<float>& aCenter, float aRadius)
+		{
+			for (const Plane& plane : aFrustum.Planes)
+			{
+				if (Vector3<float>::Dot(plane.Normal, aCenter) + plane.Distance < -aRadius)
+					return false;
+			}
+
+			return true;
+		}
+
+		std::uint32_t GetLocalIndex(std::uint32_t somePackedIndices, std::uint32_t aCorner)
+		{
+			return (somePackedIndices >> (aCorner * 8)) & 0xFF;
+		}
+	}
+
+	MeshletMesh MeshletMesh::Build(const MeshPrimitive& aMesh, const MeshletSettings& someSettings)
+	{
+		return Build(aMesh.Vertices, aMesh.Triangles, someSettings);
+	}
+
+	MeshletMesh MeshletMesh::Build(std::span<const MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles, const MeshletSettings& someSettings)
+	{
+		PROFILE_SCOPE();
+
+		MeshletMesh mesh;
+		if (!Debug::Verify(someSettings.MaxVertices >= 3 && someSettings.MaxVertices <= MaxMeshletVertices && someSettings.MaxTriangles >= 1, "Meshlets have room for a triangle, and at most %u vertices.", MaxMeshletVertices))
+			return mesh;
+
+		const std::uint32_t vertexCount = static_cast<std::uint32_t>(someVertices.size());
+		const std::uint32_t triangleCount = static_cast<std::uint32_t>(someTriangles.size());
+
+		const auto getCorner = [&someTriangles](std::uint32_t aTriangle, std::uint32_t aCorner) {
+			const MeshPrimitive::Triangle& triangle = someTriangles[aTriangle];
+			return aCorner == 0 ? triangle.V1 : (aCorner == 1 ? triangle.V2 : triangle.V3);
+			};
+
+		// The triangles around each vertex, to find the neighbours of a meshlet.
+		std::vector<std::uint32_t> vertexTriangleOffsets(vertexCount + 1, 0);
+		for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			for (std::uint32_t corner = 0; corner < 3; ++corner)
+				++vertexTriangleOffsets[getCorner(triangle, corner)];
+		}
+
+		for (std::uint32_t i = 1; i < vertexCount; ++i)
+			vertexTriangleOffsets[i] += vertexTriangleOffsets[i - 1];
+		vertexTriangleOffsets[vertexCount] = triangleCount * 3;
+
+		std::vector<std::uint32_t> vertexTriangles(triangleCount * 3);
+		for (std::uint32_t triangle = triangleCount; triangle-- > 0;)
+		{
+			for (std::uint32_t corner = 0; corner < 3; ++corner)
+				vertexTriangles[--vertexTriangleOffsets[getCorner(triangle, corner)]] = triangle;
+		}
+
+		std::vector<Vector3<float>> centroids(triangleCount);
+		for (std::uint32_t triangle = 0; triangle < triangleCount; ++triangle)
+			centroids[triangle] = (someVertices[getCorner(triangle, 0)].Position + someVertices[getCorner(triangle, 1)].Position + someVertices[getCorner(triangle, 2)].Position) * (1.f / 3.f);
+
+		std::vector<std::uint8_t> isTriangleUsed(triangleCount, 0);
+		std::vector<std::uint32_t> localIndices(vertexCount, NotInMeshlet);
+
+		// Unused triangles touching the current meshlet, which may have been used since they were added.
+		// Each triangle is added once per meshlet, marked by the index of the meshlet it was last added for.
+		std::vector<std::uint32_t> candidates;
+		std::vector<std::uint32_t> candidateMeshlets(triangleCount, NotInMeshlet);
+
+		Meshlet meshlet;
+		Vector3<float> centroidSum;
+
+		const auto addTriangle = [&](std::uint32_t aTriangle) {
+			isTriangleUsed[aTriangle] = 1;
+
+			std::uint32_t packedIndices = 0;
+			for (std::uint32_t corner = 0; corner < 3; ++corner)
+			{
+				const std::uint32_t vertex = getCorner(aTriangle, corner);
+				if (localIndices[vertex] == NotInMeshlet)
+				{
+					localIndices[vertex] = meshlet.VertexCount++;
+					mesh.VertexIndices.push_back(vertex);
+
+					const std::uint32_t meshletIndex = static_cast<std::uint32_t>(mesh.Meshlets.size());
+					for (std::uint32_t i = vertexTriangleOffsets[vertex]; i < vertexTriangleOffsets[vertex + 1]; ++i)
+					{
+						const std::uint32_t triangle = vertexTriangles[i];
+						if (isTriangleUsed[triangle] || candidateMeshlets[triangle] == meshletIndex)
+							continue;
+
+						candidateMeshlets[triangle] = meshletIndex;
+						candidates.push_back(triangle);
+					}
+				}
+
+				packedIndices |= localIndices[vertex] << (corner * 8);
+			}
+
+			mesh.TriangleIndices.push_back(packedIndices);
+			++meshlet.TriangleCount;
+			centroidSum += centroids[aTriangle];
+			};
+
+		const auto countNewVertices = [&](std::uint32_t aTriangle) {
+			std::uint32_t count = 0;
+			for (std::uint32_t corner = 0; corner < 3; ++corner)
+				count += localIndices[getCorner(aTriangle, corner)] == NotInMeshlet ? 1 : 0;
+			return count;
+			};
+
+		std::uint32_t seedCursor = 0;
+		for (std::uint32_t remaining = triangleCount; remaining > 0; --remaining)
+		{
+			const Vector3<float> center = meshlet.TriangleCount > 0 ? centroidSum * (1.f / static_cast<float>(meshlet.TriangleCount)) : Vector3<float>();
+
+			// Prefer the neighbour that adds the fewest vertices, then the one closest to the meshlet, so meshlets stay round and fill up evenly.
+			std::uint32_t next = NotInMeshlet;
+			std::uint32_t nextNewVertices = 4;
+			float nextDistanceSquared = std::numeric_limits<float>::max();
+
+			std::size_t keptCount = 0;
+			for (const std::uint32_t triangle : candidates)
+			{
+				if (isTriangleUsed[triangle])
+					continue;
+
+				candidates[keptCount++] = triangle;
+
+				const std::uint32_t newVertices = countNewVertices(triangle);
+				if (meshlet.TriangleCount >= someSettings.MaxTriangles || meshlet.VertexCount + newVertices > someSettings.MaxVertices || newVertices > nextNewVertices)
+					continue;
+
+				const Vector3<float> offset = centroids[triangle] - center;
+				const float distanceSquared = Vector3<float>::Dot(offset, offset);
+				if (newVertices < nextNewVertices || distanceSquared < nextDistanceSquared)
+				{
+					next = triangle;
+					nextNewVertices = newVertices;
+					nextDistanceSquared = distanceSquared;
+				}
+			}
+			candidates.resize(keptCount);
+
+			if (next == NotInMeshlet)
+			{
+				// The meshlet is full. Start the next one from the closest triangle around it, to keep consecutive meshlets together.
+				float seedDistanceSquared = std::numeric_limits<float>::max();
+				for (const std::uint32_t triangle : candidates)
+				{
+					const Vector3<float> offset = centroids[triangle] - center;
+					const float distanceSquared = Vector3<float>::Dot(offset, offset);
+					if (distanceSquared < seedDistanceSquared)
+					{
+						next = triangle;
+						seedDistanceSquared = distanceSquared;
+					}
+				}
+
+				if (meshlet.TriangleCount > 0)
+				{
+					for (std::uint32_t i = 0; i < meshlet.VertexCount; ++i)
+						localIndices[mesh.VertexIndices[meshlet.VertexOffset + i]] = NotInMeshlet;
+
+					mesh.Meshlets.push_back(meshlet);
+					meshlet = Meshlet { static_cast<std::uint32_t>(mesh.VertexIndices.size()), static_cast<std::uint32_t>(mesh.TriangleIndices.size()), 0, 0 };
+					centroidSum = Vector3<float>();
+				}
+
+				candidates.clear();
+
+				// Nothing around the last meshlet is left, so continue from the next unused triangle in the mesh's own order.
+				if (next == NotInMeshlet)
+				{
+					while (isTriangleUsed[seedCursor])
+						++seedCursor;
+					next = seedCursor;
+				}
+			}
+
+			addTriangle(next);
+		}
+
+		if (meshlet.TriangleCount > 0)
+			mesh.Meshlets.push_back(meshlet);
+
+		// Bounds of each meshlet, with a cone around the normals of its triangles that have any area.
+		mesh.Bounds.resize(mesh.Meshlets.size());
+		std::vector<Vector3<float>> normals;
+		for (std::size_t i = 0; i < mesh.Meshlets.size(); ++i)
+		{
+			const Meshlet& current = mesh.Meshlets[i];
+			const std::uint32_t* vertexIndices = mesh.VertexIndices.data() + current.VertexOffset;
+			const std::uint32_t* triangleIndices = mesh.TriangleIndices.data() + current.TriangleOffset;
+
+			MeshletBounds& bounds = mesh.Bounds[i];
+			const BoundingSphere sphere = GetBoundingSphere(current.VertexCount, [&](std::size_t aVertex) { return someVertices[vertexIndices[aVertex]].Position; });
+			bounds.Center = sphere.Center;
+			bounds.Radius = sphere.Radius;
+
+			normals.clear();
+			Vector3<float> normalSum;
+			for (std::uint32_t triangle = 0; triangle < current.TriangleCount; ++triangle)
+			{
+				const Vector3<float>& a = someVertices[vertexIndices[GetLocalIndex(triangleIndices[triangle], 0)]].Position;
+				const Vector3<float>& b = someVertices[vertexIndices[GetLocalIndex(triangleIndices[triangle], 1)]].Position;
+				const Vector3<float>& c = someVertices[vertexIndices[GetLocalIndex(triangleIndices[triangle], 2)]].Position;
+				const Vector3<float> normal = Vector3<float>::Cross(b - a, c - a);
+				const float lengthSquared = Vector3<float>::Dot(normal, normal);
+				if (lengthSquared <= MinLengthSquared)
+					continue;
+
+				normals.push_back(normal * (1.f / std::sqrt(lengthSquared)));
+				normalSum += normals.back();
+			}
+
+			const float sumLengthSquared = Vector3<float>::Dot(normalSum, normalSum);
+			if (normals.empty() || sumLengthSquared <= MinLengthSquared)
+			{
+				bounds.ConeAxis = Vector3<float>(0, 0, 1);
+				bounds.ConeCutoff = 1.f;
+				continue;
+			}
+
+			bounds.ConeAxis = normalSum * (1.f / std::sqrt(sumLengthSquared));
+
+			float minimumCosine = 1.f;
+			for (const Vector3<float>& normal : normals)
+				minimumCosine = std::min(minimumCosine, Vector3<float>::Dot(bounds.ConeAxis, normal));
+
+			// A cone of 90 degrees or more always has a triangle facing the camera.
+			bounds.ConeCutoff = minimumCosine <= 0.f ? 1.f : std::sqrt(1.f - minimumCosine * minimumCosine);
+		}
+
+		mesh.MeshBounds = GetBoundingSphere(mesh.Bounds.size(), [&mesh](std::size_t aMeshlet) { return mesh.Bounds[aMeshlet].Center; });
+		for (const MeshletBounds& bounds : mesh.Bounds)
+		{
+			const Vector3<float> offset = bounds.Center - mesh.MeshBounds.Center;
+			mesh.MeshBounds.Radius = std::max(mesh.MeshBounds.Radius, std::sqrt(Vector3<float>::Dot(offset, offset)) + bounds.Radius);
+		}
+
+		return mesh;
+	}
+
+	void MeshletMesh::Cull(const Frustum& aFrustum, const Vector3<float>& aCameraPosition, std::vector<std::uint32_t>& someVisibleMeshletsOut) const
+	{
+		PROFILE_SCOPE();
+
+		someVisibleMeshletsOut.clear();
+		if (!IsInFrustum(aFrustum, MeshBounds.Center, MeshBounds.Radius))
+			return;
+
+		for (std::uint32_t i = 0; i < Bounds.size(); ++i)
+		{
+			const MeshletBounds& bounds = Bounds[i];
+			if (!IsInFrustum(aFrustum, bounds.Center, bounds.Radius))
+				continue;
+
+			const Vector3<float> offset = bounds.Center - aCameraPosition;
+			const float distance = std::sqrt(Vector3<float>::Dot(offset, offset));
+			if (Vector3<float>::Dot(offset, bounds.ConeAxis) >= bounds.ConeCutoff * (distance + bounds.Radius) + bounds.Radius)
+				continue;
+
+			someVisibleMeshletsOut.push_back(i);
+		}
+
+		PROFILE_PLOT("Visible meshlets", static_cast<std::int64_t>(someVisibleMeshletsOut.size()));
+	}
+
+	void MeshletMesh::GetTriangles(std::span<const std::uint32_t> someMeshlets, std::vector<MeshPrimitive::Triangle>& someTrianglesOut) const
+	{
+		someTrianglesOut.clear();
+		for (const std::uint32_t index : someMeshlets)
+		{
+			const Meshlet& meshlet = Meshlets[index];
+			const std::uint32_t* vertexIndices = VertexIndices.data() + meshlet.VertexOffset;
+			for (std::uint32_t triangle = 0; triangle < meshlet.TriangleCount; ++triangle)
+			{
+				const std::uint32_t packedIndices = TriangleIndices[meshlet.TriangleOffset + triangle];
+				someTrianglesOut.push_back({
+					vertexIndices[GetLocalIndex(packedIndices, 0)],
+					vertexIndices[GetLocalIndex(packedIndices, 1)],
+					vertexIndices[GetLocalIndex(packedIndices, 2)]
+					});
+			}
+		}
+	}
+}
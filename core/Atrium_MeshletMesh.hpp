@@ -0,0 +1,116 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_BoundingVolumes.hpp"
+#include "Atrium_FrustumCuller.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <rose-common/math/Vector.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief A small cluster of a mesh's triangles, indexing a range of the vertex and triangle indices.
+	 *        Laid out as four 32-bit values, so it can be uploaded as is for a mesh shader.
+	 */
+	struct Meshlet
+	{
+		// First of this meshlet's entries in MeshletMesh::VertexIndices.
+		std::uint32_t VertexOffset = 0;
+
+		// First of this meshlet's entries in MeshletMesh::TriangleIndices.
+		std::uint32_t TriangleOffset = 0;
+
+		std::uint32_t VertexCount = 0;
+		std::uint32_t TriangleCount = 0;
+	};
+	static_assert(sizeof(Meshlet) == 16, "Meshlets match the layout of their shader structure.");
+
+	/**
+	 * @brief Bounds of a meshlet for culling it: a sphere around its vertices, and a cone around its triangles' normals.
+	 *
+	 *        Every triangle of the meshlet faces away from a camera when
+	 *        Dot(Center - camera, ConeAxis) >= ConeCutoff * (Length(Center - camera) + Radius) + Radius.
+	 *        Meshlets whose normals spread too far to ever all face away have a cutoff of 1.
+	 */
+	struct MeshletBounds
+	{
+		Vector3<float> Center;
+		float Radius = 0.f;
+
+		Vector3<float> ConeAxis;
+
+		// The sine of the angle between the axis and the normal furthest from it.
+		float ConeCutoff = 1.f;
+	};
+
+	/**
+	 * @brief Settings for splitting a mesh into meshlets.
+	 *        The defaults fit the vertex and primitive limits of mesh shaders, and fill most meshlets to both at once.
+	 */
+	struct MeshletSettings
+	{
+		std::uint32_t MaxVertices = 64;
+		std::uint32_t MaxTriangles = 124;
+	};
+
+	/**
+	 * @brief A mesh split into meshlets, with bounds to cull each of them.
+	 *
+	 *        Meshlets are grown one at a time from neighbouring triangles, preferring those that add the fewest new vertices,
+	 *        then those closest to the meshlet. Each meshlet is compact, and consecutive meshlets are near each other.
+	 *
+	 *        The arrays are flat and free of pointers, so they can be uploaded as buffers for drawing with mesh shaders
+	 *        and culling on the GPU, or culled here and drawn as an ordinary index buffer.
+	 */
+	struct MeshletMesh
+	{
+		std::vector<Meshlet> Meshlets;
+		std::vector<MeshletBounds> Bounds;
+
+		// Index of the mesh vertex for each of the meshlets' own vertices.
+		std::vector<std::uint32_t> VertexIndices;
+
+		// Each triangle's three indices into its meshlet's vertices, packed a byte each from the lowest.
+		std::vector<std::uint32_t> TriangleIndices;
+
+		// Bounds of the whole mesh, to reject it before testing its meshlets.
+		BoundingSphere MeshBounds;
+
+		/**
+		 * @brief Split a mesh into meshlets.
+		 */
+		static MeshletMesh Build(const MeshPrimitive& aMesh, const MeshletSettings& someSettings = MeshletSettings());
+
+		/**
+		 * @brief Split some triangles of a mesh into meshlets, such as one of its levels of detail.
+		 */
+		static MeshletMesh Build(std::span<const MeshPrimitive::Vertex> someVertices, std::span<const MeshPrimitive::Triangle> someTriangles, const MeshletSettings& someSettings = MeshletSettings());
+
+		/**
+		 * @brief Find the meshlets that are inside a frustum and face a camera.
+		 *        Everything is in the mesh's own space: for a mesh with a world matrix,
+		 *        the frustum comes from Frustum::FromViewProjection() of the world matrix multiplied by the view-projection,
+		 *        and the camera position is transformed by the inverse of the world matrix.
+		 *
+		 * @param aFrustum Frustum to test against, in the mesh's space.
+		 * @param aCameraPosition Position of the camera, in the mesh's space.
+		 * @param someVisibleMeshletsOut Replaced with the indices of the visible meshlets, in ascending order.
+		 *                               Empty if the whole mesh is outside the frustum.
+		 */
+		void Cull(const Frustum& aFrustum, const Vector3<float>& aCameraPosition, std::vector<std::uint32_t>& someVisibleMeshletsOut) const;
+
+		/**
+		 * @brief Get the triangles of some meshlets as mesh triangles, to draw them through an ordinary index buffer.
+		 *
+		 * @param someMeshlets Indices of the meshlets, such as those Cull() found visible.
+		 * @param someTrianglesOut Replaced with the meshlets' triangles, indexing the mesh's vertices.
+		 */
+		void GetTriangles(std::span<const std::uint32_t> someMeshlets, std::vector<MeshPrimitive::Triangle>& someTrianglesOut) const;
+	};
+}
@@ -0,0 +1,350 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_OcclusionCuller.hpp"
+#include "Atrium_SIMD.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Below these, handing work to the workers costs more than working on one thread.
+		constexpr std::size_t ParallelRasterizeThreshold = 1024;
+		constexpr std::size_t ParallelCullThreshold = 8192;
+		constexpr unsigned int MaxThreads = 8;
+
+		// Vertices closer than this are treated as crossing the near plane.
+		constexpr float MinClipW = 1e-5f;
+
+		constexpr float FarDepth = 1.f;
+
+		static_assert(OcclusionCuller::TileWidth % 4 == 0, "Tile rows are processed four pixels at a time.");
+
+		using Matrix = std::array<float, 16>;
+
+		Matrix Multiply(const Matrix& aLeft, const Matrix& aRight)
+		{
+			Matrix result {};
+			for (std::size_t row = 0; row < 4; ++row)
+			{
+				for (std::size_t column = 0; column < 4; ++column)
+				{
+					for (std::size_t i = 0; i < 4; ++i)
+						result[row * 4 + column] += aLeft[row * 4 + i] * aRight[i * 4 + column];
+				}
+			}
+
+			return result;
+		}
+
+		std::array<float, 4> Transform(const Vector3<float>& aPoint, const Matrix& aMatrix)
+		{
+			std::array<float, 4> result;
+			for (std::size_t column = 0; column < 4; ++column)
+				result[column] = aPoint.X * aMatrix[column] + aPoint.Y * aMatrix[4 + column] + aPoint.Z * aMatrix[8 + column] + aMatrix[12 + column];
+
+			return result;
+		}
+
+		unsigned int GetThreadCount(std::size_t aWorkSize, std::size_t aThreshold)
+		{
+			return aWorkSize < aThreshold ? 1 : MaxThreads;
+		}
+	}
+
+	OcclusionCuller::OcclusionCuller(unsigned int aWidth, unsigned int aHeight)
+		: myViewProjection { }
+		, myTileCountX(std::max(1u, (aWidth + TileWidth - 1) / TileWidth))
+		, myTileCountY(std::max(1u, (aHeight + TileHeight - 1) / TileHeight))
+		, myIsRasterized(false)
+	{
+		const std::size_t tileCount = static_cast<std::size_t>(myTileCountX) * myTileCountY;
+		myTileBins.resize(tileCount);
+		myDepth.resize(tileCount * TileWidth * TileHeight, FarDepth);
+		myTileMaxDepth.resize(tileCount, FarDepth);
+	}
+
+	void OcclusionCuller::Begin(const std::array<float, 16>& aViewProjection)
+	{
+		myViewProjection = aViewProjection;
+		myTriangles.clear();
+		myIsRasterized = false;
+	}
+
+	void OcclusionCuller::AddOccluder(const MeshPrimitive& aMesh, const std::array<float, 16>& aWorld)
+	{
+		const Matrix worldViewProjection = Multiply(aWorld, myViewProjection);
+		const float width = static_cast<float>(GetWidth());
+		const float height = static_cast<float>(GetHeight());
+
+		std::vector<std::array<float, 4>> clipPositions;
+		clipPositions.reserve(aMesh.Vertices.size());
+		for (const MeshPrimitive::Vertex& vertex : aMesh.Vertices)
+			clipPositions.push_back(Transform(vertex.Position, worldViewProjection));
+
+		for (const MeshPrimitive::Triangle& triangle : aMesh.Triangles)
+		{
+			const std::array<std::uint32_t, 3> indices = { triangle.V1, triangle.V2, triangle.V3 };
+
+			ScreenTriangle screenTriangle;
+			bool isInFront = true;
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				const std::array<float, 4>& clip = clipPositions[indices[i]];
+				if (clip[3] < MinClipW)
+				{
+					isInFront = false;
+					break;
+				}
+
+				const float inverseW = 1.f / clip[3];
+				screenTriangle.X[i] = (clip[0] * inverseW * 0.5f + 0.5f) * width;
+				screenTriangle.Y[i] = (0.5f - clip[1] * inverseW * 0.5f) * height;
+				screenTriangle.Z[i] = clip[2] * inverseW;
+			}
+
+			if (!isInFront)
+				continue;
+
+			// Triangles entirely outside the screen or beyond the far plane can't hide anything.
+			const auto [minX, maxX] = std::minmax({ screenTriangle.X[0], screenTriangle.X[1], screenTriangle.X[2] });
+			const auto [minY, maxY] = std::minmax({ screenTriangle.Y[0], screenTriangle.Y[1], screenTriangle.Y[2] });
+			const float minZ = std::min({ screenTriangle.Z[0], screenTriangle.Z[1], screenTriangle.Z[2] });
+			if (maxX < 0.f || maxY < 0.f || minX >= width || minY >= height || minZ >= FarDepth)
+				continue;
+
+			myTriangles.push_back(screenTriangle);
+		}
+	}
+
+	void OcclusionCuller::Rasterize()
+	{
+		PROFILE_SCOPE();
+
+		for (std::vector<std::uint32_t>& bin : myTileBins)
+			bin.clear();
+
+		for (std::uint32_t i = 0; i < myTriangles.size(); ++i)
+		{
+			const ScreenTriangle& triangle = myTriangles[i];
+			const float minX = std::min({ triangle.X[0], triangle.X[1], triangle.X[2] });
+			const float maxX = std::max({ triangle.X[0], triangle.X[1], triangle.X[2] });
+			const float minY = std::min({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+			const float maxY = std::max({ triangle.Y[0], triangle.Y[1], triangle.Y[2] });
+
+			const unsigned int firstTileX = static_cast<unsigned int>(std::clamp(minX / TileWidth, 0.f, static_cast<float>(myTileCountX - 1)));
+			const unsigned int lastTileX = static_cast<unsigned int>(std::clamp(maxX / TileWidth, 0.f, static_cast<float>(myTileCountX - 1)));
+			const unsigned int firstTileY = static_cast<unsigned int>(std::clamp(minY / TileHeight, 0.f, static_cast<float>(myTileCountY - 1)));
+			const unsigned int lastTileY = static_cast<unsigned int>(std::clamp(maxY / TileHeight, 0.f, static_cast<float>(myTileCountY - 1)));
+
+			for (unsigned int tileY = firstTileY; tileY <= lastTileY; ++tileY)
+			{
+				for (unsigned int tileX = firstTileX; tileX <= lastTileX; ++tileX)
+					myTileBins[tileY * myTileCountX + tileX].push_back(i);
+			}
+		}
+
+		const std::uint32_t tileCount = static_cast<std::uint32_t>(myTileBins.size());
+		WorkerPool::Get().ParallelFor(tileCount, [this](std::size_t aTile) { RasterizeTile(static_cast<std::uint32_t>(aTile)); }, GetThreadCount(myTriangles.size(), ParallelRasterizeThreshold));
+
+		PROFILE_PLOT("Occluder triangles", static_cast<std::int64_t>(myTriangles.size()));
+		myIsRasterized = true;
+	}
+
+	void OcclusionCuller::RasterizeTile(std::uint32_t aTile)
+	{
+		float* const tileDepth = myDepth.data() + static_cast<std::size_t>(aTile) * TileWidth * TileHeight;
+		std::fill_n(tileDepth, TileWidth * TileHeight, FarDepth);
+
+		const int tileX = static_cast<int>((aTile % myTileCountX) * TileWidth);
+		const int tileY = static_cast<int>((aTile / myTileCountX) * TileHeight);
+
+		for (std::uint32_t triangleIndex : myTileBins[aTile])
+		{
+			const ScreenTriangle& triangle = myTriangles[triangleIndex];
+
+			const float area = (triangle.X[1] - triangle.X[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.X[2] - triangle.X[0]) * (triangle.Y[1] - triangle.Y[0]);
+			if (area == 0.f)
+				continue;
+
+			// Edge functions, oriented to be positive inside the triangle regardless of its winding.
+			std::array<float, 3> edgeA, edgeB, edgeC;
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				const std::size_t from = (i + 1) % 3;
+				const std::size_t to = (i + 2) % 3;
+				const float sign = area > 0.f ? 1.f : -1.f;
+				edgeA[i] = sign * (triangle.Y[from] - triangle.Y[to]);
+				edgeB[i] = sign * (triangle.X[to] - triangle.X[from]);
+				edgeC[i] = sign * (triangle.X[from] * triangle.Y[to] - triangle.X[to] * triangle.Y[from]);
+			}
+
+			// Depth is linear in screen space after the perspective divide, so it's a plane over the pixels.
+			const float depthX = ((triangle.Z[1] - triangle.Z[0]) * (triangle.Y[2] - triangle.Y[0]) - (triangle.Z[2] - triangle.Z[0]) * (triangle.Y[1] - triangle.Y[0])) / area;
+			const float depthY = ((triangle.Z[2] - triangle.Z[0]) * (triangle.X[1] - triangle.X[0]) - (triangle.Z[1] - triangle.Z[0]) * (triangle.X[2] - triangle.X[0])) / area;
+			const float depthC = triangle.Z[0] - depthX * triangle.X[0] - depthY * triangle.Y[0];
+
+			const int minX = std::max(tileX, static_cast<int>(std::floor(std::min({ triangle.X[0], triangle.X[1], triangle.X[2] }))));
+			const int maxX = std::min(tileX + static_cast<int>(TileWidth) - 1, static_cast<int>(std::ceil(std::max({ triangle.X[0], triangle.X[1], triangle.X[2] }))));
+			const int minY = std::max(tileY, static_cast<int>(std::floor(std::min({ triangle.Y[0], triangle.Y[1], triangle.Y[2] }))));
+			const int maxY = std::min(tileY + static_cast<int>(TileHeight) - 1, static_cast<int>(std::ceil(std::max({ triangle.Y[0], triangle.Y[1], triangle.Y[2] }))));
+			if (minX > maxX || minY > maxY)
+				continue;
+
+			// Rows are processed four pixels at a time, from a multiple of four within the tile.
+			const int firstX = tileX + ((minX - tileX) & ~3);
+
+			for (int y = minY; y <= maxY; ++y)
+			{
+				const float centerY = static_cast<float>(y) + 0.5f;
+				float* const row = tileDepth + (y - tileY) * TileWidth;
+
+			#if ATRIUM_SIMD_SSE
+				const __m128 zero = _mm_setzero_ps();
+				const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+				std::array<__m128, 3> edgeRowA, edgeRowC;
+				for (std::size_t i = 0; i < 3; ++i)
+				{
+					edgeRowA[i] = _mm_set1_ps(edgeA[i]);
+					edgeRowC[i] = _mm_set1_ps(edgeB[i] * centerY + edgeC[i]);
+				}
+
+				const __m128 depthRowX = _mm_set1_ps(depthX);
+				const __m128 depthRowC = _mm_set1_ps(depthY * centerY + depthC);
+
+				for (int x = firstX; x <= maxX; x += 4)
+				{
+					const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+					__m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeRowA[0], centerX), edgeRowC[0]), zero);
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeRowA[1], centerX), edgeRowC[1]), zero));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edgeRowA[2], centerX), edgeRowC[2]), zero));
+
+					float* const pixels = row + (x - tileX);
+					const __m128 depth = _mm_add_ps(_mm_mul_ps(depthRowX, centerX), depthRowC);
+					const __m128 current = _mm_loadu_ps(pixels);
+					const __m128 nearest = _mm_min_ps(current, depth);
+					_mm_storeu_ps(pixels, SIMD::Select(inside, nearest, current));
+				}
+			#else
+				for (int x = firstX; x <= maxX; ++x)
+				{
+					const float centerX = static_cast<float>(x) + 0.5f;
+					bool isInside = true;
+					for (std::size_t i = 0; i < 3; ++i)
+						isInside = isInside && edgeA[i] * centerX + edgeB[i] * centerY + edgeC[i] >= 0.f;
+
+					if (isInside)
+					{
+						float& pixel = row[x - tileX];
+						pixel = std::min(pixel, depthX * centerX + depthY * centerY + depthC);
+					}
+				}
+			#endif
+			}
+		}
+
+		myTileMaxDepth[aTile] = *std::max_element(tileDepth, tileDepth + TileWidth * TileHeight);
+	}
+
+	bool OcclusionCuller::IsVisible(const AxisAlignedBox& aWorldBox) const
+	{
+		Debug::Assert(myIsRasterized, "Occluders are rasterized before testing occludees.");
+
+		const float width = static_cast<float>(GetWidth());
+		const float height = static_cast<float>(GetHeight());
+
+		float minX = width, maxX = 0.f, minY = height, maxY = 0.f, minZ = FarDepth;
+		for (unsigned int corner = 0; corner < 8; ++corner)
+		{
+			const Vector3<float> point(
+				(corner & 1) ? aWorldBox.Max.X : aWorldBox.Min.X,
+				(corner & 2) ? aWorldBox.Max.Y : aWorldBox.Min.Y,
+				(corner & 4) ? aWorldBox.Max.Z : aWorldBox.Min.Z);
+
+			const std::array<float, 4> clip = Transform(point, myViewProjection);
+
+			// Boxes crossing the near plane can't be projected, and are too close to be hidden reliably.
+			if (clip[3] < MinClipW)
+				return true;
+
+			const float inverseW = 1.f / clip[3];
+			const float x = (clip[0] * inverseW * 0.5f + 0.5f) * width;
+			const float y = (0.5f - clip[1] * inverseW * 0.5f) * height;
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+			minY = std::min(minY, y);
+			maxY = std::max(maxY, y);
+			minZ = std::min(minZ, clip[2] * inverseW);
+		}
+
+		if (maxX < 0.f || maxY < 0.f || minX >= width || minY >= height)
+			return false;
+
+		const int firstX = std::max(0, static_cast<int>(std::floor(minX)));
+		const int lastX = std::min(static_cast<int>(width) - 1, static_cast<int>(std::ceil(maxX)));
+		const int firstY = std::max(0, static_cast<int>(std::floor(minY)));
+		const int lastY = std::min(static_cast<int>(height) - 1, static_cast<int>(std::ceil(maxY)));
+
+		for (int tileY = firstY / static_cast<int>(TileHeight); tileY <= lastY / static_cast<int>(TileHeight); ++tileY)
+		{
+			for (int tileX = firstX / static_cast<int>(TileWidth); tileX <= lastX / static_cast<int>(TileWidth); ++tileX)
+			{
+				const std::size_t tile = static_cast<std::size_t>(tileY) * myTileCountX + tileX;
+
+				// Everything in the tile is in front of the box's nearest point.
+				if (minZ > myTileMaxDepth[tile])
+					continue;
+
+				const int tileLeft = tileX * static_cast<int>(TileWidth);
+				const int tileTop = tileY * static_cast<int>(TileHeight);
+				const float* const tileDepth = myDepth.data() + tile * TileWidth * TileHeight;
+
+				for (int y = std::max(firstY, tileTop); y <= std::min(lastY, tileTop + static_cast<int>(TileHeight) - 1); ++y)
+				{
+					const float* const row = tileDepth + (y - tileTop) * TileWidth;
+					for (int x = std::max(firstX, tileLeft); x <= std::min(lastX, tileLeft + static_cast<int>(TileWidth) - 1); ++x)
+					{
+						if (row[x - tileLeft] >= minZ)
+							return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void OcclusionCuller::Cull(std::span<const AxisAlignedBox> someBoxes, std::span<const std::uint32_t> someCandidateIndices, std::vector<std::uint32_t>& someVisibleIndicesOut)
+	{
+		PROFILE_SCOPE();
+
+		// Each candidate's result is written to its own slot, then compacted, so threads never share output.
+		std::vector<std::uint8_t> isVisible(someCandidateIndices.size());
+
+		constexpr std::uint32_t BatchSize = 1024;
+		const std::uint32_t batchCount = static_cast<std::uint32_t>((someCandidateIndices.size() + BatchSize - 1) / BatchSize);
+		WorkerPool::Get().ParallelFor(batchCount, [&](std::size_t aBatch) {
+			const std::size_t batchEnd = std::min(someCandidateIndices.size(), (aBatch + 1) * BatchSize);
+			for (std::size_t i = aBatch * BatchSize; i < batchEnd; ++i)
+				isVisible[i] = IsVisible(someBoxes[someCandidateIndices[i]]) ? 1 : 0;
+			}, GetThreadCount(someCandidateIndices.size(), ParallelCullThreshold));
+
+		someVisibleIndicesOut.clear();
+		for (std::size_t i = 0; i < someCandidateIndices.size(); ++i)
+		{
+			if (isVisible[i])
+				someVisibleIndicesOut.push_back(someCandidateIndices[i]);
+		}
+	}
+
+	float OcclusionCuller::GetDepth(unsigned int aX, unsigned int aY) const
+	{
+		const unsigned int tile = (aY / TileHeight) * myTileCountX + (aX / TileWidth);
+		return myDepth[static_cast<std::size_t>(tile) * TileWidth * TileHeight + (aY % TileHeight) * TileWidth + (aX % TileWidth)];
+	}
+}
@@ -0,0 +1,128 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_BoundingVolumes.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Rejects objects hidden behind large occluders, with a low-resolution depth buffer rasterized on the CPU.
+	 *        Occluder triangles are binned into screen tiles, and the tiles are rasterized in parallel with SIMD,
+	 *        each keeping the farthest depth it contains for hierarchical tests.
+	 *        Occludee boxes are first tested against those tile depths, and only against pixels when a tile can't reject them.
+	 *
+	 *        Each frame, call Begin(), add the occluders, Rasterize(), then test the objects that passed frustum culling.
+	 *        Depth ranges from 0 at the near plane to 1 at the far plane.
+	 */
+	class OcclusionCuller
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		static constexpr unsigned int TileWidth = 32;
+		static constexpr unsigned int TileHeight = 8;
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Construction
+		//--------------------------------------------------
+	#pragma region Construction
+
+		/**
+		 * @param aWidth Width of the depth buffer in pixels, rounded up to whole tiles.
+		 * @param aHeight Height of the depth buffer in pixels, rounded up to whole tiles.
+		 */
+		OcclusionCuller(unsigned int aWidth = 256, unsigned int aHeight = 128);
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Remove the occluders of the previous frame, and set the view to rasterize the next ones from.
+		 *
+		 * @param aViewProjection Row-major matrix transforming row vectors to clip space, as with Frustum::FromViewProjection().
+		 */
+		void Begin(const std::array<float, 16>& aViewProjection);
+
+		/**
+		 * @brief Add the triangles of a mesh as an occluder. Not thread-safe.
+		 *        Triangles crossing the near plane are left out, which only makes the culling more conservative.
+		 *
+		 * @param aMesh Mesh to add. Occluders should be simple meshes, not larger than the objects they stand in for.
+		 * @param aWorld Row-major matrix transforming the mesh to world space.
+		 */
+		void AddOccluder(const MeshPrimitive& aMesh, const std::array<float, 16>& aWorld);
+
+		/**
+		 * @brief Rasterize the added occluders into the depth buffer. Has to be called before testing occludees.
+		 */
+		void Rasterize();
+
+		/**
+		 * @brief Check if any part of a box may be in front of the occluders.
+		 *
+		 * @param aWorldBox Box to test, in world space.
+		 * @return False if the box is entirely hidden or outside of the view.
+		 */
+		bool IsVisible(const AxisAlignedBox& aWorldBox) const;
+
+		/**
+		 * @brief Filter a list of objects down to the ones that aren't hidden, such as the visible indices from a FrustumCuller.
+		 *
+		 * @param someBoxes World-space box of each object.
+		 * @param someCandidateIndices Indices into someBoxes of the objects to test.
+		 * @param someVisibleIndicesOut Replaced with the candidates that may be visible, in their original order.
+		 */
+		void Cull(std::span<const AxisAlignedBox> someBoxes, std::span<const std::uint32_t> someCandidateIndices, std::vector<std::uint32_t>& someVisibleIndicesOut);
+
+		unsigned int GetWidth() const { return myTileCountX * TileWidth; }
+		unsigned int GetHeight() const { return myTileCountY * TileHeight; }
+
+		/**
+		 * @brief Get the rasterized depth of a pixel, such as to visualize the buffer.
+		 */
+		float GetDepth(unsigned int aX, unsigned int aY) const;
+
+	#pragma endregion
+
+	private:
+		struct ScreenTriangle
+		{
+			std::array<float, 3> X;
+			std::array<float, 3> Y;
+			std::array<float, 3> Z;
+		};
+
+		void RasterizeTile(std::uint32_t aTile);
+
+		std::array<float, 16> myViewProjection;
+
+		unsigned int myTileCountX;
+		unsigned int myTileCountY;
+
+		std::vector<ScreenTriangle> myTriangles;
+		std::vector<std::vector<std::uint32_t>> myTileBins;
+
+		// Pixels are stored tile by tile, so each tile is contiguous for the thread rasterizing it.
+		std::vector<float> myDepth;
+		std::vector<float> myTileMaxDepth;
+
+		bool myIsRasterized;
+	};
+}
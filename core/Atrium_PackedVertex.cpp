@@ -0,0 +1,591 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_PackedVertex.hpp"
+#include "Atrium_SIMD.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Atrium
+{
+	namespace
+	{
+		constexpr float UNorm16Max = 65535.f;
+		constexpr float SNorm16Max = 32767.f;
+
+		// The quaternion's W stays at least one step from zero, so its sign survives packing and can carry the binormal's side.
+		constexpr float MinQuaternionW = 1.f / SNorm16Max;
+
+		constexpr float MinLengthSquared = 1e-20f;
+
+		// Packed positions are (position - Offset) * Multiplier, which maps the quantization range to 0 to 65535.
+		struct PositionPacking
+		{
+			Vector3<float> Offset;
+			Vector3<float> Multiplier;
+		};
+
+		PositionPacking GetPositionPacking(const VertexQuantization& aQuantization)
+		{
+			const auto getMultiplier = [](float aScale) { return aScale > 0.f ? UNorm16Max / aScale : 0.f; };
+			return PositionPacking { aQuantization.Offset, Vector3<float>(getMultiplier(aQuantization.Scale.X), getMultiplier(aQuantization.Scale.Y), getMultiplier(aQuantization.Scale.Z)) };
+		}
+
+		std::uint16_t PackUNorm16(float aValue)
+		{
+			return static_cast<std::uint16_t>(std::clamp(aValue, 0.f, 1.f) * UNorm16Max + 0.5f);
+		}
+
+		std::int16_t PackSNorm16(float aValue)
+		{
+			return static_cast<std::int16_t>(std::lround(std::clamp(aValue, -1.f, 1.f) * SNorm16Max));
+		}
+
+		float UnpackSNorm16(std::int16_t aValue)
+		{
+			return std::max(static_cast<float>(aValue) / SNorm16Max, -1.f);
+		}
+
+		std::uint16_t PackUV(float aValue, PackedUVFormat aFormat)
+		{
+			return aFormat == PackedUVFormat::Half ? FloatToHalf(aValue) : PackUNorm16(aValue);
+		}
+
+		float UnpackUV(std::uint16_t aValue, PackedUVFormat aFormat)
+		{
+			return aFormat == PackedUVFormat::Half ? HalfToFloat(aValue) : static_cast<float>(aValue) / UNorm16Max;
+		}
+
+		template <typename Packed>
+		void PackPositionAndUV(const MeshPrimitive::Vertex& aVertex, const PositionPacking& aPositionPacking, PackedUVFormat aUVFormat, Packed& aPackedOut)
+		{
+			const Vector3<float> offset = aVertex.Position - aPositionPacking.Offset;
+			aPackedOut.Position = {
+				static_cast<std::uint16_t>(std::clamp(offset.X * aPositionPacking.Multiplier.X + 0.5f, 0.f, UNorm16Max)),
+				static_cast<std::uint16_t>(std::clamp(offset.Y * aPositionPacking.Multiplier.Y + 0.5f, 0.f, UNorm16Max)),
+				static_cast<std::uint16_t>(std::clamp(offset.Z * aPositionPacking.Multiplier.Z + 0.5f, 0.f, UNorm16Max)),
+				static_cast<std::uint16_t>(UNorm16Max)
+			};
+
+			aPackedOut.UV = { PackUV(aVertex.UV.X, aUVFormat), PackUV(aVertex.UV.Y, aUVFormat) };
+		}
+
+		template <typename Packed>
+		void UnpackPositionAndUV(const Packed& aPacked, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat, MeshPrimitive::Vertex& aVertexOut)
+		{
+			aVertexOut.Position = Vector3<float>(
+				aQuantization.Offset.X + static_cast<float>(aPacked.Position[0]) / UNorm16Max * aQuantization.Scale.X,
+				aQuantization.Offset.Y + static_cast<float>(aPacked.Position[1]) / UNorm16Max * aQuantization.Scale.Y,
+				aQuantization.Offset.Z + static_cast<float>(aPacked.Position[2]) / UNorm16Max * aQuantization.Scale.Z);
+
+			aVertexOut.UV = Vector2<float>(UnpackUV(aPacked.UV[0], aUVFormat), UnpackUV(aPacked.UV[1], aUVFormat));
+		}
+
+		Vector3<float> GetPerpendicular(const Vector3<float>& aNormal)
+		{
+			// Crossing with the axis least aligned with the normal gives the most stable result.
+			const float x = std::abs(aNormal.X);
+			const float y = std::abs(aNormal.Y);
+			const float z = std::abs(aNormal.Z);
+			const Vector3<float> axis = (x <= y && x <= z) ? Vector3<float>(1, 0, 0) : (y <= z ? Vector3<float>(0, 1, 0) : Vector3<float>(0, 0, 1));
+			return Vector3<float>::Cross(aNormal, axis).Normalized();
+		}
+
+		/**
+		 * @brief Get the quaternion rotating the axes onto a vertex's tangent frame, with the binormal's side in the sign of W.
+		 *        Follows Shepperd's method, which divides by the largest of the four components so none lose precision.
+		 */
+		std::array<float, 4> GetTangentFrame(const MeshPrimitive::Vertex& aVertex)
+		{
+			Vector3<float> normal = aVertex.Normal;
+			if (Vector3<float>::Dot(normal, normal) <= MinLengthSquared)
+				normal = Vector3<float>(0, 0, 1);
+			normal.Normalize();
+
+			Vector3<float> tangent = aVertex.Tangent - normal * Vector3<float>::Dot(normal, aVertex.Tangent);
+			tangent = Vector3<float>::Dot(tangent, tangent) <= MinLengthSquared ? GetPerpendicular(normal) : tangent.Normalized();
+
+			const Vector3<float> binormal = Vector3<float>::Cross(normal, tangent);
+			const bool isMirrored = Vector3<float>::Dot(binormal, aVertex.Binormal) < 0.f;
+
+			// The rotation's columns are the tangent, binormal and normal.
+			const float m00 = tangent.X, m10 = tangent.Y, m20 = tangent.Z;
+			const float m01 = binormal.X, m11 = binormal.Y, m21 = binormal.Z;
+			const float m02 = normal.X, m12 = normal.Y, m22 = normal.Z;
+
+			const float wTerm = 1.f + m00 + m11 + m22;
+			const float xTerm = 1.f + m00 - m11 - m22;
+			const float yTerm = 1.f - m00 + m11 - m22;
+			const float zTerm = 1.f - m00 - m11 + m22;
+
+			std::array<float, 4> quaternion;
+			if (wTerm >= xTerm && wTerm >= yTerm && wTerm >= zTerm)
+			{
+				const float s = 0.5f / std::sqrt(wTerm);
+				quaternion = { (m21 - m12) * s, (m02 - m20) * s, (m10 - m01) * s, 0.25f / s };
+			}
+			else if (xTerm >= yTerm && xTerm >= zTerm)
+			{
+				const float s = 0.5f / std::sqrt(xTerm);
+				quaternion = { 0.25f / s, (m01 + m10) * s, (m02 + m20) * s, (m21 - m12) * s };
+			}
+			else if (yTerm >= zTerm)
+			{
+				const float s = 0.5f / std::sqrt(yTerm);
+				quaternion = { (m01 + m10) * s, 0.25f / s, (m12 + m21) * s, (m02 - m20) * s };
+			}
+			else
+			{
+				const float s = 0.5f / std::sqrt(zTerm);
+				quaternion = { (m02 + m20) * s, (m12 + m21) * s, 0.25f / s, (m10 - m01) * s };
+			}
+
+			const float length = std::sqrt(quaternion[0] * quaternion[0] + quaternion[1] * quaternion[1] + quaternion[2] * quaternion[2] + quaternion[3] * quaternion[3]);
+			const float sign = quaternion[3] < 0.f ? -1.f : 1.f;
+			for (float& component : quaternion)
+				component *= sign / length;
+
+			if (quaternion[3] < MinQuaternionW)
+			{
+				const float xyzScale = std::sqrt((1.f - MinQuaternionW * MinQuaternionW) / std::max(1.f - quaternion[3] * quaternion[3], MinLengthSquared));
+				for (std::size_t i = 0; i < 3; ++i)
+					quaternion[i] *= xyzScale;
+				quaternion[3] = MinQuaternionW;
+			}
+
+			if (isMirrored)
+			{
+				for (float& component : quaternion)
+					component = -component;
+			}
+
+			return quaternion;
+		}
+
+		std::array<float, 2> GetOctahedral(const Vector3<float>& aNormal)
+		{
+			const float sum = std::abs(aNormal.X) + std::abs(aNormal.Y) + std::abs(aNormal.Z);
+			if (sum <= 0.f)
+				return { 0.f, 0.f };
+
+			const float x = aNormal.X / sum;
+			const float y = aNormal.Y / sum;
+			if (aNormal.Z >= 0.f)
+				return { x, y };
+
+			// The lower half folds over the diagonals onto the corners of the square.
+			return { (1.f - std::abs(y)) * (x >= 0.f ? 1.f : -1.f), (1.f - std::abs(x)) * (y >= 0.f ? 1.f : -1.f) };
+		}
+
+	#if ATRIUM_SIMD_SSE
+		using namespace SIMD;
+
+		Lanes3 LoadLanes(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aFirst, Vector3<float> MeshPrimitive::Vertex::* aMember)
+		{
+			const Vector3<float>& a = someVertices[aFirst + 0].*aMember;
+			const Vector3<float>& b = someVertices[aFirst + 1].*aMember;
+			const Vector3<float>& c = someVertices[aFirst + 2].*aMember;
+			const Vector3<float>& d = someVertices[aFirst + 3].*aMember;
+			return { _mm_setr_ps(a.X, b.X, c.X, d.X), _mm_setr_ps(a.Y, b.Y, c.Y, d.Y), _mm_setr_ps(a.Z, b.Z, c.Z, d.Z) };
+		}
+
+		// Four lanes of floats between -1 and 1 as 16-bit signed fractions.
+		std::array<std::int32_t, 4> ToSNorm16(__m128 aValue)
+		{
+			std::array<std::int32_t, 4> result;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(result.data()), _mm_cvtps_epi32(_mm_mul_ps(aValue, _mm_set1_ps(SNorm16Max))));
+			return result;
+		}
+
+		std::array<std::int32_t, 4> ToUNorm16(__m128 aValue)
+		{
+			const __m128 clamped = _mm_min_ps(_mm_max_ps(aValue, _mm_setzero_ps()), _mm_set1_ps(UNorm16Max));
+			std::array<std::int32_t, 4> result;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(result.data()), _mm_cvttps_epi32(clamped));
+			return result;
+		}
+
+		template <typename Packed>
+		void PackPositionsAndUVs(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aFirst, const PositionPacking& aPositionPacking, PackedUVFormat aUVFormat, Packed* somePackedOut)
+		{
+			const Lanes3 positions = LoadLanes(someVertices, aFirst, &MeshPrimitive::Vertex::Position);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const std::array<std::int32_t, 4> x = ToUNorm16(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(positions[0], _mm_set1_ps(aPositionPacking.Offset.X)), _mm_set1_ps(aPositionPacking.Multiplier.X)), half));
+			const std::array<std::int32_t, 4> y = ToUNorm16(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(positions[1], _mm_set1_ps(aPositionPacking.Offset.Y)), _mm_set1_ps(aPositionPacking.Multiplier.Y)), half));
+			const std::array<std::int32_t, 4> z = ToUNorm16(_mm_add_ps(_mm_mul_ps(_mm_sub_ps(positions[2], _mm_set1_ps(aPositionPacking.Offset.Z)), _mm_set1_ps(aPositionPacking.Multiplier.Z)), half));
+
+			std::array<std::uint16_t, 8> uvs;
+			const __m128 firstUVs = _mm_setr_ps(someVertices[aFirst].UV.X, someVertices[aFirst].UV.Y, someVertices[aFirst + 1].UV.X, someVertices[aFirst + 1].UV.Y);
+			const __m128 secondUVs = _mm_setr_ps(someVertices[aFirst + 2].UV.X, someVertices[aFirst + 2].UV.Y, someVertices[aFirst + 3].UV.X, someVertices[aFirst + 3].UV.Y);
+			if (aUVFormat == PackedUVFormat::UNorm16)
+			{
+				const __m128 scale = _mm_set1_ps(UNorm16Max);
+				const std::array<std::int32_t, 4> first = ToUNorm16(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(firstUVs, _mm_setzero_ps()), _mm_set1_ps(1.f)), scale), half));
+				const std::array<std::int32_t, 4> second = ToUNorm16(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(secondUVs, _mm_setzero_ps()), _mm_set1_ps(1.f)), scale), half));
+				for (std::size_t i = 0; i < 4; ++i)
+				{
+					uvs[i] = static_cast<std::uint16_t>(first[i]);
+					uvs[i + 4] = static_cast<std::uint16_t>(second[i]);
+				}
+			}
+			else
+			{
+			#if ATRIUM_SIMD_F16C
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(uvs.data()), _mm_unpacklo_epi64(_mm_cvtps_ph(firstUVs, _MM_FROUND_TO_NEAREST_INT), _mm_cvtps_ph(secondUVs, _MM_FROUND_TO_NEAREST_INT)));
+			#else
+				for (std::size_t i = 0; i < 4; ++i)
+				{
+					uvs[i * 2 + 0] = FloatToHalf(someVertices[aFirst + i].UV.X);
+					uvs[i * 2 + 1] = FloatToHalf(someVertices[aFirst + i].UV.Y);
+				}
+			#endif
+			}
+
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				Packed& packed = somePackedOut[aFirst + i];
+				packed.Position = { static_cast<std::uint16_t>(x[i]), static_cast<std::uint16_t>(y[i]), static_cast<std::uint16_t>(z[i]), static_cast<std::uint16_t>(UNorm16Max) };
+				packed.UV = { uvs[i * 2 + 0], uvs[i * 2 + 1] };
+			}
+		}
+
+		void PackTangentFrames(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aFirst, PackedVertex* somePackedOut)
+		{
+			const __m128 minLengthSquared = _mm_set1_ps(MinLengthSquared);
+			const __m128 one = _mm_set1_ps(1.f);
+
+			Lanes3 normal = LoadLanes(someVertices, aFirst, &MeshPrimitive::Vertex::Normal);
+			const Lanes3 sourceTangent = LoadLanes(someVertices, aFirst, &MeshPrimitive::Vertex::Tangent);
+			const Lanes3 sourceBinormal = LoadLanes(someVertices, aFirst, &MeshPrimitive::Vertex::Binormal);
+
+			const __m128 normalLengthSquared = Dot(normal, normal);
+			normal = Scale(normal, _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(normalLengthSquared, minLengthSquared))));
+
+			const __m128 normalTangent = Dot(normal, sourceTangent);
+			Lanes3 tangent = Subtract(sourceTangent, Scale(normal, normalTangent));
+			const __m128 tangentLengthSquared = Dot(tangent, tangent);
+			tangent = Scale(tangent, _mm_div_ps(one, _mm_sqrt_ps(_mm_max_ps(tangentLengthSquared, minLengthSquared))));
+
+			// Lanes without a normal or tangent to work from are packed one at a time, picking a tangent for them.
+			const int degenerateMask = _mm_movemask_ps(_mm_or_ps(_mm_cmple_ps(normalLengthSquared, minLengthSquared), _mm_cmple_ps(tangentLengthSquared, minLengthSquared)));
+
+			const Lanes3 binormal = Cross(normal, tangent);
+			const __m128 isMirrored = _mm_cmplt_ps(Dot(binormal, sourceBinormal), _mm_setzero_ps());
+
+			const __m128 m00 = tangent[0], m10 = tangent[1], m20 = tangent[2];
+			const __m128 m01 = binormal[0], m11 = binormal[1], m21 = binormal[2];
+			const __m128 m02 = normal[0], m12 = normal[1], m22 = normal[2];
+
+			const __m128 wTerm = _mm_add_ps(_mm_add_ps(one, m00), _mm_add_ps(m11, m22));
+			const __m128 xTerm = _mm_sub_ps(_mm_add_ps(one, m00), _mm_add_ps(m11, m22));
+			const __m128 yTerm = _mm_sub_ps(_mm_add_ps(one, m11), _mm_add_ps(m00, m22));
+			const __m128 zTerm = _mm_sub_ps(_mm_add_ps(one, m22), _mm_add_ps(m00, m11));
+
+			// The same choice of largest component as the scalar version, made per lane.
+			const __m128 isW = _mm_and_ps(_mm_cmpge_ps(wTerm, xTerm), _mm_and_ps(_mm_cmpge_ps(wTerm, yTerm), _mm_cmpge_ps(wTerm, zTerm)));
+			const __m128 isX = _mm_andnot_ps(isW, _mm_and_ps(_mm_cmpge_ps(xTerm, yTerm), _mm_cmpge_ps(xTerm, zTerm)));
+			const __m128 isY = _mm_andnot_ps(_mm_or_ps(isW, isX), _mm_cmpge_ps(yTerm, zTerm));
+			const __m128 isZ = _mm_andnot_ps(_mm_or_ps(isW, _mm_or_ps(isX, isY)), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+			const __m128 largestTerm = Select(isW, wTerm, Select(isX, xTerm, Select(isY, yTerm, zTerm)));
+			const __m128 s = _mm_div_ps(_mm_set1_ps(0.5f), _mm_sqrt_ps(_mm_max_ps(largestTerm, minLengthSquared)));
+			const __m128 largest = _mm_div_ps(_mm_set1_ps(0.25f), s);
+
+			const __m128 differenceX = _mm_mul_ps(_mm_sub_ps(m21, m12), s);
+			const __m128 differenceY = _mm_mul_ps(_mm_sub_ps(m02, m20), s);
+			const __m128 differenceZ = _mm_mul_ps(_mm_sub_ps(m10, m01), s);
+			const __m128 sumXY = _mm_mul_ps(_mm_add_ps(m01, m10), s);
+			const __m128 sumXZ = _mm_mul_ps(_mm_add_ps(m02, m20), s);
+			const __m128 sumYZ = _mm_mul_ps(_mm_add_ps(m12, m21), s);
+
+			__m128 x = Select(isW, differenceX, Select(isX, largest, Select(isY, sumXY, sumXZ)));
+			__m128 y = Select(isW, differenceY, Select(isX, sumXY, Select(isY, largest, sumYZ)));
+			__m128 z = Select(isW, differenceZ, Select(isX, sumXZ, Select(isY, sumYZ, largest)));
+			__m128 w = Select(isW, largest, Select(isX, differenceX, Select(isY, differenceY, differenceZ)));
+			(void)isZ;
+
+			// Normalize with W positive, then keep W off zero.
+			const __m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+			const __m128 wSign = _mm_and_ps(w, _mm_set1_ps(-0.f));
+			const __m128 normalization = _mm_xor_ps(_mm_div_ps(one, _mm_sqrt_ps(lengthSquared)), wSign);
+			x = _mm_mul_ps(x, normalization);
+			y = _mm_mul_ps(y, normalization);
+			z = _mm_mul_ps(z, normalization);
+			w = _mm_mul_ps(w, normalization);
+
+			const __m128 minW = _mm_set1_ps(MinQuaternionW);
+			const __m128 isWSmall = _mm_cmplt_ps(w, minW);
+			const __m128 xyzScale = _mm_sqrt_ps(_mm_div_ps(_mm_set1_ps(1.f - MinQuaternionW * MinQuaternionW), _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(w, w)), minLengthSquared)));
+			const __m128 xyzFactor = Select(isWSmall, xyzScale, one);
+			x = _mm_mul_ps(x, xyzFactor);
+			y = _mm_mul_ps(y, xyzFactor);
+			z = _mm_mul_ps(z, xyzFactor);
+			w = _mm_max_ps(w, minW);
+
+			const __m128 mirror = _mm_and_ps(isMirrored, _mm_set1_ps(-0.f));
+			const std::array<std::int32_t, 4> packedX = ToSNorm16(_mm_xor_ps(x, mirror));
+			const std::array<std::int32_t, 4> packedY = ToSNorm16(_mm_xor_ps(y, mirror));
+			const std::array<std::int32_t, 4> packedZ = ToSNorm16(_mm_xor_ps(z, mirror));
+			const std::array<std::int32_t, 4> packedW = ToSNorm16(_mm_xor_ps(w, mirror));
+
+			for (std::size_t i = 0; i < 4; ++i)
+			{
+				if (degenerateMask & (1 << i))
+				{
+					const std::array<float, 4> quaternion = GetTangentFrame(someVertices[aFirst + i]);
+					somePackedOut[aFirst + i].TangentFrame = { PackSNorm16(quaternion[0]), PackSNorm16(quaternion[1]), PackSNorm16(quaternion[2]), PackSNorm16(quaternion[3]) };
+					continue;
+				}
+
+				somePackedOut[aFirst + i].TangentFrame = {
+					static_cast<std::int16_t>(packedX[i]),
+					static_cast<std::int16_t>(packedY[i]),
+					static_cast<std::int16_t>(packedZ[i]),
+					static_cast<std::int16_t>(packedW[i])
+				};
+			}
+		}
+
+		void PackNormals(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aFirst, PackedNormalVertex* somePackedOut)
+		{
+			const Lanes3 normal = LoadLanes(someVertices, aFirst, &MeshPrimitive::Vertex::Normal);
+
+			const __m128 sum = _mm_add_ps(_mm_add_ps(Abs(normal[0]), Abs(normal[1])), Abs(normal[2]));
+			const __m128 inverseSum = Select(_mm_cmpgt_ps(sum, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1.f), sum), _mm_setzero_ps());
+			const __m128 x = _mm_mul_ps(normal[0], inverseSum);
+			const __m128 y = _mm_mul_ps(normal[1], inverseSum);
+
+			// The lower half folds over the diagonals, keeping the sign of each coordinate and counting zero as positive.
+			const __m128 signMask = _mm_set1_ps(-0.f);
+			const __m128 xSign = _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), signMask);
+			const __m128 ySign = _mm_and_ps(_mm_cmplt_ps(y, _mm_setzero_ps()), signMask);
+			const __m128 foldedX = _mm_or_ps(_mm_sub_ps(_mm_set1_ps(1.f), Abs(y)), xSign);
+			const __m128 foldedY = _mm_or_ps(_mm_sub_ps(_mm_set1_ps(1.f), Abs(x)), ySign);
+
+			const __m128 isLower = _mm_cmplt_ps(normal[2], _mm_setzero_ps());
+			const std::array<std::int32_t, 4> packedX = ToSNorm16(Select(isLower, foldedX, x));
+			const std::array<std::int32_t, 4> packedY = ToSNorm16(Select(isLower, foldedY, y));
+
+			for (std::size_t i = 0; i < 4; ++i)
+				somePackedOut[aFirst + i].Normal = { static_cast<std::int16_t>(packedX[i]), static_cast<std::int16_t>(packedY[i]) };
+		}
+	#endif
+
+		GraphicsFormat GetUVFormat(PackedUVFormat aUVFormat)
+		{
+			return aUVFormat == PackedUVFormat::Half ? GraphicsFormat::R16G16_SFloat : GraphicsFormat::R16G16_UNorm;
+		}
+	}
+
+	VertexQuantization VertexQuantization::FromBounds(const AxisAlignedBox& aBox)
+	{
+		if (aBox.IsEmpty())
+			return VertexQuantization();
+
+		return VertexQuantization { aBox.Min, aBox.Max - aBox.Min };
+	}
+
+	VertexQuantization VertexQuantization::FromVertices(std::span<const MeshPrimitive::Vertex> someVertices)
+	{
+		AxisAlignedBox bounds;
+		for (const MeshPrimitive::Vertex& vertex : someVertices)
+			bounds.Add(vertex.Position);
+
+		return FromBounds(bounds);
+	}
+
+	std::uint16_t FloatToHalf(float aValue)
+	{
+		const std::uint32_t bits = std::bit_cast<std::uint32_t>(aValue);
+		const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+		const std::uint32_t magnitude = bits & 0x7FFFFFFF;
+
+		// Infinity and NaN, then values that round past the largest half.
+		if (magnitude >= 0x7F800000)
+			return sign | (magnitude > 0x7F800000 ? 0x7E00 : 0x7C00);
+		if (magnitude >= 0x477FF000)
+			return sign | 0x7C00;
+
+		// Below the smallest normal half, the value is a multiple of 2^-24.
+		if (magnitude < 0x38800000)
+			return sign | static_cast<std::uint16_t>(std::nearbyint(std::bit_cast<float>(magnitude) * 16777216.f));
+
+		// Rebias the exponent from 127 to 15, and round away the lowest 13 bits of the mantissa.
+		std::uint32_t half = (magnitude - 0x38000000) >> 13;
+		const std::uint32_t remainder = magnitude & 0x1FFF;
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+			++half;
+
+		return sign | static_cast<std::uint16_t>(half);
+	}
+
+	float HalfToFloat(std::uint16_t aHalf)
+	{
+		const float sign = (aHalf & 0x8000) ? -1.f : 1.f;
+		const std::uint32_t exponent = (aHalf >> 10) & 0x1F;
+		const std::uint32_t mantissa = aHalf & 0x3FF;
+
+		if (exponent == 0)
+			return sign * static_cast<float>(mantissa) * (1.f / 16777216.f);
+		if (exponent == 0x1F)
+			return mantissa ? std::numeric_limits<float>::quiet_NaN() : sign * std::numeric_limits<float>::infinity();
+
+		return std::bit_cast<float>((static_cast<std::uint32_t>(aHalf & 0x8000) << 16) | ((exponent + 112) << 23) | (mantissa << 13));
+	}
+
+	void PackedVertex::Pack(std::span<const MeshPrimitive::Vertex> someVertices, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat, std::span<PackedVertex> someVerticesOut)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someVerticesOut.size() >= someVertices.size(), "There is a packed vertex for every vertex."))
+			return;
+
+		const PositionPacking positionPacking = GetPositionPacking(aQuantization);
+
+		std::size_t i = 0;
+	#if ATRIUM_SIMD_SSE
+		for (; i + 4 <= someVertices.size(); i += 4)
+		{
+			PackPositionsAndUVs(someVertices, i, positionPacking, aUVFormat, someVerticesOut.data());
+			PackTangentFrames(someVertices, i, someVerticesOut.data());
+		}
+	#endif
+
+		for (; i < someVertices.size(); ++i)
+		{
+			PackPositionAndUV(someVertices[i], positionPacking, aUVFormat, someVerticesOut[i]);
+
+			const std::array<float, 4> quaternion = GetTangentFrame(someVertices[i]);
+			someVerticesOut[i].TangentFrame = { PackSNorm16(quaternion[0]), PackSNorm16(quaternion[1]), PackSNorm16(quaternion[2]), PackSNorm16(quaternion[3]) };
+		}
+	}
+
+	MeshPrimitive::Vertex PackedVertex::Unpack(const PackedVertex& aVertex, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat)
+	{
+		MeshPrimitive::Vertex vertex;
+		UnpackPositionAndUV(aVertex, aQuantization, aUVFormat, vertex);
+
+		const float x = UnpackSNorm16(aVertex.TangentFrame[0]);
+		const float y = UnpackSNorm16(aVertex.TangentFrame[1]);
+		const float z = UnpackSNorm16(aVertex.TangentFrame[2]);
+		const float w = UnpackSNorm16(aVertex.TangentFrame[3]);
+
+		vertex.Tangent = Vector3<float>(1.f - 2.f * (y * y + z * z), 2.f * (x * y + w * z), 2.f * (x * z - w * y));
+		vertex.Normal = Vector3<float>(2.f * (x * z + w * y), 2.f * (y * z - w * x), 1.f - 2.f * (x * x + y * y));
+		vertex.Binormal = Vector3<float>::Cross(vertex.Normal, vertex.Tangent) * (w < 0.f ? -1.f : 1.f);
+		return vertex;
+	}
+
+	std::vector<PipelineStateDescription::InputLayoutEntry> PackedVertex::GetInputLayout(PackedUVFormat aUVFormat, unsigned int anInputSlot)
+	{
+		using InputLayoutEntry = PipelineStateDescription::InputLayoutEntry;
+		return {
+			InputLayoutEntry("POSITION", GraphicsFormat::R16G16B16A16_UNorm, anInputSlot),
+			InputLayoutEntry("TANGENTFRAME", GraphicsFormat::R16G16B16A16_SNorm, anInputSlot),
+			InputLayoutEntry("TEXCOORD", GetUVFormat(aUVFormat), anInputSlot)
+		};
+	}
+
+	void PackedNormalVertex::Pack(std::span<const MeshPrimitive::Vertex> someVertices, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat, std::span<PackedNormalVertex> someVerticesOut)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someVerticesOut.size() >= someVertices.size(), "There is a packed vertex for every vertex."))
+			return;
+
+		const PositionPacking positionPacking = GetPositionPacking(aQuantization);
+
+		std::size_t i = 0;
+	#if ATRIUM_SIMD_SSE
+		for (; i + 4 <= someVertices.size(); i += 4)
+		{
+			PackPositionsAndUVs(someVertices, i, positionPacking, aUVFormat, someVerticesOut.data());
+			PackNormals(someVertices, i, someVerticesOut.data());
+		}
+	#endif
+
+		for (; i < someVertices.size(); ++i)
+		{
+			PackPositionAndUV(someVertices[i], positionPacking, aUVFormat, someVerticesOut[i]);
+
+			const std::array<float, 2> normal = GetOctahedral(someVertices[i].Normal);
+			someVerticesOut[i].Normal = { PackSNorm16(normal[0]), PackSNorm16(normal[1]) };
+		}
+	}
+
+	MeshPrimitive::Vertex PackedNormalVertex::Unpack(const PackedNormalVertex& aVertex, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat)
+	{
+		MeshPrimitive::Vertex vertex;
+		UnpackPositionAndUV(aVertex, aQuantization, aUVFormat, vertex);
+
+		Vector3<float> normal(UnpackSNorm16(aVertex.Normal[0]), UnpackSNorm16(aVertex.Normal[1]), 0.f);
+		normal.Z = 1.f - std::abs(normal.X) - std::abs(normal.Y);
+		const float fold = std::max(-normal.Z, 0.f);
+		normal.X += normal.X >= 0.f ? -fold : fold;
+		normal.Y += normal.Y >= 0.f ? -fold : fold;
+
+		vertex.Normal = normal.Normalized();
+		return vertex;
+	}
+
+	std::vector<PipelineStateDescription::InputLayoutEntry> PackedNormalVertex::GetInputLayout(PackedUVFormat aUVFormat, unsigned int anInputSlot)
+	{
+		using InputLayoutEntry = PipelineStateDescription::InputLayoutEntry;
+		return {
+			InputLayoutEntry("POSITION", GraphicsFormat::R16G16B16A16_UNorm, anInputSlot),
+			InputLayoutEntry("NORMAL", GraphicsFormat::R16G16_SNorm, anInputSlot),
+			InputLayoutEntry("TEXCOORD", GetUVFormat(aUVFormat), anInputSlot)
+		};
+	}
+
+	PackedIndices PackedIndices::Pack(std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aVertexCount)
+	{
+		PROFILE_SCOPE();
+
+		static_assert(sizeof(MeshPrimitive::Triangle) == sizeof(std::uint32_t) * 3, "Triangles are three tightly packed indices.");
+
+		PackedIndices packed;
+		if (someTriangles.empty())
+			return packed;
+
+		const std::uint32_t* indices = &someTriangles.data()->V1;
+		packed.Count = static_cast<std::uint32_t>(someTriangles.size() * 3);
+
+		if (aVertexCount > 65536)
+		{
+			packed.Stride = sizeof(std::uint32_t);
+			packed.Data.resize(packed.Count * sizeof(std::uint32_t));
+			std::memcpy(packed.Data.data(), indices, packed.Data.size());
+			return packed;
+		}
+
+		packed.Stride = sizeof(std::uint16_t);
+		packed.Data.resize(packed.Count * sizeof(std::uint16_t));
+		std::uint8_t* output = packed.Data.data();
+
+		std::size_t i = 0;
+	#if ATRIUM_SIMD_SSE
+		// SSE2 only packs to signed 16-bit, so indices are shifted into its range and back.
+		const __m128i bias = _mm_set1_epi32(32768);
+		const __m128i unbias = _mm_set1_epi16(-32768);
+		for (; i + 8 <= packed.Count; i += 8)
+		{
+			const __m128i low = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i)), bias);
+			const __m128i high = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(indices + i + 4)), bias);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i * sizeof(std::uint16_t)), _mm_xor_si128(_mm_packs_epi32(low, high), unbias));
+		}
+	#endif
+
+		for (; i < packed.Count; ++i)
+		{
+			const std::uint16_t index = static_cast<std::uint16_t>(indices[i]);
+			std::memcpy(output + i * sizeof(std::uint16_t), &index, sizeof(index));
+		}
+
+		return packed;
+	}
+}
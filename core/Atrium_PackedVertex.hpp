@@ -0,0 +1,144 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_BoundingVolumes.hpp"
+#include "Atrium_GraphicsPipeline.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <rose-common/math/Vector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief How texture coordinates are stored in packed vertices.
+	 */
+	enum class PackedUVFormat
+	{
+		// Half floats, for coordinates of any range, such as tiling textures.
+		Half,
+
+		// 16-bit fractions, with finer steps than half floats for coordinates between 0 and 1. Others are clamped.
+		UNorm16
+	};
+
+	/**
+	 * @brief Convert a float to a half float, rounding to the nearest and to even on ties, as graphics hardware does.
+	 */
+	std::uint16_t FloatToHalf(float aValue);
+
+	/**
+	 * @brief Convert a half float to a float, which holds every half float exactly.
+	 */
+	float HalfToFloat(std::uint16_t aHalf);
+
+	/**
+	 * @brief The range packed vertex positions are stored relative to, usually the bounds of the mesh.
+	 *        Shaders restore a position with Offset + packedPosition.xyz * Scale.
+	 */
+	struct VertexQuantization
+	{
+		Vector3<float> Offset;
+		Vector3<float> Scale;
+
+		static VertexQuantization FromBounds(const AxisAlignedBox& aBox);
+		static VertexQuantization FromVertices(std::span<const MeshPrimitive::Vertex> someVertices);
+	};
+
+	/**
+	 * @brief A vertex with a full tangent frame, in 20 bytes instead of the 56 of a MeshPrimitive::Vertex.
+	 *
+	 *        The frame is a unit quaternion rotating the X, Y and Z axes onto the tangent, binormal and normal.
+	 *        Its W is never zero, and is negative when the binormal is mirrored, so shaders restore the frame with
+	 *        T = (1 - 2(y² + z²), 2(xy + wz), 2(xz - wy)), N = (2(xz + wy), 2(yz - wx), 1 - 2(x² + y²)) and B = sign(w) * cross(N, T).
+	 */
+	struct PackedVertex
+	{
+		// R16G16B16A16_UNorm, relative to a VertexQuantization. W is always 1.
+		std::array<std::uint16_t, 4> Position;
+
+		// R16G16B16A16_SNorm.
+		std::array<std::int16_t, 4> TangentFrame;
+
+		// R16G16_SFloat or R16G16_UNorm, depending on the PackedUVFormat.
+		std::array<std::uint16_t, 2> UV;
+
+		/**
+		 * @brief Pack vertices, several at a time with SIMD where available.
+		 *        The tangent and binormal are made perpendicular to the normal first, and only the binormal's side is kept.
+		 *
+		 * @param someVerticesOut Packed vertices, as many as there are vertices.
+		 */
+		static void Pack(std::span<const MeshPrimitive::Vertex> someVertices, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat, std::span<PackedVertex> someVerticesOut);
+
+		/**
+		 * @brief Restore a vertex the way a shader would, to check the precision of a packed mesh or read it back.
+		 */
+		static MeshPrimitive::Vertex Unpack(const PackedVertex& aVertex, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat);
+
+		/**
+		 * @brief Get the input layout for the packed vertices, as POSITION, TANGENTFRAME and TEXCOORD.
+		 */
+		static std::vector<PipelineStateDescription::InputLayoutEntry> GetInputLayout(PackedUVFormat aUVFormat, unsigned int anInputSlot = 0);
+	};
+	static_assert(sizeof(PackedVertex) == 20);
+
+	/**
+	 * @brief A vertex with only a normal, for meshes without normal maps, in 16 bytes.
+	 *
+	 *        The normal is octahedron encoded: shaders restore it with n = (x, y, 1 - |x| - |y|),
+	 *        then, where n.z is negative, n.xy = (1 - |n.yx|) * sign(n.xy), then normalizing it.
+	 */
+	struct PackedNormalVertex
+	{
+		// R16G16B16A16_UNorm, relative to a VertexQuantization. W is always 1.
+		std::array<std::uint16_t, 4> Position;
+
+		// R16G16_SNorm.
+		std::array<std::int16_t, 2> Normal;
+
+		// R16G16_SFloat or R16G16_UNorm, depending on the PackedUVFormat.
+		std::array<std::uint16_t, 2> UV;
+
+		/**
+		 * @brief Pack vertices, several at a time with SIMD where available.
+		 *
+		 * @param someVerticesOut Packed vertices, as many as there are vertices.
+		 */
+		static void Pack(std::span<const MeshPrimitive::Vertex> someVertices, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat, std::span<PackedNormalVertex> someVerticesOut);
+
+		/**
+		 * @brief Restore a vertex the way a shader would. It has no tangent or binormal.
+		 */
+		static MeshPrimitive::Vertex Unpack(const PackedNormalVertex& aVertex, const VertexQuantization& aQuantization, PackedUVFormat aUVFormat);
+
+		/**
+		 * @brief Get the input layout for the packed vertices, as POSITION, NORMAL and TEXCOORD.
+		 */
+		static std::vector<PipelineStateDescription::InputLayoutEntry> GetInputLayout(PackedUVFormat aUVFormat, unsigned int anInputSlot = 0);
+	};
+	static_assert(sizeof(PackedNormalVertex) == 16);
+
+	/**
+	 * @brief Triangle indices in the smallest size that fits the mesh: 16 bits for meshes of up to 65536 vertices, otherwise 32.
+	 *        Create the index buffer with Count elements of Stride bytes, and fill it with Data.
+	 */
+	struct PackedIndices
+	{
+		std::vector<std::uint8_t> Data;
+		std::uint32_t Count = 0;
+		std::uint32_t Stride = sizeof(std::uint32_t);
+
+		/**
+		 * @brief Pack the indices of some triangles.
+		 *
+		 * @param aVertexCount Number of vertices the triangles index.
+		 */
+		static PackedIndices Pack(std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aVertexCount);
+	};
+}
@@ -0,0 +1,441 @@
+// Filter "Graphics"
+
+#include "Atrium_RenderGraph.hpp"
+
+#include <algorithm>
+#include <map>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Physical textures can still be in use by frames in flight for a while after the graph stops using them.
+		constexpr std::uint_least64_t PhysicalTextureLifetime = 4;
+
+		bool IsDepthState(ResourceState aState)
+		{
+			return aState == ResourceState::DepthWrite || aState == ResourceState::DepthRead;
+		}
+	}
+
+	RenderGraph::RenderGraph(GraphicsAPI& aGraphicsAPI)
+		: myGraphicsAPI(aGraphicsAPI)
+		, myFrame(0)
+		, myCulledPassCount(0)
+		, myTransitionCount(0)
+		, myIsCompiled(false)
+	{
+	}
+
+	void RenderGraph::AddPass(const char* aName, const SetupCallback& aSetup, ExecuteCallback anExecute)
+	{
+		Debug::Assert(!myIsCompiled, "Passes are added before the graph is compiled.");
+
+		Pass& pass = myPasses.emplace_back();
+		pass.Name = aName;
+		pass.Execute = std::move(anExecute);
+
+		PassBuilder builder(*this, myPasses.size() - 1);
+		aSetup(builder);
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::ImportBuffer(const char* aName, const std::shared_ptr<GraphicsBuffer>& aBuffer)
+	{
+		Resource resource;
+		resource.Name = aName;
+		resource.Buffer = aBuffer;
+		resource.IsImported = true;
+		return AddResource(std::move(resource));
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::ImportRenderTexture(const char* aName, const std::shared_ptr<RenderTexture>& aTexture, std::optional<ResourceState> aFinalState)
+	{
+		Resource resource;
+		resource.Name = aName;
+		resource.RenderTexture = aTexture;
+		resource.Texture = aTexture;
+		resource.FinalState = aFinalState;
+		resource.IsImported = true;
+		return AddResource(std::move(resource));
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::ImportTexture(const char* aName, const std::shared_ptr<Texture>& aTexture, std::optional<ResourceState> aFinalState)
+	{
+		Resource resource;
+		resource.Name = aName;
+		resource.Texture = aTexture;
+		resource.FinalState = aFinalState;
+		resource.IsImported = true;
+		return AddResource(std::move(resource));
+	}
+
+	void RenderGraph::Compile()
+	{
+		PROFILE_SCOPE();
+		Debug::Assert(!myIsCompiled, "The graph is only compiled once per frame.");
+
+		CullPasses();
+
+		std::vector<std::size_t> executedPasses;
+		executedPasses.reserve(myPasses.size());
+		for (std::size_t i = 0; i < myPasses.size(); ++i)
+		{
+			if (!myPasses[i].IsCulled)
+				executedPasses.push_back(i);
+		}
+
+		myCulledPassCount = myPasses.size() - executedPasses.size();
+
+		AssignPhysicalTextures(executedPasses);
+		ScheduleTransitions(executedPasses);
+
+		myIsCompiled = true;
+	}
+
+	void RenderGraph::Execute(FrameGraphicsContext& aContext)
+	{
+		PROFILE_SCOPE();
+		Debug::Assert(myIsCompiled, "The graph is compiled before it executes.");
+
+		for (Pass& pass : myPasses)
+		{
+			if (pass.IsCulled)
+				continue;
+
+			if (!pass.EndTransitions.empty())
+				aContext.TransitionResources(pass.EndTransitions, FrameGraphicsContext::TransitionTiming::End);
+			if (!pass.Transitions.empty())
+				aContext.TransitionResources(pass.Transitions, FrameGraphicsContext::TransitionTiming::Immediate);
+
+			{
+				PROFILE_SCOPE_NAME("Render graph pass");
+				PROFILE_ACTIVE_SCOPE_NAME("%s", pass.Name.c_str());
+				CONTEXT_ZONE(aContext, "Render graph pass");
+
+				if (pass.Execute)
+					pass.Execute(aContext);
+			}
+
+			if (!pass.BeginTransitions.empty())
+				aContext.TransitionResources(pass.BeginTransitions, FrameGraphicsContext::TransitionTiming::Begin);
+		}
+
+		if (!myFinalTransitions.empty())
+			aContext.TransitionResources(myFinalTransitions, FrameGraphicsContext::TransitionTiming::Immediate);
+	}
+
+	void RenderGraph::Reset()
+	{
+		myPasses.clear();
+		myResources.clear();
+		myFinalTransitions.clear();
+		myCulledPassCount = 0;
+		myTransitionCount = 0;
+		myIsCompiled = false;
+
+		myFrame += 1;
+
+		std::erase_if(myPhysicalTextures, [&](const PhysicalTexture& aTexture) {
+			return (myFrame - aTexture.LastUsedFrame) > PhysicalTextureLifetime;
+		});
+	}
+
+	std::shared_ptr<GraphicsBuffer> RenderGraph::GetBuffer(ResourceHandle aResource) const
+	{
+		Debug::Assert(aResource.Index < myResources.size(), "Valid resource handle.");
+		return myResources[aResource.Index].Buffer;
+	}
+
+	std::shared_ptr<RenderTexture> RenderGraph::GetRenderTexture(ResourceHandle aResource) const
+	{
+		Debug::Assert(aResource.Index < myResources.size(), "Valid resource handle.");
+		return myResources[aResource.Index].RenderTexture;
+	}
+
+	std::shared_ptr<Texture> RenderGraph::GetTexture(ResourceHandle aResource) const
+	{
+		Debug::Assert(aResource.Index < myResources.size(), "Valid resource handle.");
+		return myResources[aResource.Index].Texture;
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::AddResource(Resource&& aResource)
+	{
+		Debug::Assert(!myIsCompiled, "Resources are added before the graph is compiled.");
+
+		myResources.push_back(std::move(aResource));
+
+		ResourceHandle handle;
+		handle.Index = static_cast<std::uint32_t>(myResources.size() - 1);
+		return handle;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		PROFILE_SCOPE();
+
+		// Passes are referenced by the resources they write, and resources by the passes reading them.
+		// Imported resources are visible outside the graph, so they always count as read.
+		for (Resource& resource : myResources)
+			resource.ReferenceCount = resource.IsImported ? 1 : 0;
+
+		for (Pass& pass : myPasses)
+		{
+			pass.ReferenceCount = 0;
+			pass.IsCulled = false;
+
+			for (const ResourceUse& use : pass.Uses)
+			{
+				if (use.IsWrite)
+					pass.ReferenceCount += 1;
+				else
+					myResources[use.Resource].ReferenceCount += 1;
+			}
+		}
+
+		// Passes are culled from their own outputs: one that nothing reads, including one that writes nothing, goes right away.
+		std::vector<std::size_t> unreferencedPasses;
+		for (std::size_t i = 0; i < myPasses.size(); ++i)
+		{
+			if (myPasses[i].ReferenceCount == 0 && !myPasses[i].HasSideEffects)
+				unreferencedPasses.push_back(i);
+		}
+
+		std::vector<std::uint32_t> unreferencedResources;
+		for (std::uint32_t i = 0; i < myResources.size(); ++i)
+		{
+			if (myResources[i].ReferenceCount == 0)
+				unreferencedResources.push_back(i);
+		}
+
+		// Culling a pass releases what it reads, which may leave those resources unread. An unread resource in turn
+		// releases the passes writing it, which are culled once none of their writes are read.
+		while (!unreferencedPasses.empty() || !unreferencedResources.empty())
+		{
+			if (!unreferencedPasses.empty())
+			{
+				Pass& pass = myPasses[unreferencedPasses.back()];
+				unreferencedPasses.pop_back();
+
+				pass.IsCulled = true;
+				for (const ResourceUse& use : pass.Uses)
+				{
+					if (!use.IsWrite && --myResources[use.Resource].ReferenceCount == 0)
+						unreferencedResources.push_back(use.Resource);
+				}
+
+				continue;
+			}
+
+			const std::uint32_t resourceIndex = unreferencedResources.back();
+			unreferencedResources.pop_back();
+
+			for (std::size_t i = 0; i < myPasses.size(); ++i)
+			{
+				Pass& writer = myPasses[i];
+				if (writer.IsCulled || writer.ReferenceCount == 0)
+					continue;
+
+				for (const ResourceUse& use : writer.Uses)
+				{
+					if (use.IsWrite && use.Resource == resourceIndex)
+						writer.ReferenceCount -= 1;
+				}
+
+				if (writer.ReferenceCount == 0 && !writer.HasSideEffects)
+					unreferencedPasses.push_back(i);
+			}
+		}
+	}
+
+	void RenderGraph::AssignPhysicalTextures(const std::vector<std::size_t>& someExecutedPasses)
+	{
+		PROFILE_SCOPE();
+
+		std::vector<bool> isUsed(myResources.size(), false);
+		for (std::size_t position = 0; position < someExecutedPasses.size(); ++position)
+		{
+			for (const ResourceUse& use : myPasses[someExecutedPasses[position]].Uses)
+			{
+				Resource& resource = myResources[use.Resource];
+				if (!isUsed[use.Resource])
+					resource.FirstUse = position;
+
+				resource.LastUse = position;
+				isUsed[use.Resource] = true;
+			}
+		}
+
+		std::vector<std::uint32_t> transientTextures;
+		for (std::uint32_t i = 0; i < myResources.size(); ++i)
+		{
+			if (isUsed[i] && !myResources[i].IsImported)
+				transientTextures.push_back(i);
+		}
+
+		std::sort(transientTextures.begin(), transientTextures.end(), [&](std::uint32_t a, std::uint32_t b) {
+			return myResources[a].FirstUse < myResources[b].FirstUse;
+		});
+
+		for (PhysicalTexture& physicalTexture : myPhysicalTextures)
+			physicalTexture.BusyUntil.reset();
+
+		// Textures whose lifetimes don't overlap share a physical texture, if their descriptions match.
+		for (std::uint32_t resourceIndex : transientTextures)
+		{
+			Resource& resource = myResources[resourceIndex];
+
+			auto physicalTexture = std::find_if(myPhysicalTextures.begin(), myPhysicalTextures.end(), [&](const PhysicalTexture& aTexture) {
+				return aTexture.Descriptor == resource.Descriptor && (!aTexture.BusyUntil.has_value() || aTexture.BusyUntil.value() < resource.FirstUse);
+			});
+
+			if (physicalTexture == myPhysicalTextures.end())
+			{
+				PhysicalTexture& createdTexture = myPhysicalTextures.emplace_back();
+				createdTexture.Descriptor = resource.Descriptor;
+				createdTexture.Texture = myGraphicsAPI.GetResourceManager().CreateRenderTexture(resource.Descriptor);
+				physicalTexture = myPhysicalTextures.end() - 1;
+			}
+
+			physicalTexture->BusyUntil = resource.LastUse;
+			physicalTexture->LastUsedFrame = myFrame;
+
+			resource.PhysicalIndex = static_cast<std::size_t>(physicalTexture - myPhysicalTextures.begin());
+			resource.RenderTexture = physicalTexture->Texture;
+			resource.Texture = physicalTexture->Texture;
+		}
+
+		PROFILE_PLOT("Render graph transient textures", static_cast<std::int64_t>(transientTextures.size()));
+		PROFILE_PLOT("Render graph physical textures", static_cast<std::int64_t>(myPhysicalTextures.size()));
+	}
+
+	void RenderGraph::ScheduleTransitions(const std::vector<std::size_t>& someExecutedPasses)
+	{
+		PROFILE_SCOPE();
+
+		struct TrackedState
+		{
+			ResourceState State;
+			std::size_t Position;
+		};
+
+		// States are tracked per physical resource, as transient textures sharing one continue where the previous left off.
+		// Render textures keep separate color and depth buffers, so depth states are tracked separately.
+		std::map<std::size_t, TrackedState> trackedStates;
+		const auto getStateKey = [&](std::uint32_t aResourceIndex, ResourceState aState) -> std::size_t {
+			const Resource& resource = myResources[aResourceIndex];
+			const std::size_t physicalKey = resource.IsImported ? aResourceIndex : myResources.size() + resource.PhysicalIndex;
+			return physicalKey * 2 + (IsDepthState(aState) ? 1 : 0);
+		};
+
+		for (std::size_t position = 0; position < someExecutedPasses.size(); ++position)
+		{
+			Pass& pass = myPasses[someExecutedPasses[position]];
+
+			for (const ResourceUse& use : pass.Uses)
+			{
+				const Resource& resource = myResources[use.Resource];
+
+				FrameGraphicsContext::ResourceTransition transition;
+				transition.Texture = resource.Texture;
+				transition.Buffer = resource.Buffer;
+				transition.State = use.State;
+
+				const std::size_t stateKey = getStateKey(use.Resource, use.State);
+				const auto tracked = trackedStates.find(stateKey);
+
+				if (tracked == trackedStates.end())
+				{
+					// The state before the graph is only known to the backend.
+					pass.Transitions.push_back(transition);
+				}
+				else if (tracked->second.State == use.State && use.State != ResourceState::UnorderedAccess)
+				{
+					// Already in the right state, unless unordered accesses have to be ordered.
+				}
+				else if (use.State == ResourceState::UnorderedAccess || (position - tracked->second.Position) <= 1)
+				{
+					pass.Transitions.push_back(transition);
+				}
+				else
+				{
+					myPasses[someExecutedPasses[tracked->second.Position]].BeginTransitions.push_back(transition);
+					pass.EndTransitions.push_back(transition);
+				}
+
+				trackedStates[stateKey] = TrackedState { use.State, position };
+			}
+
+			myTransitionCount += pass.Transitions.size() + pass.EndTransitions.size();
+		}
+
+		for (std::uint32_t i = 0; i < myResources.size(); ++i)
+		{
+			const Resource& resource = myResources[i];
+			if (!resource.FinalState.has_value())
+				continue;
+
+			const auto tracked = trackedStates.find(getStateKey(i, resource.FinalState.value()));
+			if (tracked != trackedStates.end() && tracked->second.State == resource.FinalState.value())
+				continue;
+
+			FrameGraphicsContext::ResourceTransition transition;
+			transition.Texture = resource.Texture;
+			transition.Buffer = resource.Buffer;
+			transition.State = resource.FinalState.value();
+			myFinalTransitions.push_back(transition);
+		}
+
+		myTransitionCount += myFinalTransitions.size();
+		PROFILE_PLOT("Render graph transitions", static_cast<std::int64_t>(myTransitionCount));
+	}
+
+	RenderGraph::PassBuilder::PassBuilder(RenderGraph& aGraph, std::size_t aPassIndex)
+		: myGraph(aGraph)
+		, myPassIndex(aPassIndex)
+	{
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::PassBuilder::CreateTexture(const char* aName, const RenderTextureDescriptor& aDescriptor)
+	{
+		Resource resource;
+		resource.Name = aName;
+		resource.Descriptor = aDescriptor;
+		return myGraph.AddResource(std::move(resource));
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::PassBuilder::Read(ResourceHandle aResource, ResourceState aState)
+	{
+		return AddUse(aResource, aState, false);
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::PassBuilder::Write(ResourceHandle aResource, ResourceState aState)
+	{
+		return AddUse(aResource, aState, true);
+	}
+
+	RenderGraph::ResourceHandle RenderGraph::PassBuilder::AddUse(ResourceHandle aResource, ResourceState aState, bool anIsWrite)
+	{
+		Debug::Assert(aResource.Index < myGraph.myResources.size(), "Valid resource handle.");
+
+		// Transitions are scheduled once per resource and pass, so a second use has to agree with the first.
+		Pass& pass = myGraph.myPasses[myPassIndex];
+		for (ResourceUse& use : pass.Uses)
+		{
+			if (use.Resource != aResource.Index || IsDepthState(use.State) != IsDepthState(aState))
+				continue;
+
+			if (Debug::Verify(use.State == aState, "Pass '%s' uses resource '%s' in one state at a time.", pass.Name.c_str(), myGraph.myResources[aResource.Index].Name.c_str()))
+				use.IsWrite = use.IsWrite || anIsWrite;
+
+			return aResource;
+		}
+
+		pass.Uses.push_back(ResourceUse { aResource.Index, aState, anIsWrite });
+		return aResource;
+	}
+
+	void RenderGraph::PassBuilder::SetSideEffects()
+	{
+		myGraph.myPasses[myPassIndex].HasSideEffects = true;
+	}
+}
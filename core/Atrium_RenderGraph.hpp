@@ -0,0 +1,266 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_FrameContext.hpp"
+#include "Atrium_GraphicsAPI.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Describes a frame as a list of passes that declare which resources they read and write.
+	 *        Compiling the graph culls passes whose results are never used, batches the resource transitions between passes
+	 *        and splits them where other passes run in between, and lets transient render textures with non-overlapping lifetimes
+	 *        share a physical texture.
+	 *
+	 *        Rebuild the graph each frame, after calling Reset(). Physical textures are kept between frames.
+	 *
+	 *        Only render textures can be transient, buffers have to be imported. Transient textures only share a physical texture
+	 *        when their descriptors are identical, as textures aren't placed in shared heap memory.
+	 */
+	class RenderGraph
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		/**
+		 * @brief Refers to a resource in the graph, only valid until the graph is reset.
+		 */
+		struct ResourceHandle
+		{
+			static constexpr std::uint32_t InvalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+			inline bool IsValid() const { return Index != InvalidIndex; }
+
+			std::uint32_t Index = InvalidIndex;
+		};
+
+		class PassBuilder;
+
+		using SetupCallback = std::function<void(PassBuilder& aBuilder)>;
+		using ExecuteCallback = std::function<void(FrameGraphicsContext& aContext)>;
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Construction
+		//--------------------------------------------------
+	#pragma region Construction
+
+		RenderGraph(GraphicsAPI& aGraphicsAPI);
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Add a pass to the graph. Passes execute in the order they are added.
+		 *
+		 * @param aName Name of the pass, used for profiling.
+		 * @param aSetup Called immediately to declare the resources the pass creates, reads and writes.
+		 * @param anExecute Called during Execute() to record the pass' commands, unless the pass is culled.
+		 */
+		void AddPass(const char* aName, const SetupCallback& aSetup, ExecuteCallback anExecute);
+
+		/**
+		 * @brief Import an existing buffer, to track which passes depend on it.
+		 *
+		 * @param aName Name of the resource.
+		 * @param aBuffer Buffer to import.
+		 * @return A handle to the imported buffer.
+		 */
+		ResourceHandle ImportBuffer(const char* aName, const std::shared_ptr<GraphicsBuffer>& aBuffer);
+
+		/**
+		 * @brief Import an existing render texture, such as a window's.
+		 *        Passes writing to imported resources are never culled.
+		 *
+		 * @param aName Name of the resource.
+		 * @param aTexture Render texture to import.
+		 * @param aFinalState State to leave the texture in after the graph has executed, if any.
+		 * @return A handle to the imported texture.
+		 */
+		ResourceHandle ImportRenderTexture(const char* aName, const std::shared_ptr<RenderTexture>& aTexture, std::optional<ResourceState> aFinalState = { });
+
+		/**
+		 * @brief Import an existing texture.
+		 *
+		 * @param aName Name of the resource.
+		 * @param aTexture Texture to import.
+		 * @param aFinalState State to leave the texture in after the graph has executed, if any.
+		 * @return A handle to the imported texture.
+		 */
+		ResourceHandle ImportTexture(const char* aName, const std::shared_ptr<Texture>& aTexture, std::optional<ResourceState> aFinalState = { });
+
+		/**
+		 * @brief Cull unused passes, assign physical textures to transient ones and schedule the transitions between passes.
+		 */
+		void Compile();
+
+		/**
+		 * @brief Record all passes that weren't culled, with their transitions, into a context.
+		 *
+		 * @param aContext Context to record to.
+		 */
+		void Execute(FrameGraphicsContext& aContext);
+
+		/**
+		 * @brief Remove all passes and resources, to build the graph for a new frame.
+		 *        Physical textures that haven't been used for a few frames are released.
+		 */
+		void Reset();
+
+		/**
+		 * @brief Get the buffer behind a handle.
+		 */
+		std::shared_ptr<GraphicsBuffer> GetBuffer(ResourceHandle aResource) const;
+
+		/**
+		 * @brief Get the render texture behind a handle.
+		 *        Transient textures only have one once the graph is compiled.
+		 */
+		std::shared_ptr<RenderTexture> GetRenderTexture(ResourceHandle aResource) const;
+
+		/**
+		 * @brief Get the texture behind a handle.
+		 *        Transient textures only have one once the graph is compiled.
+		 */
+		std::shared_ptr<Texture> GetTexture(ResourceHandle aResource) const;
+
+		std::size_t GetCulledPassCount() const { return myCulledPassCount; }
+		std::size_t GetPhysicalTextureCount() const { return myPhysicalTextures.size(); }
+		std::size_t GetTransitionCount() const { return myTransitionCount; }
+
+	#pragma endregion
+
+	private:
+		struct ResourceUse
+		{
+			std::uint32_t Resource;
+			ResourceState State;
+			bool IsWrite;
+		};
+
+		struct Pass
+		{
+			std::string Name;
+			ExecuteCallback Execute;
+			std::vector<ResourceUse> Uses;
+			std::uint32_t ReferenceCount = 0;
+			bool HasSideEffects = false;
+			bool IsCulled = false;
+
+			std::vector<FrameGraphicsContext::ResourceTransition> EndTransitions;
+			std::vector<FrameGraphicsContext::ResourceTransition> Transitions;
+			std::vector<FrameGraphicsContext::ResourceTransition> BeginTransitions;
+		};
+
+		struct Resource
+		{
+			std::string Name;
+			RenderTextureDescriptor Descriptor;
+			std::shared_ptr<Atrium::GraphicsBuffer> Buffer;
+			std::shared_ptr<Atrium::RenderTexture> RenderTexture;
+			std::shared_ptr<Atrium::Texture> Texture;
+			std::optional<ResourceState> FinalState;
+			std::uint32_t ReferenceCount = 0;
+			bool IsImported = false;
+
+			std::size_t FirstUse = 0;
+			std::size_t LastUse = 0;
+			std::size_t PhysicalIndex = 0;
+		};
+
+		struct PhysicalTexture
+		{
+			RenderTextureDescriptor Descriptor;
+			std::shared_ptr<RenderTexture> Texture;
+			std::uint_least64_t LastUsedFrame = 0;
+			std::optional<std::size_t> BusyUntil;
+		};
+
+		ResourceHandle AddResource(Resource&& aResource);
+		void CullPasses();
+		void AssignPhysicalTextures(const std::vector<std::size_t>& someExecutedPasses);
+		void ScheduleTransitions(const std::vector<std::size_t>& someExecutedPasses);
+
+		GraphicsAPI& myGraphicsAPI;
+
+		std::vector<Pass> myPasses;
+		std::vector<Resource> myResources;
+		std::vector<PhysicalTexture> myPhysicalTextures;
+		std::vector<FrameGraphicsContext::ResourceTransition> myFinalTransitions;
+
+		std::uint_least64_t myFrame;
+		std::size_t myCulledPassCount;
+		std::size_t myTransitionCount;
+		bool myIsCompiled;
+	};
+
+	/**
+	 * @brief Declares how a pass uses the graph's resources.
+	 */
+	class RenderGraph::PassBuilder
+	{
+	public:
+		/**
+		 * @brief Create a render texture that only lives for the duration of the graph.
+		 *        Its contents are undefined until written, as the memory may be shared with other transient textures.
+		 *
+		 * @param aName Name of the resource.
+		 * @param aDescriptor Size and formats of the texture.
+		 * @return A handle to the texture.
+		 */
+		ResourceHandle CreateTexture(const char* aName, const RenderTextureDescriptor& aDescriptor);
+
+		/**
+		 * @brief Declare that the pass reads a resource.
+		 *        A pass uses a resource in one state at a time, counting a render texture's depth separately from its color,
+		 *        so declaring it again in the same state only adds to the use, and in another state is an error.
+		 *
+		 * @param aResource Resource to read.
+		 * @param aState State the resource has to be in while the pass executes.
+		 * @return The same handle, for convenience.
+		 */
+		ResourceHandle Read(ResourceHandle aResource, ResourceState aState = ResourceState::ShaderResource);
+
+		/**
+		 * @brief Declare that the pass writes a resource.
+		 *        As with Read(), a resource read and written by the same pass has to be in one state for both.
+		 *
+		 * @param aResource Resource to write.
+		 * @param aState State the resource has to be in while the pass executes.
+		 * @return The same handle, for convenience.
+		 */
+		ResourceHandle Write(ResourceHandle aResource, ResourceState aState = ResourceState::RenderTarget);
+
+		/**
+		 * @brief Keep the pass even if nothing reads what it writes, such as for readbacks.
+		 */
+		void SetSideEffects();
+
+	private:
+		friend class RenderGraph;
+		PassBuilder(RenderGraph& aGraph, std::size_t aPassIndex);
+
+		ResourceHandle AddUse(ResourceHandle aResource, ResourceState aState, bool anIsWrite);
+
+		RenderGraph& myGraph;
+		std::size_t myPassIndex;
+	};
+}
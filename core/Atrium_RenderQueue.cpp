@@ -0,0 +1,454 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_RenderQueue.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Below this, spreading the sort over threads costs more than it saves.
+		constexpr std::size_t ParallelSortThreshold = 16384;
+		constexpr unsigned int MaxSortThreads = 8;
+
+		constexpr unsigned int PassBits = 4;
+
+		// Opaque: | pass | pipeline | material | vertex buffer | mesh | depth |
+		// The mesh keeps draws of the same index range together, so they can be merged into instanced draws.
+		constexpr unsigned int OpaquePipelineBits = 10;
+		constexpr unsigned int OpaqueMaterialBits = 12;
+		constexpr unsigned int OpaqueVertexBufferBits = 10;
+		constexpr unsigned int OpaqueMeshBits = 12;
+		constexpr unsigned int OpaqueDepthBits = 16;
+
+		// Transparent: | pass | inverted depth | pipeline | material | vertex buffer | mesh |
+		constexpr unsigned int TransparentDepthBits = 24;
+		constexpr unsigned int TransparentPipelineBits = 10;
+		constexpr unsigned int TransparentMaterialBits = 10;
+		constexpr unsigned int TransparentVertexBufferBits = 8;
+		constexpr unsigned int TransparentMeshBits = 8;
+
+		static_assert(PassBits + OpaquePipelineBits + OpaqueMaterialBits + OpaqueVertexBufferBits + OpaqueMeshBits + OpaqueDepthBits == 64);
+		static_assert(PassBits + TransparentDepthBits + TransparentPipelineBits + TransparentMaterialBits + TransparentVertexBufferBits + TransparentMeshBits == 64);
+		static_assert(RenderQueue::MaxPasses == (1u << PassBits));
+
+		constexpr unsigned int PassShift = 64 - PassBits;
+
+		constexpr std::uint32_t MinInstanceBufferCount = 1024;
+
+		inline std::uint64_t Mask(std::uint64_t aValue, unsigned int aBitCount)
+		{
+			return aValue & ((std::uint64_t(1) << aBitCount) - 1);
+		}
+
+		// The bit patterns of non-negative floats sort like the floats, so the top bits are a coarse depth.
+		inline std::uint64_t QuantizeDepth(float aDepth, unsigned int aBitCount)
+		{
+			const std::uint32_t depthBits = std::bit_cast<std::uint32_t>(std::max(aDepth, 0.f));
+			return depthBits >> (32 - aBitCount);
+		}
+	}
+
+	RenderQueue::RenderQueue()
+		: myGraphicsAPI(nullptr)
+		, myInstanceInputSlot(0)
+		, myInstanceStride(0)
+		, myStateChangeCount(0)
+		, myIsSorted(true)
+	{
+		myPassOrders.fill(DepthOrder::FrontToBack);
+	}
+
+	void RenderQueue::Add(DrawPacket&& aPacket)
+	{
+		Debug::Assert(aPacket.Pass < MaxPasses, "Pass fits in the sort key.");
+		Debug::Assert(!!aPacket.PipelineState, "Draws have a pipeline state.");
+
+		mySortedEntries.push_back(SortEntry { BuildKey(aPacket), static_cast<std::uint32_t>(myPackets.size()) });
+		myPackets.push_back(std::move(aPacket));
+		myInstanceDataRanges.emplace_back();
+		myIsSorted = false;
+	}
+
+	void RenderQueue::Add(DrawPacket&& aPacket, std::span<const std::byte> someInstanceData)
+	{
+		Debug::Assert(myGraphicsAPI != nullptr, "Instancing is enabled before adding per-instance data.");
+		Debug::Assert(someInstanceData.size() == myInstanceStride, "Per-instance data is as large as the instance stride.");
+
+		Add(std::move(aPacket));
+
+		InstanceDataRange& range = myInstanceDataRanges.back();
+		range.Offset = static_cast<std::uint32_t>(myInstanceStaging.size());
+		range.HasData = true;
+		myInstanceStaging.insert(myInstanceStaging.end(), someInstanceData.begin(), someInstanceData.end());
+	}
+
+	void RenderQueue::Clear()
+	{
+		myPackets.clear();
+		mySortedEntries.clear();
+		myDraws.clear();
+
+		myInstanceDataRanges.clear();
+		myInstanceStaging.clear();
+		myInstanceData.clear();
+
+		for (auto& retiredBuffer : myRetiredInstanceBuffers)
+			--retiredBuffer.second;
+
+		std::erase_if(myRetiredInstanceBuffers, [](const auto& aRetiredBuffer) { return aRetiredBuffer.second == 0; });
+
+		myPipelineIds.clear();
+		myMaterialIds.clear();
+		myVertexBufferIds.clear();
+		myMeshIds.clear();
+
+		myIsSorted = true;
+	}
+
+	void RenderQueue::EnableInstancing(GraphicsAPI& aGraphicsAPI, unsigned int anInputSlot, std::uint32_t anInstanceStride)
+	{
+		Debug::Assert(myPackets.empty(), "Instancing is enabled before draws are added.");
+		Debug::Assert(anInstanceStride > 0, "Per-instance data has a size.");
+
+		myGraphicsAPI = &aGraphicsAPI;
+		myInstanceInputSlot = anInputSlot;
+		myInstanceStride = anInstanceStride;
+		myInstanceBuffer.reset();
+	}
+
+	void RenderQueue::SetPassOrder(std::uint8_t aPass, DepthOrder anOrder)
+	{
+		Debug::Assert(aPass < MaxPasses, "Pass fits in the sort key.");
+		Debug::Assert(myPackets.empty(), "Pass orders are set before draws are added, as keys are built when adding.");
+
+		myPassOrders[aPass] = anOrder;
+	}
+
+	void RenderQueue::Sort()
+	{
+		PROFILE_SCOPE();
+
+		RadixSort(mySortedEntries, mySortScratch);
+		BuildDraws();
+		UploadInstanceData();
+		myIsSorted = true;
+	}
+
+	void RenderQueue::Submit(FrameGraphicsContext& aContext)
+	{
+		SubmitRange(aContext, 0, myDraws.size());
+	}
+
+	void RenderQueue::Submit(FrameGraphicsContext& aContext, std::uint8_t aPass)
+	{
+		const auto passBegin = std::partition_point(myDraws.begin(), myDraws.end(),
+			[&](const Draw& aDraw) { return myPackets[aDraw.Packet].Pass < aPass; });
+		const auto passEnd = std::partition_point(passBegin, myDraws.end(),
+			[&](const Draw& aDraw) { return myPackets[aDraw.Packet].Pass == aPass; });
+
+		SubmitRange(aContext, passBegin - myDraws.begin(), passEnd - myDraws.begin());
+	}
+
+	std::uint64_t RenderQueue::BuildKey(const DrawPacket& aPacket)
+	{
+		const std::uint64_t pipeline = GetObjectId(myPipelineIds, aPacket.PipelineState.get());
+		const std::uint64_t material = GetObjectId(myMaterialIds, aPacket.Material.get());
+		const std::uint64_t vertexBuffer = GetObjectId(myVertexBufferIds, aPacket.VertexBuffer.get());
+		const std::uint64_t mesh = myMeshIds.try_emplace(
+			std::make_tuple(static_cast<const void*>(aPacket.IndexBuffer.get()), aPacket.Arguments.StartIndexLocation, aPacket.Arguments.BaseVertexLocation),
+			static_cast<std::uint32_t>(myMeshIds.size())).first->second;
+
+		std::uint64_t key = std::uint64_t(aPacket.Pass) << PassShift;
+
+		// Ids wrapping around only loses some grouping, the state is still set correctly when submitting.
+		if (myPassOrders[aPacket.Pass] == DepthOrder::BackToFront)
+		{
+			const std::uint64_t depth = Mask(~QuantizeDepth(aPacket.Depth, TransparentDepthBits), TransparentDepthBits);
+
+			key |= depth << (TransparentPipelineBits + TransparentMaterialBits + TransparentVertexBufferBits + TransparentMeshBits);
+			key |= Mask(pipeline, TransparentPipelineBits) << (TransparentMaterialBits + TransparentVertexBufferBits + TransparentMeshBits);
+			key |= Mask(material, TransparentMaterialBits) << (TransparentVertexBufferBits + TransparentMeshBits);
+			key |= Mask(vertexBuffer, TransparentVertexBufferBits) << TransparentMeshBits;
+			key |= Mask(mesh, TransparentMeshBits);
+		}
+		else
+		{
+			key |= Mask(pipeline, OpaquePipelineBits) << (OpaqueMaterialBits + OpaqueVertexBufferBits + OpaqueMeshBits + OpaqueDepthBits);
+			key |= Mask(material, OpaqueMaterialBits) << (OpaqueVertexBufferBits + OpaqueMeshBits + OpaqueDepthBits);
+			key |= Mask(vertexBuffer, OpaqueVertexBufferBits) << (OpaqueMeshBits + OpaqueDepthBits);
+			key |= Mask(mesh, OpaqueMeshBits) << OpaqueDepthBits;
+			key |= QuantizeDepth(aPacket.Depth, OpaqueDepthBits);
+		}
+
+		return key;
+	}
+
+	bool RenderQueue::CanMerge(const DrawPacket& aPacket, const DrawPacket& anotherPacket) const
+	{
+		return aPacket.Pass == anotherPacket.Pass
+			&& aPacket.PipelineState == anotherPacket.PipelineState
+			&& aPacket.Material == anotherPacket.Material
+			&& aPacket.VertexBuffer == anotherPacket.VertexBuffer
+			&& aPacket.IndexBuffer == anotherPacket.IndexBuffer
+			&& aPacket.ObjectBuffer == anotherPacket.ObjectBuffer
+			&& aPacket.Arguments.IndexCountPerInstance == anotherPacket.Arguments.IndexCountPerInstance
+			&& aPacket.Arguments.StartIndexLocation == anotherPacket.Arguments.StartIndexLocation
+			&& aPacket.Arguments.BaseVertexLocation == anotherPacket.Arguments.BaseVertexLocation;
+	}
+
+	void RenderQueue::BuildDraws()
+	{
+		myDraws.clear();
+		myInstanceData.clear();
+		myInstanceData.reserve(myInstanceStaging.size());
+
+		for (const SortEntry& entry : mySortedEntries)
+		{
+			const DrawPacket& packet = myPackets[entry.Packet];
+			const InstanceDataRange& instanceData = myInstanceDataRanges[entry.Packet];
+
+			if (!instanceData.HasData)
+			{
+				myDraws.push_back(Draw { entry.Packet, packet.Arguments.InstanceCount, packet.Arguments.StartInstanceLocation, false });
+				continue;
+			}
+
+			// Per-instance data is packed in sorted order, so a merged draw's instances are contiguous.
+			const std::uint32_t instanceIndex = static_cast<std::uint32_t>(myInstanceData.size() / myInstanceStride);
+			const auto data = myInstanceStaging.begin() + instanceData.Offset;
+			myInstanceData.insert(myInstanceData.end(), data, data + myInstanceStride);
+
+			if (!myDraws.empty() && myDraws.back().IsInstanced && CanMerge(myPackets[myDraws.back().Packet], packet))
+				++myDraws.back().InstanceCount;
+			else
+				myDraws.push_back(Draw { entry.Packet, 1, instanceIndex, true });
+		}
+	}
+
+	void RenderQueue::UploadInstanceData()
+	{
+		if (myInstanceData.empty())
+			return;
+
+		const std::uint32_t instanceCount = static_cast<std::uint32_t>(myInstanceData.size() / myInstanceStride);
+		if (!myInstanceBuffer || myInstanceBuffer->GetCount() < instanceCount)
+		{
+			if (myInstanceBuffer)
+				myRetiredInstanceBuffers.emplace_back(std::move(myInstanceBuffer), static_cast<std::uint32_t>(myGraphicsAPI->GetFramesInFlightCount()));
+
+			const std::uint32_t bufferCount = std::max(MinInstanceBufferCount, std::bit_ceil(instanceCount));
+			myInstanceBuffer = myGraphicsAPI->GetResourceManager().CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, bufferCount, myInstanceStride);
+			if (myInstanceBuffer)
+				myInstanceBuffer->SetName(L"Render queue instance data");
+		}
+
+		if (myInstanceBuffer)
+			myInstanceBuffer->SetData(myInstanceData.data(), static_cast<std::uint32_t>(myInstanceData.size()));
+	}
+
+	void RenderQueue::SubmitRange(FrameGraphicsContext& aContext, std::size_t aBegin, std::size_t anEnd)
+	{
+		Debug::Assert(myIsSorted, "The queue is sorted before it is submitted.");
+
+		CONTEXT_ZONE(aContext, "Submit render queue");
+
+		myStateChangeCount = 0;
+
+		const PipelineState* currentPipelineState = nullptr;
+		const Material* currentMaterial = nullptr;
+		const GraphicsBuffer* currentVertexBuffer = nullptr;
+		const GraphicsBuffer* currentIndexBuffer = nullptr;
+		const GraphicsBuffer* currentObjectBuffer = nullptr;
+
+		std::vector<FrameGraphicsContext::DrawIndexedArguments> batch;
+		const auto flushBatch = [&]() {
+			if (!currentIndexBuffer)
+			{
+				for (const FrameGraphicsContext::DrawIndexedArguments& draw : batch)
+					aContext.DrawInstanced(draw.IndexCountPerInstance, draw.InstanceCount, draw.StartIndexLocation, draw.StartInstanceLocation);
+			}
+			else if (batch.size() == 1)
+			{
+				const FrameGraphicsContext::DrawIndexedArguments& draw = batch.front();
+				aContext.DrawIndexedInstanced(draw.IndexCountPerInstance, draw.InstanceCount, draw.StartIndexLocation, draw.BaseVertexLocation, draw.StartInstanceLocation);
+			}
+			else if (!batch.empty())
+			{
+				aContext.DrawIndexedInstancedBatch(batch);
+			}
+
+			batch.clear();
+		};
+
+		bool isInstanceBufferBound = false;
+
+		for (std::size_t i = aBegin; i < anEnd; ++i)
+		{
+			const Draw& draw = myDraws[i];
+			const DrawPacket& packet = myPackets[draw.Packet];
+
+			const bool pipelineChanged = packet.PipelineState.get() != currentPipelineState;
+			const bool materialChanged = pipelineChanged || packet.Material.get() != currentMaterial;
+			const bool vertexBufferChanged = packet.VertexBuffer.get() != currentVertexBuffer;
+			const bool indexBufferChanged = packet.IndexBuffer.get() != currentIndexBuffer;
+			const bool objectBufferChanged = pipelineChanged || packet.ObjectBuffer.get() != currentObjectBuffer;
+
+			if (pipelineChanged || materialChanged || vertexBufferChanged || indexBufferChanged || objectBufferChanged)
+				flushBatch();
+
+			if (pipelineChanged)
+			{
+				aContext.SetPipelineState(packet.PipelineState);
+				currentPipelineState = packet.PipelineState.get();
+				++myStateChangeCount;
+			}
+
+			// Bindings are tied to the pipeline's root signature, so they're set again whenever it changes.
+			if (materialChanged)
+			{
+				if (packet.Material)
+				{
+					for (const Material::Binding& binding : packet.Material->Bindings)
+					{
+						if (binding.Texture)
+							aContext.SetPipelineResource(ResourceUpdateFrequency::PerMaterial, binding.RegisterIndex, binding.Texture);
+						else if (binding.Buffer)
+							aContext.SetPipelineResource(ResourceUpdateFrequency::PerMaterial, binding.RegisterIndex, binding.Buffer);
+					}
+				}
+
+				currentMaterial = packet.Material.get();
+				++myStateChangeCount;
+			}
+
+			if (vertexBufferChanged)
+			{
+				if (packet.VertexBuffer)
+					aContext.SetVertexBuffer(packet.VertexBuffer);
+
+				currentVertexBuffer = packet.VertexBuffer.get();
+				++myStateChangeCount;
+			}
+
+			if (indexBufferChanged)
+			{
+				if (packet.IndexBuffer)
+					aContext.SetIndexBuffer(packet.IndexBuffer);
+
+				currentIndexBuffer = packet.IndexBuffer.get();
+				++myStateChangeCount;
+			}
+
+			if (objectBufferChanged)
+			{
+				if (packet.ObjectBuffer)
+					aContext.SetPipelineResource(ResourceUpdateFrequency::PerObject, 0, packet.ObjectBuffer);
+
+				currentObjectBuffer = packet.ObjectBuffer.get();
+			}
+
+			// Input slots aren't part of the pipeline state, so the instance buffer stays bound across pipeline changes.
+			if (draw.IsInstanced && !isInstanceBufferBound && myInstanceBuffer)
+			{
+				aContext.SetVertexBuffer(myInstanceBuffer, myInstanceInputSlot);
+				isInstanceBufferBound = true;
+			}
+
+			FrameGraphicsContext::DrawIndexedArguments& arguments = batch.emplace_back(packet.Arguments);
+			arguments.InstanceCount = draw.InstanceCount;
+			arguments.StartInstanceLocation = draw.StartInstance;
+		}
+
+		flushBatch();
+
+		PROFILE_PLOT("Render queue state changes", static_cast<std::int64_t>(myStateChangeCount));
+	}
+
+	std::uint32_t RenderQueue::GetObjectId(std::unordered_map<const void*, std::uint32_t>& someIds, const void* anObject)
+	{
+		if (!anObject)
+			return 0;
+
+		// Id 0 is reserved for no object, so draws without one sort first.
+		return someIds.try_emplace(anObject, static_cast<std::uint32_t>(someIds.size() + 1)).first->second;
+	}
+
+	void RenderQueue::RadixSort(std::vector<SortEntry>& someEntries, std::vector<SortEntry>& aScratch)
+	{
+		const std::size_t entryCount = someEntries.size();
+		if (entryCount < 2)
+			return;
+
+		aScratch.resize(entryCount);
+
+		// Bytes that are the same in every key don't affect the order, so their passes are skipped.
+		std::uint64_t differingBits = 0;
+		for (const SortEntry& entry : someEntries)
+			differingBits |= entry.Key ^ someEntries.front().Key;
+
+		std::vector<unsigned int> shifts;
+		for (unsigned int shift = 0; shift < 64; shift += 8)
+		{
+			if (((differingBits >> shift) & 0xFF) != 0)
+				shifts.push_back(shift);
+		}
+
+		if (shifts.empty())
+			return;
+
+		WorkerPool& workerPool = WorkerPool::Get();
+		const unsigned int threadCount = entryCount < ParallelSortThreshold ? 1 : std::min(workerPool.GetThreadCount(), MaxSortThreads);
+		const std::size_t entriesPerThread = (entryCount + threadCount - 1) / threadCount;
+
+		using Histogram = std::array<std::size_t, 256>;
+		std::vector<Histogram> histograms(threadCount);
+
+		SortEntry* source = someEntries.data();
+		SortEntry* destination = aScratch.data();
+
+		// Every pass counts the digits of each chunk, turns the counts into offsets where each chunk is scattered stably,
+		// then swaps the buffers. Chunks keep their histogram between the two loops, so the offsets line up.
+		for (const unsigned int shift : shifts)
+		{
+			workerPool.ParallelFor(threadCount, [&](std::size_t aChunk) {
+				const std::size_t chunkBegin = std::min(entryCount, aChunk * entriesPerThread);
+				const std::size_t chunkEnd = std::min(entryCount, chunkBegin + entriesPerThread);
+				Histogram& histogram = histograms[aChunk];
+
+				histogram.fill(0);
+				for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+					++histogram[(source[i].Key >> shift) & 0xFF];
+			});
+
+			std::size_t offset = 0;
+			for (std::size_t digit = 0; digit < 256; ++digit)
+			{
+				for (Histogram& histogram : histograms)
+				{
+					const std::size_t count = histogram[digit];
+					histogram[digit] = offset;
+					offset += count;
+				}
+			}
+
+			workerPool.ParallelFor(threadCount, [&](std::size_t aChunk) {
+				const std::size_t chunkBegin = std::min(entryCount, aChunk * entriesPerThread);
+				const std::size_t chunkEnd = std::min(entryCount, chunkBegin + entriesPerThread);
+				Histogram& histogram = histograms[aChunk];
+
+				for (std::size_t i = chunkBegin; i < chunkEnd; ++i)
+					destination[histogram[(source[i].Key >> shift) & 0xFF]++] = source[i];
+			});
+
+			std::swap(source, destination);
+		}
+
+		if (source != someEntries.data())
+			someEntries.swap(aScratch);
+	}
+}
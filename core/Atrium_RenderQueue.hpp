@@ -0,0 +1,250 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_FrameContext.hpp"
+#include "Atrium_GraphicsAPI.hpp"
+#include "Atrium_GraphicsBuffer.hpp"
+#include "Atrium_GraphicsPipeline.hpp"
+#include "Atrium_Texture.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Collects draws for a frame and submits them ordered by a 64-bit sort key, to minimize state changes.
+	 *        Keys are built from the pass, pipeline state, material, mesh and depth of each draw, and sorted with a radix sort
+	 *        that is split over several threads for large queues.
+	 *
+	 *        Opaque passes are sorted by state first and front-to-back within the same state.
+	 *        Transparent passes are sorted back-to-front first, so blending stays correct, and by state within the same depth.
+	 *
+	 *        With instancing enabled, consecutive sorted draws of the same mesh with the same state and per-instance data
+	 *        are merged into a single instanced draw.
+	 */
+	class RenderQueue
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		/**
+		 * @brief Order of the draws within a pass.
+		 */
+		enum class DepthOrder
+		{
+			FrontToBack,
+			BackToFront
+		};
+
+		/**
+		 * @brief Resources bound with the PerMaterial update frequency, shared by all draws using the material.
+		 *        Draws are grouped by material, so keep material objects alive and reuse them between draws.
+		 */
+		struct Material
+		{
+			struct Binding
+			{
+				std::uint32_t RegisterIndex = 0;
+				std::shared_ptr<GraphicsBuffer> Buffer;
+				std::shared_ptr<Atrium::Texture> Texture;
+			};
+
+			std::vector<Binding> Bindings;
+		};
+
+		/**
+		 * @brief Everything needed to issue one draw.
+		 */
+		struct DrawPacket
+		{
+			std::shared_ptr<Atrium::PipelineState> PipelineState;
+			std::shared_ptr<const RenderQueue::Material> Material;
+			std::shared_ptr<const GraphicsBuffer> VertexBuffer;
+
+			// Bound as the index buffer for the draw, if set. Its stride picks 16 or 32-bit indices.
+			// Without one the draw isn't indexed, and the arguments' index count and start index are used as the vertex count and start vertex.
+			std::shared_ptr<const GraphicsBuffer> IndexBuffer;
+
+			// Bound to register 0 with the PerObject update frequency, if set.
+			std::shared_ptr<GraphicsBuffer> ObjectBuffer;
+
+			FrameGraphicsContext::DrawIndexedArguments Arguments;
+
+			// View-space distance, only used for ordering.
+			float Depth = 0.f;
+			std::uint8_t Pass = 0;
+		};
+
+		static constexpr std::size_t MaxPasses = 16;
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Construction
+		//--------------------------------------------------
+	#pragma region Construction
+
+		RenderQueue();
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Add a draw to the queue.
+		 *
+		 * @param aPacket Draw to add. Its pass has to be lower than MaxPasses.
+		 */
+		void Add(DrawPacket&& aPacket);
+
+		/**
+		 * @brief Add a draw with per-instance data, to be merged with other draws of the same mesh and state.
+		 *        Requires instancing to be enabled. The packet's own instance count and start instance are replaced.
+		 *
+		 * @param aPacket Draw to add. Its pass has to be lower than MaxPasses.
+		 * @param someInstanceData Per-instance data for the draw, as large as the instance stride.
+		 */
+		void Add(DrawPacket&& aPacket, std::span<const std::byte> someInstanceData);
+
+		template <typename T>
+		void Add(DrawPacket&& aPacket, const T& someInstanceData)
+		{
+			Add(std::move(aPacket), std::as_bytes(std::span<const T>(&someInstanceData, 1)));
+		}
+
+		/**
+		 * @brief Remove all draws, to collect a new frame. Pass orders are kept.
+		 */
+		void Clear();
+
+		/**
+		 * @brief Enable merging repeated draws into instanced draws.
+		 *        Per-instance data of each frame is packed into a transient vertex buffer, bound to the given input slot.
+		 *        Pipelines used for instanced draws declare their per-instance input layout entries on that slot, with an InstancePerStep of 1.
+		 *
+		 * @param aGraphicsAPI Graphics API to create the instance buffers with.
+		 * @param anInputSlot Input slot to bind the instance buffer to.
+		 * @param anInstanceStride Size in bytes of the per-instance data of each draw.
+		 */
+		void EnableInstancing(GraphicsAPI& aGraphicsAPI, unsigned int anInputSlot, std::uint32_t anInstanceStride);
+
+		/**
+		 * @brief Set how draws within a pass are ordered. Passes default to front-to-back.
+		 *
+		 * @param aPass Pass to set the order of.
+		 * @param anOrder Front-to-back for opaque passes, back-to-front for transparent ones.
+		 */
+		void SetPassOrder(std::uint8_t aPass, DepthOrder anOrder);
+
+		/**
+		 * @brief Sort the draws by their keys, merge repeated draws if instancing is enabled and upload their instance data.
+		 *        Has to be called before submitting, after the last draw has been added.
+		 */
+		void Sort();
+
+		/**
+		 * @brief Submit all sorted draws, in pass order.
+		 *        State is only set when it differs from the previous draw's, and consecutive draws sharing all state are batched.
+		 *
+		 * @param aContext Context to record the draws to.
+		 */
+		void Submit(FrameGraphicsContext& aContext);
+
+		/**
+		 * @brief Submit the sorted draws of a single pass, such as when passes use different render targets.
+		 *
+		 * @param aContext Context to record the draws to.
+		 * @param aPass Pass to submit.
+		 */
+		void Submit(FrameGraphicsContext& aContext, std::uint8_t aPass);
+
+		std::size_t GetDrawCount() const { return myPackets.size(); }
+
+		/**
+		 * @brief Get the amount of draws that will be submitted, after merging repeated draws.
+		 */
+		std::size_t GetSubmittedDrawCount() const { return myDraws.size(); }
+
+		/**
+		 * @brief Get the amount of pipeline state, material and buffer changes made by the last submit.
+		 */
+		std::size_t GetStateChangeCount() const { return myStateChangeCount; }
+
+	#pragma endregion
+
+	private:
+		struct SortEntry
+		{
+			std::uint64_t Key;
+			std::uint32_t Packet;
+		};
+
+		struct Draw
+		{
+			std::uint32_t Packet;
+			std::uint32_t InstanceCount;
+			std::uint32_t StartInstance;
+			bool IsInstanced;
+		};
+
+		// Where a packet's per-instance data is in the staging data.
+		struct InstanceDataRange
+		{
+			std::uint32_t Offset = 0;
+			bool HasData = false;
+		};
+
+		std::uint64_t BuildKey(const DrawPacket& aPacket);
+		bool CanMerge(const DrawPacket& aPacket, const DrawPacket& anotherPacket) const;
+		void BuildDraws();
+		void UploadInstanceData();
+		void SubmitRange(FrameGraphicsContext& aContext, std::size_t aBegin, std::size_t anEnd);
+
+		static std::uint32_t GetObjectId(std::unordered_map<const void*, std::uint32_t>& someIds, const void* anObject);
+		static void RadixSort(std::vector<SortEntry>& someEntries, std::vector<SortEntry>& aScratch);
+
+		std::array<DepthOrder, MaxPasses> myPassOrders;
+
+		std::vector<DrawPacket> myPackets;
+		std::vector<SortEntry> mySortedEntries;
+		std::vector<SortEntry> mySortScratch;
+		std::vector<Draw> myDraws;
+
+		GraphicsAPI* myGraphicsAPI;
+		unsigned int myInstanceInputSlot;
+		std::uint32_t myInstanceStride;
+
+		std::vector<InstanceDataRange> myInstanceDataRanges;
+		std::vector<std::byte> myInstanceStaging;
+		std::vector<std::byte> myInstanceData;
+
+		// Replaced buffers may still be read by frames in flight, so they're kept until those are done.
+		std::shared_ptr<GraphicsBuffer> myInstanceBuffer;
+		std::vector<std::pair<std::shared_ptr<GraphicsBuffer>, std::uint32_t>> myRetiredInstanceBuffers;
+
+		// Dense per-frame ids, so state objects fit in the few bits the key has for them.
+		std::unordered_map<const void*, std::uint32_t> myPipelineIds;
+		std::unordered_map<const void*, std::uint32_t> myMaterialIds;
+		std::unordered_map<const void*, std::uint32_t> myVertexBufferIds;
+		std::map<std::tuple<const void*, std::uint32_t, std::uint32_t>, std::uint32_t> myMeshIds;
+
+		std::size_t myStateChangeCount;
+		bool myIsSorted;
+	};
+}
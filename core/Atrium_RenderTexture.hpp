@@ -20,6 +20,8 @@ namespace Atrium
 		unsigned int Size_Depth = 0;
 		unsigned int Size_Height = 0;
 		unsigned int Size_Width = 0;
+
+		bool operator==(const RenderTextureDescriptor&) const = default;
 	};
 
 	class RenderTexture : public Texture
@@ -28,5 +30,11 @@ namespace Atrium
 		virtual const RenderTextureDescriptor& GetDescriptor() const = 0;
 
 		virtual void* GetNativeDepthBufferPtr() const = 0;
+
+		// Implements Texture, render textures are only written to by the GPU.
+	public:
+		bool SetPixels(const void*, std::size_t, const TextureRegion&, unsigned int, unsigned int) override { return false; }
+		void Apply(bool, bool) override { }
+		void ApplyDirtyRegions(bool) override { }
 	};
 }
\ No newline at end of file
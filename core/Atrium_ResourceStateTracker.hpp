@@ -0,0 +1,162 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Tracks the states of the resources used by a single recording context, per subresource.
+	 *        Transitions between states already known to the context are produced while recording.
+	 *        The state a resource is in when the context starts depends on the contexts submitted before it,
+	 *        so those initial transitions are deferred until the context is submitted, and resolved against the shared states then.
+	 *        Recording never touches the shared states, which lets several contexts record in parallel.
+	 *
+	 * @tparam ResourceType Backend resource type. Resources have to outlive the submission of the contexts using them.
+	 * @tparam StateType Backend resource state type.
+	 */
+	template <typename ResourceType, typename StateType>
+	class ResourceStateTracker
+	{
+	public:
+		static constexpr std::uint32_t AllSubresources = std::numeric_limits<std::uint32_t>::max();
+
+		/**
+		 * @brief A transition of a resource between two states.
+		 *        Before and After are equal when accesses in an ordered state have to finish before the next.
+		 */
+		struct Transition
+		{
+			ResourceType* Resource = nullptr;
+			std::uint32_t Subresource = AllSubresources;
+			StateType Before;
+			StateType After;
+		};
+
+	public:
+		/**
+		 * @param anOrderedState State whose accesses have to be ordered with a barrier even without a state change, if any.
+		 */
+		ResourceStateTracker(std::optional<StateType> anOrderedState = { })
+			: myOrderedState(anOrderedState)
+		{
+		}
+
+		/**
+		 * @brief Require a resource to be in a state for the commands recorded next.
+		 *
+		 * @param aResource Resource to transition.
+		 * @param aSubresourceCount Amount of subresources the resource has.
+		 * @param aSubresource Subresource to transition, or AllSubresources.
+		 * @param aState State to transition to.
+		 * @param someTransitionsOut Transitions that have to be recorded before the next commands.
+		 *                           Subresource transitions are merged into one when the whole resource changes from the same state.
+		 */
+		void Require(ResourceType& aResource, std::uint32_t aSubresourceCount, std::uint32_t aSubresource, StateType aState, std::vector<Transition>& someTransitionsOut)
+		{
+			ResourceStates& states = myResources[&aResource];
+			if (states.Current.empty())
+			{
+				states.Initial.resize(aSubresourceCount);
+				states.Current.resize(aSubresourceCount);
+			}
+
+			const std::uint32_t first = aSubresource == AllSubresources ? 0 : aSubresource;
+			const std::uint32_t last = aSubresource == AllSubresources ? static_cast<std::uint32_t>(states.Current.size()) : aSubresource + 1;
+			const std::size_t firstTransition = someTransitionsOut.size();
+
+			for (std::uint32_t i = first; i < last; ++i)
+			{
+				std::optional<StateType>& current = states.Current[i];
+				if (!current.has_value())
+				{
+					// First use in this context, transitioned at submission.
+					states.Initial[i] = aState;
+				}
+				else if (current.value() != aState || (myOrderedState.has_value() && aState == myOrderedState.value()))
+				{
+					someTransitionsOut.push_back(Transition { &aResource, i, current.value(), aState });
+				}
+
+				current = aState;
+			}
+
+			if (aSubresource == AllSubresources)
+				MergeTransitions(someTransitionsOut, firstTransition, last - first);
+		}
+
+		/**
+		 * @brief Resolve the transitions needed before the context's commands, and update the shared states with the context's final states.
+		 *        Call once per recording, in submission order.
+		 *
+		 * @param aGetSharedStates Function returning a std::span<StateType> with the shared state of each subresource of a resource.
+		 * @param someTransitionsOut Transitions to submit before the context's commands.
+		 */
+		template <typename GetSharedStatesFunction>
+		void Resolve(GetSharedStatesFunction&& aGetSharedStates, std::vector<Transition>& someTransitionsOut)
+		{
+			for (auto& [resource, states] : myResources)
+			{
+				std::span<StateType> sharedStates = aGetSharedStates(*resource);
+				const std::uint32_t subresourceCount = static_cast<std::uint32_t>(std::min(sharedStates.size(), states.Current.size()));
+				const std::size_t firstTransition = someTransitionsOut.size();
+
+				for (std::uint32_t i = 0; i < subresourceCount; ++i)
+				{
+					if (states.Initial[i].has_value() && states.Initial[i].value() != sharedStates[i])
+						someTransitionsOut.push_back(Transition { resource, i, sharedStates[i], states.Initial[i].value() });
+
+					if (states.Current[i].has_value())
+						sharedStates[i] = states.Current[i].value();
+				}
+
+				MergeTransitions(someTransitionsOut, firstTransition, subresourceCount);
+			}
+		}
+
+		/**
+		 * @brief Forget all states, to start a new recording.
+		 */
+		void Reset()
+		{
+			myResources.clear();
+		}
+
+	private:
+		struct ResourceStates
+		{
+			std::vector<std::optional<StateType>> Initial;
+			std::vector<std::optional<StateType>> Current;
+		};
+
+		// Replace per-subresource transitions with a single one, if all subresources change between the same states.
+		static void MergeTransitions(std::vector<Transition>& someTransitions, std::size_t aFirstTransition, std::uint32_t aSubresourceCount)
+		{
+			const std::size_t transitionCount = someTransitions.size() - aFirstTransition;
+			if (transitionCount == 0 || transitionCount != aSubresourceCount)
+				return;
+
+			const Transition& firstTransition = someTransitions[aFirstTransition];
+			for (std::size_t i = aFirstTransition + 1; i < someTransitions.size(); ++i)
+			{
+				if (someTransitions[i].Before != firstTransition.Before || someTransitions[i].After != firstTransition.After)
+					return;
+			}
+
+			Transition merged = firstTransition;
+			merged.Subresource = AllSubresources;
+			someTransitions.resize(aFirstTransition);
+			someTransitions.push_back(merged);
+		}
+
+		std::optional<StateType> myOrderedState;
+		std::unordered_map<ResourceType*, ResourceStates> myResources;
+	};
+}
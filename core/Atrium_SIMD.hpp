@@ -0,0 +1,72 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include <array>
+
+// SSE2 is part of every x64 target, and of x86 builds with /arch:SSE2 or -msse2.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ATRIUM_SIMD_SSE 1
+#include <emmintrin.h>
+#endif
+
+// Only when the compiler targets it, with /arch:AVX2 or -mavx2, as there's no dispatch at runtime.
+#if ATRIUM_SIMD_SSE && defined(__AVX2__)
+#define ATRIUM_SIMD_AVX2 1
+#endif
+
+// Every AVX2 CPU has F16C, which MSVC doesn't define a macro for.
+#if ATRIUM_SIMD_SSE && (defined(__F16C__) || defined(__AVX2__))
+#define ATRIUM_SIMD_F16C 1
+#endif
+
+#if ATRIUM_SIMD_AVX2 || ATRIUM_SIMD_F16C
+#include <immintrin.h>
+#endif
+
+namespace Atrium::SIMD
+{
+#if ATRIUM_SIMD_SSE
+	/**
+	 * @brief The X, Y and Z components of four vectors, one vector per lane.
+	 */
+	using Lanes3 = std::array<__m128, 3>;
+
+	inline __m128 Dot(const Lanes3& aVector, const Lanes3& anotherVector)
+	{
+		return _mm_add_ps(_mm_add_ps(_mm_mul_ps(aVector[0], anotherVector[0]), _mm_mul_ps(aVector[1], anotherVector[1])), _mm_mul_ps(aVector[2], anotherVector[2]));
+	}
+
+	inline Lanes3 Subtract(const Lanes3& aVector, const Lanes3& anotherVector)
+	{
+		return { _mm_sub_ps(aVector[0], anotherVector[0]), _mm_sub_ps(aVector[1], anotherVector[1]), _mm_sub_ps(aVector[2], anotherVector[2]) };
+	}
+
+	inline Lanes3 Scale(const Lanes3& aVector, __m128 aScale)
+	{
+		return { _mm_mul_ps(aVector[0], aScale), _mm_mul_ps(aVector[1], aScale), _mm_mul_ps(aVector[2], aScale) };
+	}
+
+	inline Lanes3 Cross(const Lanes3& aVector, const Lanes3& anotherVector)
+	{
+		return {
+			_mm_sub_ps(_mm_mul_ps(aVector[1], anotherVector[2]), _mm_mul_ps(aVector[2], anotherVector[1])),
+			_mm_sub_ps(_mm_mul_ps(aVector[2], anotherVector[0]), _mm_mul_ps(aVector[0], anotherVector[2])),
+			_mm_sub_ps(_mm_mul_ps(aVector[0], anotherVector[1]), _mm_mul_ps(aVector[1], anotherVector[0]))
+		};
+	}
+
+	/**
+	 * @brief Pick lanes from one value where a mask is set, and from the other where it isn't.
+	 */
+	inline __m128 Select(__m128 aMask, __m128 aValue, __m128 aFallback)
+	{
+		return _mm_or_ps(_mm_and_ps(aMask, aValue), _mm_andnot_ps(aMask, aFallback));
+	}
+
+	inline __m128 Abs(__m128 aValue)
+	{
+		return _mm_andnot_ps(_mm_set1_ps(-0.f), aValue);
+	}
+#endif
+}
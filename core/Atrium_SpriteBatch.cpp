@@ -0,0 +1,247 @@
+// Filter "Graphics"
+
+#include "Atrium_MeshPrimitives.hpp"
+#include "Atrium_SpriteBatch.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Atrium
+{
+	namespace
+	{
+		constexpr std::uint32_t RetiredSpriteBufferLifetime = 4;
+		constexpr std::uint32_t MinSpriteBufferCount = 4096;
+
+		constexpr std::uint32_t QuadVertexCount = 4;
+
+		static_assert(sizeof(SpriteBatch::Sprite) == 52, "Sprites are tightly packed, as described by the input layout.");
+	}
+
+	SpriteBatch::SpriteBatch(GraphicsAPI& aGraphicsAPI, std::uint32_t aTextureRegister)
+		: myGraphicsAPI(aGraphicsAPI)
+		, myTextureRegister(aTextureRegister)
+		, mySortMode(SortMode::Deferred)
+		, myLastUploadFrame(std::numeric_limits<std::uint_least64_t>::max())
+		, myDrawCount(0)
+		, myIsCollecting(false)
+	{
+		// The Quad's vertices are already in triangle strip order, its two triangles being (0, 1, 2) and (2, 1, 3).
+		const MeshPrimitive quad = MeshPrimitive::Generate(MeshPrimitiveType::Quad);
+		Debug::Assert(quad.Vertices.size() == QuadVertexCount, "The quad has a vertex per corner.");
+
+		myQuadBuffer = myGraphicsAPI.GetResourceManager().CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, QuadVertexCount, sizeof(MeshPrimitive::Vertex));
+		if (myQuadBuffer)
+		{
+			myQuadBuffer->SetName(L"Sprite batch quad");
+			myQuadBuffer->SetData(std::span(quad.Vertices));
+		}
+	}
+
+	std::vector<PipelineStateDescription::InputLayoutEntry> SpriteBatch::GetInputLayout()
+	{
+		using InputLayoutEntry = PipelineStateDescription::InputLayoutEntry;
+		return {
+			InputLayoutEntry("POSITION", GraphicsFormat::R32G32B32_SFloat, QuadInputSlot),
+			InputLayoutEntry("NORMAL", GraphicsFormat::R32G32B32_SFloat, QuadInputSlot),
+			InputLayoutEntry("BINORMAL", GraphicsFormat::R32G32B32_SFloat, QuadInputSlot),
+			InputLayoutEntry("TANGENT", GraphicsFormat::R32G32B32_SFloat, QuadInputSlot),
+			InputLayoutEntry("TEXCOORD", GraphicsFormat::R32G32_SFloat, QuadInputSlot),
+
+			InputLayoutEntry("SPRITE_POSITION", GraphicsFormat::R32G32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_SIZE", GraphicsFormat::R32G32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_ORIGIN", GraphicsFormat::R32G32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_UVOFFSET", GraphicsFormat::R32G32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_UVSCALE", GraphicsFormat::R32G32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_ROTATION", GraphicsFormat::R32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("SPRITE_DEPTH", GraphicsFormat::R32_SFloat, SpriteInputSlot, 1),
+			InputLayoutEntry("COLOR", GraphicsFormat::R8G8B8A8_UNorm, SpriteInputSlot, 1)
+		};
+	}
+
+	std::uint32_t SpriteBatch::PackColor(const ColorARGB<float>& aColor)
+	{
+		const auto toByte = [](float aChannel) { return static_cast<std::uint32_t>(std::clamp(aChannel, 0.f, 1.f) * 255.f + 0.5f); };
+		return toByte(aColor.R)
+			| (toByte(aColor.G) << 8)
+			| (toByte(aColor.B) << 16)
+			| (toByte(aColor.A) << 24);
+	}
+
+	void SpriteBatch::Begin(SortMode aSortMode)
+	{
+		Debug::Assert(!myIsCollecting, "Begin() isn't called again before End().");
+
+		mySortMode = aSortMode;
+		mySprites.clear();
+		mySpriteBatches.clear();
+		myBatches.clear();
+		myBatchLookup.clear();
+		myIsCollecting = true;
+	}
+
+	void SpriteBatch::Draw(const std::shared_ptr<PipelineState>& aPipelineState, const std::shared_ptr<Texture>& aTexture, const Sprite& aSprite)
+	{
+		Debug::Assert(myIsCollecting, "Sprites are drawn between Begin() and End().");
+		Debug::Assert(!!aPipelineState, "Sprites have a pipeline state.");
+
+		const std::uint32_t batch = FindOrAddBatch(aPipelineState, aTexture);
+		++myBatches[batch].SpriteCount;
+
+		mySprites.push_back(aSprite);
+		if (mySortMode == SortMode::Texture)
+			mySpriteBatches.push_back(batch);
+	}
+
+	void SpriteBatch::End(FrameGraphicsContext& aContext)
+	{
+		PROFILE_SCOPE();
+		Debug::Assert(myIsCollecting, "End() is called after Begin().");
+		myIsCollecting = false;
+		myDrawCount = 0;
+
+		if (mySprites.empty() || !myQuadBuffer)
+			return;
+
+		Upload();
+		if (!mySpriteBuffer)
+			return;
+
+		CONTEXT_ZONE(aContext, "Draw sprite batch");
+
+		aContext.SetPrimitiveTopology(PrimitiveTopology::TriangleStrip);
+		aContext.SetVertexBuffer(myQuadBuffer, QuadInputSlot);
+		aContext.SetVertexBuffer(mySpriteBuffer, SpriteInputSlot);
+
+		const PipelineState* currentPipelineState = nullptr;
+		const Texture* currentTexture = nullptr;
+		for (const Batch& batch : myBatches)
+		{
+			const bool pipelineChanged = batch.PipelineState.get() != currentPipelineState;
+			if (pipelineChanged)
+			{
+				aContext.SetPipelineState(batch.PipelineState);
+				currentPipelineState = batch.PipelineState.get();
+			}
+
+			// Bindings are tied to the pipeline's root signature, so they're set again whenever it changes.
+			if ((pipelineChanged || batch.Texture.get() != currentTexture) && batch.Texture)
+				aContext.SetPipelineResource(ResourceUpdateFrequency::PerMaterial, myTextureRegister, batch.Texture);
+
+			currentTexture = batch.Texture.get();
+
+			aContext.DrawInstanced(QuadVertexCount, batch.SpriteCount, 0, batch.FirstSprite);
+			++myDrawCount;
+		}
+
+		PROFILE_PLOT("Sprite batch draws", static_cast<std::int64_t>(myDrawCount));
+	}
+
+	std::size_t SpriteBatch::BatchKeyHash::operator()(const std::pair<const void*, const void*>& aKey) const
+	{
+		const std::size_t pipelineHash = std::hash<const void*>()(aKey.first);
+		return pipelineHash ^ (std::hash<const void*>()(aKey.second) + 0x9e3779b9 + (pipelineHash << 6) + (pipelineHash >> 2));
+	}
+
+	std::uint32_t SpriteBatch::FindOrAddBatch(const std::shared_ptr<PipelineState>& aPipelineState, const std::shared_ptr<Texture>& aTexture)
+	{
+		// Consecutive sprites usually share their state, which skips the lookup.
+		if (!myBatches.empty())
+		{
+			const Batch& lastBatch = myBatches.back();
+			if (lastBatch.PipelineState == aPipelineState && lastBatch.Texture == aTexture)
+				return static_cast<std::uint32_t>(myBatches.size() - 1);
+		}
+
+		if (mySortMode == SortMode::Texture)
+		{
+			const auto [it, isNew] = myBatchLookup.try_emplace({ aPipelineState.get(), aTexture.get() }, static_cast<std::uint32_t>(myBatches.size()));
+			if (!isNew)
+				return it->second;
+		}
+
+		myBatches.push_back(Batch { aPipelineState, aTexture });
+		return static_cast<std::uint32_t>(myBatches.size() - 1);
+	}
+
+	void SpriteBatch::Upload()
+	{
+		PROFILE_SCOPE();
+
+		const std::uint_least64_t frameIndex = myGraphicsAPI.GetCurrentFrameIndex();
+		Debug::Assert(frameIndex != myLastUploadFrame, "A sprite batch is only ended once per frame, as later uploads would overwrite the sprites of earlier ones.");
+		myLastUploadFrame = frameIndex;
+
+		for (auto& retiredBuffer : myRetiredSpriteBuffers)
+			--retiredBuffer.second;
+
+		std::erase_if(myRetiredSpriteBuffers, [](const auto& aRetiredBuffer) { return aRetiredBuffer.second == 0; });
+
+		const std::vector<Sprite>* sprites = &mySprites;
+
+		if (mySortMode == SortMode::Texture)
+		{
+			// Batches using the same pipeline state are put next to each other, to change it as little as possible.
+			std::unordered_map<const void*, std::uint32_t> pipelineOrder;
+			for (const Batch& batch : myBatches)
+				pipelineOrder.try_emplace(batch.PipelineState.get(), static_cast<std::uint32_t>(pipelineOrder.size()));
+
+			std::vector<std::uint32_t> batchOrder(myBatches.size());
+			for (std::uint32_t i = 0; i < batchOrder.size(); ++i)
+				batchOrder[i] = i;
+
+			std::stable_sort(batchOrder.begin(), batchOrder.end(), [&](std::uint32_t aBatch, std::uint32_t anotherBatch) {
+				return pipelineOrder[myBatches[aBatch].PipelineState.get()] < pipelineOrder[myBatches[anotherBatch].PipelineState.get()];
+				});
+
+			std::uint32_t firstSprite = 0;
+			for (std::uint32_t batchIndex : batchOrder)
+			{
+				myBatches[batchIndex].FirstSprite = firstSprite;
+				firstSprite += myBatches[batchIndex].SpriteCount;
+			}
+
+			// A counting sort by batch, which keeps the order sprites were added in within each batch.
+			std::vector<std::uint32_t> nextSprite(myBatches.size());
+			for (std::size_t i = 0; i < myBatches.size(); ++i)
+				nextSprite[i] = myBatches[i].FirstSprite;
+
+			mySortedSprites.resize(mySprites.size());
+			for (std::size_t i = 0; i < mySprites.size(); ++i)
+				mySortedSprites[nextSprite[mySpriteBatches[i]]++] = mySprites[i];
+
+			std::vector<Batch> sortedBatches;
+			sortedBatches.reserve(myBatches.size());
+			for (std::uint32_t batchIndex : batchOrder)
+				sortedBatches.push_back(std::move(myBatches[batchIndex]));
+
+			myBatches = std::move(sortedBatches);
+			sprites = &mySortedSprites;
+		}
+		else
+		{
+			std::uint32_t firstSprite = 0;
+			for (Batch& batch : myBatches)
+			{
+				batch.FirstSprite = firstSprite;
+				firstSprite += batch.SpriteCount;
+			}
+		}
+
+		const std::uint32_t spriteCount = static_cast<std::uint32_t>(sprites->size());
+		if (!mySpriteBuffer || mySpriteBuffer->GetCount() < spriteCount)
+		{
+			if (mySpriteBuffer)
+				myRetiredSpriteBuffers.emplace_back(std::move(mySpriteBuffer), RetiredSpriteBufferLifetime);
+
+			const std::uint32_t bufferCount = std::max(MinSpriteBufferCount, std::bit_ceil(spriteCount));
+			mySpriteBuffer = myGraphicsAPI.GetResourceManager().CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, bufferCount, sizeof(Sprite));
+			if (mySpriteBuffer)
+				mySpriteBuffer->SetName(L"Sprite batch sprites");
+		}
+
+		if (mySpriteBuffer)
+			mySpriteBuffer->SetData(sprites->data(), spriteCount * static_cast<std::uint32_t>(sizeof(Sprite)));
+	}
+}
@@ -0,0 +1,186 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_FrameContext.hpp"
+#include "Atrium_GraphicsAPI.hpp"
+#include "Atrium_GraphicsBuffer.hpp"
+#include "Atrium_GraphicsPipeline.hpp"
+#include "Atrium_Texture.hpp"
+
+#include <rose-common/Color.hpp>
+#include <rose-common/math/Vector.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Collects 2D sprites for a frame and draws them with as few draws as possible.
+	 *        Every sprite is an instance of the MeshPrimitive Quad, which is drawn as a triangle strip from vertex slot 0.
+	 *        The sprites themselves are packed into one large vertex buffer per frame, bound to slot 1 as per-instance data.
+	 *        Sprites sharing a pipeline state, and with it a blend mode, and a texture or atlas are drawn with a single instanced draw.
+	 *
+	 *        Pipelines used with the batch take their input layout from GetInputLayout().
+	 *        The vertex shader places each quad corner with the sprite's position, size, origin and rotation,
+	 *        and maps the quad UVs through the sprite's UV offset and scale.
+	 */
+	class SpriteBatch
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		/**
+		 * @brief How the sprites of a batch are ordered.
+		 */
+		enum class SortMode
+		{
+			// Sprites are drawn in the order they were added. Only consecutive sprites with the same state share a draw.
+			// Use it for overlapping blended sprites, which rely on draw order.
+			Deferred,
+
+			// Sprites are grouped by state, so each pipeline state and texture pair is drawn once.
+			// Sprites within a group keep the order they were added in.
+			Texture
+		};
+
+		/**
+		 * @brief Per-instance data of a sprite, as read from vertex slot 1.
+		 */
+		struct Sprite
+		{
+			// Where the sprite's origin is placed.
+			Vector2<float> Position;
+			Vector2<float> Size { 1.f, 1.f };
+
+			// Point of the sprite that is placed at its position and rotated around, from (0,0) at the top-left to (1,1) at the bottom-right.
+			Vector2<float> Origin;
+
+			// Sub-rectangle of the texture to sample, such as a region of an atlas.
+			Vector2<float> UVOffset;
+			Vector2<float> UVScale { 1.f, 1.f };
+
+			// Clockwise rotation in radians.
+			float Rotation = 0.f;
+			float Depth = 0.f;
+
+			// Packed color, see PackColor().
+			std::uint32_t Color = 0xFFFFFFFF;
+		};
+
+		static constexpr unsigned int QuadInputSlot = 0;
+		static constexpr unsigned int SpriteInputSlot = 1;
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Construction
+		//--------------------------------------------------
+	#pragma region Construction
+
+		/**
+		 * @param aGraphicsAPI Graphics API to create the buffers with.
+		 * @param aTextureRegister Register to bind sprite textures to, with the PerMaterial update frequency.
+		 */
+		SpriteBatch(GraphicsAPI& aGraphicsAPI, std::uint32_t aTextureRegister = 0);
+
+	#pragma endregion
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Get the input layout that pipelines used with the batch need.
+		 *        Slot 0 holds the Quad's vertices and slot 1 the sprites, in the order of their members.
+		 */
+		static std::vector<PipelineStateDescription::InputLayoutEntry> GetInputLayout();
+
+		/**
+		 * @brief Pack a color into a sprite color, read by the input layout as R8G8B8A8_UNorm.
+		 */
+		static std::uint32_t PackColor(const ColorARGB<float>& aColor);
+
+		/**
+		 * @brief Start collecting sprites. Any sprites from the previous batch are removed.
+		 *
+		 * @param aSortMode How the sprites of the batch are ordered.
+		 */
+		void Begin(SortMode aSortMode = SortMode::Deferred);
+
+		/**
+		 * @brief Add a sprite to the batch.
+		 *
+		 * @param aPipelineState Pipeline state to draw the sprite with, which determines its blend mode.
+		 * @param aTexture Texture or atlas to sample.
+		 * @param aSprite Placement, texture region and color of the sprite.
+		 */
+		void Draw(const std::shared_ptr<PipelineState>& aPipelineState, const std::shared_ptr<Texture>& aTexture, const Sprite& aSprite);
+
+		/**
+		 * @brief Upload the sprites of the batch and draw them.
+		 *        The sprites are uploaded to a buffer for the current frame, so a batch can only be ended once per frame.
+		 *        Use separate batches for layers that are drawn separately, such as the world and a HUD on top of it.
+		 *
+		 * @param aContext Context to record the draws to. Render targets and viewport are expected to be set.
+		 */
+		void End(FrameGraphicsContext& aContext);
+
+		std::size_t GetSpriteCount() const { return mySprites.size(); }
+
+		/**
+		 * @brief Get the amount of draws made by the last End().
+		 */
+		std::size_t GetDrawCount() const { return myDrawCount; }
+
+	#pragma endregion
+
+	private:
+		struct Batch
+		{
+			std::shared_ptr<Atrium::PipelineState> PipelineState;
+			std::shared_ptr<Atrium::Texture> Texture;
+			std::uint32_t SpriteCount = 0;
+			std::uint32_t FirstSprite = 0;
+		};
+
+		struct BatchKeyHash
+		{
+			std::size_t operator()(const std::pair<const void*, const void*>& aKey) const;
+		};
+
+		std::uint32_t FindOrAddBatch(const std::shared_ptr<PipelineState>& aPipelineState, const std::shared_ptr<Texture>& aTexture);
+		void Upload();
+
+		GraphicsAPI& myGraphicsAPI;
+		std::uint32_t myTextureRegister;
+
+		SortMode mySortMode;
+		std::vector<Sprite> mySprites;
+		std::vector<Batch> myBatches;
+
+		// Only used when sorting by texture, to group the sprites by batch when uploading.
+		std::vector<std::uint32_t> mySpriteBatches;
+		std::vector<Sprite> mySortedSprites;
+		std::unordered_map<std::pair<const void*, const void*>, std::uint32_t, BatchKeyHash> myBatchLookup;
+
+		std::shared_ptr<GraphicsBuffer> myQuadBuffer;
+
+		// Replaced buffers may still be read by frames in flight, so they're kept for a few frames.
+		std::shared_ptr<GraphicsBuffer> mySpriteBuffer;
+		std::vector<std::pair<std::shared_ptr<GraphicsBuffer>, std::uint32_t>> myRetiredSpriteBuffers;
+
+		std::uint_least64_t myLastUploadFrame;
+		std::size_t myDrawCount;
+		bool myIsCollecting;
+	};
+}
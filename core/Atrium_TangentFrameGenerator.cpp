@@ -0,0 +1,431 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_SIMD.hpp"
+#include "Atrium_TangentFrameGenerator.hpp"
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Below this many triangles or vertices, handing ranges to workers costs more than working on one.
+		constexpr std::size_t ParallelThreshold = 32768;
+		constexpr unsigned int MaxThreads = 8;
+
+		constexpr float MinLengthSquared = 1e-20f;
+
+		// Abramowitz and Stegun 4.4.45, accurate to within 7e-5 radians, which is plenty for weighting.
+		constexpr float AcosCoefficient0 = 1.5707288f;
+		constexpr float AcosCoefficient1 = -0.2121144f;
+		constexpr float AcosCoefficient2 = 0.0742610f;
+		constexpr float AcosCoefficient3 = -0.0187293f;
+
+	#if !ATRIUM_SIMD_SSE
+		float ApproximateAcos(float aCosine)
+		{
+			const float x = std::min(std::abs(aCosine), 1.f);
+			const float angle = std::sqrt(1.f - x) * (AcosCoefficient0 + x * (AcosCoefficient1 + x * (AcosCoefficient2 + x * AcosCoefficient3)));
+			return aCosine < 0.f ? Atrium::TwoPi * 0.5f - angle : angle;
+		}
+
+		/**
+		 * @brief Get the angle at each corner of a triangle.
+		 *
+		 * @return False if the triangle has no area.
+		 */
+		bool GetCornerAngles(const std::array<Vector3<float>, 3>& somePositions, std::array<float, 3>& someAnglesOut)
+		{
+			std::array<Vector3<float>, 3> edges;
+			std::array<float, 3> lengths;
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				edges[i] = somePositions[(i + 1) % 3] - somePositions[i];
+				lengths[i] = std::sqrt(Vector3<float>::Dot(edges[i], edges[i]));
+				if (lengths[i] * lengths[i] <= MinLengthSquared)
+					return false;
+			}
+
+			// The corner at each vertex is between the edge leaving it and the reversed edge arriving at it.
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				const std::size_t previous = (i + 2) % 3;
+				someAnglesOut[i] = ApproximateAcos(-Vector3<float>::Dot(edges[i], edges[previous]) / (lengths[i] * lengths[previous]));
+			}
+
+			return true;
+		}
+	#endif
+
+		Vector3<float> GetPerpendicular(const Vector3<float>& aNormal)
+		{
+			// Crossing with the axis least aligned with the normal gives the most stable result.
+			const float x = std::abs(aNormal.X);
+			const float y = std::abs(aNormal.Y);
+			const float z = std::abs(aNormal.Z);
+			const Vector3<float> axis = (x <= y && x <= z) ? Vector3<float>(1, 0, 0) : (y <= z ? Vector3<float>(0, 1, 0) : Vector3<float>(0, 0, 1));
+			return Vector3<float>::Cross(aNormal, axis).Normalized();
+		}
+
+	#if ATRIUM_SIMD_SSE
+		using namespace SIMD;
+
+		// The reciprocal of a length, or zero for lanes too short to have a direction.
+		__m128 InverseLength(__m128 aLengthSquared)
+		{
+			const __m128 isLong = _mm_cmpgt_ps(aLengthSquared, _mm_set1_ps(MinLengthSquared));
+			return _mm_and_ps(isLong, _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(_mm_max_ps(aLengthSquared, _mm_set1_ps(MinLengthSquared)))));
+		}
+
+		__m128 ApproximateAcos(__m128 someCosines)
+		{
+			const __m128 signMask = _mm_set1_ps(-0.f);
+			const __m128 x = _mm_min_ps(_mm_andnot_ps(signMask, someCosines), _mm_set1_ps(1.f));
+
+			__m128 polynomial = _mm_add_ps(_mm_set1_ps(AcosCoefficient2), _mm_mul_ps(x, _mm_set1_ps(AcosCoefficient3)));
+			polynomial = _mm_add_ps(_mm_set1_ps(AcosCoefficient1), _mm_mul_ps(x, polynomial));
+			polynomial = _mm_add_ps(_mm_set1_ps(AcosCoefficient0), _mm_mul_ps(x, polynomial));
+			const __m128 angle = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.f), x)), polynomial);
+
+			const __m128 isNegative = _mm_cmplt_ps(someCosines, _mm_setzero_ps());
+			const __m128 mirrored = _mm_sub_ps(_mm_set1_ps(Atrium::TwoPi * 0.5f), angle);
+			return _mm_or_ps(_mm_and_ps(isNegative, mirrored), _mm_andnot_ps(isNegative, angle));
+		}
+
+		/**
+		 * @brief Get the angle at each corner of four triangles, or zero for triangles without area.
+		 */
+		std::array<__m128, 3> GetCornerAngles(const std::array<Lanes3, 3>& somePositions)
+		{
+			std::array<Lanes3, 3> edges;
+			std::array<__m128, 3> inverseLengths;
+			__m128 hasArea = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				edges[i] = Subtract(somePositions[(i + 1) % 3], somePositions[i]);
+				const __m128 lengthSquared = Dot(edges[i], edges[i]);
+				inverseLengths[i] = InverseLength(lengthSquared);
+				hasArea = _mm_and_ps(hasArea, _mm_cmpgt_ps(lengthSquared, _mm_set1_ps(MinLengthSquared)));
+			}
+
+			std::array<__m128, 3> angles;
+			for (std::size_t i = 0; i < 3; ++i)
+			{
+				const std::size_t previous = (i + 2) % 3;
+				const __m128 cosine = _mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), Dot(edges[i], edges[previous])), _mm_mul_ps(inverseLengths[i], inverseLengths[previous]));
+				angles[i] = _mm_and_ps(hasArea, ApproximateAcos(cosine));
+			}
+
+			return angles;
+		}
+
+		Lanes3 GatherPositions(std::span<const MeshPrimitive::Vertex> someVertices, const std::uint32_t* someIndices)
+		{
+			const Vector3<float>& a = someVertices[someIndices[0]].Position;
+			const Vector3<float>& b = someVertices[someIndices[1]].Position;
+			const Vector3<float>& c = someVertices[someIndices[2]].Position;
+			const Vector3<float>& d = someVertices[someIndices[3]].Position;
+			return { _mm_setr_ps(a.X, b.X, c.X, d.X), _mm_setr_ps(a.Y, b.Y, c.Y, d.Y), _mm_setr_ps(a.Z, b.Z, c.Z, d.Z) };
+		}
+
+		Lanes3 GatherNormals(std::span<const MeshPrimitive::Vertex> someVertices, const std::uint32_t* someIndices)
+		{
+			const Vector3<float>& a = someVertices[someIndices[0]].Normal;
+			const Vector3<float>& b = someVertices[someIndices[1]].Normal;
+			const Vector3<float>& c = someVertices[someIndices[2]].Normal;
+			const Vector3<float>& d = someVertices[someIndices[3]].Normal;
+			return { _mm_setr_ps(a.X, b.X, c.X, d.X), _mm_setr_ps(a.Y, b.Y, c.Y, d.Y), _mm_setr_ps(a.Z, b.Z, c.Z, d.Z) };
+		}
+
+		std::array<__m128, 2> GatherUVs(std::span<const MeshPrimitive::Vertex> someVertices, const std::uint32_t* someIndices)
+		{
+			const Vector2<float>& a = someVertices[someIndices[0]].UV;
+			const Vector2<float>& b = someVertices[someIndices[1]].UV;
+			const Vector2<float>& c = someVertices[someIndices[2]].UV;
+			const Vector2<float>& d = someVertices[someIndices[3]].UV;
+			return { _mm_setr_ps(a.X, b.X, c.X, d.X), _mm_setr_ps(a.Y, b.Y, c.Y, d.Y) };
+		}
+	#endif
+	}
+
+	void TangentFrameGenerator::SetTopology(std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aVertexCount)
+	{
+		PROFILE_SCOPE();
+
+		const std::size_t triangleCount = someTriangles.size();
+		for (const MeshPrimitive::Triangle& triangle : someTriangles)
+		{
+			if (!Debug::Verify(triangle.V1 < aVertexCount && triangle.V2 < aVertexCount && triangle.V3 < aVertexCount, "Triangle indices are below the vertex count of %zu.", aVertexCount))
+			{
+				// Leaves no topology, so calculating frames for any vertices fails the vertex count check.
+				for (std::vector<std::uint32_t>& indices : myIndices)
+					indices.clear();
+
+				myVertexCount = 0;
+				myVertexCornerOffsets.assign(1, 0);
+				myVertexCorners.clear();
+				return;
+			}
+		}
+
+		// Corner arrays are padded to whole groups of four, with the padding repeating the last triangle.
+		const std::size_t paddedCount = (triangleCount + 3) & ~std::size_t(3);
+		for (std::vector<std::uint32_t>& indices : myIndices)
+			indices.resize(paddedCount);
+
+		for (std::size_t i = 0; i < paddedCount; ++i)
+		{
+			const MeshPrimitive::Triangle& triangle = someTriangles[std::min(i, triangleCount - 1)];
+			myIndices[0][i] = triangle.V1;
+			myIndices[1][i] = triangle.V2;
+			myIndices[2][i] = triangle.V3;
+		}
+
+		myVertexCount = aVertexCount;
+
+		// Counting sort of the corners by vertex.
+		myVertexCornerOffsets.assign(aVertexCount + 1, 0);
+		for (std::size_t corner = 0; corner < 3; ++corner)
+		{
+			for (std::size_t i = 0; i < triangleCount; ++i)
+				++myVertexCornerOffsets[myIndices[corner][i] + 1];
+		}
+
+		for (std::size_t i = 0; i < aVertexCount; ++i)
+			myVertexCornerOffsets[i + 1] += myVertexCornerOffsets[i];
+
+		myVertexCorners.resize(triangleCount * 3);
+		std::vector<std::uint32_t> nextCorner(myVertexCornerOffsets.begin(), myVertexCornerOffsets.end() - 1);
+		for (std::size_t corner = 0; corner < 3; ++corner)
+		{
+			for (std::size_t i = 0; i < triangleCount; ++i)
+				myVertexCorners[nextCorner[myIndices[corner][i]]++] = static_cast<std::uint32_t>(corner * paddedCount + i);
+		}
+
+		for (std::vector<float>& values : myCornerValues)
+			values.resize(paddedCount * 3);
+	}
+
+	void TangentFrameGenerator::CalculateNormals(std::span<MeshPrimitive::Vertex> someVertices)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someVertices.size() == myVertexCount, "The vertices match the topology that was set."))
+			return;
+
+		ForEachRange(myIndices[0].size(), [&](std::size_t aBegin, std::size_t anEnd) { CalculateCornerNormals(someVertices, aBegin, anEnd); });
+
+		ForEachRange(myVertexCount, [&](std::size_t aBegin, std::size_t anEnd) {
+			for (std::size_t i = aBegin; i < anEnd; ++i)
+			{
+				Vector3<float> normal;
+				for (std::uint32_t j = myVertexCornerOffsets[i]; j < myVertexCornerOffsets[i + 1]; ++j)
+				{
+					const std::uint32_t corner = myVertexCorners[j];
+					normal += Vector3<float>(myCornerValues[0][corner], myCornerValues[1][corner], myCornerValues[2][corner]);
+				}
+
+				if (Vector3<float>::Dot(normal, normal) > MinLengthSquared)
+					someVertices[i].Normal = normal.Normalized();
+			}
+			});
+	}
+
+	void TangentFrameGenerator::CalculateTangents(std::span<MeshPrimitive::Vertex> someVertices)
+	{
+		PROFILE_SCOPE();
+
+		if (!Debug::Verify(someVertices.size() == myVertexCount, "The vertices match the topology that was set."))
+			return;
+
+		ForEachRange(myIndices[0].size(), [&](std::size_t aBegin, std::size_t anEnd) { CalculateCornerTangents(someVertices, aBegin, anEnd); });
+
+		ForEachRange(myVertexCount, [&](std::size_t aBegin, std::size_t anEnd) {
+			for (std::size_t i = aBegin; i < anEnd; ++i)
+			{
+				Vector3<float> tangent;
+				Vector3<float> binormal;
+				for (std::uint32_t j = myVertexCornerOffsets[i]; j < myVertexCornerOffsets[i + 1]; ++j)
+				{
+					const std::uint32_t corner = myVertexCorners[j];
+					tangent += Vector3<float>(myCornerValues[0][corner], myCornerValues[1][corner], myCornerValues[2][corner]);
+					binormal += Vector3<float>(myCornerValues[3][corner], myCornerValues[4][corner], myCornerValues[5][corner]);
+				}
+
+				MeshPrimitive::Vertex& vertex = someVertices[i];
+				vertex.Tangent = Vector3<float>::Dot(tangent, tangent) > MinLengthSquared ? tangent.Normalized() : GetPerpendicular(vertex.Normal);
+
+				// The binormal is perpendicular to both, pointing the way the texture's V coordinate increases.
+				const Vector3<float> crossed = Vector3<float>::Cross(vertex.Normal, vertex.Tangent);
+				vertex.Binormal = Vector3<float>::Dot(crossed, binormal) < 0.f ? crossed * -1.f : crossed;
+			}
+			});
+	}
+
+	void TangentFrameGenerator::Calculate(std::span<MeshPrimitive::Vertex> someVertices)
+	{
+		CalculateNormals(someVertices);
+		CalculateTangents(someVertices);
+	}
+
+	void TangentFrameGenerator::CalculateCornerNormals(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aBegin, std::size_t anEnd)
+	{
+		const std::size_t paddedCount = myIndices[0].size();
+
+	#if ATRIUM_SIMD_SSE
+		for (std::size_t i = aBegin; i < anEnd; i += 4)
+		{
+			std::array<Lanes3, 3> positions;
+			for (std::size_t corner = 0; corner < 3; ++corner)
+				positions[corner] = GatherPositions(someVertices, &myIndices[corner][i]);
+
+			const Lanes3 normal = Cross(Subtract(positions[1], positions[0]), Subtract(positions[2], positions[0]));
+			const Lanes3 unitNormal = Scale(normal, InverseLength(Dot(normal, normal)));
+			const std::array<__m128, 3> angles = GetCornerAngles(positions);
+
+			for (std::size_t corner = 0; corner < 3; ++corner)
+			{
+				const std::size_t offset = corner * paddedCount + i;
+				_mm_storeu_ps(&myCornerValues[0][offset], _mm_mul_ps(unitNormal[0], angles[corner]));
+				_mm_storeu_ps(&myCornerValues[1][offset], _mm_mul_ps(unitNormal[1], angles[corner]));
+				_mm_storeu_ps(&myCornerValues[2][offset], _mm_mul_ps(unitNormal[2], angles[corner]));
+			}
+		}
+	#else
+		for (std::size_t i = aBegin; i < anEnd; ++i)
+		{
+			const std::array<Vector3<float>, 3> positions = {
+				someVertices[myIndices[0][i]].Position,
+				someVertices[myIndices[1][i]].Position,
+				someVertices[myIndices[2][i]].Position
+			};
+
+			std::array<float, 3> angles = { 0.f, 0.f, 0.f };
+			Vector3<float> normal = Vector3<float>::Cross(positions[1] - positions[0], positions[2] - positions[0]);
+			if (Vector3<float>::Dot(normal, normal) > MinLengthSquared && GetCornerAngles(positions, angles))
+				normal = normal.Normalized();
+
+			for (std::size_t corner = 0; corner < 3; ++corner)
+			{
+				const std::size_t offset = corner * paddedCount + i;
+				myCornerValues[0][offset] = normal.X * angles[corner];
+				myCornerValues[1][offset] = normal.Y * angles[corner];
+				myCornerValues[2][offset] = normal.Z * angles[corner];
+			}
+		}
+	#endif
+	}
+
+	void TangentFrameGenerator::CalculateCornerTangents(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aBegin, std::size_t anEnd)
+	{
+		const std::size_t paddedCount = myIndices[0].size();
+
+	#if ATRIUM_SIMD_SSE
+		for (std::size_t i = aBegin; i < anEnd; i += 4)
+		{
+			std::array<Lanes3, 3> positions;
+			std::array<std::array<__m128, 2>, 3> uvs;
+			for (std::size_t corner = 0; corner < 3; ++corner)
+			{
+				positions[corner] = GatherPositions(someVertices, &myIndices[corner][i]);
+				uvs[corner] = GatherUVs(someVertices, &myIndices[corner][i]);
+			}
+
+			const Lanes3 edge1 = Subtract(positions[1], positions[0]);
+			const Lanes3 edge2 = Subtract(positions[2], positions[0]);
+			const __m128 du1 = _mm_sub_ps(uvs[1][0], uvs[0][0]);
+			const __m128 dv1 = _mm_sub_ps(uvs[1][1], uvs[0][1]);
+			const __m128 du2 = _mm_sub_ps(uvs[2][0], uvs[0][0]);
+			const __m128 dv2 = _mm_sub_ps(uvs[2][1], uvs[0][1]);
+
+			// The texture-space directions, flipped for mirrored texture coordinates so they still point the way U and V increase.
+			const __m128 signedArea = _mm_sub_ps(_mm_mul_ps(du1, dv2), _mm_mul_ps(du2, dv1));
+			const __m128 sign = _mm_or_ps(_mm_and_ps(signedArea, _mm_set1_ps(-0.f)), _mm_set1_ps(1.f));
+			const Lanes3 faceTangent = Scale(Subtract(Scale(edge1, dv2), Scale(edge2, dv1)), sign);
+			const Lanes3 faceBinormal = Scale(Subtract(Scale(edge2, du1), Scale(edge1, du2)), sign);
+
+			const std::array<__m128, 3> angles = GetCornerAngles(positions);
+
+			for (std::size_t corner = 0; corner < 3; ++corner)
+			{
+				// Projected onto the plane of the vertex's normal, so corners with different normals still agree.
+				const Lanes3 normal = GatherNormals(someVertices, &myIndices[corner][i]);
+				const Lanes3 tangent = Subtract(faceTangent, Scale(normal, Dot(normal, faceTangent)));
+				const Lanes3 binormal = Subtract(faceBinormal, Scale(normal, Dot(normal, faceBinormal)));
+				const Lanes3 weightedTangent = Scale(tangent, _mm_mul_ps(InverseLength(Dot(tangent, tangent)), angles[corner]));
+				const Lanes3 weightedBinormal = Scale(binormal, _mm_mul_ps(InverseLength(Dot(binormal, binormal)), angles[corner]));
+
+				const std::size_t offset = corner * paddedCount + i;
+				for (std::size_t axis = 0; axis < 3; ++axis)
+				{
+					_mm_storeu_ps(&myCornerValues[axis][offset], weightedTangent[axis]);
+					_mm_storeu_ps(&myCornerValues[3 + axis][offset], weightedBinormal[axis]);
+				}
+			}
+		}
+	#else
+		for (std::size_t i = aBegin; i < anEnd; ++i)
+		{
+			std::array<const MeshPrimitive::Vertex*, 3> vertices;
+			for (std::size_t corner = 0; corner < 3; ++corner)
+				vertices[corner] = &someVertices[myIndices[corner][i]];
+
+			const Vector3<float> edge1 = vertices[1]->Position - vertices[0]->Position;
+			const Vector3<float> edge2 = vertices[2]->Position - vertices[0]->Position;
+			const float du1 = vertices[1]->UV.X - vertices[0]->UV.X;
+			const float dv1 = vertices[1]->UV.Y - vertices[0]->UV.Y;
+			const float du2 = vertices[2]->UV.X - vertices[0]->UV.X;
+			const float dv2 = vertices[2]->UV.Y - vertices[0]->UV.Y;
+
+			const float sign = (du1 * dv2 - du2 * dv1) < 0.f ? -1.f : 1.f;
+			const Vector3<float> faceTangent = (edge1 * dv2 - edge2 * dv1) * sign;
+			const Vector3<float> faceBinormal = (edge2 * du1 - edge1 * du2) * sign;
+
+			std::array<float, 3> angles = { 0.f, 0.f, 0.f };
+			GetCornerAngles({ vertices[0]->Position, vertices[1]->Position, vertices[2]->Position }, angles);
+
+			for (std::size_t corner = 0; corner < 3; ++corner)
+			{
+				const Vector3<float>& normal = vertices[corner]->Normal;
+				Vector3<float> tangent = faceTangent - normal * Vector3<float>::Dot(normal, faceTangent);
+				Vector3<float> binormal = faceBinormal - normal * Vector3<float>::Dot(normal, faceBinormal);
+				tangent = Vector3<float>::Dot(tangent, tangent) > MinLengthSquared ? tangent.Normalized() * angles[corner] : Vector3<float>();
+				binormal = Vector3<float>::Dot(binormal, binormal) > MinLengthSquared ? binormal.Normalized() * angles[corner] : Vector3<float>();
+
+				const std::size_t offset = corner * paddedCount + i;
+				myCornerValues[0][offset] = tangent.X;
+				myCornerValues[1][offset] = tangent.Y;
+				myCornerValues[2][offset] = tangent.Z;
+				myCornerValues[3][offset] = binormal.X;
+				myCornerValues[4][offset] = binormal.Y;
+				myCornerValues[5][offset] = binormal.Z;
+			}
+		}
+	#endif
+	}
+
+	template <typename Function>
+	void TangentFrameGenerator::ForEachRange(std::size_t aCount, Function&& aFunction) const
+	{
+		WorkerPool& workerPool = WorkerPool::Get();
+		const unsigned int threadCount = aCount < ParallelThreshold ? 1 : std::min(workerPool.GetThreadCount(), MaxThreads);
+		if (threadCount == 1)
+		{
+			aFunction(std::size_t(0), aCount);
+			return;
+		}
+
+		// Ranges start on groups of four, so the SIMD loops of different threads never share a group.
+		const std::size_t countPerThread = ((aCount + threadCount - 1) / threadCount + 3) & ~std::size_t(3);
+
+		workerPool.ParallelFor(threadCount, [&](std::size_t aRange) {
+			const std::size_t begin = std::min(aCount, countPerThread * aRange);
+			const std::size_t end = std::min(aCount, begin + countPerThread);
+			if (begin < end)
+				aFunction(begin, end);
+			});
+	}
+}
@@ -0,0 +1,84 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_MeshPrimitives.hpp"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Calculates smooth normals, and tangents and binormals following the texture coordinates, for meshes of any size.
+	 *
+	 *        Normals are the average of the surrounding triangles' normals, weighted by the angle of each triangle's corner at the vertex.
+	 *        Tangent frames follow MikkTSpace: each triangle's texture-space tangent is projected onto the vertex's normal plane,
+	 *        weighted by the corner angle, and the binormal's handedness comes from the triangles' texture orientation.
+	 *        Results match MikkTSpace for meshes whose vertices are already split along texture seams and mirrored texture coordinates,
+	 *        as vertices are never split here.
+	 *
+	 *        Triangles are processed four at a time with SIMD, and both triangles and vertices are split over threads for large meshes.
+	 *        The topology is kept between calls, so deforming meshes only pay for it once.
+	 */
+	class TangentFrameGenerator
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Set the triangles of the meshes to calculate frames for, and find the triangle corners at each vertex.
+		 *
+		 * @param someTriangles Triangles of the mesh.
+		 * @param aVertexCount Number of vertices the triangles index.
+		 */
+		void SetTopology(std::span<const MeshPrimitive::Triangle> someTriangles, std::size_t aVertexCount);
+
+		/**
+		 * @brief Calculate the normals of the vertices from their positions.
+		 *        Vertices that no triangle uses, or that only degenerate triangles use, keep their normal.
+		 *
+		 * @param someVertices Vertices of a mesh with the topology set last.
+		 */
+		void CalculateNormals(std::span<MeshPrimitive::Vertex> someVertices);
+
+		/**
+		 * @brief Calculate the tangents and binormals of the vertices from their positions, normals and texture coordinates.
+		 *        Where the texture coordinates don't define a direction, the tangent is any direction perpendicular to the normal.
+		 *
+		 * @param someVertices Vertices of a mesh with the topology set last.
+		 */
+		void CalculateTangents(std::span<MeshPrimitive::Vertex> someVertices);
+
+		/**
+		 * @brief Calculate normals, then tangents and binormals.
+		 */
+		void Calculate(std::span<MeshPrimitive::Vertex> someVertices);
+
+	#pragma endregion
+
+	private:
+		void CalculateCornerNormals(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aBegin, std::size_t anEnd);
+		void CalculateCornerTangents(std::span<const MeshPrimitive::Vertex> someVertices, std::size_t aBegin, std::size_t anEnd);
+
+		template <typename Function>
+		void ForEachRange(std::size_t aCount, Function&& aFunction) const;
+
+		// Vertex indices of each corner of each triangle, by corner then triangle.
+		std::array<std::vector<std::uint32_t>, 3> myIndices;
+		std::size_t myVertexCount = 0;
+
+		// The corners at each vertex, as offsets into myVertexCorners, which holds the indices into the corner values.
+		std::vector<std::uint32_t> myVertexCornerOffsets;
+		std::vector<std::uint32_t> myVertexCorners;
+
+		// Weighted vectors of each corner, by corner then triangle: the normal, or the tangent then the binormal.
+		std::array<std::vector<float>, 6> myCornerValues;
+	};
+}
@@ -6,8 +6,26 @@
 
 #include "Atrium_GraphicsEnums.hpp"
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
 namespace Atrium
 {
+	/**
+	 * @brief A box of pixels within one mip level of a texture.
+	 */
+	struct TextureRegion
+	{
+		unsigned int X = 0;
+		unsigned int Y = 0;
+		unsigned int Z = 0;
+
+		unsigned int Width = 0;
+		unsigned int Height = 0;
+		unsigned int Depth = 1;
+	};
+
 	class Texture
 	{
 	public:
@@ -20,6 +38,43 @@ namespace Atrium
 		virtual unsigned int GetMipmapCount() const = 0;
 		virtual unsigned int GetWidth() const = 0;
 
+		/**
+		 * @brief Get the texture's index in the bindless resource table, for shaders using bindless tables.
+		 *        The index is available from creation and stays the same for the texture's whole lifetime.
+		 *
+		 * @return The index, or nothing if the API or texture type has no bindless support.
+		 */
+		virtual std::optional<std::uint32_t> GetBindlessIndex() const = 0;
+
+		/**
+		 * @brief Write pixels into a readable texture's CPU-side copy, such as one made with ResourceManager::CreateTexture().
+		 *        The region is remembered as dirty until the next ApplyDirtyRegions() or Apply().
+		 *
+		 * @param someData Pixels in the texture's format, rows of aRegion.Width pixels.
+		 * @param aRowPitch Bytes between the starts of two rows of someData. Depth slices follow each other every aRegion.Height rows.
+		 * @param aRegion The region to write, within the mip level.
+		 * @param aMipLevel Mip level to write to.
+		 * @param anArrayIndex Array slice, or cube face, to write to.
+		 * @return Whether the pixels were written. Textures that aren't readable, like render textures, and block-compressed textures can't be written to.
+		 */
+		virtual bool SetPixels(const void* someData, std::size_t aRowPitch, const TextureRegion& aRegion, unsigned int aMipLevel = 0, unsigned int anArrayIndex = 0) = 0;
+
+		/**
+		 * @brief Upload the whole texture from its CPU-side copy, recreating its GPU resource.
+		 *
+		 * @param anUpdateMipmaps Whether to regenerate all the mip levels from the top one first.
+		 * @param aMakeNoLongerReadable Whether to free the CPU-side copy after uploading it.
+		 */
+		virtual void Apply(bool anUpdateMipmaps, bool aMakeNoLongerReadable) = 0;
+
+		/**
+		 * @brief Upload only the regions written with SetPixels() since the last upload, into the existing GPU resource.
+		 *        Textures that were never applied are uploaded whole.
+		 *
+		 * @param anUpdateMipmaps Whether to regenerate the lower mip levels under the regions written to the top one, and upload those as well.
+		 */
+		virtual void ApplyDirtyRegions(bool anUpdateMipmaps) = 0;
+
 		/// <summary>
 		/// Gives a pointer to the native texture resource of the underlying graphics API.
 		/// Ex.
@@ -0,0 +1,228 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Atrium
+{
+	TlsfAllocator::TlsfAllocator(std::uint32_t aCapacity)
+		: myFirstLevelBitmap(0)
+		, mySecondLevelBitmaps()
+		, myCapacity(aCapacity)
+		, myUsedSize(0)
+		, myAllocationCount(0)
+	{
+		for (std::array<std::uint32_t, SecondLevelCount>& freeLists : myFreeLists)
+			freeLists.fill(InvalidBlock);
+
+		if (aCapacity == 0)
+			return;
+
+		const std::uint32_t block = CreateBlock();
+		myBlocks[block].Size = aCapacity;
+		InsertFree(block);
+	}
+
+	std::optional<TlsfAllocator::Allocation> TlsfAllocator::Allocate(std::uint32_t aSize)
+	{
+		const std::uint32_t size = std::max(aSize, 1u);
+
+		std::uint32_t block = InvalidBlock;
+		if (const std::optional<SizeClass> searchClass = GetSizeClassToSearch(size))
+		{
+			if (const std::optional<SizeClass> freeClass = FindFreeClass(*searchClass))
+				block = myFreeLists[freeClass->FirstLevel][freeClass->SecondLevel];
+		}
+
+		// The size's own class can still hold a large enough block, which the rounded search skips, such as when
+		// allocating all that's left. Only the head of its list is checked, as walking the list wouldn't take constant time.
+		if (block == InvalidBlock)
+		{
+			const SizeClass sizeClass = GetSizeClass(size);
+			const std::uint32_t candidate = myFreeLists[sizeClass.FirstLevel][sizeClass.SecondLevel];
+			if (candidate == InvalidBlock || myBlocks[candidate].Size < size)
+				return { };
+
+			block = candidate;
+		}
+
+		RemoveFree(block);
+
+		// Split off what's left of the block as a new free block.
+		if (myBlocks[block].Size > size)
+		{
+			const std::uint32_t remainder = CreateBlock();
+			Block& allocated = myBlocks[block];
+			Block& rest = myBlocks[remainder];
+
+			rest.Offset = allocated.Offset + size;
+			rest.Size = allocated.Size - size;
+			rest.PreviousPhysical = block;
+			rest.NextPhysical = allocated.NextPhysical;
+			if (rest.NextPhysical != InvalidBlock)
+				myBlocks[rest.NextPhysical].PreviousPhysical = remainder;
+
+			allocated.Size = size;
+			allocated.NextPhysical = remainder;
+			InsertFree(remainder);
+		}
+
+		myUsedSize += size;
+		++myAllocationCount;
+
+		return Allocation { myBlocks[block].Offset, size, block };
+	}
+
+	void TlsfAllocator::Free(const Allocation& anAllocation)
+	{
+		if (!Debug::Verify(anAllocation.Block < myBlocks.size() && !myBlocks[anAllocation.Block].IsFree && myBlocks[anAllocation.Block].Offset == anAllocation.Offset, "The allocation belongs to the allocator and wasn't freed yet."))
+			return;
+
+		std::uint32_t block = anAllocation.Block;
+		myUsedSize -= myBlocks[block].Size;
+		--myAllocationCount;
+
+		const std::uint32_t next = myBlocks[block].NextPhysical;
+		if (next != InvalidBlock && myBlocks[next].IsFree)
+		{
+			RemoveFree(next);
+			MergeInto(block, next);
+		}
+
+		const std::uint32_t previous = myBlocks[block].PreviousPhysical;
+		if (previous != InvalidBlock && myBlocks[previous].IsFree)
+		{
+			RemoveFree(previous);
+			MergeInto(previous, block);
+			block = previous;
+		}
+
+		InsertFree(block);
+	}
+
+	std::uint32_t TlsfAllocator::GetLargestGuaranteedSize() const
+	{
+		if (myFirstLevelBitmap == 0)
+			return 0;
+
+		const std::uint32_t firstLevel = std::bit_width(myFirstLevelBitmap) - 1;
+		const std::uint32_t secondLevel = std::bit_width(mySecondLevelBitmaps[firstLevel]) - 1;
+		if (firstLevel == 0)
+			return secondLevel;
+
+		return (SecondLevelCount + secondLevel) << (firstLevel - 1);
+	}
+
+	TlsfAllocator::SizeClass TlsfAllocator::GetSizeClass(std::uint32_t aSize)
+	{
+		if (aSize < SecondLevelCount)
+			return SizeClass { 0, aSize };
+
+		// Sizes from 2^n up to 2^(n+1) share a first level, split into linear steps by the bits below the highest.
+		const std::uint32_t highestBit = std::bit_width(aSize) - 1;
+		return SizeClass { highestBit - SecondLevelLog2 + 1, (aSize >> (highestBit - SecondLevelLog2)) - SecondLevelCount };
+	}
+
+	std::optional<TlsfAllocator::SizeClass> TlsfAllocator::GetSizeClassToSearch(std::uint32_t aSize)
+	{
+		if (aSize < SecondLevelCount)
+			return GetSizeClass(aSize);
+
+		// Rounding up to the next class means any block in the class found is large enough, without checking its size.
+		const std::uint32_t highestBit = std::bit_width(aSize) - 1;
+		const std::uint64_t rounded = static_cast<std::uint64_t>(aSize) + (1ull << (highestBit - SecondLevelLog2)) - 1;
+		if (rounded > std::numeric_limits<std::uint32_t>::max())
+			return { };
+
+		return GetSizeClass(static_cast<std::uint32_t>(rounded));
+	}
+
+	std::optional<TlsfAllocator::SizeClass> TlsfAllocator::FindFreeClass(SizeClass aMinimumClass) const
+	{
+		const std::uint32_t secondLevelBitmap = mySecondLevelBitmaps[aMinimumClass.FirstLevel] & (~0u << aMinimumClass.SecondLevel);
+		if (secondLevelBitmap != 0)
+			return SizeClass { aMinimumClass.FirstLevel, static_cast<std::uint32_t>(std::countr_zero(secondLevelBitmap)) };
+
+		const std::uint32_t firstLevelBitmap = aMinimumClass.FirstLevel + 1 < 32 ? myFirstLevelBitmap & (~0u << (aMinimumClass.FirstLevel + 1)) : 0;
+		if (firstLevelBitmap == 0)
+			return { };
+
+		const std::uint32_t firstLevel = std::countr_zero(firstLevelBitmap);
+		return SizeClass { firstLevel, static_cast<std::uint32_t>(std::countr_zero(mySecondLevelBitmaps[firstLevel])) };
+	}
+
+	std::uint32_t TlsfAllocator::CreateBlock()
+	{
+		if (myUnusedBlocks.empty())
+		{
+			myBlocks.emplace_back();
+			return static_cast<std::uint32_t>(myBlocks.size() - 1);
+		}
+
+		const std::uint32_t block = myUnusedBlocks.back();
+		myUnusedBlocks.pop_back();
+		myBlocks[block] = Block();
+		return block;
+	}
+
+	void TlsfAllocator::InsertFree(std::uint32_t aBlock)
+	{
+		Block& block = myBlocks[aBlock];
+		const SizeClass sizeClass = GetSizeClass(block.Size);
+		std::uint32_t& head = myFreeLists[sizeClass.FirstLevel][sizeClass.SecondLevel];
+
+		block.IsFree = true;
+		block.PreviousFree = InvalidBlock;
+		block.NextFree = head;
+		if (head != InvalidBlock)
+			myBlocks[head].PreviousFree = aBlock;
+		head = aBlock;
+
+		myFirstLevelBitmap |= 1u << sizeClass.FirstLevel;
+		mySecondLevelBitmaps[sizeClass.FirstLevel] |= 1u << sizeClass.SecondLevel;
+	}
+
+	void TlsfAllocator::RemoveFree(std::uint32_t aBlock)
+	{
+		Block& block = myBlocks[aBlock];
+		const SizeClass sizeClass = GetSizeClass(block.Size);
+		std::uint32_t& head = myFreeLists[sizeClass.FirstLevel][sizeClass.SecondLevel];
+
+		if (block.PreviousFree != InvalidBlock)
+			myBlocks[block.PreviousFree].NextFree = block.NextFree;
+		else
+			head = block.NextFree;
+
+		if (block.NextFree != InvalidBlock)
+			myBlocks[block.NextFree].PreviousFree = block.PreviousFree;
+
+		block.IsFree = false;
+		block.PreviousFree = InvalidBlock;
+		block.NextFree = InvalidBlock;
+
+		if (head == InvalidBlock)
+		{
+			mySecondLevelBitmaps[sizeClass.FirstLevel] &= ~(1u << sizeClass.SecondLevel);
+			if (mySecondLevelBitmaps[sizeClass.FirstLevel] == 0)
+				myFirstLevelBitmap &= ~(1u << sizeClass.FirstLevel);
+		}
+	}
+
+	void TlsfAllocator::MergeInto(std::uint32_t aBlock, std::uint32_t aNextBlock)
+	{
+		Block& block = myBlocks[aBlock];
+		const Block& next = myBlocks[aNextBlock];
+
+		block.Size += next.Size;
+		block.NextPhysical = next.NextPhysical;
+		if (block.NextPhysical != InvalidBlock)
+			myBlocks[block.NextPhysical].PreviousPhysical = aBlock;
+
+		myBlocks[aNextBlock] = Block();
+		myUnusedBlocks.push_back(aNextBlock);
+	}
+}
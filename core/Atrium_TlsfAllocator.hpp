@@ -0,0 +1,131 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Sub-allocates ranges of a fixed capacity, such as elements of a large buffer, with a two-level segregated fit.
+	 *        It only hands out offsets, so it works for any memory, on the CPU or GPU.
+	 *
+	 *        Free ranges are kept in lists by size class: a power of two, split further into linear steps.
+	 *        Two levels of bitmaps find a list with a large enough range in constant time, without searching,
+	 *        and freed ranges merge with free neighbours right away, so allocation and freeing both take constant time.
+	 *        Any range found is at most one step, an eighth of its size, larger than asked for before it's split.
+	 */
+	class TlsfAllocator
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		struct Allocation
+		{
+			std::uint32_t Offset = 0;
+			std::uint32_t Size = 0;
+
+			// Identifies the allocation's range to the allocator.
+			std::uint32_t Block = ~0u;
+		};
+
+	#pragma endregion
+
+		/**
+		 * @brief Create an allocator with a single free range.
+		 *
+		 * @param aCapacity Size of the whole range, in any unit, such as bytes or elements.
+		 */
+		explicit TlsfAllocator(std::uint32_t aCapacity);
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Allocate a range.
+		 *
+		 * @param aSize Size of the range. Empty ranges are given a size of 1.
+		 * @return The allocated range, or nothing if no free range is certain to be large enough.
+		 *         Ranges in the size's own class are only tried when one is first in its list, to keep this constant time,
+		 *         so sizes above GetLargestGuaranteedSize() can fail even when a large enough range is free.
+		 */
+		std::optional<Allocation> Allocate(std::uint32_t aSize);
+
+		/**
+		 * @brief Free a range, making it available to later allocations.
+		 *
+		 * @param anAllocation A range allocated from this allocator, which wasn't freed yet.
+		 */
+		void Free(const Allocation& anAllocation);
+
+		std::uint32_t GetCapacity() const { return myCapacity; }
+		std::uint32_t GetUsedSize() const { return myUsedSize; }
+		std::uint32_t GetAllocationCount() const { return myAllocationCount; }
+
+		/**
+		 * @brief Get the size of the largest range Allocate() is sure to find room for.
+		 *        A free range can be larger, but only ranges of a larger size class are certain to fit.
+		 */
+		std::uint32_t GetLargestGuaranteedSize() const;
+
+	#pragma endregion
+
+	private:
+		static constexpr std::uint32_t SecondLevelLog2 = 3;
+		static constexpr std::uint32_t SecondLevelCount = 1 << SecondLevelLog2;
+		static constexpr std::uint32_t FirstLevelCount = 32 - SecondLevelLog2 + 1;
+		static constexpr std::uint32_t InvalidBlock = ~0u;
+
+		struct Block
+		{
+			std::uint32_t Offset = 0;
+			std::uint32_t Size = 0;
+
+			// Neighbours in memory, to merge with when freed.
+			std::uint32_t PreviousPhysical = InvalidBlock;
+			std::uint32_t NextPhysical = InvalidBlock;
+
+			// Neighbours in the free list of the block's size class, while free.
+			std::uint32_t PreviousFree = InvalidBlock;
+			std::uint32_t NextFree = InvalidBlock;
+
+			bool IsFree = false;
+		};
+
+		struct SizeClass
+		{
+			std::uint32_t FirstLevel;
+			std::uint32_t SecondLevel;
+		};
+
+		static SizeClass GetSizeClass(std::uint32_t aSize);
+		static std::optional<SizeClass> GetSizeClassToSearch(std::uint32_t aSize);
+
+		std::optional<SizeClass> FindFreeClass(SizeClass aMinimumClass) const;
+
+		std::uint32_t CreateBlock();
+		void InsertFree(std::uint32_t aBlock);
+		void RemoveFree(std::uint32_t aBlock);
+		void MergeInto(std::uint32_t aBlock, std::uint32_t aNextBlock);
+
+		std::vector<Block> myBlocks;
+		std::vector<std::uint32_t> myUnusedBlocks;
+
+		std::uint32_t myFirstLevelBitmap;
+		std::array<std::uint32_t, FirstLevelCount> mySecondLevelBitmaps;
+		std::array<std::array<std::uint32_t, SecondLevelCount>, FirstLevelCount> myFreeLists;
+
+		std::uint32_t myCapacity;
+		std::uint32_t myUsedSize;
+		std::uint32_t myAllocationCount;
+	};
+}
@@ -0,0 +1,389 @@
+// Filter "Graphics"
+
+#include "Atrium_Diagnostics.hpp"
+#include "Atrium_SIMD.hpp"
+#include "Atrium_VertexStreamPacker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+namespace Atrium
+{
+	namespace
+	{
+		// Vertices are gathered into components a block at a time, then converted a component at a time.
+		constexpr std::size_t BlockSize = 64;
+
+		using ComponentBlock = std::array<std::array<float, BlockSize>, 4>;
+
+		enum class ComponentType
+		{
+			Float32,
+			Float16,
+			UNorm16,
+			SNorm16,
+			UNorm8,
+			SNorm8
+		};
+
+		struct ComponentFormat
+		{
+			ComponentType Type;
+			std::uint32_t Count;
+		};
+
+		std::optional<ComponentFormat> GetComponentFormat(GraphicsFormat aFormat)
+		{
+			switch (aFormat)
+			{
+				case GraphicsFormat::R32_SFloat: return ComponentFormat { ComponentType::Float32, 1 };
+				case GraphicsFormat::R32G32_SFloat: return ComponentFormat { ComponentType::Float32, 2 };
+				case GraphicsFormat::R32G32B32_SFloat: return ComponentFormat { ComponentType::Float32, 3 };
+				case GraphicsFormat::R32G32B32A32_SFloat: return ComponentFormat { ComponentType::Float32, 4 };
+				case GraphicsFormat::R16_SFloat: return ComponentFormat { ComponentType::Float16, 1 };
+				case GraphicsFormat::R16G16_SFloat: return ComponentFormat { ComponentType::Float16, 2 };
+				case GraphicsFormat::R16G16B16A16_SFloat: return ComponentFormat { ComponentType::Float16, 4 };
+				case GraphicsFormat::R16_UNorm: return ComponentFormat { ComponentType::UNorm16, 1 };
+				case GraphicsFormat::R16G16_UNorm: return ComponentFormat { ComponentType::UNorm16, 2 };
+				case GraphicsFormat::R16G16B16A16_UNorm: return ComponentFormat { ComponentType::UNorm16, 4 };
+				case GraphicsFormat::R16_SNorm: return ComponentFormat { ComponentType::SNorm16, 1 };
+				case GraphicsFormat::R16G16_SNorm: return ComponentFormat { ComponentType::SNorm16, 2 };
+				case GraphicsFormat::R16G16B16A16_SNorm: return ComponentFormat { ComponentType::SNorm16, 4 };
+				case GraphicsFormat::R8_UNorm: return ComponentFormat { ComponentType::UNorm8, 1 };
+				case GraphicsFormat::R8G8_UNorm: return ComponentFormat { ComponentType::UNorm8, 2 };
+				case GraphicsFormat::R8G8B8A8_UNorm: return ComponentFormat { ComponentType::UNorm8, 4 };
+				case GraphicsFormat::R8_SNorm: return ComponentFormat { ComponentType::SNorm8, 1 };
+				case GraphicsFormat::R8G8_SNorm: return ComponentFormat { ComponentType::SNorm8, 2 };
+				case GraphicsFormat::R8G8B8A8_SNorm: return ComponentFormat { ComponentType::SNorm8, 4 };
+				default: return { };
+			}
+		}
+
+		std::uint32_t GetComponentSize(ComponentType aType)
+		{
+			switch (aType)
+			{
+				case ComponentType::Float32: return 4;
+				case ComponentType::Float16:
+				case ComponentType::UNorm16:
+				case ComponentType::SNorm16: return 2;
+				default: return 1;
+			}
+		}
+
+		bool IsNormalized(ComponentType aType)
+		{
+			return aType != ComponentType::Float32 && aType != ComponentType::Float16;
+		}
+
+		// HLSL semantics are case insensitive.
+		bool IsSemantic(const std::string& aName, std::string_view aSemantic)
+		{
+			return std::equal(aName.begin(), aName.end(), aSemantic.begin(), aSemantic.end(), [](char aCharacter, char anotherCharacter) {
+				return std::toupper(static_cast<unsigned char>(aCharacter)) == anotherCharacter;
+			});
+		}
+
+		std::optional<VertexStreamPacker::Attribute> GetAttribute(const PipelineStateDescription::InputLayoutEntry& anEntry, std::uint32_t aComponentCount)
+		{
+			using Attribute = VertexStreamPacker::Attribute;
+
+			if (anEntry.SemanticIndex != 0)
+				return { };
+
+			if (IsSemantic(anEntry.SemanticName, "POSITION"))
+				return Attribute::Position;
+			if (IsSemantic(anEntry.SemanticName, "NORMAL") && aComponentCount >= 2)
+				return aComponentCount == 2 ? Attribute::OctahedralNormal : Attribute::Normal;
+			if (IsSemantic(anEntry.SemanticName, "TANGENT"))
+				return Attribute::Tangent;
+			if (IsSemantic(anEntry.SemanticName, "BINORMAL"))
+				return Attribute::Binormal;
+			if (IsSemantic(anEntry.SemanticName, "TANGENTFRAME") && aComponentCount == 4)
+				return Attribute::TangentFrame;
+			if (IsSemantic(anEntry.SemanticName, "TEXCOORD"))
+				return Attribute::UV;
+
+			return { };
+		}
+
+		void GatherVector(std::span<const MeshPrimitive::Vertex> someVertices, Vector3<float> MeshPrimitive::Vertex::* aMember, float aFourthComponent, ComponentBlock& someComponentsOut)
+		{
+			for (std::size_t i = 0; i < someVertices.size(); ++i)
+			{
+				const Vector3<float>& vector = someVertices[i].*aMember;
+				someComponentsOut[0][i] = vector.X;
+				someComponentsOut[1][i] = vector.Y;
+				someComponentsOut[2][i] = vector.Z;
+				someComponentsOut[3][i] = aFourthComponent;
+			}
+		}
+
+		void GatherComponents(std::span<const MeshPrimitive::Vertex> someVertices, VertexStreamPacker::Attribute anAttribute, bool isNormalized, const VertexQuantization& aQuantization, ComponentBlock& someComponentsOut)
+		{
+			using Attribute = VertexStreamPacker::Attribute;
+
+			switch (anAttribute)
+			{
+				case Attribute::Position:
+				{
+					GatherVector(someVertices, &MeshPrimitive::Vertex::Position, 1.f, someComponentsOut);
+					if (!isNormalized)
+						break;
+
+					const std::array<float, 3> offsets = { aQuantization.Offset.X, aQuantization.Offset.Y, aQuantization.Offset.Z };
+					const std::array<float, 3> scales = { aQuantization.Scale.X, aQuantization.Scale.Y, aQuantization.Scale.Z };
+					for (std::size_t component = 0; component < 3; ++component)
+					{
+						const float multiplier = scales[component] > 0.f ? 1.f / scales[component] : 0.f;
+						for (std::size_t i = 0; i < someVertices.size(); ++i)
+							someComponentsOut[component][i] = (someComponentsOut[component][i] - offsets[component]) * multiplier;
+					}
+					break;
+				}
+				case Attribute::Normal:
+					GatherVector(someVertices, &MeshPrimitive::Vertex::Normal, 0.f, someComponentsOut);
+					break;
+				case Attribute::Tangent:
+					GatherVector(someVertices, &MeshPrimitive::Vertex::Tangent, 0.f, someComponentsOut);
+					break;
+				case Attribute::Binormal:
+					GatherVector(someVertices, &MeshPrimitive::Vertex::Binormal, 0.f, someComponentsOut);
+					break;
+				case Attribute::UV:
+					for (std::size_t i = 0; i < someVertices.size(); ++i)
+					{
+						someComponentsOut[0][i] = someVertices[i].UV.X;
+						someComponentsOut[1][i] = someVertices[i].UV.Y;
+						someComponentsOut[2][i] = 0.f;
+						someComponentsOut[3][i] = 0.f;
+					}
+					break;
+				case Attribute::TangentFrame:
+				{
+					// The packed vertex encoders make the frames, which are then converted like any other component.
+					std::array<PackedVertex, BlockSize> packed;
+					PackedVertex::Pack(someVertices, aQuantization, PackedUVFormat::Half, packed);
+					for (std::size_t i = 0; i < someVertices.size(); ++i)
+					{
+						for (std::size_t component = 0; component < 4; ++component)
+							someComponentsOut[component][i] = static_cast<float>(packed[i].TangentFrame[component]) / 32767.f;
+					}
+					break;
+				}
+				case Attribute::OctahedralNormal:
+				{
+					std::array<PackedNormalVertex, BlockSize> packed;
+					PackedNormalVertex::Pack(someVertices, aQuantization, PackedUVFormat::Half, packed);
+					for (std::size_t i = 0; i < someVertices.size(); ++i)
+					{
+						someComponentsOut[0][i] = static_cast<float>(packed[i].Normal[0]) / 32767.f;
+						someComponentsOut[1][i] = static_cast<float>(packed[i].Normal[1]) / 32767.f;
+					}
+					break;
+				}
+			}
+		}
+
+		template <typename T>
+		void Scatter(const T* someValues, std::size_t aCount, std::byte* aDestination, std::uint32_t aStride)
+		{
+			for (std::size_t i = 0; i < aCount; ++i)
+				std::memcpy(aDestination + i * aStride, &someValues[i], sizeof(T));
+		}
+
+		/**
+		 * @brief Convert one component of a block of vertices to a normalized type, and write it into each vertex.
+		 */
+		void WriteNormalized(const std::array<float, BlockSize>& someValues, std::size_t aCount, ComponentType aType, std::byte* aDestination, std::uint32_t aStride)
+		{
+			const bool isSigned = aType == ComponentType::SNorm16 || aType == ComponentType::SNorm8;
+			const float minimum = isSigned ? -1.f : 0.f;
+			const float scale = aType == ComponentType::UNorm16 ? 65535.f : aType == ComponentType::SNorm16 ? 32767.f : aType == ComponentType::UNorm8 ? 255.f : 127.f;
+
+			// Both paths round to the nearest, and to even on ties.
+			alignas(16) std::array<std::int32_t, BlockSize> converted;
+			std::size_t i = 0;
+		#if ATRIUM_SIMD_SSE
+			const __m128 minimumLanes = _mm_set1_ps(minimum);
+			const __m128 maximumLanes = _mm_set1_ps(1.f);
+			const __m128 scaleLanes = _mm_set1_ps(scale);
+			for (; i + 4 <= aCount; i += 4)
+			{
+				const __m128 values = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(someValues.data() + i), minimumLanes), maximumLanes);
+				_mm_store_si128(reinterpret_cast<__m128i*>(converted.data() + i), _mm_cvtps_epi32(_mm_mul_ps(values, scaleLanes)));
+			}
+		#endif
+			for (; i < aCount; ++i)
+				converted[i] = static_cast<std::int32_t>(std::nearbyint(std::clamp(someValues[i], minimum, 1.f) * scale));
+
+			if (GetComponentSize(aType) == 2)
+			{
+				std::array<std::uint16_t, BlockSize> narrowed;
+				for (std::size_t j = 0; j < aCount; ++j)
+					narrowed[j] = static_cast<std::uint16_t>(converted[j]);
+				Scatter(narrowed.data(), aCount, aDestination, aStride);
+			}
+			else
+			{
+				std::array<std::uint8_t, BlockSize> narrowed;
+				for (std::size_t j = 0; j < aCount; ++j)
+					narrowed[j] = static_cast<std::uint8_t>(converted[j]);
+				Scatter(narrowed.data(), aCount, aDestination, aStride);
+			}
+		}
+
+		void WriteHalf(const std::array<float, BlockSize>& someValues, std::size_t aCount, std::byte* aDestination, std::uint32_t aStride)
+		{
+			std::array<std::uint16_t, BlockSize> converted;
+			std::size_t i = 0;
+		#if ATRIUM_SIMD_F16C
+			for (; i + 8 <= aCount; i += 8)
+			{
+				const __m128i halves = _mm_unpacklo_epi64(
+					_mm_cvtps_ph(_mm_loadu_ps(someValues.data() + i), _MM_FROUND_TO_NEAREST_INT),
+					_mm_cvtps_ph(_mm_loadu_ps(someValues.data() + i + 4), _MM_FROUND_TO_NEAREST_INT));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(converted.data() + i), halves);
+			}
+		#endif
+			for (; i < aCount; ++i)
+				converted[i] = FloatToHalf(someValues[i]);
+
+			Scatter(converted.data(), aCount, aDestination, aStride);
+		}
+
+		void WriteComponents(const ComponentBlock& someComponents, std::size_t aCount, const ComponentFormat& aFormat, std::byte* aDestination, std::uint32_t aStride)
+		{
+			const std::uint32_t componentSize = GetComponentSize(aFormat.Type);
+			for (std::uint32_t component = 0; component < aFormat.Count; ++component)
+			{
+				std::byte* destination = aDestination + component * componentSize;
+				switch (aFormat.Type)
+				{
+					case ComponentType::Float32:
+						Scatter(someComponents[component].data(), aCount, destination, aStride);
+						break;
+					case ComponentType::Float16:
+						WriteHalf(someComponents[component], aCount, destination, aStride);
+						break;
+					default:
+						WriteNormalized(someComponents[component], aCount, aFormat.Type, destination, aStride);
+						break;
+				}
+			}
+		}
+	}
+
+	VertexStreamPacker::VertexStreamPacker(std::span<const PipelineStateDescription::InputLayoutEntry> someEntries, const VertexQuantization& aQuantization)
+		: myQuantization(aQuantization)
+		, myIsValid(true)
+	{
+		for (const PipelineStateDescription::InputLayoutEntry& entry : someEntries)
+		{
+			if (entry.InstancePerStep != 0)
+				continue;
+
+			auto stream = std::find_if(myStreams.begin(), myStreams.end(), [&entry](const Stream& aStream) { return aStream.InputSlot == entry.InputSlot; });
+			if (stream == myStreams.end())
+			{
+				myStreams.emplace_back().InputSlot = entry.InputSlot;
+				stream = myStreams.end() - 1;
+			}
+
+			const std::optional<ComponentFormat> format = GetComponentFormat(entry.Format);
+			if (!format)
+			{
+				Debug::LogError("Vertex streams can't be packed in the format of %s%u.", entry.SemanticName.c_str(), entry.SemanticIndex);
+				myIsValid = false;
+				continue;
+			}
+
+			// Elements are placed after the previous one, aligned to their components.
+			const std::uint32_t componentSize = GetComponentSize(format->Type);
+			const std::uint32_t offset = (stream->Stride + componentSize - 1) / componentSize * componentSize;
+			stream->Stride = offset + componentSize * format->Count;
+
+			const std::optional<Attribute> attribute = GetAttribute(entry, format->Count);
+			if (!attribute)
+			{
+				Debug::LogError("Meshes have no vertex data for %s%u.", entry.SemanticName.c_str(), entry.SemanticIndex);
+				myIsValid = false;
+				continue;
+			}
+
+			stream->Elements.push_back(Element { *attribute, entry.Format, offset });
+		}
+
+		for (Stream& stream : myStreams)
+			stream.Stride = (stream.Stride + 3) / 4 * 4;
+
+		std::sort(myStreams.begin(), myStreams.end(), [](const Stream& aStream, const Stream& anotherStream) { return aStream.InputSlot < anotherStream.InputSlot; });
+	}
+
+	const VertexStreamPacker::Stream* VertexStreamPacker::GetStream(unsigned int anInputSlot) const
+	{
+		for (const Stream& stream : myStreams)
+		{
+			if (stream.InputSlot == anInputSlot)
+				return &stream;
+		}
+
+		return nullptr;
+	}
+
+	void VertexStreamPacker::Pack(unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices, std::span<std::byte> aDestination) const
+	{
+		PROFILE_SCOPE();
+
+		const Stream* stream = GetStream(anInputSlot);
+		if (!Debug::Verify(stream != nullptr, "The input layout has per-vertex entries in slot %u.", anInputSlot))
+			return;
+
+		if (!Debug::Verify(aDestination.size() >= someVertices.size() * stream->Stride, "The destination has room for %zu vertices of %u bytes.", someVertices.size(), stream->Stride))
+			return;
+
+		ComponentBlock components = { };
+		for (std::size_t first = 0; first < someVertices.size(); first += BlockSize)
+		{
+			const std::span<const MeshPrimitive::Vertex> block = someVertices.subspan(first, std::min(BlockSize, someVertices.size() - first));
+			std::byte* destination = aDestination.data() + first * stream->Stride;
+
+			for (const Element& element : stream->Elements)
+			{
+				const ComponentFormat format = *GetComponentFormat(element.Format);
+				GatherComponents(block, element.Source, IsNormalized(format.Type), myQuantization, components);
+				WriteComponents(components, block.size(), format, destination + element.Offset, stream->Stride);
+			}
+		}
+	}
+
+	void VertexStreamPacker::Pack(unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices, GraphicsBuffer& aBuffer) const
+	{
+		const Stream* stream = GetStream(anInputSlot);
+		if (!Debug::Verify(stream != nullptr, "The input layout has per-vertex entries in slot %u.", anInputSlot))
+			return;
+
+		if (!Debug::Verify(aBuffer.GetStride() == stream->Stride, "The buffer's stride %u matches the stream's %u.", aBuffer.GetStride(), stream->Stride))
+			return;
+
+		Pack(anInputSlot, someVertices, aBuffer.GetWritableData());
+	}
+
+	std::shared_ptr<GraphicsBuffer> VertexStreamPacker::CreateBuffer(GraphicsAPI::ResourceManager& aResourceManager, unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices) const
+	{
+		const Stream* stream = GetStream(anInputSlot);
+		if (!stream || someVertices.empty())
+			return nullptr;
+
+		std::shared_ptr<GraphicsBuffer> buffer = aResourceManager.CreateGraphicsBuffer(GraphicsBuffer::Target::Vertex, static_cast<std::uint32_t>(someVertices.size()), stream->Stride);
+		if (buffer)
+			Pack(anInputSlot, someVertices, *buffer);
+
+		return buffer;
+	}
+}
@@ -0,0 +1,126 @@
+// Filter "Graphics"
+
+#pragma once
+
+#include "Atrium_GraphicsAPI.hpp"
+#include "Atrium_GraphicsBuffer.hpp"
+#include "Atrium_GraphicsPipeline.hpp"
+#include "Atrium_MeshPrimitives.hpp"
+#include "Atrium_PackedVertex.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Writes mesh vertices in the exact format a pipeline's input layout describes, as one stream per input slot.
+	 *        Splitting attributes over slots gives passes that need only some of them a smaller stream to fetch,
+	 *        such as depth passes binding only a position stream in slot 0.
+	 *
+	 *        Entries are matched to the vertex by semantic: POSITION, NORMAL, TANGENT, BINORMAL and TEXCOORD take its own attributes,
+	 *        and TANGENTFRAME takes the quaternion of a PackedVertex. A NORMAL of two components is octahedron encoded like a PackedNormalVertex's.
+	 *        Positions in normalized formats are stored from 0 to 1 across the quantization, and missing fourth components are 1 for positions, 0 otherwise.
+	 *        Per-instance entries are left out, as meshes have no instance data.
+	 */
+	class VertexStreamPacker
+	{
+	public:
+
+		//--------------------------------------------------
+		// * Types
+		//--------------------------------------------------
+	#pragma region Types
+
+		enum class Attribute
+		{
+			Position,
+			Normal,
+			OctahedralNormal,
+			Tangent,
+			Binormal,
+			TangentFrame,
+			UV
+		};
+
+		struct Element
+		{
+			// The vertex attribute written into the element.
+			Attribute Source;
+			GraphicsFormat Format;
+
+			// Offset in bytes from the start of the vertex, where D3D12_APPEND_ALIGNED_ELEMENT would place it.
+			std::uint32_t Offset = 0;
+		};
+
+		struct Stream
+		{
+			unsigned int InputSlot = 0;
+			std::uint32_t Stride = 0;
+			std::vector<Element> Elements;
+		};
+
+	#pragma endregion
+
+		/**
+		 * @brief Lay out the streams of an input layout.
+		 *
+		 * @param someEntries The input layout, such as a PipelineStateDescription's.
+		 * @param aQuantization Range to store positions in normalized formats relative to.
+		 */
+		VertexStreamPacker(std::span<const PipelineStateDescription::InputLayoutEntry> someEntries, const VertexQuantization& aQuantization = VertexQuantization());
+
+		//--------------------------------------------------
+		// * Methods
+		//--------------------------------------------------
+	#pragma region Methods
+
+		/**
+		 * @brief Check that every entry of the input layout has a semantic and format that can be packed.
+		 */
+		bool IsValid() const { return myIsValid; }
+
+		/**
+		 * @brief Get the streams, in order of input slot.
+		 */
+		std::span<const Stream> GetStreams() const { return myStreams; }
+
+		/**
+		 * @brief Get the stream of an input slot.
+		 *
+		 * @return The stream, or nullptr if the input layout has no per-vertex entries in the slot.
+		 */
+		const Stream* GetStream(unsigned int anInputSlot) const;
+
+		/**
+		 * @brief Write the stream of an input slot for some vertices, converting several vertices at a time with SIMD where available.
+		 *
+		 * @param aDestination Memory to write into, at least the stream's stride times the vertex count large.
+		 */
+		void Pack(unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices, std::span<std::byte> aDestination) const;
+
+		/**
+		 * @brief Write the stream of an input slot for some vertices straight into a buffer's memory, without an intermediate copy.
+		 *
+		 * @param aBuffer Buffer with the stream's stride, and room for every vertex.
+		 */
+		void Pack(unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices, GraphicsBuffer& aBuffer) const;
+
+		/**
+		 * @brief Create a vertex buffer holding the stream of an input slot for some vertices.
+		 *
+		 * @return The buffer, or nullptr if the slot has no stream or the buffer couldn't be created.
+		 */
+		std::shared_ptr<GraphicsBuffer> CreateBuffer(GraphicsAPI::ResourceManager& aResourceManager, unsigned int anInputSlot, std::span<const MeshPrimitive::Vertex> someVertices) const;
+
+	#pragma endregion
+
+	private:
+		std::vector<Stream> myStreams;
+		VertexQuantization myQuantization;
+		bool myIsValid;
+	};
+}
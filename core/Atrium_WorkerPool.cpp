@@ -0,0 +1,91 @@
+// Filter "Threading"
+
+#include "Atrium_WorkerPool.hpp"
+
+#include <algorithm>
+
+namespace Atrium
+{
+	WorkerPool& WorkerPool::Get()
+	{
+		static WorkerPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+		return pool;
+	}
+
+	WorkerPool::WorkerPool(unsigned int aWorkerCount)
+	{
+		myWorkers.reserve(aWorkerCount);
+		for (unsigned int i = 0; i < aWorkerCount; ++i)
+			myWorkers.emplace_back([this](std::stop_token aStopToken) { ProcessJobs(aStopToken); });
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		for (std::jthread& worker : myWorkers)
+			worker.request_stop();
+
+		myWorkers.clear();
+	}
+
+	void WorkerPool::ParallelFor(std::size_t aCount, const std::function<void(std::size_t)>& aFunction, unsigned int aMaxThreadCount)
+	{
+		const std::size_t helperCount = std::min<std::size_t>({ myWorkers.size(), aCount > 0 ? aCount - 1 : 0, aMaxThreadCount > 0 ? aMaxThreadCount - 1 : 0 });
+		if (helperCount == 0)
+		{
+			for (std::size_t i = 0; i < aCount; ++i)
+				aFunction(i);
+
+			return;
+		}
+
+		// Shared with the workers, which may still be finishing their last index when the loop returns.
+		std::shared_ptr<Job> job = std::make_shared<Job>();
+		job->Function = &aFunction;
+		job->Count = aCount;
+
+		{
+			std::scoped_lock lock(myMutex);
+			myJobs.insert(myJobs.end(), helperCount, job);
+		}
+
+		if (helperCount == 1)
+			myJobAdded.notify_one();
+		else
+			myJobAdded.notify_all();
+
+		RunJob(*job);
+
+		for (std::size_t completedCount = job->CompletedCount.load(); completedCount != aCount; completedCount = job->CompletedCount.load())
+			job->CompletedCount.wait(completedCount);
+	}
+
+	void WorkerPool::RunJob(Job& aJob)
+	{
+		for (std::size_t i = aJob.NextIndex++; i < aJob.Count; i = aJob.NextIndex++)
+		{
+			(*aJob.Function)(i);
+
+			if (++aJob.CompletedCount == aJob.Count)
+				aJob.CompletedCount.notify_all();
+		}
+	}
+
+	void WorkerPool::ProcessJobs(std::stop_token aStopToken)
+	{
+		while (true)
+		{
+			std::shared_ptr<Job> job;
+			{
+				std::unique_lock lock(myMutex);
+				if (!myJobAdded.wait(lock, aStopToken, [this]() { return !myJobs.empty(); }))
+					return;
+
+				job = std::move(myJobs.front());
+				myJobs.pop_front();
+			}
+
+			// The calling thread may have run every index already, in which case this returns right away.
+			RunJob(*job);
+		}
+	}
+}
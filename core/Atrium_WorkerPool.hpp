@@ -0,0 +1,70 @@
+// Filter "Threading"
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Atrium
+{
+	/**
+	 * @brief Worker threads shared by the engine's parallel loops, started once instead of for every loop.
+	 *
+	 *        The calling thread always takes part in its own loop and claims indices like the workers do,
+	 *        so a loop finishes even when every worker is busy, and loops can be started from inside other loops.
+	 */
+	class WorkerPool
+	{
+	public:
+		/**
+		 * @brief Get the pool shared by the whole process, with a worker for every hardware thread but the caller's.
+		 */
+		static WorkerPool& Get();
+
+		explicit WorkerPool(unsigned int aWorkerCount);
+		~WorkerPool();
+
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/**
+		 * @brief Get how many threads can run a loop at once, counting the calling thread.
+		 */
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>(myWorkers.size()) + 1; }
+
+		/**
+		 * @brief Run a function for every index below a count, spread over the workers and the calling thread.
+		 *        Threads take the next index as they finish one, so indices can vary in cost. Returns when all have run.
+		 *
+		 * @param aCount Number of indices.
+		 * @param aFunction Function to call with each index, from any thread.
+		 * @param aMaxThreadCount Most threads to use, counting the calling thread.
+		 */
+		void ParallelFor(std::size_t aCount, const std::function<void(std::size_t)>& aFunction, unsigned int aMaxThreadCount = ~0u);
+
+	private:
+		struct Job
+		{
+			const std::function<void(std::size_t)>* Function = nullptr;
+			std::size_t Count = 0;
+			std::atomic<std::size_t> NextIndex = 0;
+			std::atomic<std::size_t> CompletedCount = 0;
+		};
+
+		static void RunJob(Job& aJob);
+		void ProcessJobs(std::stop_token aStopToken);
+
+		std::mutex myMutex;
+		std::condition_variable_any myJobAdded;
+		std::deque<std::shared_ptr<Job>> myJobs;
+
+		std::vector<std::jthread> myWorkers;
+	};
+}
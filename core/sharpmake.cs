@@ -28,6 +28,15 @@ namespace Atrium
 			conf.AddPublicDependency<RoseCommon>(target);
 
 			conf.AddPublicDependency<Tracy>(target);
+
+			// The SIMD paths in Atrium_SIMD.hpp pick AVX2 and F16C at compile time.
+			conf.Options.Add(Options.Vc.Compiler.EnhancedInstructionSet.AdvancedVectorExtensions2);
+
+			if (target.Optimization != Sharpmake.Optimization.Retail)
+			{
+				conf.Defines.Add("IS_DEBUG_DRAW_ENABLED=1");
+				conf.ExportDefines.Add("IS_DEBUG_DRAW_ENABLED=1");
+			}
 		}
 	}
 }
\ No newline at end of file
@@ -2,11 +2,317 @@
 
 #include "Atrium_NullGraphicsHandler.hpp"
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
 namespace Atrium
 {
+	/**
+	 * @brief Emulates a GPU queue with a worker thread executing submitted operations in order.
+	 *        Fence values are signaled by the worker, so waits between queues behave like they would on a GPU.
+	 */
+	class NullCommandQueue
+	{
+	public:
+		NullCommandQueue()
+			: myIsRunning(true)
+			, myNextFenceValue(1)
+			, myCompletedFenceValue(0)
+			, myNextTimelineValue(1)
+			, myCompletedTimelineValue(0)
+		{
+			myWorker = std::thread(&NullCommandQueue::ProcessOperations, this);
+		}
+
+		~NullCommandQueue()
+		{
+			Stop();
+			myWorker.join();
+		}
+
+		std::uint64_t InsertSignal()
+		{
+			std::scoped_lock lock(myMutex);
+			const std::uint64_t fenceValue = myNextFenceValue++;
+			myOperations.emplace_back([this, fenceValue]() {
+				{
+					std::scoped_lock completedLock(myMutex);
+					myCompletedFenceValue = fenceValue;
+				}
+				myFenceCompleted.notify_all();
+			});
+			myOperationAdded.notify_one();
+			return fenceValue;
+		}
+
+		void InsertWait(NullCommandQueue& aQueue, std::uint64_t aFenceValue)
+		{
+			std::scoped_lock lock(myMutex);
+			myOperations.emplace_back([&aQueue, aFenceValue]() {
+				aQueue.WaitForFence(aFenceValue, std::chrono::milliseconds::max());
+			});
+			myOperationAdded.notify_one();
+		}
+
+		bool WaitForFence(std::uint64_t aFenceValue, std::chrono::milliseconds aTimeout) const
+		{
+			return WaitForValue(myCompletedFenceValue, aFenceValue, aTimeout);
+		}
+
+		// Timeline values are only signaled by InsertTimelineSignal(), so they can be handed out before the signal is inserted.
+		std::uint64_t ReserveTimelineValue()
+		{
+			std::scoped_lock lock(myMutex);
+			return myNextTimelineValue++;
+		}
+
+		void InsertTimelineSignal(std::uint64_t aTimelineValue)
+		{
+			std::scoped_lock lock(myMutex);
+			myOperations.emplace_back([this, aTimelineValue]() {
+				{
+					std::scoped_lock completedLock(myMutex);
+					myCompletedTimelineValue = aTimelineValue;
+				}
+				myFenceCompleted.notify_all();
+			});
+			myOperationAdded.notify_one();
+		}
+
+		void InsertWaitForTimelineValue(NullCommandQueue& aQueue, std::uint64_t aTimelineValue)
+		{
+			std::scoped_lock lock(myMutex);
+			myOperations.emplace_back([&aQueue, aTimelineValue]() {
+				aQueue.WaitForTimelineValue(aTimelineValue, std::chrono::milliseconds::max());
+			});
+			myOperationAdded.notify_one();
+		}
+
+		bool IsTimelineValueComplete(std::uint64_t aTimelineValue) const
+		{
+			std::scoped_lock lock(myMutex);
+			return aTimelineValue <= myCompletedTimelineValue;
+		}
+
+		bool WaitForTimelineValue(std::uint64_t aTimelineValue, std::chrono::milliseconds aTimeout) const
+		{
+			return WaitForValue(myCompletedTimelineValue, aTimelineValue, aTimeout);
+		}
+
+		void WaitForIdle()
+		{
+			WaitForFence(InsertSignal(), std::chrono::milliseconds::max());
+		}
+
+		// Release the worker and anyone waiting on this queue, even if their fence is never reached.
+		void Stop()
+		{
+			{
+				std::scoped_lock lock(myMutex);
+				myIsRunning = false;
+			}
+			myOperationAdded.notify_all();
+			myFenceCompleted.notify_all();
+		}
+
+	private:
+		bool WaitForValue(const std::uint64_t& aCompletedValue, std::uint64_t aValue, std::chrono::milliseconds aTimeout) const
+		{
+			std::unique_lock lock(myMutex);
+			const auto isDone = [&]() { return aValue <= aCompletedValue || !myIsRunning; };
+
+			if (aTimeout == std::chrono::milliseconds::max())
+				myFenceCompleted.wait(lock, isDone);
+			else
+				myFenceCompleted.wait_for(lock, aTimeout, isDone);
+
+			return aValue <= aCompletedValue;
+		}
+
+		void ProcessOperations()
+		{
+			for (;;)
+			{
+				std::function<void()> operation;
+				{
+					std::unique_lock lock(myMutex);
+					myOperationAdded.wait(lock, [&]() { return !myOperations.empty() || !myIsRunning; });
+					if (!myIsRunning)
+						return;
+
+					operation = std::move(myOperations.front());
+					myOperations.pop_front();
+				}
+
+				operation();
+			}
+		}
+
+	private:
+		mutable std::mutex myMutex;
+		std::condition_variable myOperationAdded;
+		mutable std::condition_variable myFenceCompleted;
+		std::deque<std::function<void()>> myOperations;
+		std::thread myWorker;
+		bool myIsRunning;
+
+		std::uint64_t myNextFenceValue;
+		std::uint64_t myCompletedFenceValue;
+
+		std::uint64_t myNextTimelineValue;
+		std::uint64_t myCompletedTimelineValue;
+	};
+
+	/**
+	 * @brief The queue and dependencies of a context, which the handler submits in dependency order when the frame ends.
+	 *        Shared with the handler, which keeps it for as long as it submits contexts.
+	 */
+	struct NullContextSubmission
+	{
+		GraphicsAPI::QueueType Queue;
+		std::vector<const NullContextSubmission*> Dependencies;
+
+		void AddDependency(const NullContextSubmission& aSubmission)
+		{
+			// Checked once here, as contexts in a cycle can't be ordered when they're submitted every frame.
+			if (!Debug::Verify(!aSubmission.DependsOn(*this), "Context dependencies don't form a cycle."))
+				return;
+
+			if (std::find(Dependencies.begin(), Dependencies.end(), &aSubmission) == Dependencies.end())
+				Dependencies.push_back(&aSubmission);
+		}
+
+		bool DependsOn(const NullContextSubmission& aSubmission) const
+		{
+			if (&aSubmission == this)
+				return true;
+
+			return std::any_of(Dependencies.begin(), Dependencies.end(), [&](const NullContextSubmission* aDependency) { return aDependency->DependsOn(aSubmission); });
+		}
+	};
+
+	/**
+	 * @brief Keeps the recorded commands pre-decoded, as calls to replay on the executing context.
+	 */
+	class NullCommandBundle final : public CommandBundle
+	{
+	public:
+		using Command = std::function<void(FrameGraphicsContext&)>;
+
+		NullCommandBundle()
+			: myIsClosed(false)
+		{
+		}
+
+		void Replay(FrameGraphicsContext& aContext) const
+		{
+			Debug::Assert(myIsClosed, "Only closed bundles can be executed.");
+
+			for (const Command& command : myCommands)
+				command(aContext);
+		}
+
+		void Close() override { myIsClosed = true; }
+		bool IsClosed() const override { return myIsClosed; }
+
+		void Draw(std::uint32_t aVertexCount, std::uint32_t aVertexStartOffset) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.Draw(aVertexCount, aVertexStartOffset); });
+		}
+
+		void DrawIndexed(std::uint32_t anIndexCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.DrawIndexed(anIndexCount, aStartIndexLocation, aBaseVertexLocation); });
+		}
+
+		void DrawInstanced(std::uint32_t aVertexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartVertexLocation, std::uint32_t aStartInstanceLocation) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.DrawInstanced(aVertexCountPerInstance, anInstanceCount, aStartVertexLocation, aStartInstanceLocation); });
+		}
+
+		void DrawIndexedInstanced(std::uint32_t anIndexCountPerInstance, std::uint32_t anInstanceCount, std::uint32_t aStartIndexLocation, std::uint32_t aBaseVertexLocation, std::uint32_t aStartInstanceLocation) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.DrawIndexedInstanced(anIndexCountPerInstance, anInstanceCount, aStartIndexLocation, aBaseVertexLocation, aStartInstanceLocation); });
+		}
+
+		void DrawIndexedInstancedBatch(std::span<const FrameGraphicsContext::DrawIndexedArguments> someDraws) override
+		{
+			Record([draws = std::vector(someDraws.begin(), someDraws.end())](FrameGraphicsContext& aContext) { aContext.DrawIndexedInstancedBatch(draws); });
+		}
+
+		void SetBlendFactor(ColorARGB<float> aBlendFactor) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetBlendFactor(aBlendFactor); });
+		}
+
+		void SetPipelineState(const std::shared_ptr<PipelineState>& aPipelineState) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetPipelineState(aPipelineState); });
+		}
+
+		void SetVertexBuffer(const std::shared_ptr<const GraphicsBuffer>& aVertexBuffer, unsigned int aSlot) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetVertexBuffer(aVertexBuffer, aSlot); });
+		}
+
+		void SetIndexBuffer(const std::shared_ptr<const GraphicsBuffer>& anIndexBuffer) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetIndexBuffer(anIndexBuffer); });
+		}
+
+		void SetPipelineConstants(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, std::span<const std::uint32_t> someValues) override
+		{
+			Record([=, values = std::vector(someValues.begin(), someValues.end())](FrameGraphicsContext& aContext) { aContext.SetPipelineConstants(anUpdateFrequency, aRegisterIndex, values); });
+		}
+
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<GraphicsBuffer>& aBuffer) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetPipelineResource(anUpdateFrequency, aRegisterIndex, aBuffer); });
+		}
+
+		void SetPipelineResource(ResourceUpdateFrequency anUpdateFrequency, std::uint32_t aRegisterIndex, const std::shared_ptr<Texture>& aTexture) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetPipelineResource(anUpdateFrequency, aRegisterIndex, aTexture); });
+		}
+
+		void SetPrimitiveTopology(PrimitiveTopology aTopology) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetPrimitiveTopology(aTopology); });
+		}
+
+		void SetStencilRef(std::uint32_t aStencilRef) override
+		{
+			Record([=](FrameGraphicsContext& aContext) { aContext.SetStencilRef(aStencilRef); });
+		}
+
+	private:
+		void Record(Command&& aCommand)
+		{
+			Debug::Assert(!myIsClosed, "Closed bundles can't be recorded to.");
+			myCommands.push_back(std::move(aCommand));
+		}
+
+		std::vector<Command> myCommands;
+		bool myIsClosed;
+	};
+
 	class NullFrameGraphicsContext final : public FrameGraphicsContext
 	{
 	public:
+		NullFrameGraphicsContext(const std::shared_ptr<NullContextSubmission>& aSubmission)
+			: mySubmission(aSubmission)
+		{
+		}
+
+		NullContextSubmission& GetSubmission() const { return *mySubmission; }
+
 		void BeginProfileZone(ProfileContextZone&
 		#ifdef TRACY_ENABLE
 			, const tracy::SourceLocationData&
@@ -14,6 +320,8 @@ namespace Atrium
 		) override {
 		}
 
+		void AddDependency(const std::shared_ptr<FrameComputeContext>& aContext) override;
+
 		void ClearColor(const std::shared_ptr<RenderTexture>&, ColorARGB<float>) override {}
 		void ClearDepth(const std::shared_ptr<RenderTexture>&, float, std::uint8_t) override {}
 
@@ -23,30 +331,90 @@ namespace Atrium
 		void Dispatch1D(std::uint32_t, std::uint32_t) override {}
 		void Dispatch2D(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
 		void Dispatch3D(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
+		void DispatchIndirect(const std::shared_ptr<GraphicsBuffer>&, std::uint32_t, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&, std::uint32_t) override {}
+
+		void ExecuteBundle(const std::shared_ptr<CommandBundle>& aBundle) override
+		{
+			static_cast<const NullCommandBundle&>(*aBundle).Replay(*this);
+		}
 
 		void Draw(std::uint32_t, std::uint32_t) override {}
 		void DrawIndexed(std::uint32_t, std::uint32_t, std::uint32_t) override {}
 		void DrawInstanced(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
 		void DrawIndexedInstanced(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
+		void DrawIndexedInstancedBatch(std::span<const DrawIndexedArguments>) override {}
+		void DrawIndexedInstancedIndirect(const std::shared_ptr<GraphicsBuffer>&, std::uint32_t, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&, std::uint32_t) override {}
 
 		void SetBlendFactor(ColorARGB<float>) override {}
 		void SetPipelineState(const std::shared_ptr<PipelineState>&) override {}
 		void SetVertexBuffer(const std::shared_ptr<const GraphicsBuffer>&, unsigned int) override {}
+		void SetIndexBuffer(const std::shared_ptr<const GraphicsBuffer>&) override {}
+		void SetPipelineConstants(ResourceUpdateFrequency, std::uint32_t, std::span<const std::uint32_t>) override {}
 		void SetPipelineResource(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&) override {}
 		void SetPipelineResource(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<Texture>&) override {}
+		void SetPipelineUnorderedAccess(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&) override {}
 		void SetPrimitiveTopology(PrimitiveTopology) override {}
 		void SetScissorRect(const Rectangle<int>&) override {}
 		void SetStencilRef(std::uint32_t) override {}
 		void SetRenderTargets(const std::vector<std::shared_ptr<RenderTexture>>&, const std::shared_ptr<RenderTexture>&) override {}
 		void SetViewportAndScissorRect(const Vector2<int>&) override {}
 		void SetViewport(const Rectangle<float>&) override {}
+		void TransitionResources(std::span<const ResourceTransition>, TransitionTiming) override {}
+
+	private:
+		std::shared_ptr<NullContextSubmission> mySubmission;
 	};
 
+	class NullFrameComputeContext final : public FrameComputeContext
+	{
+	public:
+		NullFrameComputeContext(const std::shared_ptr<NullContextSubmission>& aSubmission)
+			: mySubmission(aSubmission)
+		{
+		}
+
+		NullContextSubmission& GetSubmission() const { return *mySubmission; }
+
+		void BeginProfileZone(FrameGraphicsContext::ProfileContextZone&
+		#ifdef TRACY_ENABLE
+			, const tracy::SourceLocationData&
+		#endif
+		) override {
+		}
+
+		void AddDependency(const std::shared_ptr<FrameGraphicsContext>& aContext) override
+		{
+			mySubmission->AddDependency(static_cast<const NullFrameGraphicsContext&>(*aContext).GetSubmission());
+		}
+
+		void Dispatch(std::uint32_t, std::uint32_t, std::uint32_t) override {}
+		void Dispatch1D(std::uint32_t, std::uint32_t) override {}
+		void Dispatch2D(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
+		void Dispatch3D(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) override {}
+		void DispatchIndirect(const std::shared_ptr<GraphicsBuffer>&, std::uint32_t, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&, std::uint32_t) override {}
+
+		void SetPipelineState(const std::shared_ptr<PipelineState>&) override {}
+		void SetPipelineConstants(ResourceUpdateFrequency, std::uint32_t, std::span<const std::uint32_t>) override {}
+		void SetPipelineResource(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&) override {}
+		void SetPipelineResource(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<Texture>&) override {}
+		void SetPipelineUnorderedAccess(ResourceUpdateFrequency, std::uint32_t, const std::shared_ptr<GraphicsBuffer>&) override {}
+
+	private:
+		std::shared_ptr<NullContextSubmission> mySubmission;
+	};
+
+	void NullFrameGraphicsContext::AddDependency(const std::shared_ptr<FrameComputeContext>& aContext)
+	{
+		mySubmission->AddDependency(static_cast<const NullFrameComputeContext&>(*aContext).GetSubmission());
+	}
+
 	class NullResourceManager final : public GraphicsAPI::ResourceManager
 	{
+		std::shared_ptr<RenderTexture> CreateRenderTexture(const RenderTextureDescriptor&) { return nullptr; }
 		std::shared_ptr<RenderTexture> CreateRenderTextureForWindow(Window&) { return nullptr; }
-		std::shared_ptr<GraphicsBuffer> CreateGraphicsBuffer(GraphicsBuffer::Target, std::uint32_t, std::uint32_t) { return nullptr; }
+		std::shared_ptr<GraphicsBuffer> CreateGraphicsBuffer(GraphicsBuffer::Target, std::uint32_t, std::uint32_t, GraphicsBuffer::Mode) { return nullptr; }
 		std::shared_ptr<PipelineState> CreatePipelineState(const PipelineStateDescription&) { return nullptr; }
+		std::shared_ptr<PipelineState> CreateComputePipelineState(const ComputePipelineStateDescription&) { return nullptr; }
 		std::unique_ptr<RootSignatureBuilder> CreateRootSignature() { return nullptr; }
 		std::shared_ptr<Shader> CreateShader(const std::filesystem::path&, Shader::Type, const char*) { return nullptr; }
 		std::shared_ptr<Texture> CreateTexture(unsigned int, unsigned int, unsigned int, unsigned int, TextureFormat, std::optional<TextureDimension>) { return nullptr; }
@@ -54,13 +422,67 @@ namespace Atrium
 	};
 
 	NullGraphicsHandler::NullGraphicsHandler()
-		: myFrameCounter(0)
+		: myIsRecordingFrame(false)
+		, myFrameEndFences()
+		, myFrameCounter(0)
+	{
+		for (auto& queue : myQueues)
+			queue.reset(new NullCommandQueue());
+	}
+
+	NullGraphicsHandler::~NullGraphicsHandler()
 	{
+		// Stop every queue before joining any worker, as a worker may be blocked waiting on another queue.
+		for (auto& queue : myQueues)
+			queue->Stop();
+
+		for (auto& queue : myQueues)
+			queue.reset();
 	}
 
 	std::shared_ptr<FrameGraphicsContext> NullGraphicsHandler::CreateFrameGraphicsContext()
 	{
-		return std::make_shared<NullFrameGraphicsContext>();
+		return std::make_shared<NullFrameGraphicsContext>(myContextSubmissions.emplace_back(new NullContextSubmission { QueueType::Graphics, { } }));
+	}
+
+	std::shared_ptr<FrameComputeContext> NullGraphicsHandler::CreateFrameComputeContext()
+	{
+		return std::make_shared<NullFrameComputeContext>(myContextSubmissions.emplace_back(new NullContextSubmission { QueueType::Compute, { } }));
+	}
+
+	std::shared_ptr<CommandBundle> NullGraphicsHandler::CreateCommandBundle()
+	{
+		return std::make_shared<NullCommandBundle>();
+	}
+
+	GraphicsAPI::TimelinePoint NullGraphicsHandler::InsertSignal(QueueType aQueue)
+	{
+		NullCommandQueue& queue = GetQueue(aQueue);
+
+		// Signals made while a frame is recorded wait for MarkFrameEnd() to submit its contexts, like on a GPU backend.
+		std::scoped_lock lock(myPendingSignalsMutex);
+		const TimelinePoint point { aQueue, queue.ReserveTimelineValue() };
+		if (myIsRecordingFrame)
+			myPendingSignals.push_back(point);
+		else
+			queue.InsertTimelineSignal(point.Value);
+
+		return point;
+	}
+
+	void NullGraphicsHandler::InsertWait(QueueType aQueue, const TimelinePoint& aPoint)
+	{
+		GetQueue(aQueue).InsertWaitForTimelineValue(GetQueue(aPoint.Queue), aPoint.Value);
+	}
+
+	bool NullGraphicsHandler::IsComplete(const TimelinePoint& aPoint) const
+	{
+		return GetQueue(aPoint.Queue).IsTimelineValueComplete(aPoint.Value);
+	}
+
+	bool NullGraphicsHandler::WaitForCompletion(const TimelinePoint& aPoint, std::chrono::milliseconds aTimeout) const
+	{
+		return GetQueue(aPoint.Queue).WaitForTimelineValue(aPoint.Value, aTimeout);
 	}
 
 	std::uint_least64_t NullGraphicsHandler::GetCurrentFrameIndex() const
@@ -77,11 +499,42 @@ namespace Atrium
 	void NullGraphicsHandler::MarkFrameStart()
 	{
 		myFrameCounter += 1;
+
+		const auto& frameEndFences = myFrameEndFences[myFrameCounter % ourFramesInFlight];
+		for (std::size_t i = 0; i < ourQueueCount; ++i)
+			myQueues[i]->WaitForFence(frameEndFences[i], std::chrono::milliseconds::max());
+
+		std::scoped_lock lock(myPendingSignalsMutex);
+		myIsRecordingFrame = true;
 	}
 
 	void NullGraphicsHandler::MarkFrameEnd()
 	{
+		SubmitFrameContexts();
 
+		{
+			// Timeline values were reserved in the order the signals were made, which they're inserted in too.
+			std::scoped_lock lock(myPendingSignalsMutex);
+			for (const TimelinePoint& signal : myPendingSignals)
+				GetQueue(signal.Queue).InsertTimelineSignal(signal.Value);
+
+			myPendingSignals.clear();
+			myIsRecordingFrame = false;
+		}
+
+		auto& frameEndFences = myFrameEndFences[myFrameCounter % ourFramesInFlight];
+		for (std::size_t i = 0; i < ourQueueCount; ++i)
+			frameEndFences[i] = myQueues[i]->InsertSignal();
+	}
+
+	std::size_t NullGraphicsHandler::GetFramesInFlightCount() const
+	{
+		return ourFramesInFlight;
+	}
+
+	bool NullGraphicsHandler::SupportsBindlessResources() const
+	{
+		return false;
 	}
 
 	bool NullGraphicsHandler::SupportsMultipleWindows() const
@@ -91,6 +544,48 @@ namespace Atrium
 
 	void NullGraphicsHandler::WaitForIdle() const
 	{
+		for (const auto& queue : myQueues)
+			queue->WaitForIdle();
+	}
+
+	void NullGraphicsHandler::SubmitFrameContexts()
+	{
+		// Contexts are submitted in creation order, except that dependencies are moved ahead of the contexts depending on them.
+		std::vector<const NullContextSubmission*> submissionOrder;
+		{
+			std::map<const NullContextSubmission*, bool> isVisited;
+			const auto visit = [&](const auto& aVisit, const NullContextSubmission* aSubmission) -> void {
+				if (std::exchange(isVisited[aSubmission], true))
+					return;
 
+				for (const NullContextSubmission* dependency : aSubmission->Dependencies)
+					aVisit(aVisit, dependency);
+
+				submissionOrder.push_back(aSubmission);
+			};
+
+			for (const std::shared_ptr<NullContextSubmission>& submission : myContextSubmissions)
+				visit(visit, submission.get());
+		}
+
+		// Each context's work is a signal on its queue, which contexts on other queues depending on it wait for.
+		std::map<const NullContextSubmission*, std::uint64_t> submittedFences;
+		for (const NullContextSubmission* submission : submissionOrder)
+		{
+			NullCommandQueue& queue = GetQueue(submission->Queue);
+
+			for (const NullContextSubmission* dependency : submission->Dependencies)
+			{
+				if (dependency->Queue != submission->Queue)
+					queue.InsertWait(GetQueue(dependency->Queue), submittedFences.at(dependency));
+			}
+
+			submittedFences[submission] = queue.InsertSignal();
+		}
+	}
+
+	NullCommandQueue& NullGraphicsHandler::GetQueue(QueueType aQueue) const
+	{
+		return *myQueues[static_cast<std::size_t>(aQueue)];
 	}
 }
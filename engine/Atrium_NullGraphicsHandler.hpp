@@ -4,22 +4,60 @@
 
 #include "Atrium_GraphicsAPI.hpp"
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace Atrium
 {
+	class NullCommandQueue;
+	struct NullContextSubmission;
+
+	/**
+	 * @brief Headless graphics API without a device.
+	 *        Records nothing, but emulates the GPU queues and their timelines with a worker thread each,
+	 *        and submits contexts to them in dependency order, so queue scheduling can be exercised without a GPU.
+	 */
 	class NullGraphicsHandler final : public GraphicsAPI
 	{
 	public:
 		NullGraphicsHandler();
+		~NullGraphicsHandler();
 
 		std::shared_ptr<FrameGraphicsContext> CreateFrameGraphicsContext() override;
+		std::shared_ptr<FrameComputeContext> CreateFrameComputeContext() override;
+		std::shared_ptr<CommandBundle> CreateCommandBundle() override;
+		TimelinePoint InsertSignal(QueueType aQueue) override;
+		void InsertWait(QueueType aQueue, const TimelinePoint& aPoint) override;
+		bool IsComplete(const TimelinePoint& aPoint) const override;
+		bool WaitForCompletion(const TimelinePoint& aPoint, std::chrono::milliseconds aTimeout = std::chrono::milliseconds::max()) const override;
 		std::uint_least64_t GetCurrentFrameIndex() const override;
+		std::size_t GetFramesInFlightCount() const override;
 		ResourceManager& GetResourceManager() override;
 		void MarkFrameStart() override;
 		void MarkFrameEnd() override;
+		bool SupportsBindlessResources() const override;
 		bool SupportsMultipleWindows() const override;
 		void WaitForIdle() const override;
 
 	private:
+		static constexpr std::size_t ourFramesInFlight = 2;
+		static constexpr std::size_t ourQueueCount = 3;
+
+		NullCommandQueue& GetQueue(QueueType aQueue) const;
+		void SubmitFrameContexts();
+
+	private:
+		std::array<std::unique_ptr<NullCommandQueue>, ourQueueCount> myQueues;
+		std::vector<std::shared_ptr<NullContextSubmission>> myContextSubmissions;
+
+		// Signals made while a frame is recorded, inserted once its contexts are submitted.
+		std::mutex myPendingSignalsMutex;
+		std::vector<TimelinePoint> myPendingSignals;
+		bool myIsRecordingFrame;
+
+		std::array<std::array<std::uint64_t, ourQueueCount>, ourFramesInFlight> myFrameEndFences;
 		std::uint_least64_t myFrameCounter;
 	};
 }
\ No newline at end of file
@@ -18,14 +18,6 @@ namespace Atrium::Extension
 		DirectX12::DirectX12API& dxAPI = static_cast<DirectX12::DirectX12API&>(AtriumApplication::GetRunningInstance()->GetGraphicsHandler());
 		DirectX12::ComPtr<ID3D12Device> dxDevice = dxAPI.GetDevice().GetDevice();
 
-		myCBV_SRVHeap.reset(
-			new DirectX12::RenderPassDescriptorHeap(
-				dxDevice,
-				D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
-				8
-			)
-		);
-
 		// Imgui internally uses num_frames_in_flight for amount of back-buffers, which should be
 		// one above the amount of actual frames in flight, so increasing the number by 1 to keep it working even with only 1 frame in flight.
 		// Additionally, depending on the swapchain swap-effect, they may require a minimum of 2 or crash on init.
@@ -39,12 +31,14 @@ namespace Atrium::Extension
 		initInfo.RTVFormat = DirectX12::ToDXGIFormat(aRenderTarget->GetDescriptor().ColorGraphicsFormat);
 
 		initInfo.UserData = this;
-		initInfo.SrvDescriptorHeap = myCBV_SRVHeap->GetHeap().Get();
+		// Imgui's descriptors live in the persistent region of the frame ring, which frame contexts already have bound.
+		initInfo.SrvDescriptorHeap = dxAPI.GetDevice().GetDescriptorHeapManager().GetFrameRing().GetHeap().Get();
 		initInfo.SrvDescriptorAllocFn = [](ImGui_ImplDX12_InitInfo* initInfo, D3D12_CPU_DESCRIPTOR_HANDLE* outCPUHandle, D3D12_GPU_DESCRIPTOR_HANDLE* outGPUHandle)
 			{
 				DearImGuiBackendContext_DirectX12* context = reinterpret_cast<DearImGuiBackendContext_DirectX12*>(initInfo->UserData);
 
-				DirectX12::DescriptorHeapHandle handle = context->myCBV_SRVHeap->GetHeapHandleBlock(1);
+				DirectX12::DirectX12API& dxAPI = static_cast<DirectX12::DirectX12API&>(AtriumApplication::GetRunningInstance()->GetGraphicsHandler());
+				DirectX12::DescriptorHeapHandle handle = dxAPI.GetDevice().GetDescriptorHeapManager().GetFrameRing().AllocatePersistent();
 				if (Debug::Verify(outCPUHandle != nullptr, "There is a CPU handle out pointer."))
 					(*outCPUHandle) = handle.GetCPUHandle();
 				if (Debug::Verify(outGPUHandle != nullptr, "There is a GPU handle out pointer."))
@@ -65,7 +59,7 @@ namespace Atrium::Extension
 	DearImGuiBackendContext_DirectX12::~DearImGuiBackendContext_DirectX12()
 	{
 		ImGui_ImplDX12_Shutdown();
-		myCBV_SRVHeap.reset();
+		myCBV_SRVHeapHandles.clear();
 	}
 
 	void DearImGuiBackendContext_DirectX12::MarkFrameStart()
@@ -82,7 +76,6 @@ namespace Atrium::Extension
 		aFrameContext.SetRenderTargets({ target }, nullptr);
 
 		ID3D12GraphicsCommandList* commandList = static_cast<DirectX12::FrameGraphicsContext&>(aFrameContext).GetCommandList();
-		commandList->SetDescriptorHeaps(1, myCBV_SRVHeap->GetHeap().GetAddressOf());
 		ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), commandList);
 		ImGui::RenderPlatformWindowsDefault(nullptr, (void*)commandList);
 	}
@@ -25,7 +25,6 @@ namespace Atrium::Extension
 
 	private:
 		std::weak_ptr<Atrium::RenderTexture> myRenderTarget;
-		std::unique_ptr<DirectX12::RenderPassDescriptorHeap> myCBV_SRVHeap;
 		std::map<std::uint64_t, DirectX12::DescriptorHeapHandle> myCBV_SRVHeapHandles;
 	};
 }